@@ -79,6 +79,10 @@ public:
 
     virtual void getGpuStats(SkCanvas*, SkTArray<SkString>* keys, SkTArray<double>* values) {}
 
+    // Extra metrics describing the work done by the timed draws (e.g. pixels touched per frame).
+    // Called after the timed draws, before perCanvasPostDraw().
+    virtual void getStats(SkTArray<SkString>* keys, SkTArray<double>* values) {}
+
     // Count of units (pixels, whatever) being exercised, to scale timing by.
     int getUnits() const { return fUnits; }
 
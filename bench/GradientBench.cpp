@@ -12,6 +12,7 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/effects/SkGradientShader.h"
+#include "src/shaders/gradients/SkGradientShaderPriv.h"
 
 #include "tools/ToolUtils.h"
 
@@ -50,31 +51,33 @@ static const GradData gGradData[] = {
 
 /// Ignores scale
 static sk_sp<SkShader> MakeLinear(const SkPoint pts[2], const GradData& data,
-                                  SkTileMode tm, float scale) {
-    return SkGradientShader::MakeLinear(pts, data.fColors, data.fPos, data.fCount, tm);
+                                  SkTileMode tm, float scale, uint32_t flags) {
+    return SkGradientShader::MakeLinear(pts, data.fColors, data.fPos, data.fCount, tm,
+                                        flags, nullptr);
 }
 
 static sk_sp<SkShader> MakeRadial(const SkPoint pts[2], const GradData& data,
-                                  SkTileMode tm, float scale) {
+                                  SkTileMode tm, float scale, uint32_t flags) {
     SkPoint center;
     center.set(SkScalarAve(pts[0].fX, pts[1].fX),
                SkScalarAve(pts[0].fY, pts[1].fY));
     return SkGradientShader::MakeRadial(center, center.fX * scale, data.fColors,
-                                        data.fPos, data.fCount, tm);
+                                        data.fPos, data.fCount, tm, flags, nullptr);
 }
 
 /// Ignores scale
 static sk_sp<SkShader> MakeSweep(const SkPoint pts[2], const GradData& data,
-                                 SkTileMode tm, float scale) {
+                                 SkTileMode tm, float scale, uint32_t flags) {
     SkPoint center;
     center.set(SkScalarAve(pts[0].fX, pts[1].fX),
                SkScalarAve(pts[0].fY, pts[1].fY));
-    return SkGradientShader::MakeSweep(center.fX, center.fY, data.fColors, data.fPos, data.fCount);
+    return SkGradientShader::MakeSweep(center.fX, center.fY, data.fColors, data.fPos, data.fCount,
+                                       flags, nullptr);
 }
 
 /// Ignores scale
 static sk_sp<SkShader> MakeConical(const SkPoint pts[2], const GradData& data,
-                                   SkTileMode tm, float scale) {
+                                   SkTileMode tm, float scale, uint32_t flags) {
     SkPoint center0, center1;
     center0.set(SkScalarAve(pts[0].fX, pts[1].fX),
                 SkScalarAve(pts[0].fY, pts[1].fY));
@@ -82,12 +85,13 @@ static sk_sp<SkShader> MakeConical(const SkPoint pts[2], const GradData& data,
                 SkScalarInterp(pts[0].fY, pts[1].fY, SkIntToScalar(1)/4));
     return SkGradientShader::MakeTwoPointConical(center1, (pts[1].fX - pts[0].fX) / 7,
                                                  center0, (pts[1].fX - pts[0].fX) / 2,
-                                                 data.fColors, data.fPos, data.fCount, tm);
+                                                 data.fColors, data.fPos, data.fCount, tm,
+                                                 flags, nullptr);
 }
 
 /// Ignores scale
 static sk_sp<SkShader> MakeConicalZeroRad(const SkPoint pts[2], const GradData& data,
-                                          SkTileMode tm, float scale) {
+                                          SkTileMode tm, float scale, uint32_t flags) {
     SkPoint center0, center1;
     center0.set(SkScalarAve(pts[0].fX, pts[1].fX),
                 SkScalarAve(pts[0].fY, pts[1].fY));
@@ -95,12 +99,13 @@ static sk_sp<SkShader> MakeConicalZeroRad(const SkPoint pts[2], const GradData&
                 SkScalarInterp(pts[0].fY, pts[1].fY, SkIntToScalar(1)/4));
     return SkGradientShader::MakeTwoPointConical(center1, 0.0,
                                                  center0, (pts[1].fX - pts[0].fX) / 2,
-                                                 data.fColors, data.fPos, data.fCount, tm);
+                                                 data.fColors, data.fPos, data.fCount, tm,
+                                                 flags, nullptr);
 }
 
 /// Ignores scale
 static sk_sp<SkShader> MakeConicalOutside(const SkPoint pts[2], const GradData& data,
-                                          SkTileMode tm, float scale) {
+                                          SkTileMode tm, float scale, uint32_t flags) {
     SkPoint center0, center1;
     SkScalar radius0 = (pts[1].fX - pts[0].fX) / 10;
     SkScalar radius1 = (pts[1].fX - pts[0].fX) / 3;
@@ -109,12 +114,12 @@ static sk_sp<SkShader> MakeConicalOutside(const SkPoint pts[2], const GradData&
     return SkGradientShader::MakeTwoPointConical(center0, radius0,
                                                  center1, radius1,
                                                  data.fColors, data.fPos,
-                                                 data.fCount, tm);
+                                                 data.fCount, tm, flags, nullptr);
 }
 
 /// Ignores scale
 static sk_sp<SkShader> MakeConicalOutsideZeroRad(const SkPoint pts[2], const GradData& data,
-                                                 SkTileMode tm, float scale) {
+                                                 SkTileMode tm, float scale, uint32_t flags) {
     SkPoint center0, center1;
     SkScalar radius0 = (pts[1].fX - pts[0].fX) / 10;
     SkScalar radius1 = (pts[1].fX - pts[0].fX) / 3;
@@ -123,11 +128,11 @@ static sk_sp<SkShader> MakeConicalOutsideZeroRad(const SkPoint pts[2], const Gra
     return SkGradientShader::MakeTwoPointConical(center0, 0.0,
                                                  center1, radius1,
                                                  data.fColors, data.fPos,
-                                                 data.fCount, tm);
+                                                 data.fCount, tm, flags, nullptr);
 }
 
 typedef sk_sp<SkShader> (*GradMaker)(const SkPoint pts[2], const GradData& data,
-                                     SkTileMode tm, float scale);
+                                     SkTileMode tm, float scale, uint32_t flags);
 
 static const struct {
     GradMaker   fMaker;
@@ -177,7 +182,8 @@ public:
                   GradData data = gGradData[0],
                   SkTileMode tm = SkTileMode::kClamp,
                   GeomType geomType = kRect_GeomType,
-                  float scale = 1.0f)
+                  float scale = 1.0f,
+                  uint32_t flags = 0)
         : fGeomType(geomType) {
 
         fName.printf("gradient_%s_%s", gGrads[gradType].fName,
@@ -192,11 +198,15 @@ public:
 
         fName.append(data.fName);
 
+        if (flags & SkGradientShaderBase::kUseColorLUT_PrivateFlag) {
+            fName.append("_lut");
+        }
+
         this->setupPaint(&fPaint);
-        fPaint.setShader(MakeShader(gradType, data, tm, scale));
+        fPaint.setShader(MakeShader(gradType, data, tm, scale, flags));
     }
 
-    GradientBench(GradType gradType, GradData data, bool dither)
+    GradientBench(GradType gradType, GradData data, bool dither, uint32_t flags = 0)
         : fGeomType(kRect_GeomType) {
 
         const char *tmname = ToolUtils::tilemode_name(SkTileMode::kClamp);
@@ -207,8 +217,12 @@ public:
             fName.appendf("_dither");
         }
 
+        if (flags & SkGradientShaderBase::kUseColorLUT_PrivateFlag) {
+            fName.append("_lut");
+        }
+
         this->setupPaint(&fPaint);
-        fPaint.setShader(MakeShader(gradType, data, SkTileMode::kClamp, 1.0f));
+        fPaint.setShader(MakeShader(gradType, data, SkTileMode::kClamp, 1.0f, flags));
         fPaint.setDither(dither);
     }
 
@@ -240,13 +254,13 @@ private:
     using INHERITED = Benchmark;
 
     sk_sp<SkShader> MakeShader(GradType gradType, GradData data,
-                               SkTileMode tm, float scale) {
+                               SkTileMode tm, float scale, uint32_t flags) {
         const SkPoint pts[2] = {
             { 0, 0 },
             { SkIntToScalar(kSize), SkIntToScalar(kSize) }
         };
 
-        return gGrads[gradType].fMaker(pts, data, tm, scale);
+        return gGrads[gradType].fMaker(pts, data, tm, scale, flags);
     }
 
     static const int kSize = 400;
@@ -306,6 +320,19 @@ DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[3], false); )
 DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[3], true); )
 DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[3], false); )
 
+// The same gradients, looking their colors up in a table.
+static constexpr uint32_t kLUT = SkGradientShaderBase::kUseColorLUT_PrivateFlag;
+
+DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[1], SkTileMode::kClamp, kRect_GeomType, 1.0f, kLUT); )
+DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[2], SkTileMode::kClamp, kRect_GeomType, 1.0f, kLUT); )
+DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[4], SkTileMode::kClamp, kRect_GeomType, 1.0f, kLUT); )
+DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[1], SkTileMode::kRepeat, kRect_GeomType, 1.0f, kLUT); )
+DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[1], SkTileMode::kMirror, kRect_GeomType, 1.0f, kLUT); )
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[1], SkTileMode::kClamp, kRect_GeomType, 1.0f, kLUT); )
+DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[1], SkTileMode::kClamp, kRect_GeomType, 1.0f, kLUT); )
+DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[1], SkTileMode::kClamp, kRect_GeomType, 1.0f, kLUT); )
+DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[1], true, kLUT); )
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class Gradient2Bench : public Benchmark {
@@ -14,17 +14,19 @@
 #include "include/core/SkString.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/private/SkTemplates.h"
+#include "src/shaders/gradients/SkGradientShaderPriv.h"
 
 class HardStopGradientBench_ScaleNumHardStops : public Benchmark {
 public:
-    HardStopGradientBench_ScaleNumHardStops(int colorCount, int hardStopCount) {
+    HardStopGradientBench_ScaleNumHardStops(int colorCount, int hardStopCount, bool lut = false) {
         SkASSERT(hardStopCount <= colorCount/2);
 
-        fName.printf("hardstop_scale_num_hard_stops_%03d_colors_%03d_hard_stops",
-                     colorCount, hardStopCount);
+        fName.printf("hardstop_scale_num_hard_stops_%03d_colors_%03d_hard_stops%s",
+                     colorCount, hardStopCount, lut ? "_lut" : "");
 
         fColorCount    = colorCount;
         fHardStopCount = hardStopCount;
+        fLUT           = lut;
     }
 
     const char* onGetName() override {
@@ -69,12 +71,13 @@ public:
             positions[i] = i / (fColorCount - 1.0f);
         }
 
+        const uint32_t flags = fLUT ? SkGradientShaderBase::kUseColorLUT_PrivateFlag : 0;
         fPaint.setShader(SkGradientShader::MakeLinear(points,
                                                       colors.get(),
                                                       positions.get(),
                                                       fColorCount,
                                                       SkTileMode::kClamp,
-                                                      0,
+                                                      flags,
                                                       nullptr));
     }
 
@@ -93,6 +96,7 @@ private:
     SkString fName;
     int      fColorCount;
     int      fHardStopCount;
+    bool     fLUT;
     SkPaint  fPaint;
 
     using INHERITED = Benchmark;
@@ -113,3 +117,7 @@ DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(50, 25);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100,  1);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100, 25);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100, 50);)
+
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(10,  5, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(50, 25, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100, 50, true);)
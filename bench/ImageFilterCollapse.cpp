@@ -25,11 +25,15 @@ public:
     BaseImageFilterCollapseBench() {}
 
 protected:
-    void doPreDraw(sk_sp<SkColorFilter> colorFilters[], int nFilters) {
+    void doPreDraw(sk_sp<SkColorFilter> colorFilters[], int nFilters,
+                   bool offsetBetween = false) {
         SkASSERT(!fImageFilter);
 
         // Create a chain of ImageFilters from colorFilters
         for(int i = nFilters; i --> 0;) {
+            if (offsetBetween && fImageFilter) {
+                fImageFilter = SkImageFilters::Offset(1, 1, fImageFilter);
+            }
             fImageFilter = SkImageFilters::ColorFilter(colorFilters[i], fImageFilter);
         }
     }
@@ -132,5 +136,25 @@ protected:
     }
 };
 
+// The offsets between the color filters stop them from being collapsed when the chain is built,
+// but they are still fused into a single draw when it is filtered.
+class MatrixOffsetCollapseBench: public BaseImageFilterCollapseBench {
+protected:
+    const char* onGetName() override {
+        return "image_filter_collapse_matrix_offset";
+    }
+
+    void onDelayedSetup() override {
+        sk_sp<SkColorFilter> colorFilters[] = {
+            make_brightness(0.1f),
+            make_grayscale(),
+            make_brightness(-0.1f),
+        };
+
+        this->doPreDraw(colorFilters, SK_ARRAY_COUNT(colorFilters), true);
+    }
+};
+
 DEF_BENCH(return new TableCollapseBench;)
 DEF_BENCH(return new MatrixCollapseBench;)
+DEF_BENCH(return new MatrixOffsetCollapseBench;)
@@ -7,7 +7,10 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkPoint3.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/GrRecordingContext.h"
@@ -164,7 +167,78 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Exercise a DAG of independent branches and pixel-local filters covering the whole canvas, with
+// the default SkExecutor set to a thread pool of the given size, to measure how raster filtering
+// scales with threads. 0 threads leaves the default (single-threaded) executor in place.
+class ImageFilterDAGThreadsBench : public Benchmark {
+public:
+    explicit ImageFilterDAGThreadsBench(int threads) : fThreads(threads) {
+        fName.printf("image_filter_dag_threads_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return kRaster_Backend == backend; }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fPrevExecutor = &SkExecutor::GetDefault();
+        if (fThreads > 0) {
+            fThreadPool = SkExecutor::MakeFIFOThreadPool(fThreads);
+            SkExecutor::SetDefault(fThreadPool.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkExecutor::SetDefault(fPrevExecutor);
+        fThreadPool.reset();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkRect rect = SkRect::Make(canvas->imageInfo().bounds());
+        const SkIRect crop = canvas->imageInfo().bounds();
+
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        for (int j = 0; j < loops; j++) {
+            // Rebuild the DAG every loop so the raster backend's image filter cache only helps
+            // with nodes shared within one evaluation (see ImageFilterDAGBench).
+            auto blur = SkImageFilters::Blur(8.0f, 8.0f, nullptr);
+            auto lit = SkImageFilters::DistantLitDiffuse(SkPoint3::Make(1, 1, 1), SK_ColorWHITE,
+                                                         2.0f, 1.0f, blur);
+            auto tinted = SkImageFilters::ColorFilter(
+                    SkColorFilters::Blend(SK_ColorRED, SkBlendMode::kModulate),
+                    SkImageFilters::Offset(10.0f, 10.0f, nullptr, &crop));
+            auto arithmetic = SkImageFilters::Arithmetic(0.5f, 0.5f, 0.5f, 0.0f, true,
+                                                         lit, tinted);
+            auto displaced = SkImageFilters::DisplacementMap(SkColorChannel::kR,
+                                                             SkColorChannel::kG,
+                                                             8.0f, blur, arithmetic);
+            sk_sp<SkImageFilter> inputs[] = {
+                arithmetic,
+                displaced,
+                SkImageFilters::Xfermode(SkBlendMode::kSrcOver, lit, tinted),
+            };
+            paint.setImageFilter(SkImageFilters::Merge(inputs, SK_ARRAY_COUNT(inputs)));
+            canvas->drawRect(rect, paint);
+        }
+    }
+
+private:
+    int fThreads;
+    SkString fName;
+    SkExecutor* fPrevExecutor = nullptr;
+    std::unique_ptr<SkExecutor> fThreadPool;
+
+    using INHERITED = Benchmark;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(0);)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(1);)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(2);)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(4);)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(8);)
@@ -18,9 +18,12 @@ static constexpr const char* kBenchFile = "/tmp/bench.json";
 
 class JsonBench : public Benchmark {
 public:
+    // When |binary| is set, the bench file is converted to the precompiled skjson format
+    // upfront, and only the binary load is measured.
+    explicit JsonBench(bool binary) : fBinary(binary) {}
 
 protected:
-    const char* onGetName() override { return "json_skjson"; }
+    const char* onGetName() override { return fBinary ? "json_skjson_binary" : "json_skjson"; }
 
     bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
 
@@ -28,6 +31,14 @@ protected:
         fData = SkData::MakeFromFileName(kBenchFile);
         if (!fData) {
             SkDebugf("!! Could not open bench file: %s\n", kBenchFile);
+            return;
+        }
+
+        if (fBinary) {
+            const skjson::DOM dom(static_cast<const char*>(fData->data()), fData->size());
+            SkDynamicMemoryWStream stream;
+            dom.writeBinary(&stream);
+            fData = stream.detachAsData();
         }
     }
 
@@ -47,13 +58,63 @@ protected:
         }
     }
 
+private:
+    const bool    fBinary;
+    sk_sp<SkData> fData;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new JsonBench(false); )
+DEF_BENCH( return new JsonBench(true ); )
+
+// Synthetic Lottie-style document dominated by long string values (embedded base64 image
+// assets), exercising the chunked string scanning without requiring a bench file.
+class JsonStringBench : public Benchmark {
+protected:
+    const char* onGetName() override { return "json_skjson_strings"; }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        static constexpr char kBase64[] =
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        static constexpr int kAssetCount  = 64,
+                             kAssetLength = 64 * 1024;
+
+        SkDynamicMemoryWStream stream;
+        stream.writeText("{\"v\":\"5.5.2\",\"assets\":[");
+        for (int i = 0; i < kAssetCount; ++i) {
+            stream.writeText(i ? ",{\"id\":\"image_" : "{\"id\":\"image_");
+            stream.writeDecAsText(i);
+            stream.writeText("\",\"w\":512,\"h\":512,\"p\":\"data:image/png;base64,");
+            for (int j = 0; j < kAssetLength; ++j) {
+                stream.write8(kBase64[(i + j * 7) % 64]);
+            }
+            stream.writeText("\"}");
+        }
+        stream.writeText("]}");
+
+        fData = stream.detachAsData();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            skjson::DOM dom(static_cast<const char*>(fData->data()), fData->size());
+            if (dom.root().is<skjson::NullValue>()) {
+                SkDebugf("!! Parsing failed.\n");
+                return;
+            }
+        }
+    }
+
 private:
     sk_sp<SkData> fData;
 
     using INHERITED = Benchmark;
 };
 
-DEF_BENCH( return new JsonBench; )
+DEF_BENCH( return new JsonStringBench; )
 
 #if (0)
 
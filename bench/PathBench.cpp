@@ -1279,3 +1279,80 @@ DEF_BENCH( return new CommonConvexBench(200, 16, false, false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, false, true); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  true); )
+
+#include "include/utils/SkTextUtils.h"
+#include "src/core/SkScan.h"
+#include "tools/ToolUtils.h"
+
+// Fills the same anti-aliased path with the usual rasterizers or with the sparse tile rasterizer.
+class SparseTileAABench : public Benchmark {
+public:
+    enum Shape { kText_Shape, kMap_Shape };
+
+    SparseTileAABench(Shape shape, bool sparse) : fShape(shape), fSparse(sparse) {
+        fName.printf("path_aa_%s_%s", shape == kText_Shape ? "text" : "map",
+                     sparse ? "sparse_tile" : "default");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kRaster_Backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        if (fShape == kText_Shape) {
+            // A page of large glyph outlines: many small curved contours.
+            SkFont font(ToolUtils::create_portable_typeface(), 48);
+            const char* text = "The quick brown fox jumps over";
+            for (int line = 0; line < 8; ++line) {
+                SkPath path;
+                SkTextUtils::GetPath(text, strlen(text), SkTextEncoding::kUTF8,
+                                     10, 55.5f + line * 56, font, &path);
+                fPath.addPath(path);
+            }
+        } else {
+            // A coastline around a few lakes: long contours of short, jagged lines.
+            SkRandom rand;
+            for (int ring = 0; ring < 4; ++ring) {
+                SkPoint center = ring ? SkPoint{160.0f * ring, 240} : SkPoint{320, 240};
+                SkScalar radius = ring ? 60 : 230;
+                for (int i = 0; i < 2000; ++i) {
+                    SkScalar a = i * 2 * SK_ScalarPI / 2000,
+                             r = radius * (1 + 0.1f * rand.nextSScalar1());
+                    SkPoint p = center + SkPoint{r * SkScalarCos(a), r * SkScalarSin(a) * 0.9f};
+                    i ? fPath.lineTo(p) : fPath.moveTo(p);
+                }
+                fPath.close();
+            }
+            fPath.setFillType(SkPathFillType::kEvenOdd);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+
+        bool prev = gSkUseSparseTileAA.exchange(fSparse);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, paint);
+        }
+        gSkUseSparseTileAA = prev;
+    }
+
+private:
+    SkString    fName;
+    SkPath      fPath;
+    const Shape fShape;
+    const bool  fSparse;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new SparseTileAABench(SparseTileAABench::kText_Shape, false); )
+DEF_BENCH( return new SparseTileAABench(SparseTileAABench::kText_Shape, true); )
+DEF_BENCH( return new SparseTileAABench(SparseTileAABench::kMap_Shape, false); )
+DEF_BENCH( return new SparseTileAABench(SparseTileAABench::kMap_Shape, true); )
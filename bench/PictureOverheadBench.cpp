@@ -6,10 +6,15 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRRect.h"
 
+#include <vector>
+
 class ClipOverheadRecordingBench : public Benchmark {
 public:
     ClipOverheadRecordingBench() {}
@@ -40,3 +45,53 @@ private:
     }
 };
 DEF_BENCH( return new ClipOverheadRecordingBench; )
+
+// Records the same path and image content, drawn from separate objects, over and over.
+class ContentRecordingBench : public Benchmark {
+public:
+    ContentRecordingBench(bool dedup) : fDedup(dedup) {}
+
+private:
+    const char* onGetName() override {
+        return fDedup ? "content_recording_dedup" : "content_recording";
+    }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < kCount; i++) {
+            SkPath path;
+            path.moveTo(0, 0);
+            for (int j = 1; j < 64; j++) {
+                path.quadTo(j * 10, (j % 7) * 10, j * 10 + 5, (j % 5) * 10);
+            }
+            fPaths.push_back(path);
+
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(64, 64);
+            bitmap.eraseColor(SK_ColorGREEN);
+            fImages.push_back(SkImage::MakeFromBitmap(bitmap));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPictureRecorder rec;
+        const uint32_t flags = fDedup ? SkPictureRecorder::kDeduplicateContent_RecordFlag : 0;
+
+        for (int i = 0; i < loops; i++) {
+            SkCanvas* canvas = rec.beginRecording({0,0, 2000,3000}, nullptr, flags);
+            for (int j = 0; j < kCount; j++) {
+                canvas->drawPath(fPaths[j], SkPaint());
+                canvas->drawImage(fImages[j], j, j);
+            }
+            (void)rec.finishRecordingAsPicture();
+        }
+    }
+
+    static constexpr int kCount = 200;
+
+    bool                        fDedup;
+    std::vector<SkPath>         fPaths;
+    std::vector<sk_sp<SkImage>> fImages;
+};
+DEF_BENCH( return new ContentRecordingBench(false); )
+DEF_BENCH( return new ContentRecordingBench(true); )
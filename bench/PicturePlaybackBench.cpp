@@ -9,13 +9,18 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkData.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
 #include "include/utils/SkRandom.h"
+#include "src/core/SkPicturePriv.h"
 
 // This is designed to emulate about 4 screens of textual content
 
@@ -97,3 +102,110 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// 10000 rects and paths, each under its own translate, scattered over a 1024x1024 picture.
+static sk_sp<SkPicture> make_scattered_picture() {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(1024, 1024);
+        SkRandom rand;
+        SkPath path;
+        path.addOval({0, 0, 32, 32});
+        path.lineTo(16, 48);
+        for (int i = 0; i < 10000; i++) {
+            SkScalar x = rand.nextRangeScalar(0, 1024),
+                     y = rand.nextRangeScalar(0, 1024);
+            SkPaint paint;
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas->save();
+            canvas->translate(x, y);
+            if (i % 4 == 0) {
+                canvas->drawPath(path, paint);
+            } else {
+                canvas->drawRect(SkRect::MakeWH(rand.nextRangeScalar(0, 128),
+                                                rand.nextRangeScalar(0, 128)), paint);
+            }
+            canvas->restore();
+        }
+    return recorder.finishRecordingAsPicture();
+}
+
+// Measures SkPicture deserialization, from either the SkPictureData format (replayed through a
+// recorder) or the SkRecord format (decoded directly into an SkRecord).
+class PictureDeserializeBench : public Benchmark {
+public:
+    PictureDeserializeBench(bool record) : fRecord(record) {
+        fName.printf("picture_deserialize_%s", record ? "skrecord" : "skpicturedata");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        sk_sp<SkPicture> picture = make_scattered_picture();
+
+        SkDynamicMemoryWStream stream;
+        if (fRecord) {
+            SkPicturePriv::SerializeRecord(picture.get(), &stream);
+        } else {
+            picture->serialize(&stream);
+        }
+        fData = stream.detachAsData();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkPicture> picture = SkPicture::MakeFromData(fData.get());
+            SkASSERT(picture);
+        }
+    }
+
+private:
+    bool          fRecord;
+    SkString      fName;
+    sk_sp<SkData> fData;
+};
+
+DEF_BENCH( return new PictureDeserializeBench(false); )
+DEF_BENCH( return new PictureDeserializeBench(true ); )
+
+// Measures loading an indexed SkRecord format picture and drawing one 128x128 tile of it, either
+// decoding the whole picture up front (eager) or just the ops that tile needs (lazy).
+class PictureLoadTileBench : public Benchmark {
+public:
+    PictureLoadTileBench(bool lazy) : fLazy(lazy) {
+        fName.printf("picture_load_tile_%s", lazy ? "lazy" : "eager");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        sk_sp<SkPicture> picture = make_scattered_picture();
+        SkDynamicMemoryWStream stream;
+        SkPicturePriv::SerializeRecord(picture.get(), &stream, nullptr, /*writeIndex=*/true);
+        fData = stream.detachAsData();
+        fSurface = SkSurface::MakeRasterN32Premul(128, 128);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkPicture> picture = fLazy ? SkPicturePriv::MakeLazyFromData(fData)
+                                             : SkPicture::MakeFromData(fData.get());
+            SkASSERT(picture);
+            canvas->save();
+            canvas->translate(-448, -448);
+            canvas->drawPicture(picture);
+            canvas->restore();
+        }
+    }
+
+private:
+    bool             fLazy;
+    SkString         fName;
+    sk_sp<SkData>    fData;
+    sk_sp<SkSurface> fSurface;
+};
+
+DEF_BENCH( return new PictureLoadTileBench(false); )
+DEF_BENCH( return new PictureLoadTileBench(true ); )
@@ -16,14 +16,18 @@
 static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
 static const int NUM_QUERY_RECTS = 5000;
+static const int NUM_LARGE_RECTS = 1 << 20;
 static const int GRID_WIDTH = 100;
+static const int NUM_TILES = 16;  // a 4x4 grid of tiles per query
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
+    RTreeBuildBench(const char* name, MakeRectProc proc, int numRects = NUM_BUILD_RECTS)
+            : fProc(proc)
+            , fNumRects(numRects) {
         fName.printf("rtree_%s_build", name);
     }
 
@@ -37,19 +41,20 @@ protected:
     }
     void onDraw(int loops, SkCanvas* canvas) override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_BUILD_RECTS);
-        for (int i = 0; i < NUM_BUILD_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_BUILD_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
 
         for (int i = 0; i < loops; ++i) {
             SkRTree tree;
-            tree.insert(rects.get(), NUM_BUILD_RECTS);
+            tree.insert(rects.get(), fNumRects);
             SkASSERT(rects != nullptr);  // It'd break this bench if the tree took ownership of rects.
         }
     }
 private:
     MakeRectProc fProc;
+    int fNumRects;
     SkString fName;
     using INHERITED = Benchmark;
 };
@@ -57,7 +62,9 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
+    RTreeQueryBench(const char* name, MakeRectProc proc, int numRects = NUM_QUERY_RECTS)
+            : fProc(proc)
+            , fNumRects(numRects) {
         fName.printf("rtree_%s_query", name);
     }
 
@@ -70,11 +77,11 @@ protected:
     }
     void onDelayedSetup() override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_QUERY_RECTS);
-        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        fTree.insert(rects.get(), fNumRects);
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -92,6 +99,65 @@ protected:
 private:
     SkRTree fTree;
     MakeRectProc fProc;
+    int fNumRects;
+    SkString fName;
+    using INHERITED = Benchmark;
+};
+
+// Time how long it takes to find what a 4x4 grid of tiles needs, with either a query per tile or
+// a single batched query.
+class RTreeTileQueryBench : public Benchmark {
+public:
+    RTreeTileQueryBench(const char* name, MakeRectProc proc, bool batched,
+                        int numRects = NUM_QUERY_RECTS)
+            : fProc(proc)
+            , fNumRects(numRects)
+            , fBatched(batched) {
+        fName.printf("rtree_%s_query_tiles%s", name, batched ? "_batched" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
+        }
+        fTree.insert(rects.get(), fNumRects);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkRandom rand;
+        for (int i = 0; i < loops; ++i) {
+            const SkScalar x = rand.nextRangeF(0, GENERATE_EXTENTS),
+                           y = rand.nextRangeF(0, GENERATE_EXTENTS),
+                           size = GENERATE_EXTENTS/16;
+            SkRect tiles[NUM_TILES];
+            for (int t = 0; t < NUM_TILES; ++t) {
+                tiles[t] = SkRect::MakeXYWH(x + (t % 4) * size, y + (t / 4) * size, size, size);
+            }
+
+            std::vector<int> hits[NUM_TILES];
+            if (fBatched) {
+                fTree.search(tiles, NUM_TILES, hits);
+            } else {
+                for (int t = 0; t < NUM_TILES; ++t) {
+                    fTree.search(tiles[t], &hits[t]);
+                }
+            }
+        }
+    }
+private:
+    SkRTree fTree;
+    MakeRectProc fProc;
+    int fNumRects;
+    bool fBatched;
     SkString fName;
     using INHERITED = Benchmark;
 };
@@ -122,6 +188,16 @@ static inline SkRect make_random_rects(SkRandom& rand, int index, int numRects)
     return out;
 }
 
+// Lots of small rects, like the glyph runs and icons of a long page.
+static inline SkRect make_small_rects(SkRandom& rand, int index, int numRects) {
+    SkRect out;
+    out.fLeft   = rand.nextRangeF(0, GENERATE_EXTENTS);
+    out.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
+    out.fRight  = out.fLeft + 1 + rand.nextRangeF(0, 4);
+    out.fBottom = out.fTop  + 1 + rand.nextRangeF(0, 4);
+    return out;
+}
+
 static inline SkRect make_concentric_rects(SkRandom&, int index, int numRects) {
     return SkRect::MakeWH(SkIntToScalar(index+1), SkIntToScalar(index+1));
 }
@@ -137,3 +213,17 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+// Big enough to be Hilbert packed.
+DEF_BENCH(return new RTreeBuildBench("XY_5K", &make_XYordered_rects, NUM_QUERY_RECTS));
+DEF_BENCH(return new RTreeBuildBench("random_5K", &make_random_rects, NUM_QUERY_RECTS));
+
+DEF_BENCH(return new RTreeBuildBench("small_1M", &make_small_rects, NUM_LARGE_RECTS));
+DEF_BENCH(return new RTreeQueryBench("small_1M", &make_small_rects, NUM_LARGE_RECTS));
+
+DEF_BENCH(return new RTreeTileQueryBench("XY", &make_XYordered_rects, false));
+DEF_BENCH(return new RTreeTileQueryBench("XY", &make_XYordered_rects, true));
+DEF_BENCH(return new RTreeTileQueryBench("random", &make_random_rects, false));
+DEF_BENCH(return new RTreeTileQueryBench("random", &make_random_rects, true));
+DEF_BENCH(return new RTreeTileQueryBench("small_1M", &make_small_rects, false, NUM_LARGE_RECTS));
+DEF_BENCH(return new RTreeTileQueryBench("small_1M", &make_small_rects, true,  NUM_LARGE_RECTS));
@@ -7,6 +7,7 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkRegion.h"
 #include "include/core/SkString.h"
+#include "include/private/SkTDArray.h"
 #include "include/utils/SkRandom.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
@@ -34,6 +35,13 @@ static bool diffrectbig_proc(SkRegion& a, SkRegion& b) {
     return result.op(a, a.getBounds(), SkRegion::kDifference_Op);
 }
 
+static bool unionrect_proc(SkRegion& a, SkRegion& b) {
+    SkIRect r = a.getBounds();
+    r.inset(r.width() * 3 / 8, r.height() * 3 / 8);
+    SkRegion result;
+    return result.op(a, r, SkRegion::kUnion_Op);
+}
+
 static bool containsrect_proc(SkRegion& a, SkRegion& b) {
     SkIRect r = a.getBounds();
     r.inset(r.width()/4, r.height()/4);
@@ -125,7 +133,59 @@ DEF_BENCH(return new RegionBench(SMALL, sect_proc, "intersect");)
 DEF_BENCH(return new RegionBench(SMALL, diff_proc, "difference");)
 DEF_BENCH(return new RegionBench(SMALL, diffrect_proc, "differencerect");)
 DEF_BENCH(return new RegionBench(SMALL, diffrectbig_proc, "differencerectbig");)
+DEF_BENCH(return new RegionBench(SMALL, unionrect_proc, "unionrect");)
+DEF_BENCH(return new RegionBench(256, unionrect_proc, "unionrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsrect_proc, "containsrect");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrgn_proc, "intersectsrgn");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrect_proc, "intersectsrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsxy_proc, "containsxy");)
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Builds a region from lots of small, often overlapping rects, like a frame's worth of damage,
+// either all at once with setRects() or one rect at a time.
+class RegionSetRectsBench : public Benchmark {
+public:
+    RegionSetRectsBench(int count, bool batched) : fBatched(batched) {
+        fName.printf("region_%s_%d", batched ? "setrects" : "unionrects", count);
+
+        SkRandom rand;
+        for (int i = 0; i < count; i++) {
+            int x = rand.nextU() % 1024;
+            int y = rand.nextU() % 768;
+            fRects.push_back(SkIRect::MakeXYWH(x, y, 1 + rand.nextU() % 64, 1 + rand.nextU() % 64));
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            if (fBatched) {
+                rgn.setRects(fRects.begin(), fRects.count());
+            } else {
+                for (const SkIRect& r : fRects) {
+                    rgn.op(r, SkRegion::kUnion_Op);
+                }
+            }
+        }
+    }
+
+private:
+    SkTDArray<SkIRect> fRects;
+    bool               fBatched;
+    SkString           fName;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new RegionSetRectsBench(100, true);)
+DEF_BENCH(return new RegionSetRectsBench(100, false);)
+DEF_BENCH(return new RegionSetRectsBench(2000, true);)
+DEF_BENCH(return new RegionSetRectsBench(2000, false);)
@@ -6,8 +6,10 @@
  */
 
 #include "bench/SKPBench.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkSurface.h"
 #include "include/gpu/GrDirectContext.h"
+#include "src/core/SkPicturePriv.h"
 #include "src/gpu/GrContextPriv.h"
 #include "tools/flags/CommandLineFlags.h"
 
@@ -134,6 +136,48 @@ void SKPBench::drawPicture() {
     }
 }
 
+SKPThreadedBench::SKPThreadedBench(const char* name, const SkPicture* pic, const SkIRect& clip,
+                                   SkScalar scale, int threads, bool doLooping)
+    : INHERITED(SkStringPrintf("%s_threads%d", name, threads).c_str(), pic, clip, scale,
+                doLooping)
+    , fThreads(threads) {
+    fUniqueName.printf("%s_%.2g_threads%d", name, scale, threads);
+}
+
+SKPThreadedBench::~SKPThreadedBench() = default;
+
+const char* SKPThreadedBench::onGetUniqueName() {
+    return fUniqueName.c_str();
+}
+
+bool SKPThreadedBench::isSuitableFor(Backend backend) {
+    return backend == kRaster_Backend;
+}
+
+void SKPThreadedBench::onPerCanvasPreDraw(SkCanvas* canvas) {
+    if (!canvas->peekPixels(&fDst)) {
+        SkDebugf("%s needs a canvas with pixels.\n", this->getName());
+        fDst.reset();
+        return;
+    }
+    fMatrix = SkMatrix::Concat(canvas->getTotalMatrix(),
+                               SkMatrix::Scale(this->scale(), this->scale()));
+    fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+}
+
+void SKPThreadedBench::onPerCanvasPostDraw(SkCanvas*) {
+    fExecutor.reset();
+    fDst.reset();
+}
+
+void SKPThreadedBench::drawPicture() {
+    if (!fDst.addr()) {
+        return;
+    }
+    SkPicturePriv::PlaybackTiled(this->picture(), fDst, fMatrix, fExecutor.get(),
+                                 FLAGS_CPUbenchTileW, FLAGS_CPUbenchTileH);
+}
+
 #include "src/gpu/GrGpu.h"
 static void draw_pic_for_stats(SkCanvas* canvas, GrDirectContext* context, const SkPicture* picture,
                                SkTArray<SkString>* keys, SkTArray<double>* values) {
@@ -11,8 +11,10 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkPicture.h"
+#include "include/core/SkPixmap.h"
 #include "include/private/SkTDArray.h"
 
+class SkExecutor;
 class SkSurface;
 
 /**
@@ -43,6 +45,7 @@ protected:
     virtual void drawPicture();
 
     const SkPicture* picture() const { return fPic.get(); }
+    SkScalar scale() const { return fScale; }
     const SkTArray<sk_sp<SkSurface>>& surfaces() const { return fSurfaces; }
     const SkTDArray<SkIRect>& tileRects() const { return fTileRects; }
 
@@ -61,4 +64,35 @@ private:
     using INHERITED = Benchmark;
 };
 
+/**
+ * Draws an SkPicture straight into a raster canvas's pixels with SkPicturePriv::PlaybackTiled(),
+ * spreading the tiles over a pool of threads.  Comparing thread counts shows how playback scales.
+ */
+class SKPThreadedBench : public SKPBench {
+public:
+    SKPThreadedBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale,
+                     int threads, bool doLooping);
+    ~SKPThreadedBench() override;
+
+protected:
+    const char* onGetUniqueName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onPerCanvasPreDraw(SkCanvas*) override;
+    void onPerCanvasPostDraw(SkCanvas*) override;
+
+    void drawMPDPicture() override {
+        SK_ABORT("MPD not supported\n");
+    }
+    void drawPicture() override;
+
+private:
+    const int                   fThreads;
+    SkString                    fUniqueName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkPixmap                    fDst;
+    SkMatrix                    fMatrix;
+
+    using INHERITED = SKPBench;
+};
+
 #endif
@@ -7,6 +7,8 @@
 #include "bench/Benchmark.h"
 #include "bench/ResultsWriter.h"
 #include "bench/SkSLBench.h"
+#include "include/effects/SkRuntimeEffect.h"
+#include "src/core/SkRuntimeEffectPriv.h"
 #include "src/sksl/SkSLCompiler.h"
 
 class SkSLCompilerStartupBench : public Benchmark {
@@ -416,6 +418,77 @@ DEF_BENCH(return new SkSLBench("medium", R"(
     }
 )"); )
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Measures making the same SkRuntimeEffect over and over, as happens when each instance of a
+// widget makes its own effect. kCached calls Make() and finds the effect it made last time;
+// kUncached purges the cache first so every call compiles the source again; kFromBlob loads a
+// precompiled blob with SkRuntimeEffect_MakeFromBlob(), which never runs the compiler.
+class SkRuntimeEffectMakeBench : public Benchmark {
+public:
+    enum class Mode { kCached, kUncached, kFromBlob };
+
+    SkRuntimeEffectMakeBench(Mode mode) : fMode(mode) {
+        static const char* kModeNames[] = { "cached", "uncached", "from_blob" };
+        fName.printf("sksl_runtime_effect_make_%s", kModeNames[(int)mode]);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        if (fMode == Mode::kFromBlob) {
+            auto [effect, error] = SkRuntimeEffect::Make(SkString(kSource));
+            fBlob = effect ? SkRuntimeEffect_Serialize(*effect) : nullptr;
+            if (!fBlob) {
+                SK_ABORT("runtime effect serialization failed");
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fMode == Mode::kUncached) {
+                SkRuntimeEffect_PurgeCache();
+            }
+            auto [effect, error] = fMode == Mode::kFromBlob
+                                           ? SkRuntimeEffect_MakeFromBlob(fBlob)
+                                           : SkRuntimeEffect::Make(SkString(kSource));
+            if (!effect) {
+                printf("%s\n", error.c_str());
+                SK_ABORT("runtime effect creation failed");
+            }
+        }
+    }
+
+private:
+    static constexpr char kSource[] = R"(
+        uniform float4 gColor;
+        uniform float  gScale;
+        half4 main(float2 p) {
+            float2 q = fract(p * gScale) - 0.5;
+            half d = half(clamp((0.25 - length(q)) * 20, 0, 1));
+            return half4(gColor) * d;
+        }
+    )";
+
+    SkString      fName;
+    Mode          fMode;
+    sk_sp<SkData> fBlob;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new SkRuntimeEffectMakeBench(SkRuntimeEffectMakeBench::Mode::kCached);)
+DEF_BENCH(return new SkRuntimeEffectMakeBench(SkRuntimeEffectMakeBench::Mode::kUncached);)
+DEF_BENCH(return new SkRuntimeEffectMakeBench(SkRuntimeEffectMakeBench::Mode::kFromBlob);)
+
 #if defined(SK_BUILD_FOR_UNIX)
 
 #include <malloc.h>
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+
+#if defined(SK_ENABLE_SKOTTIE)
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkSurface.h"
+#include "modules/skottie/include/Skottie.h"
+#include "modules/sksg/include/SkSGInvalidationController.h"
+#include "src/utils/SkJSON.h"
+#include "tools/Resources.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Plays back an animation frame by frame into a persistent raster surface, either redrawing
+// the whole frame (full) or only the damaged areas (damage).  Also reports the average number
+// of pixels touched per frame.
+class SkottieRenderBench final : public Benchmark {
+public:
+    SkottieRenderBench(const char* name, const char* res, bool damageOnly)
+        : fResource(res)
+        , fDamageOnly(damageOnly) {
+        fName.printf("skottie_render_%s_%s", damageOnly ? "damage" : "full", name);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        if (auto stream = GetResourceAsStream(fResource)) {
+            fAnimation = skottie::Animation::Make(stream.get());
+        }
+        if (!fAnimation) {
+            SkDebugf("!! Could not load animation: %s\n", fResource);
+            return;
+        }
+
+        const auto size = fAnimation->size();
+        fSurface = SkSurface::MakeRasterN32Premul(SkScalarCeilToInt(size.width()),
+                                                  SkScalarCeilToInt(size.height()));
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (!fSurface) {
+            return;
+        }
+
+        fFrame = 0;
+        fFrameCount = 0;
+        fPixelsTouched = 0;
+
+        fAnimation->seekFrame(fAnimation->inPoint());
+        fSurface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        fAnimation->render(fSurface->getCanvas());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fSurface) {
+            return;
+        }
+
+        auto* canvas = fSurface->getCanvas();
+        const auto frames = std::max(1.0, std::floor(fAnimation->outPoint() -
+                                                     fAnimation->inPoint()));
+
+        for (int i = 0; i < loops; ++i) {
+            // Loop over the animation frames (frame 0 is already on the surface).
+            const auto t = fAnimation->inPoint() + std::fmod(++fFrame, frames);
+
+            if (fDamageOnly) {
+                sksg::InvalidationController ic;
+                fAnimation->seekFrame(t, &ic);
+
+                SkRegion damage;
+                fAnimation->renderDamage(canvas, ic, nullptr, 0, &damage);
+                for (SkRegion::Iterator it(damage); !it.done(); it.next()) {
+                    fPixelsTouched += it.rect().width() * it.rect().height();
+                }
+            } else {
+                fAnimation->seekFrame(t);
+                canvas->clear(SK_ColorTRANSPARENT);
+                fAnimation->render(canvas);
+                fPixelsTouched += fSurface->width() * fSurface->height();
+            }
+            fFrameCount++;
+        }
+    }
+
+    void getStats(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        if (!fFrameCount) {
+            return;
+        }
+
+        keys->push_back(SkString("pixels_touched_per_frame"));
+        values->push_back(fPixelsTouched / fFrameCount);
+        keys->push_back(SkString("pixels_per_frame"));
+        values->push_back(fSurface->width() * fSurface->height());
+    }
+
+private:
+    const char*               fResource;
+    const bool                fDamageOnly;
+    SkString                  fName;
+    sk_sp<skottie::Animation> fAnimation;
+    sk_sp<SkSurface>          fSurface;
+    uint64_t                  fFrame = 0,
+                              fFrameCount = 0;
+    double                    fPixelsTouched = 0;
+
+    using INHERITED = Benchmark;
+};
+
+// Measures animation load time, from either the JSON text or the precompiled binary form.
+class SkottieLoadBench final : public Benchmark {
+public:
+    SkottieLoadBench(const char* name, const char* res, bool binary)
+        : fResource(res)
+        , fBinary(binary) {
+        fName.printf("skottie_load_%s_%s", binary ? "bin" : "json", name);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fResource);
+        if (!fData) {
+            SkDebugf("!! Could not load animation: %s\n", fResource);
+            return;
+        }
+
+        if (fBinary) {
+            const skjson::DOM dom(static_cast<const char*>(fData->data()), fData->size());
+            SkDynamicMemoryWStream stream;
+            dom.writeBinary(&stream);
+            fData = stream.detachAsData();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+
+        for (int i = 0; i < loops; ++i) {
+            if (!skottie::Animation::Make(static_cast<const char*>(fData->data()),
+                                          fData->size())) {
+                SkDebugf("!! Could not parse animation: %s\n", fResource);
+                return;
+            }
+        }
+    }
+
+private:
+    const char*   fResource;
+    const bool    fBinary;
+    SkString      fName;
+    sk_sp<SkData> fData;
+
+    using INHERITED = Benchmark;
+};
+
+}  // namespace
+
+#define SKOTTIE_BENCH(name, res)                                                   \
+    DEF_BENCH( return new SkottieRenderBench(#name, "skottie/" res, false); )     \
+    DEF_BENCH( return new SkottieRenderBench(#name, "skottie/" res, true ); )     \
+    DEF_BENCH( return new SkottieLoadBench  (#name, "skottie/" res, false); )     \
+    DEF_BENCH( return new SkottieLoadBench  (#name, "skottie/" res, true ); )
+
+SKOTTIE_BENCH(sample2     , "skottie_sample_2.json"       )
+SKOTTIE_BENCH(search      , "skottie_sample_search.json"  )
+SKOTTIE_BENCH(textanimator, "skottie-text-animator-1.json")
+SKOTTIE_BENCH(trimpath    , "skottie-trimpath-modes.json" )
+SKOTTIE_BENCH(repeater    , "skottie-repeater.json"       )
+
+#undef SKOTTIE_BENCH
+
+#endif  // SK_ENABLE_SKOTTIE
@@ -119,6 +119,9 @@ static DEFINE_int(maxCalibrationAttempts, 3,
 static DEFINE_int(maxLoops, 1000000, "Never run a bench more times than this.");
 static DEFINE_string(clip, "0,0,1000,1000", "Clip for SKPs.");
 static DEFINE_string(scales, "1.0", "Space-separated scales for SKPs.");
+static DEFINE_string(skpThreads, "",
+                     "Space-separated thread counts for tiled, multithreaded raster playback of "
+                     "SKPs.");
 static DEFINE_string(zoom, "1.0,0",
                      "Comma-separated zoomMax,zoomPeriodMs factors for a periodic SKP zoom "
                      "function that ping-pongs between 1.0 and zoomMax.");
@@ -666,6 +669,15 @@ public:
             }
         }
 
+        for (int i = 0; i < FLAGS_skpThreads.count(); i++) {
+            if (1 != sscanf(FLAGS_skpThreads[i], "%d", &fSKPThreads.push_back()) ||
+                fSKPThreads.back() < 1) {
+                SkDebugf("Can't parse %s from --skpThreads as a thread count.\n",
+                         FLAGS_skpThreads[i]);
+                exit(1);
+            }
+        }
+
         if (2 != sscanf(FLAGS_zoom[0], "%f,%lf", &fZoomMax, &fZoomPeriodMs)) {
             SkDebugf("Can't parse %s from --zoom as a zoomMax,zoomPeriodMs.\n", FLAGS_zoom[0]);
             exit(1);
@@ -701,6 +713,20 @@ public:
         return SkPicture::MakeFromStream(stream.get());
     }
 
+    static sk_sp<SkPicture> ReadPlaybackPicture(const char* path) {
+        sk_sp<SkPicture> pic = ReadPicture(path);
+        if (pic && FLAGS_bbh) {
+            // The SKP we read off disk doesn't have a BBH.  Re-record so it grows one.
+            SkRTreeFactory factory;
+            SkPictureRecorder recorder;
+            pic->playback(recorder.beginRecording(pic->cullRect().width(),
+                                                  pic->cullRect().height(),
+                                                  &factory));
+            pic = recorder.finishRecordingAsPicture();
+        }
+        return pic;
+    }
+
     static sk_sp<SkPicture> ReadSVGPicture(const char* path) {
         sk_sp<SkData> data(SkData::MakeFromFileName(path));
         if (!data) {
@@ -810,20 +836,10 @@ public:
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
                 const SkString& path = fSKPs[fCurrentSKP++];
-                sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+                sk_sp<SkPicture> pic = ReadPlaybackPicture(path.c_str());
                 if (!pic) {
                     continue;
                 }
-
-                if (FLAGS_bbh) {
-                    // The SKP we read off disk doesn't have a BBH.  Re-record so it grows one.
-                    SkRTreeFactory factory;
-                    SkPictureRecorder recorder;
-                    pic->playback(recorder.beginRecording(pic->cullRect().width(),
-                                                          pic->cullRect().height(),
-                                                          &factory));
-                    pic = recorder.finishRecordingAsPicture();
-                }
                 SkString name = SkOSPath::Basename(path.c_str());
                 fSourceType = "skp";
                 fBenchType = "playback";
@@ -831,6 +847,21 @@ public:
                                     FLAGS_loopSKP);
             }
 
+            // And once for each thread count as SKPThreadedBenches.
+            while (fCurrentThreadedSKP < fSKPs.count() * fSKPThreads.count()) {
+                const int i = fCurrentThreadedSKP++;
+                const SkString& path = fSKPs[i / fSKPThreads.count()];
+                sk_sp<SkPicture> pic = ReadPlaybackPicture(path.c_str());
+                if (!pic) {
+                    continue;
+                }
+                SkString name = SkOSPath::Basename(path.c_str());
+                fSourceType = "skp";
+                fBenchType = "playback_threaded";
+                return new SKPThreadedBench(name.c_str(), pic.get(), fClip, fScales[fCurrentScale],
+                                            fSKPThreads[i % fSKPThreads.count()], FLAGS_loopSKP);
+            }
+
             while (fCurrentSVG < fSVGs.count()) {
                 const char* path = fSVGs[fCurrentSVG++].c_str();
                 if (sk_sp<SkPicture> pic = ReadSVGPicture(path)) {
@@ -842,6 +873,7 @@ public:
             }
 
             fCurrentSKP = 0;
+            fCurrentThreadedSKP = 0;
             fCurrentSVG = 0;
             fCurrentScale++;
         }
@@ -1100,6 +1132,7 @@ private:
     const skiagm::GMRegistry* fGMs;
     SkIRect            fClip;
     SkTArray<SkScalar> fScales;
+    SkTArray<int>      fSKPThreads;
     SkTArray<SkString> fSKPs;
     SkTArray<SkString> fSVGs;
     SkTArray<SkString> fTextBlobTraces;
@@ -1116,6 +1149,7 @@ private:
     int fCurrentDeserialPicture = 0;
     int fCurrentScale = 0;
     int fCurrentSKP = 0;
+    int fCurrentThreadedSKP = 0;
     int fCurrentSVG = 0;
     int fCurrentTextBlobTrace = 0;
     int fCurrentCodec = 0;
@@ -1324,6 +1358,7 @@ int main(int argc, char** argv) {
 
             SkTArray<SkString> keys;
             SkTArray<double> values;
+            bench->getStats(&keys, &values);
             bool gpuStatsDump = FLAGS_gpuStatsDump && Benchmark::kGPU_Backend == configs[i].backend;
             if (gpuStatsDump) {
                 // TODO cache stats
@@ -1361,12 +1396,10 @@ int main(int argc, char** argv) {
             }
             log.endArray(); // samples
             benchStream.fillCurrentMetrics(log);
-            if (gpuStatsDump) {
-                // dump to json, only SKPBench currently returns valid keys / values
-                SkASSERT(keys.count() == values.count());
-                for (int i = 0; i < keys.count(); i++) {
-                    log.appendMetric(keys[i].c_str(), values[i]);
-                }
+            // dump to json, only SKPBench currently returns valid GPU keys / values
+            SkASSERT(keys.count() == values.count());
+            for (int i = 0; i < keys.count(); i++) {
+                log.appendMetric(keys[i].c_str(), values[i]);
             }
 
             log.endObject(); // config
@@ -1434,6 +1467,9 @@ int main(int argc, char** argv) {
                     SkDebugf("%s  ", HUMANIZE(samples[i]));
                 }
                 SkDebugf("%s\n", bench->getUniqueName());
+                for (int i = 0; i < keys.count(); i++) {
+                    SkDebugf("%s: %g\n", keys[i].c_str(), values[i]);
+                }
             }
             cleanup_run(target);
             pool.drain();
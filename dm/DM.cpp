@@ -40,6 +40,7 @@
 #include "tools/trace/EventTracingPriv.h"
 #include "tools/trace/SkDebugfTracer.h"
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -60,6 +61,7 @@
 
 extern bool gSkForceRasterPipelineBlitter;
 extern bool gUseSkVMBlitter;
+extern std::atomic<bool> gSkUseGradientLUT;
 extern bool gSkVMAllowJIT;
 
 static DEFINE_string(src, "tests gm skp mskp lottie rive svg image colorImage",
@@ -95,6 +97,7 @@ static DEFINE_int(shard,  0, "Which shard do I run?");
 static DEFINE_string(mskps, "", "Directory to read mskps from, or a single mskp file.");
 static DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
 static DEFINE_bool(skvm, false, "sets gUseSkVMBlitter");
+static DEFINE_bool(gradientLUT, false, "sets gSkUseGradientLUT");
 static DEFINE_bool(jit,  true,  "sets gSkVMAllowJIT");
 
 static DEFINE_string(bisect, "",
@@ -1504,6 +1507,7 @@ int main(int argc, char** argv) {
 
     gSkForceRasterPipelineBlitter = FLAGS_forceRasterPipeline;
     gUseSkVMBlitter               = FLAGS_skvm;
+    gSkUseGradientLUT             = FLAGS_gradientLUT;
     gSkVMAllowJIT                 = FLAGS_jit;
 
     // The bots like having a verbose.log to upload, so always touch the file even if --verbose.
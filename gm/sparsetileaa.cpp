@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "gm/gm.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/utils/SkTextUtils.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkRasterClip.h"
+#include "src/core/SkScan.h"
+#include "tools/ToolUtils.h"
+
+#include <vector>
+
+// Draws each path twice, on the left with the usual anti-aliasing and on the right with the sparse
+// tile rasterizer. The two columns should be indistinguishable. Both are rasterized in software,
+// whatever the backend, and then drawn as bitmaps.
+
+static constexpr int kCell = 200;
+
+static std::vector<SkPath> make_paths() {
+    std::vector<SkPath> paths;
+
+    // Text, the classic sparse tile workload: lots of small curvy contours.
+    SkFont font(ToolUtils::create_portable_typeface(), 36);
+    const char* text = "Sparse gg@&";
+    SkPath path;
+    SkTextUtils::GetPath(text, strlen(text), SkTextEncoding::kUTF8, 4, 60, font, &path);
+    SkPath more;
+    font.setSize(12);
+    SkTextUtils::GetPath(text, strlen(text), SkTextEncoding::kUTF8, 4, 100, font, &more);
+    path.addPath(more);
+    font.setSize(90);
+    SkTextUtils::GetPath("Ag", 2, SkTextEncoding::kUTF8, 4, 185, font, &more);
+    path.addPath(more);
+    paths.push_back(path);
+
+    // A star and a ring, winding and even-odd.
+    path.reset();
+    for (int i = 0; i < 7; ++i) {
+        SkScalar a = i * 6 * SK_ScalarPI / 7;
+        SkPoint p = {100.3f + 90 * SkScalarSin(a), 100.6f - 90 * SkScalarCos(a)};
+        i ? path.lineTo(p) : path.moveTo(p);
+    }
+    path.addCircle(100, 100, 30);
+    paths.push_back(path);
+    path.setFillType(SkPathFillType::kEvenOdd);
+    paths.push_back(path);
+
+    // Curves of every kind, thin slivers, and an inverse fill.
+    path.reset();
+    path.moveTo(10, 10);
+    path.quadTo(190, 0, 150, 90);
+    path.conicTo(190, 190, 100, 180, 0.3f);
+    path.cubicTo(0, 190, 100, 60, 10, 10);
+    path.moveTo(20, 150);
+    path.lineTo(180, 152);
+    path.lineTo(20, 151);
+    path.moveTo(180, 20);
+    path.lineTo(181, 190);
+    path.lineTo(180.5f, 20);
+    paths.push_back(path);
+    path.setFillType(SkPathFillType::kInverseWinding);
+    paths.push_back(path);
+
+    return paths;
+}
+
+static SkBitmap rasterize(const SkPath& path, const SkPaint& paint,
+                          SkScan::Rasterizer rasterizer) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kCell, kCell);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+
+    SkSimpleMatrixProvider matrixProvider(SkMatrix::I());
+    SkSTArenaAlloc<2048> alloc;
+    SkBlitter* blitter = SkBlitter::Choose(bitmap.pixmap(), matrixProvider, paint, &alloc,
+                                           false, nullptr);
+    SkScan::AntiFillPath(path.view(), SkRasterClip(SkIRect::MakeWH(kCell, kCell)), blitter,
+                         rasterizer);
+    return bitmap;
+}
+
+DEF_SIMPLE_GM(sparse_tile_aa, canvas, 2 * kCell, 5 * kCell) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(0xff204080);
+
+    for (const SkPath& path : make_paths()) {
+        canvas->drawBitmap(rasterize(path, paint, SkScan::Rasterizer::kDefault), 0, 0);
+        canvas->drawBitmap(rasterize(path, paint, SkScan::Rasterizer::kSparseTile), kCell, 0);
+        canvas->translate(0, kCell);
+    }
+}
@@ -131,6 +131,21 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  These functions get the memory usage of the image filter cache, which holds the results of
+     *  recently evaluated image filters, and get/set its memory usage limit.
+     */
+    static size_t GetImageFilterCacheTotalBytesUsed();
+    static size_t GetImageFilterCacheTotalByteLimit();
+    static size_t SetImageFilterCacheTotalByteLimit(size_t newLimit);
+
+    /**
+     *  Purges the least recently used image filter results until the image filter cache uses at
+     *  most 'bytes'. Unlike PurgeAllCaches(), this keeps the most recently used results, so it can
+     *  be called in response to memory pressure without throwing away everything.
+     */
+    static void PurgeImageFilterCacheToBytes(size_t bytes);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
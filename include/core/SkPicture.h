@@ -236,6 +236,7 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkLazyRecordPicture;
     friend class SkPicturePriv;
     template <typename> friend class SkMiniPicture;
 
@@ -31,6 +31,12 @@ public:
     SkPictureRecorder();
     ~SkPictureRecorder();
 
+    enum RecordFlags {
+        // Share one copy of each distinct path and image, however many objects they were drawn
+        // from.  This hashes the contents of every path and image the first time it is drawn.
+        kDeduplicateContent_RecordFlag = 1 << 0,
+    };
+
     enum FinishFlags {
     };
 
@@ -41,13 +47,15 @@ public:
         @param recordFlags optional flags that control recording.
         @return the canvas.
     */
-    SkCanvas* beginRecording(const SkRect& bounds, sk_sp<SkBBoxHierarchy> bbh);
+    SkCanvas* beginRecording(const SkRect& bounds, sk_sp<SkBBoxHierarchy> bbh,
+                             uint32_t recordFlags = 0);
 
-    SkCanvas* beginRecording(const SkRect& bounds, SkBBHFactory* bbhFactory = nullptr);
+    SkCanvas* beginRecording(const SkRect& bounds, SkBBHFactory* bbhFactory = nullptr,
+                             uint32_t recordFlags = 0);
 
     SkCanvas* beginRecording(SkScalar width, SkScalar height,
-                             SkBBHFactory* bbhFactory = nullptr) {
-        return this->beginRecording(SkRect::MakeWH(width, height), bbhFactory);
+                             SkBBHFactory* bbhFactory = nullptr, uint32_t recordFlags = 0) {
+        return this->beginRecording(SkRect::MakeWH(width, height), bbhFactory, recordFlags);
     }
 
     /** Returns the recording canvas if one is active, or NULL if recording is
@@ -135,6 +135,15 @@ private:
                     bool usesSampleCoords,
                     bool allowColorFilter);
 
+    // Make() without the cache. Returns the inline threshold the effect was compiled with.
+    static EffectResult MakeUncached(SkString sksl, int* inlineThreshold);
+
+    // See SkRuntimeEffectPriv.h.
+    friend sk_sp<SkData> SkRuntimeEffect_Serialize(const SkRuntimeEffect&);
+    friend EffectResult SkRuntimeEffect_MakeFromBlob(sk_sp<SkData> blob);
+    sk_sp<SkData> serialize() const;
+    static EffectResult MakeFromBlob(sk_sp<SkData> blob);
+
     uint32_t hash() const { return fHash; }
     bool usesSampleCoords() const { return fUsesSampleCoords; }
 
@@ -161,7 +170,10 @@ private:
     uint32_t fHash;
     SkString fSkSL;
 
+    // Null for effects made from a blob, which have fByteCode (as flattened by
+    // SkSL::ByteCode::flatten) instead.
     std::unique_ptr<SkSL::Program> fBaseProgram;
+    sk_sp<SkData> fByteCode;
     std::vector<Uniform> fUniforms;
     std::vector<SkString> fChildren;
     std::vector<SkSL::SampleUsage> fSampleUsages;
@@ -22,6 +22,7 @@
 
 class SkCanvas;
 struct SkRect;
+class SkRegion;
 class SkStream;
 
 namespace skjson { class ObjectValue; }
@@ -72,6 +73,9 @@ public:
                                          // frames are only resolved when needed, at seek() time.
             kPreferEmbeddedFonts = 0x02, // Attempt to use the embedded fonts (glyph paths,
                                          // normally used as fallback) over native Skia typefaces.
+            kPrecomputeEasing    = 0x04, // Sample cubic keyframe easing curves into lookup tables
+                                         // at load time, for faster seek() (at the cost of a
+                                         // small approximation error).
         };
 
         explicit Builder(uint32_t flags = 0);
@@ -181,6 +185,25 @@ public:
     void render(SkCanvas* canvas, const SkRect* dst = nullptr) const;
     void render(SkCanvas* canvas, const SkRect* dst, RenderFlags) const;
 
+    /**
+     * Partial redraw: repaints only the areas damaged since the previous frame, as accumulated
+     * in |damage| by the last seek*() call.
+     *
+     * The canvas is expected to retain the previously rendered frame (e.g. a persistent raster
+     * surface), drawn using the same canvas matrix, |dst| and |flags|.  Damaged areas are cleared
+     * to transparent and repainted, everything else is left untouched.  Anti-aliased edges that
+     * cross the damaged area's bounds may differ from a full redraw by one rounding unit.
+     *
+     * @param canvas        destination canvas, holding the previous frame
+     * @param damage        invalidation controller passed to the last seek*() call
+     * @param dst           optional destination rect
+     * @param flags         optional RenderFlags
+     * @param deviceDamage  optional output: the device-space area repainted
+     */
+    void renderDamage(SkCanvas* canvas, const sksg::InvalidationController& damage,
+                      const SkRect* dst = nullptr, RenderFlags flags = 0,
+                      SkRegion* deviceDamage = nullptr) const;
+
     /**
      * [Deprecated: use one of the other versions.]
      *
@@ -139,7 +139,10 @@ sk_sp<sksg::RenderNode> CompositionBuilder::build(const AnimationBuilder& abuild
     std::reverse(layers.begin(), layers.end());
     layers.shrink_to_fit();
 
-    return sksg::Group::Make(std::move(layers));
+    auto group = sksg::Group::Make(std::move(layers));
+    group->setCacheRenderList(true);
+
+    return std::move(group);
 }
 
 } // namespace internal
@@ -13,6 +13,7 @@
 #include "include/core/SkImage.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkStream.h"
 #include "include/private/SkTArray.h"
 #include "include/private/SkTo.h"
@@ -488,6 +489,52 @@ void Animation::render(SkCanvas* canvas, const SkRect* dstR, RenderFlags renderF
     fScene->render(canvas);
 }
 
+void Animation::renderDamage(SkCanvas* canvas, const sksg::InvalidationController& damage,
+                             const SkRect* dstR, RenderFlags renderFlags,
+                             SkRegion* deviceDamage) const {
+    TRACE_EVENT0("skottie", TRACE_FUNC);
+
+    SkRegion damage_rgn;
+
+    if (fScene) {
+        // Invalidation rects are in animation coordinates: map them to device space using the
+        // same transform as render().
+        const SkRect srcR = SkRect::MakeSize(this->size());
+        auto ctm = canvas->getTotalMatrix();
+        if (dstR) {
+            ctm.preConcat(SkMatrix::MakeRectToRect(srcR, *dstR, SkMatrix::kCenter_ScaleToFit));
+        }
+
+        const auto clip_to_bounds = !(renderFlags & RenderFlag::kDisableTopLevelClipping);
+        const auto dev_clip       = canvas->getDeviceClipBounds();
+
+        for (SkRect r : damage) {
+            if (clip_to_bounds && !r.intersect(srcR)) {
+                continue;
+            }
+
+            auto dev_r = ctm.mapRect(r).roundOut();
+            if (dev_r.intersect(dev_clip)) {
+                damage_rgn.op(dev_r, SkRegion::kUnion_Op);
+            }
+        }
+    }
+
+    if (!damage_rgn.isEmpty()) {
+        // The damage region is pixel aligned, so repainting it with the full scene matches a
+        // full redraw, except that anti-aliased edges crossing the damage bounds can differ by
+        // a rounding unit: the AA scan converters clip edges to the clip before walking them.
+        SkAutoCanvasRestore restore(canvas, true);
+        canvas->clipRegion(damage_rgn);
+        canvas->clear(SK_ColorTRANSPARENT);
+        this->render(canvas, dstR, renderFlags);
+    }
+
+    if (deviceDamage) {
+        *deviceDamage = std::move(damage_rgn);
+    }
+}
+
 void Animation::seekFrame(double t, sksg::InvalidationController* ic) {
     TRACE_EVENT0("skottie", TRACE_FUNC);
 
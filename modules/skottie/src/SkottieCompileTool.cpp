@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkStream.h"
+#include "modules/skottie/include/Skottie.h"
+#include "src/utils/SkJSON.h"
+#include "tools/flags/CommandLineFlags.h"
+
+// Converts a Lottie .json animation into the precompiled (binary) skjson form, which
+// skottie::Animation::Builder accepts interchangeably with the JSON text.
+
+static DEFINE_string2(input , i, nullptr, "Input .json file.");
+static DEFINE_string2(output, o, nullptr, "Output file.");
+
+int main(int argc, char** argv) {
+    CommandLineFlags::Parse(argc, argv);
+    SkAutoGraphics ag;
+
+    if (FLAGS_input.isEmpty() || FLAGS_output.isEmpty()) {
+        SkDebugf("Missing required 'input' and 'output' args.\n");
+        return 1;
+    }
+
+    auto data = SkData::MakeFromFileName(FLAGS_input[0]);
+    if (!data) {
+        SkDebugf("Could not load %s.\n", FLAGS_input[0]);
+        return 1;
+    }
+
+    const skjson::DOM dom(static_cast<const char*>(data->data()), data->size());
+    if (!dom.root().is<skjson::ObjectValue>()) {
+        SkDebugf("Could not parse %s.\n", FLAGS_input[0]);
+        return 1;
+    }
+
+    SkDynamicMemoryWStream bin_stream;
+    dom.writeBinary(&bin_stream);
+    const auto bin = bin_stream.detachAsData();
+
+    // Make sure the result is a valid animation before emitting.
+    if (!skottie::Animation::Make(static_cast<const char*>(bin->data()), bin->size())) {
+        SkDebugf("Invalid animation: '%s'.\n", FLAGS_input[0]);
+        return 1;
+    }
+
+    SkFILEWStream out(FLAGS_output[0]);
+    if (!out.isValid() || !out.write(bin->data(), bin->size())) {
+        SkDebugf("Could not write %s.\n", FLAGS_output[0]);
+        return 1;
+    }
+
+    SkDebugf("%s: %zu -> %zu bytes.\n", FLAGS_output[0], data->size(), bin->size());
+
+    return 0;
+}
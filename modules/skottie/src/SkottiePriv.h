@@ -93,6 +93,10 @@ public:
 
     bool hasNontrivialBlending() const { return fHasNontrivialBlending; }
 
+    bool precomputeEasing() const {
+        return fFlags & Animation::Builder::Flags::kPrecomputeEasing;
+    }
+
     class AutoScope final {
     public:
         explicit AutoScope(const AnimationBuilder* builder) : AutoScope(builder, AnimatorScope()) {}
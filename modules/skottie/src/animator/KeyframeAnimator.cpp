@@ -8,11 +8,33 @@
 #include "modules/skottie/src/animator/KeyframeAnimator.h"
 
 #include "modules/skottie/src/SkottieJson.h"
+#include "modules/skottie/src/SkottiePriv.h"
 
 #define DUMP_KF_RECORDS 0
 
 namespace skottie::internal {
 
+CubicEasing::CubicEasing(const SkPoint& c0, const SkPoint& c1, bool precompute)
+    : fMap(c0, c1) {
+    if (precompute) {
+        fLUT = std::make_unique<float[]>(kLUTSegments + 1);
+        for (int i = 0; i <= kLUTSegments; ++i) {
+            fLUT[i] = fMap.computeYFromX(static_cast<float>(i) / kLUTSegments);
+        }
+    }
+}
+
+float CubicEasing::operator()(float x) const {
+    if (!fLUT) {
+        return fMap.computeYFromX(x);
+    }
+
+    const auto fx = SkTPin(x, 0.0f, 1.0f) * kLUTSegments;
+    const auto  i = std::min(static_cast<int>(fx), kLUTSegments - 1);
+
+    return Lerp(fLUT[i], fLUT[i + 1], fx - i);
+}
+
 KeyframeAnimator::~KeyframeAnimator() = default;
 
 KeyframeAnimator::LERPInfo KeyframeAnimator::getLERPInfo(float t) const {
@@ -53,6 +75,21 @@ KeyframeAnimator::KFSegment KeyframeAnimator::find_segment(float t) const {
     auto kf0 = &fKFs.front(),
          kf1 = &fKFs.back();
 
+    // Narrow the search range based on the current segment.
+    if (fCurrentSegment.kf0) {
+        if (t >= fCurrentSegment.kf1->t) {
+            kf0 = fCurrentSegment.kf1;
+
+            // Monotonic playback typically advances to the next segment: O(1) lookup.
+            if (kf0 + 1 != kf1 && t < kf0[1].t) {
+                kf1 = kf0 + 1;
+            }
+        } else {
+            SkASSERT(t < fCurrentSegment.kf0->t);
+            kf1 = fCurrentSegment.kf0;
+        }
+    }
+
     // Binary-search, until we reduce to sequential keyframes.
     while (kf0 + 1 != kf1) {
         SkASSERT(kf0 < kf1);
@@ -80,7 +117,7 @@ float KeyframeAnimator::compute_weight(const KFSegment &seg, float t) const {
     if (seg.kf0->mapping >= Keyframe::kCubicIndexOffset) {
         SkASSERT(seg.kf0->v != seg.kf1->v);
         const auto mapper_index = SkToSizeT(seg.kf0->mapping - Keyframe::kCubicIndexOffset);
-        w = fCMs[mapper_index].computeYFromX(w);
+        w = fCMs[mapper_index](w);
     }
 
     return w;
@@ -172,7 +209,7 @@ bool KeyframeAnimatorBuilder::parseKeyframes(const AnimationBuilder& abuilder,
             }
         }
 
-        fKFs.push_back({t, v, this->parseMapping(*jkf)});
+        fKFs.push_back({t, v, this->parseMapping(abuilder, *jkf)});
 
         constant_value = constant_value && (v == fKFs.front().v);
     }
@@ -196,7 +233,8 @@ bool KeyframeAnimatorBuilder::parseKeyframes(const AnimationBuilder& abuilder,
     return true;
 }
 
-uint32_t KeyframeAnimatorBuilder::parseMapping(const skjson::ObjectValue& jkf) {
+uint32_t KeyframeAnimatorBuilder::parseMapping(const AnimationBuilder& abuilder,
+                                               const skjson::ObjectValue& jkf) {
     if (ParseDefault(jkf["h"], false)) {
         return Keyframe::kConstantMapping;
     }
@@ -210,7 +248,7 @@ uint32_t KeyframeAnimatorBuilder::parseMapping(const skjson::ObjectValue& jkf) {
 
     // De-dupe sequential cubic mappers.
     if (c0 != prev_c0 || c1 != prev_c1 || fCMs.empty()) {
-        fCMs.emplace_back(c0, c1);
+        fCMs.emplace_back(c0, c1, abuilder.precomputeEasing());
         prev_c0 = c0;
         prev_c1 = c1;
     }
@@ -13,6 +13,7 @@
 #include "include/private/SkNoncopyable.h"
 #include "modules/skottie/src/animator/Animator.h"
 
+#include <memory>
 #include <vector>
 
 namespace skjson {
@@ -53,6 +54,24 @@ struct Keyframe {
     static constexpr uint32_t kCubicIndexOffset = 2;
 };
 
+// Cubic Bezier keyframe easing.
+//
+// When requested (Animation::Builder::kPrecomputeEasing), the easing curve is sampled into a
+// lookup table at build time, and evaluated via linear interpolation at seek time.  This trades
+// a small approximation error for skipping the cubic solver on every seek.
+class CubicEasing {
+public:
+    CubicEasing(const SkPoint& c0, const SkPoint& c1, bool precompute);
+
+    float operator()(float x) const;
+
+private:
+    static constexpr int kLUTSegments = 64;
+
+    SkCubicMap               fMap;
+    std::unique_ptr<float[]> fLUT; // Optional, kLUTSegments + 1 samples.
+};
+
 class KeyframeAnimator : public Animator {
 public:
     ~KeyframeAnimator() override;
@@ -65,7 +84,7 @@ public:
     }
 
 protected:
-    KeyframeAnimator(std::vector<Keyframe> kfs, std::vector<SkCubicMap> cms)
+    KeyframeAnimator(std::vector<Keyframe> kfs, std::vector<CubicEasing> cms)
         : fKFs(std::move(kfs))
         , fCMs(std::move(cms)) {}
 
@@ -93,15 +112,15 @@ private:
         }
     };
 
-    // Find the KFSegment containing |t|.
+    // Find the KFSegment containing |t|, starting from the current (cached) segment.
     KFSegment find_segment(float t) const;
 
     // Given a |t| and a containing KFSegment, compute the local interpolation weight.
     float compute_weight(const KFSegment& seg, float t) const;
 
-    const std::vector<Keyframe>   fKFs; // Keyframe records, one per AE/Lottie keyframe.
-    const std::vector<SkCubicMap> fCMs; // Optional cubic mappers (Bezier interpolation).
-    mutable KFSegment             fCurrentSegment = { nullptr, nullptr }; // Cached segment.
+    const std::vector<Keyframe>    fKFs; // Keyframe records, one per AE/Lottie keyframe.
+    const std::vector<CubicEasing> fCMs; // Optional cubic mappers (Bezier interpolation).
+    mutable KFSegment              fCurrentSegment = { nullptr, nullptr }; // Cached segment.
 };
 
 class KeyframeAnimatorBuilder : public SkNoncopyable {
@@ -120,11 +139,11 @@ protected:
 
     bool parseKeyframes(const AnimationBuilder&, const skjson::ArrayValue&);
 
-    std::vector<Keyframe>   fKFs; // Keyframe records, one per AE/Lottie keyframe.
-    std::vector<SkCubicMap> fCMs; // Optional cubic mappers (Bezier interpolation).
+    std::vector<Keyframe>    fKFs; // Keyframe records, one per AE/Lottie keyframe.
+    std::vector<CubicEasing> fCMs; // Optional cubic mappers (Bezier interpolation).
 
 private:
-    uint32_t parseMapping(const skjson::ObjectValue&);
+    uint32_t parseMapping(const AnimationBuilder&, const skjson::ObjectValue&);
 
     // Track previous cubic map parameters (for deduping).
     SkPoint prev_c0 = { 0, 0 },
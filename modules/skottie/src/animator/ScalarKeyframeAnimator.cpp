@@ -49,7 +49,7 @@ public:
 
 private:
     ScalarKeyframeAnimator(std::vector<Keyframe> kfs,
-                           std::vector<SkCubicMap> cms,
+                           std::vector<CubicEasing> cms,
                            ScalarValue* target_value)
         : INHERITED(std::move(kfs), std::move(cms))
         , fTarget(target_value) {}
@@ -66,7 +66,7 @@ public:
     };
 
 private:
-    TextKeyframeAnimator(std::vector<Keyframe> kfs, std::vector<SkCubicMap> cms,
+    TextKeyframeAnimator(std::vector<Keyframe> kfs, std::vector<CubicEasing> cms,
                          std::vector<TextValue> vs, TextValue* target_value)
         : INHERITED(std::move(kfs), std::move(cms))
         , fValues(std::move(vs))
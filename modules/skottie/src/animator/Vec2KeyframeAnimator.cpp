@@ -133,7 +133,7 @@ public:
     };
 
 private:
-    Vec2KeyframeAnimator(std::vector<Keyframe> kfs, std::vector<SkCubicMap> cms,
+    Vec2KeyframeAnimator(std::vector<Keyframe> kfs, std::vector<CubicEasing> cms,
                          std::vector<SpatialValue> vs, Vec2Value* vec_target, float* rot_target)
         : INHERITED(std::move(kfs), std::move(cms))
         , fValues(std::move(vs))
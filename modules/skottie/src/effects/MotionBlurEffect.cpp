@@ -191,6 +191,12 @@ void MotionBlurEffect::renderToRaster8888Pow2Samples(SkCanvas* canvas,
 }
 
 void MotionBlurEffect::onRender(SkCanvas* canvas, const RenderContext* ctx) const {
+    // Sampling mutates the subtree, and the raster path accesses the destination pixels:
+    // this cannot be recorded.
+    if (ctx) {
+        ctx->requireDirectRendering();
+    }
+
     if (!fVisibleSampleCount) {
         return;
     }
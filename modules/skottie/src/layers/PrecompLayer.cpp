@@ -117,6 +117,11 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachExternalPrecompLayer(
         }
 
         void onRender(SkCanvas* canvas, const RenderContext* ctx) const override {
+            // External content may depend on the destination canvas.
+            if (ctx) {
+                ctx->requireDirectRendering();
+            }
+
             // Commit all pending effects via a layer if needed,
             // since we don't have knowledge of the external content.
             const auto local_scope =
@@ -323,7 +323,9 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachShape(const skjson::ArrayValue*
         draws.shrink_to_fit();
 
         // We need a group to dispatch multiple draws.
-        shape_wrapper = sksg::Group::Make(std::move(draws));
+        auto group = sksg::Group::Make(std::move(draws));
+        group->setCacheRenderList(true);
+        shape_wrapper = std::move(group);
     }
 
     sk_sp<sksg::Transform> shape_transform;
@@ -22,9 +22,9 @@ namespace  {
 template <typename T>
 class MockProperty final : public AnimatablePropertyContainer {
 public:
-    explicit MockProperty(const char* jprop) {
+    explicit MockProperty(const char* jprop, uint32_t flags = 0) {
         AnimationBuilder abuilder(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-                                  {100, 100}, 10, 1, 0);
+                                  {100, 100}, 10, 1, flags);
         skjson::DOM json_dom(jprop, strlen(jprop));
 
         fDidBind = this->bind(abuilder, json_dom.root(), &fValue);
@@ -134,4 +134,37 @@ DEF_TEST(Skottie_Keyframe, reporter) {
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(prop(3  ), 4));
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(prop(4  ), 4));
     }
+    {
+        // Cubic easing, exact vs. precomputed.
+        static constexpr char json[] = R"({
+                                         "a": 1,
+                                         "k": [
+                                           { "t":  0, "s": 0, "o": [0.1, 0.9], "i": [0.6, 0.1] },
+                                           { "t":  1, "s": 4, "o": [0.4, 0.0], "i": [0.2, 1.0] },
+                                           { "t":  2, "s": 1, "o": [0.0, 0.0], "i": [0.0, 1.0] },
+                                           { "t":  3, "s": 2 }
+                                         ]
+                                       })";
+        MockProperty<ScalarValue> exact(json),
+                                  lut(json, Animation::Builder::kPrecomputeEasing);
+        REPORTER_ASSERT(reporter, exact);
+        REPORTER_ASSERT(reporter, lut);
+
+        // Forward, backward and random access all hit the same values.
+        for (float t = -0.5f; t <= 3.5f; t += 0.01f) {
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(exact(t), lut(t), 0.05f));
+        }
+        for (float t = 3.5f; t >= -0.5f; t -= 0.03f) {
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(exact(t), lut(t), 0.05f));
+        }
+        for (float t : { 2.5f, 0.5f, 1.5f, 0.f, 3.f, 1.f, 2.f }) {
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(exact(t), lut(t), 0.05f));
+        }
+
+        // Keyframe boundaries are exact.
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(lut(0), 0));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(lut(1), 4));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(lut(2), 1));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(lut(3), 2));
+    }
 }
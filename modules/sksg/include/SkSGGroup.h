@@ -10,8 +10,12 @@
 
 #include "modules/sksg/include/SkSGRenderNode.h"
 
+#include "include/core/SkM44.h"
+
 #include <vector>
 
+class SkPicture;
+
 namespace sksg {
 
 /**
@@ -34,6 +38,10 @@ public:
     bool  empty() const { return fChildren.empty(); }
     void  clear();
 
+    // Opt-in render list caching: once the subtree is stable, it is recorded into a flat
+    // render list and replayed on subsequent renders, until invalidated (see onRender).
+    void setCacheRenderList(bool cache) { fCacheRenderList = cache; }
+
 protected:
     Group();
     explicit Group(std::vector<sk_sp<RenderNode>>);
@@ -45,8 +53,19 @@ protected:
     SkRect onRevalidate(InvalidationController*, const SkMatrix&) override;
 
 private:
+    void renderChildren(SkCanvas*, const RenderContext*) const;
+
     std::vector<sk_sp<RenderNode>> fChildren;
     bool                           fRequiresIsolation = true;
+    bool                           fCacheRenderList   = false;
+
+    // Render list for the group subtree, recorded once the subtree is stable
+    // (see onRender).  Discarded on revalidation.
+    mutable sk_sp<SkPicture>       fRenderList;
+    mutable RenderContext          fRenderListCtx;
+    mutable SkM44                  fRenderListCTM;
+    mutable bool                   fHasRenderListCtx     = false,
+                                   fRequiresDirectRender = false;
 
     using INHERITED = RenderNode;
 };
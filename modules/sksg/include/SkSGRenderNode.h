@@ -58,9 +58,16 @@ protected:
         float                fOpacity   = 1;
         SkBlendMode          fBlendMode = SkBlendMode::kSrcOver;
 
+        // Set while a caching group renders its subtree directly (see Group::onRender).
+        bool*                fDirectRenderProbe = nullptr;
+
         // Returns true if the paint overrides require a layer when applied to non-atomic draws.
         bool requiresIsolation() const;
 
+        // Must be called by nodes which cannot be recorded into a group render list, e.g.
+        // because they access the destination pixels or depend on the canvas type.
+        void requireDirectRendering() const;
+
         void modulatePaint(const SkMatrix& ctm, SkPaint*, bool is_layer_paint = false) const;
     };
 
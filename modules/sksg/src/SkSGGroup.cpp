@@ -8,6 +8,7 @@
 #include "modules/sksg/include/SkSGGroup.h"
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
 
 #include <algorithm>
 
@@ -59,6 +60,77 @@ void Group::removeChild(const sk_sp<RenderNode>& node) {
 }
 
 void Group::onRender(SkCanvas* canvas, const RenderContext* ctx) const {
+    if (!fCacheRenderList) {
+        this->renderChildren(canvas, ctx);
+        return;
+    }
+
+    if (fRequiresDirectRender) {
+        // Some descendants cannot be recorded: always render directly, and let caching
+        // ancestors know.
+        if (ctx) {
+            ctx->requireDirectRendering();
+        }
+        this->renderChildren(canvas, ctx);
+        return;
+    }
+
+    // The render list is recorded under the actual CTM, for nodes deriving state from it.
+    const auto ctm = canvas->getLocalToDevice();
+
+    RenderContext render_ctx = ctx ? *ctx : RenderContext();
+    render_ctx.fDirectRenderProbe = nullptr;
+
+    const auto same_ctx = fHasRenderListCtx &&
+                          ctm                     == fRenderListCTM              &&
+                          render_ctx.fColorFilter == fRenderListCtx.fColorFilter &&
+                          render_ctx.fShader      == fRenderListCtx.fShader      &&
+                          render_ctx.fMaskShader  == fRenderListCtx.fMaskShader  &&
+                          render_ctx.fShaderCTM   == fRenderListCtx.fShaderCTM   &&
+                          render_ctx.fMaskCTM     == fRenderListCtx.fMaskCTM     &&
+                          render_ctx.fOpacity     == fRenderListCtx.fOpacity     &&
+                          render_ctx.fBlendMode   == fRenderListCtx.fBlendMode;
+
+    if (!same_ctx) {
+        // First render after revalidation, or the context changed: traverse the subtree
+        // directly, probing for nodes which cannot be recorded, and track the context to
+        // detect subsequent stable renders.
+        fRenderList.reset();
+        fRenderListCtx    = render_ctx;
+        fRenderListCTM    = ctm;
+        fHasRenderListCtx = true;
+
+        bool requires_direct_render = false;
+        render_ctx.fDirectRenderProbe = &requires_direct_render;
+        this->renderChildren(canvas, &render_ctx);
+
+        if (requires_direct_render) {
+            fRequiresDirectRender = true;
+            fHasRenderListCtx     = false;
+            if (ctx) {
+                ctx->requireDirectRendering();
+            }
+        }
+        return;
+    }
+
+    if (!fRenderList) {
+        // The subtree is stable: compile it to a flat render list, replayed on subsequent
+        // renders until invalidated.
+        SkPictureRecorder recorder;
+        auto* recording_canvas =
+                recorder.beginRecording(canvas->getTotalMatrix().mapRect(this->bounds()));
+        recording_canvas->concat(ctm);
+        this->renderChildren(recording_canvas, &render_ctx);
+        fRenderList = recorder.finishRecordingAsPicture();
+    }
+
+    SkAutoCanvasRestore acr(canvas, true);
+    canvas->resetMatrix();
+    canvas->drawPicture(fRenderList);
+}
+
+void Group::renderChildren(SkCanvas* canvas, const RenderContext* ctx) const {
     const auto local_ctx = ScopedRenderContext(canvas, ctx).setIsolation(this->bounds(),
                                                                          canvas->getTotalMatrix(),
                                                                          fRequiresIsolation);
@@ -84,6 +156,10 @@ SkRect Group::onRevalidate(InvalidationController* ic, const SkMatrix& ctm) {
     SkRect bounds = SkRect::MakeEmpty();
     fRequiresIsolation = false;
 
+    fRenderList.reset();
+    fHasRenderListCtx     = false;
+    fRequiresDirectRender = false;
+
     for (size_t i = 0; i < fChildren.size(); ++i) {
         const auto child_bounds = fChildren[i]->revalidate(ic, ctm);
 
@@ -53,6 +53,7 @@ void MaskEffect::onRender(SkCanvas* canvas, const RenderContext* ctx) const {
         }
 
         RenderContext mask_render_context;
+        mask_render_context.fDirectRenderProbe = ctx ? ctx->fDirectRenderProbe : nullptr;
         if (is_luma(fMaskMode)) {
             mask_render_context.fColorFilter = SkLumaColorFilter::Make();
         }
@@ -91,6 +91,12 @@ bool RenderNode::RenderContext::requiresIsolation() const {
         || fBlendMode != SkBlendMode::kSrcOver;
 }
 
+void RenderNode::RenderContext::requireDirectRendering() const {
+    if (fDirectRenderProbe) {
+        *fDirectRenderProbe = true;
+    }
+}
+
 void RenderNode::RenderContext::modulatePaint(const SkMatrix& ctm, SkPaint* paint,
                                               bool is_layer_paint) const {
     paint->setAlpha(ScaleAlpha(paint->getAlpha(), fOpacity));
@@ -215,7 +221,10 @@ RenderNode::ScopedRenderContext::setFilterIsolation(const SkRect& bounds, const
         SkASSERT(!layer_paint.getImageFilter());
         layer_paint.setImageFilter(std::move(filter));
         fCanvas->saveLayer(bounds, &layer_paint);
+
+        auto* probe = fCtx.fDirectRenderProbe;
         fCtx = RenderContext();
+        fCtx.fDirectRenderProbe = probe;
     }
 
     return std::move(*this);
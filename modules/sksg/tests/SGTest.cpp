@@ -9,14 +9,19 @@
 
 #if !defined(SK_BUILD_FOR_GOOGLE3)
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSurface.h"
 #include "include/private/SkTo.h"
 #include "modules/sksg/include/SkSGDraw.h"
 #include "modules/sksg/include/SkSGGroup.h"
 #include "modules/sksg/include/SkSGInvalidationController.h"
+#include "modules/sksg/include/SkSGOpacityEffect.h"
 #include "modules/sksg/include/SkSGPaint.h"
 #include "modules/sksg/include/SkSGRect.h"
 #include "modules/sksg/include/SkSGRenderEffect.h"
+#include "modules/sksg/include/SkSGScene.h"
 #include "modules/sksg/include/SkSGTransform.h"
 #include "src/core/SkRectPriv.h"
 
@@ -355,4 +360,49 @@ DEF_TEST(SGInvalidation, reporter) {
     inval_group_remove(reporter);
 }
 
+DEF_TEST(SGRenderList, reporter) {
+    auto color1 = sksg::Color::Make(SK_ColorRED),
+         color2 = sksg::Color::Make(SK_ColorBLUE);
+    auto grp    = sksg::Group::Make({
+                      sksg::Draw::Make(sksg::Rect::Make(SkRect::MakeLTRB( 0, 0, 10, 10)), color1),
+                      sksg::Draw::Make(sksg::Rect::Make(SkRect::MakeLTRB(10, 0, 20, 10)), color2),
+                  });
+    grp->setCacheRenderList(true);
+    auto opacity = sksg::OpacityEffect::Make(grp);
+    auto scene   = sksg::Scene::Make(opacity);
+
+    auto surface = SkSurface::MakeRasterN32Premul(20, 10);
+
+    const auto check = [&](SkColor c1, SkColor c2) {
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        scene->render(surface->getCanvas());
+
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::MakeN32Premul(20, 10));
+        REPORTER_ASSERT(reporter, surface->readPixels(bm, 0, 0));
+        REPORTER_ASSERT(reporter, bm.getColor( 5, 5) == c1);
+        REPORTER_ASSERT(reporter, bm.getColor(15, 5) == c2);
+    };
+
+    // Direct render, followed by render list compilation and replays.
+    for (int i = 0; i < 3; ++i) {
+        check(SK_ColorRED, SK_ColorBLUE);
+    }
+
+    // Invalidated subtrees are rebuilt.
+    color1->setColor(SK_ColorGREEN);
+    for (int i = 0; i < 3; ++i) {
+        scene->revalidate();
+        check(SK_ColorGREEN, SK_ColorBLUE);
+    }
+
+    // Ancestor render context changes are reflected without subtree invalidation.
+    opacity->setOpacity(0);
+    scene->revalidate();
+    check(SK_ColorTRANSPARENT, SK_ColorTRANSPARENT);
+    opacity->setOpacity(1);
+    scene->revalidate();
+    check(SK_ColorGREEN, SK_ColorBLUE);
+}
+
 #endif // !defined(SK_BUILD_FOR_GOOGLE3)
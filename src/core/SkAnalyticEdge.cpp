@@ -335,9 +335,15 @@ bool SkAnalyticEdge::update(SkFixed last_y, bool sortY) {
 }
 
 bool SkAnalyticQuadraticEdge::setQuadratic(const SkPoint pts[3]) {
+    SkFDot6 xy[6];
+    SkEdge::ConvertToFDot6(pts, 3, kDefaultAccuracy, xy);
+    return this->setQuadratic(xy);
+}
+
+bool SkAnalyticQuadraticEdge::setQuadratic(const SkFDot6 xy[6]) {
     fRiteE = nullptr;
 
-    if (!fQEdge.setQuadraticWithoutUpdate(pts, kDefaultAccuracy)) {
+    if (!fQEdge.setQuadraticWithoutUpdate(xy, kDefaultAccuracy)) {
         return false;
     }
     fQEdge.fQx >>= kDefaultAccuracy;
@@ -424,9 +430,15 @@ bool SkAnalyticQuadraticEdge::updateQuadratic() {
 }
 
 bool SkAnalyticCubicEdge::setCubic(const SkPoint pts[4], bool sortY) {
+    SkFDot6 xy[8];
+    SkEdge::ConvertToFDot6(pts, 4, kDefaultAccuracy, xy);
+    return this->setCubic(xy, sortY);
+}
+
+bool SkAnalyticCubicEdge::setCubic(const SkFDot6 xy[8], bool sortY) {
     fRiteE = nullptr;
 
-    if (!fCEdge.setCubicWithoutUpdate(pts, kDefaultAccuracy, sortY)) {
+    if (!fCEdge.setCubicWithoutUpdate(xy, kDefaultAccuracy, sortY)) {
         return false;
     }
 
@@ -111,6 +111,8 @@ struct SkAnalyticQuadraticEdge : public SkAnalyticEdge {
     SkFixed fSnappedX, fSnappedY;
 
     bool setQuadratic(const SkPoint pts[3]);
+    // As above, from points converted by SkEdge::ConvertToFDot6() with kDefaultAccuracy.
+    bool setQuadratic(const SkFDot6 xy[6]);
     bool updateQuadratic();
     inline void keepContinuous() {
         // We use fX as the starting x to ensure the continuouty.
@@ -128,6 +130,8 @@ struct SkAnalyticCubicEdge : public SkAnalyticEdge {
     SkFixed fSnappedY; // to make sure that y is increasing with smooth jump and snapping
 
     bool setCubic(const SkPoint pts[4], bool sortY = true);
+    // As above, from points converted by SkEdge::ConvertToFDot6() with kDefaultAccuracy.
+    bool setCubic(const SkFDot6 xy[8], bool sortY = true);
     bool updateCubic(bool sortY = true);
     inline void keepContinuous() {
         SkASSERT(SkAbs32(fX - SkFixedMul(fDX, fY - SnapY(fCEdge.fCy)) - fCEdge.fCx) < SK_Fixed1);
@@ -39,6 +39,24 @@ void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
                  callback);
 }
 
+void SkBigPicture::playbackIntersecting(SkCanvas* canvas, const SkRect& query) const {
+    SkASSERT(canvas);
+
+    if (!fBBH || query.contains(this->cullRect())) {
+        this->playback(canvas, nullptr);
+        return;
+    }
+
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+    std::vector<int> ops;
+    fBBH->search(query, &ops);
+
+    SkRecords::Draw draw(canvas, this->drawablePicts(), nullptr, this->drawableCount());
+    for (int op : ops) {
+        fRecord->visit(op, draw);
+    }
+}
+
 void SkBigPicture::partialPlayback(SkCanvas* canvas,
                                    int start,
                                    int stop,
@@ -48,6 +48,11 @@ public:
     size_t approximateBytesUsed() const override;
     const SkBigPicture* asSkBigPicture() const override { return this; }
 
+// Used by SkPicturePriv::PlaybackTiled()
+    // Like playback(), but draws the ops the BBH finds under query (in picture space) as if it
+    // were the canvas's local clip bounds.
+    void playbackIntersecting(SkCanvas*, const SkRect& query) const;
+
 // Used by GrLayerHoister
     void partialPlayback(SkCanvas*,
                          int start,
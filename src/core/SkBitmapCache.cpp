@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPixelRef.h"
 #include "include/core/SkRect.h"
@@ -290,7 +291,7 @@ const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCa
         return nullptr;
     }
 
-    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache));
+    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache), &SkExecutor::GetDefault());
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(SkBitmapCacheDesc::Make(image), mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
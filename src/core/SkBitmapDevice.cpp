@@ -56,6 +56,7 @@ class SkDrawTiler {
     // fCurr... are only used if fNeedTiling
     SkTLazy<SkPostTranslateMatrixProvider> fTileMatrixProvider;
     SkRasterClip                           fTileRC;
+    SkIRect                                fTileBlitBounds;
     SkIPoint                               fOrigin;
 
     bool            fDone, fNeedsTiling;
@@ -117,6 +118,7 @@ public:
             fOrigin.set(0, 0);
 
             fDraw.fCoverage = dev->accessCoverage();
+            fDraw.fBlitBounds = dev->fBlitBounds.getMaybeNull();
         }
     }
 
@@ -170,6 +172,10 @@ private:
         fDevice->fRCStack.rc().translate(-fOrigin.x(), -fOrigin.y(), &fTileRC);
         fTileRC.op(SkIRect::MakeWH(fDraw.fDst.width(), fDraw.fDst.height()),
                    SkRegion::kIntersect_Op);
+        if (const SkIRect* blitBounds = fDevice->fBlitBounds.getMaybeNull()) {
+            fTileBlitBounds = blitBounds->makeOffset(-fOrigin.x(), -fOrigin.y());
+            fDraw.fBlitBounds = &fTileBlitBounds;
+        }
     }
 };
 
@@ -195,6 +201,7 @@ public:
         fMatrixProvider = dev;
         fRC = &dev->fRCStack.rc();
         fCoverage = dev->accessCoverage();
+        fBlitBounds = dev->fBlitBounds.getMaybeNull();
     }
 };
 
@@ -577,6 +584,7 @@ void SkBitmapDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPain
         draw.fDst = fBitmap.pixmap();
         draw.fMatrixProvider = &matrixProvider;
         draw.fRC = &fRCStack.rc();
+        draw.fBlitBounds = fBlitBounds.getMaybeNull();
         paint.writable()->setShader(src->fBitmap.makeShader());
         draw.drawBitmap(*src->fCoverage,
                         SkMatrix::Translate(SkIntToScalar(x),SkIntToScalar(y)), nullptr, *paint);
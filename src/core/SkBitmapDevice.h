@@ -20,6 +20,7 @@
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRasterClipStack.h"
+#include "src/core/SkTLazy.h"
 
 class SkImageFilterCache;
 class SkMatrix;
@@ -68,6 +69,13 @@ public:
         return fCoverage ? &fCoverage->pixmap() : nullptr;
     }
 
+    /**
+     *  Leave the pixels outside of bounds untouched.  Unlike a clip, this does not change how
+     *  anything is rasterized, so the pixels inside bounds come out exactly as they would without
+     *  it.  Layers made by this device are not affected.
+     */
+    void setBlitBounds(const SkIRect& bounds) { fBlitBounds.set(bounds); }
+
 protected:
     void* getRasterHandle() const override { return fRasterHandle; }
 
@@ -157,6 +165,7 @@ private:
     void*       fRasterHandle = nullptr;
     SkRasterClipStack  fRCStack;
     std::unique_ptr<SkBitmap> fCoverage;    // if non-null, will have the same dimensions as fBitmap
+    SkTLazy<SkIRect>   fBlitBounds;
     SkGlyphRunListPainter fGlyphPainter;
 
 
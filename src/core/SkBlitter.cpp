@@ -874,6 +874,11 @@ const SkPixmap* SkRectClipCheckBlitter::justAnOpaqueColor(uint32_t* value) {
     return fBlitter->justAnOpaqueColor(value);
 }
 
+void SkRectClipCheckBlitter::blitAntiPixel(int x, int y, U8CPU a) {
+    SkASSERT(fClipRect.contains(x, y));
+    fBlitter->blitAntiPixel(x, y, a);
+}
+
 void SkRectClipCheckBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
     SkASSERT(fClipRect.contains(SkIRect::MakeXYWH(x, y, 2, 1)));
     fBlitter->blitAntiH2(x, y, a0, a1);
@@ -77,6 +77,17 @@ public:
     */
     virtual const SkPixmap* justAnOpaqueColor(uint32_t* value);
 
+    // (x, y) alone, blended the same way blitAntiH2() and blitAntiV2() blend each of theirs.
+    virtual void blitAntiPixel(int x, int y, U8CPU a) {
+        int16_t runs[2];
+        uint8_t aa[1];
+
+        runs[0] = 1;
+        runs[1] = 0;
+        aa[0] = SkToU8(a);
+        this->blitAntiH(x, y, aa, runs);
+    }
+
     // (x, y), (x + 1, y)
     virtual void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
         int16_t runs[3];
@@ -259,6 +270,7 @@ public:
                               SkAlpha leftAlpha, SkAlpha rightAlpha) override;
     void blitMask(const SkMask&, const SkIRect& clip) override;
     const SkPixmap* justAnOpaqueColor(uint32_t* value) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
 
@@ -315,6 +327,7 @@ public:
     }
     void blitMask(const SkMask& mask, const SkIRect& clip) override { SHARD(blitMask(mask, clip)) }
     const SkPixmap* justAnOpaqueColor(uint32_t* value) override { return nullptr; }
+    void blitAntiPixel(int x, int y, U8CPU a) override { SHARD(blitAntiPixel(x, y, a)) }
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override { SHARD(blitAntiH2(x, y, a0, a1)) }
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override { SHARD(blitAntiV2(x, y, a0, a1)) }
 };
@@ -733,6 +733,11 @@ void SkARGB32_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
     }
 }
 
+void SkARGB32_Blitter::blitAntiPixel(int x, int y, U8CPU a) {
+    uint32_t* device = fDevice.writable_addr32(x, y);
+    device[0] = SkBlendARGB32(fPMColor, device[0], a);
+}
+
 void SkARGB32_Blitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
     uint32_t* device = fDevice.writable_addr32(x, y);
     SkDEBUGCODE((void)fDevice.writable_addr32(x + 1, y);)
@@ -834,6 +839,11 @@ void SkARGB32_Opaque_Blitter::blitMask(const SkMask& mask,
     }
 }
 
+void SkARGB32_Opaque_Blitter::blitAntiPixel(int x, int y, U8CPU a) {
+    uint32_t* device = fDevice.writable_addr32(x, y);
+    device[0] = SkFastFourByteInterp(fPMColor, device[0], a);
+}
+
 void SkARGB32_Opaque_Blitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
     uint32_t* device = fDevice.writable_addr32(x, y);
     SkDEBUGCODE((void)fDevice.writable_addr32(x + 1, y);)
@@ -931,6 +941,11 @@ void SkARGB32_Black_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
     }
 }
 
+void SkARGB32_Black_Blitter::blitAntiPixel(int x, int y, U8CPU a) {
+    uint32_t* device = fDevice.writable_addr32(x, y);
+    device[0] = (a << SK_A32_SHIFT) + SkAlphaMulQ(device[0], 256 - a);
+}
+
 void SkARGB32_Black_Blitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
     uint32_t* device = fDevice.writable_addr32(x, y);
     SkDEBUGCODE((void)fDevice.writable_addr32(x + 1, y);)
@@ -77,6 +77,7 @@ public:
     void blitRect(int x, int y, int width, int height) override;
     void blitMask(const SkMask&, const SkIRect&) override;
     const SkPixmap* justAnOpaqueColor(uint32_t*) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
 
@@ -98,6 +99,7 @@ public:
     SkARGB32_Opaque_Blitter(const SkPixmap& device, const SkPaint& paint)
         : INHERITED(device, paint) { SkASSERT(paint.getAlpha() == 0xFF); }
     void blitMask(const SkMask&, const SkIRect&) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
 
@@ -110,6 +112,7 @@ public:
     SkARGB32_Black_Blitter(const SkPixmap& device, const SkPaint& paint)
         : INHERITED(device, paint) {}
     void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
 
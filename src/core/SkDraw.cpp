@@ -799,6 +799,71 @@ DRAW_PATH:
     this->drawPath(path, paint, nullptr, true);
 }
 
+namespace {
+
+// SkRectClipBlitter turns calls that straddle the rect into calls to blitAntiH() or blitV(),
+// which may blend differently than the calls they replace.  This keeps every pixel inside
+// the rect blended by the same entry point it would have been without the rect.
+class BlitBoundsBlitter final : public SkRectClipBlitter {
+public:
+    BlitBoundsBlitter(SkBlitter* blitter, const SkIRect& bounds)
+            : fRealBlitter(blitter), fBounds(bounds) {
+        this->init(blitter, bounds);
+    }
+
+    void blitAntiRect(int x, int y, int width, int height,
+                      SkAlpha leftAlpha, SkAlpha rightAlpha) override {
+        if (fBounds.contains(SkIRect::MakeXYWH(x, y, width + 2, height))) {
+            fRealBlitter->blitAntiRect(x, y, width, height, leftAlpha, rightAlpha);
+            return;
+        }
+        // Same pieces as SkBlitter::blitAntiRect(), each cut down on its own.
+        this->blitV(x, y, height, leftAlpha);
+        this->blitRect(x + 1, y, width, height);
+        this->blitV(x + 1 + width, y, height, rightAlpha);
+    }
+
+    void blitAntiPixel(int x, int y, U8CPU a) override {
+        if (fBounds.contains(x, y)) {
+            fRealBlitter->blitAntiPixel(x, y, a);
+        }
+    }
+
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        if (fBounds.contains(SkIRect::MakeXYWH(x, y, 2, 1))) {
+            fRealBlitter->blitAntiH2(x, y, a0, a1);
+            return;
+        }
+        this->blitAntiPixel(x, y, a0);
+        this->blitAntiPixel(x + 1, y, a1);
+    }
+
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        if (fBounds.contains(SkIRect::MakeXYWH(x, y, 1, 2))) {
+            fRealBlitter->blitAntiV2(x, y, a0, a1);
+            return;
+        }
+        this->blitAntiPixel(x, y, a0);
+        this->blitAntiPixel(x, y + 1, a1);
+    }
+
+    // Callers that get the pixmap write to it directly, past the bounds.
+    const SkPixmap* justAnOpaqueColor(uint32_t*) override { return nullptr; }
+
+private:
+    SkBlitter* fRealBlitter;
+    SkIRect    fBounds;
+};
+
+}  // namespace
+
+SkBlitter* SkDraw::applyBlitBounds(SkBlitter* blitter, SkArenaAlloc* alloc) const {
+    if (!fBlitBounds) {
+        return blitter;
+    }
+    return alloc->make<BlitBoundsBlitter>(blitter, *fBlitBounds);
+}
+
 SkScalar SkDraw::ComputeResScaleForStroking(const SkMatrix& matrix) {
     // Not sure how to handle perspective differently, so we just don't try (yet)
     SkScalar sx = SkPoint::Length(matrix[SkMatrix::kMScaleX], matrix[SkMatrix::kMSkewY]);
@@ -1110,7 +1175,7 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
                                                          fRC->clipShader());
             if (blitter) {
                 SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
-                                  *fRC, blitter);
+                                  *fRC, this->applyBlitBounds(blitter, &allocator));
                 return;
             }
             // if !blitter, then we fall-through to the slower case
@@ -1165,7 +1230,7 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator,
                                                      fRC->clipShader());
         if (blitter) {
-            SkScan::FillIRect(bounds, *fRC, blitter);
+            SkScan::FillIRect(bounds, *fRC, this->applyBlitBounds(blitter, &allocator));
             return;
         }
     }
@@ -17,6 +17,7 @@
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkMask.h"
 
+class SkArenaAlloc;
 class SkBitmap;
 class SkClipStack;
 class SkBaseDevice;
@@ -123,6 +124,12 @@ public:
 
     static SkScalar ComputeResScaleForStroking(const SkMatrix& );
 
+    /**
+     *  If fBlitBounds is set, wraps blitter (allocating from alloc) so that it leaves the pixels
+     *  outside of fBlitBounds alone.  Otherwise returns blitter.
+     */
+    SkBlitter* applyBlitBounds(SkBlitter* blitter, SkArenaAlloc* alloc) const;
+
 private:
     void drawBitmapAsMask(const SkBitmap&, const SkPaint&) const;
     void draw_fixed_vertices(const SkVertices*, SkBlendMode, const SkPaint&, const SkMatrix&,
@@ -162,6 +169,10 @@ public:
     // optional, will be same dimensions as fDst if present
     const SkPixmap* fCoverage{nullptr};
 
+    // optional, if present pixels outside of it are left untouched.  Unlike fRC, this does not
+    // change how anything is rasterized.
+    const SkIRect* fBlitBounds{nullptr};
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
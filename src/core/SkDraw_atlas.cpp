@@ -104,6 +104,7 @@ void SkDraw::drawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRe
 
     if (auto blitter = SkCreateRasterPipelineBlitter(fDst, p, pipeline, isOpaque, &alloc,
                                                      fRC->clipShader())) {
+        blitter = this->applyBlitBounds(blitter, &alloc);
         for (int i = 0; i < count; ++i) {
             if (colors) {
                 SkColor4f c4 = SkColor4f::FromColor(colors[i]);
@@ -46,6 +46,7 @@ void SkDraw::paintMasks(SkDrawableGlyphBuffer* drawables, const SkPaint& paint)
                 SkBlitter::Choose(
                         *fCoverage, *fMatrixProvider, SkPaint(), &alloc, true, fRC->clipShader()));
     }
+    blitter = this->applyBlitBounds(blitter, &alloc);
 
     SkAAClipBlitterWrapper wrapper{*fRC, blitter};
     blitter = wrapper.getBlitter();
@@ -332,6 +332,7 @@ void SkDraw::draw_fixed_vertices(const SkVertices* vertices, SkBlendMode bmode,
     if (!textures) {    // only tricolor shader
         if (auto blitter = SkCreateRasterPipelineBlitter(fDst, p, *fMatrixProvider, outerAlloc,
                                                          this->fRC->clipShader())) {
+            blitter = this->applyBlitBounds(blitter, outerAlloc);
             while (vertProc(&state)) {
                 if (triShader &&
                     !triShader->update(ctmInv, positions, dstColors,
@@ -365,6 +366,7 @@ void SkDraw::draw_fixed_vertices(const SkVertices* vertices, SkBlendMode bmode,
 
         if (auto blitter = SkCreateRasterPipelineBlitter(fDst, p, pipeline, isOpaque, outerAlloc,
                                                          fRC->clipShader())) {
+            blitter = this->applyBlitBounds(blitter, outerAlloc);
             while (vertProc(&state)) {
                 if (triShader && !triShader->update(ctmInv, positions, dstColors,
                                                     state.f0, state.f1, state.f2)) {
@@ -401,7 +403,7 @@ void SkDraw::draw_fixed_vertices(const SkVertices* vertices, SkBlendMode bmode,
 
             if (auto blitter = SkCreateRasterPipelineBlitter(fDst, p, *matrixProvider, &innerAlloc,
                                                              this->fRC->clipShader())) {
-                fill_triangle(state, blitter, *fRC, dev2, dev3);
+                fill_triangle(state, this->applyBlitBounds(blitter, &innerAlloc), *fRC, dev2, dev3);
             }
         }
     }
@@ -7,6 +7,7 @@
 
 #include "src/core/SkEdge.h"
 
+#include "include/private/SkNx.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkFDot6.h"
 #include "src/core/SkMathPriv.h"
@@ -140,6 +141,25 @@ void SkEdge::chopLineWithClip(const SkIRect& clip)
     }
 }
 
+void SkEdge::ConvertToFDot6(const SkPoint pts[], int count, int shift, SkFDot6 xy[]) {
+    const float* src = &pts[0].fX;
+    int n = 2 * count;
+#ifdef SK_RASTERIZE_EVEN_ROUNDING
+    for (int i = 0; i < n; i++) {
+        xy[i] = SkScalarRoundToFDot6(src[i], shift);
+    }
+#else
+    float scale = float(1 << (shift + 6));
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        SkNx_cast<int32_t>(Sk4f::Load(src + i) * scale).store(xy + i);
+    }
+    for (; i < n; i++) {
+        xy[i] = int(src[i] * scale);
+    }
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /*  We store 1<<shift in a (signed) byte, so its maximum value is 1<<6 == 64.
@@ -179,26 +199,15 @@ static inline int diff_to_shift(SkFDot6 dx, SkFDot6 dy, int shiftAA = 2)
 }
 
 bool SkQuadraticEdge::setQuadraticWithoutUpdate(const SkPoint pts[3], int shift) {
-    SkFDot6 x0, y0, x1, y1, x2, y2;
+    SkFDot6 xy[6];
+    ConvertToFDot6(pts, 3, shift, xy);
+    return this->setQuadraticWithoutUpdate(xy, shift);
+}
 
-    {
-#ifdef SK_RASTERIZE_EVEN_ROUNDING
-        x0 = SkScalarRoundToFDot6(pts[0].fX, shift);
-        y0 = SkScalarRoundToFDot6(pts[0].fY, shift);
-        x1 = SkScalarRoundToFDot6(pts[1].fX, shift);
-        y1 = SkScalarRoundToFDot6(pts[1].fY, shift);
-        x2 = SkScalarRoundToFDot6(pts[2].fX, shift);
-        y2 = SkScalarRoundToFDot6(pts[2].fY, shift);
-#else
-        float scale = float(1 << (shift + 6));
-        x0 = int(pts[0].fX * scale);
-        y0 = int(pts[0].fY * scale);
-        x1 = int(pts[1].fX * scale);
-        y1 = int(pts[1].fY * scale);
-        x2 = int(pts[2].fX * scale);
-        y2 = int(pts[2].fY * scale);
-#endif
-    }
+bool SkQuadraticEdge::setQuadraticWithoutUpdate(const SkFDot6 xy[6], int shift) {
+    SkFDot6 x0 = xy[0], y0 = xy[1],
+            x1 = xy[2], y1 = xy[3],
+            x2 = xy[4], y2 = xy[5];
 
     int winding = 1;
     if (y0 > y2)
@@ -285,6 +294,13 @@ int SkQuadraticEdge::setQuadratic(const SkPoint pts[3], int shift) {
     return this->updateQuadratic();
 }
 
+int SkQuadraticEdge::setQuadratic(const SkFDot6 xy[6], int shift) {
+    if (!this->setQuadraticWithoutUpdate(xy, shift)) {
+        return 0;
+    }
+    return this->updateQuadratic();
+}
+
 int SkQuadraticEdge::updateQuadratic()
 {
     int     success;
@@ -349,30 +365,16 @@ static SkFDot6 cubic_delta_from_line(SkFDot6 a, SkFDot6 b, SkFDot6 c, SkFDot6 d)
 }
 
 bool SkCubicEdge::setCubicWithoutUpdate(const SkPoint pts[4], int shift, bool sortY) {
-    SkFDot6 x0, y0, x1, y1, x2, y2, x3, y3;
+    SkFDot6 xy[8];
+    ConvertToFDot6(pts, 4, shift, xy);
+    return this->setCubicWithoutUpdate(xy, shift, sortY);
+}
 
-    {
-#ifdef SK_RASTERIZE_EVEN_ROUNDING
-        x0 = SkScalarRoundToFDot6(pts[0].fX, shift);
-        y0 = SkScalarRoundToFDot6(pts[0].fY, shift);
-        x1 = SkScalarRoundToFDot6(pts[1].fX, shift);
-        y1 = SkScalarRoundToFDot6(pts[1].fY, shift);
-        x2 = SkScalarRoundToFDot6(pts[2].fX, shift);
-        y2 = SkScalarRoundToFDot6(pts[2].fY, shift);
-        x3 = SkScalarRoundToFDot6(pts[3].fX, shift);
-        y3 = SkScalarRoundToFDot6(pts[3].fY, shift);
-#else
-        float scale = float(1 << (shift + 6));
-        x0 = int(pts[0].fX * scale);
-        y0 = int(pts[0].fY * scale);
-        x1 = int(pts[1].fX * scale);
-        y1 = int(pts[1].fY * scale);
-        x2 = int(pts[2].fX * scale);
-        y2 = int(pts[2].fY * scale);
-        x3 = int(pts[3].fX * scale);
-        y3 = int(pts[3].fY * scale);
-#endif
-    }
+bool SkCubicEdge::setCubicWithoutUpdate(const SkFDot6 xy[8], int shift, bool sortY) {
+    SkFDot6 x0 = xy[0], y0 = xy[1],
+            x1 = xy[2], y1 = xy[3],
+            x2 = xy[4], y2 = xy[5],
+            x3 = xy[6], y3 = xy[7];
 
     int winding = 1;
     if (sortY && y0 > y3)
@@ -455,6 +457,13 @@ int SkCubicEdge::setCubic(const SkPoint pts[4], int shift) {
     return this->updateCubic();
 }
 
+int SkCubicEdge::setCubic(const SkFDot6 xy[8], int shift) {
+    if (!this->setCubicWithoutUpdate(xy, shift)) {
+        return 0;
+    }
+    return this->updateCubic();
+}
+
 int SkCubicEdge::updateCubic()
 {
     int     success;
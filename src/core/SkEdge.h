@@ -43,6 +43,10 @@ struct SkEdge {
     inline int updateLine(SkFixed ax, SkFixed ay, SkFixed bx, SkFixed by);
     void chopLineWithClip(const SkIRect& clip);
 
+    // Converts count points to (x,y) pairs of FDot6, scaled up by shiftUp, exactly as the setters
+    // below do for their own points. This lets curves be converted in batches.
+    static void ConvertToFDot6(const SkPoint pts[], int count, int shiftUp, SkFDot6 xy[]);
+
     inline bool intersectsClip(const SkIRect& clip) const {
         SkASSERT(fFirstY < clip.fBottom);
         return fLastY >= clip.fTop;
@@ -72,6 +76,9 @@ struct SkQuadraticEdge : public SkEdge {
 
     bool setQuadraticWithoutUpdate(const SkPoint pts[3], int shiftUp);
     int setQuadratic(const SkPoint pts[3], int shiftUp);
+    // As above, but from points already converted by ConvertToFDot6().
+    bool setQuadraticWithoutUpdate(const SkFDot6 xy[6], int shiftUp);
+    int setQuadratic(const SkFDot6 xy[6], int shiftUp);
     int updateQuadratic();
 };
 
@@ -84,6 +91,9 @@ struct SkCubicEdge : public SkEdge {
 
     bool setCubicWithoutUpdate(const SkPoint pts[4], int shiftUp, bool sortY = true);
     int setCubic(const SkPoint pts[4], int shiftUp);
+    // As above, but from points already converted by ConvertToFDot6().
+    bool setCubicWithoutUpdate(const SkFDot6 xy[8], int shiftUp, bool sortY = true);
+    int setCubic(const SkFDot6 xy[8], int shiftUp);
     int updateCubic();
 };
 
@@ -17,6 +17,9 @@
 #include "src/core/SkPathView.h"
 #include "src/core/SkSafeMath.h"
 
+#include <algorithm>
+#include <cstring>
+
 SkEdgeBuilder::Combine SkBasicEdgeBuilder::combineVertical(const SkEdge* edge, SkEdge* last) {
     if (last->fCurveCount || last->fDX || edge->fX != last->fX) {
         return kNo_Combine;
@@ -118,7 +121,7 @@ static bool is_vertical(const Edge* edge) {
 // or when we don't use it (kPartial_Combine or kTotal_Combine).
 
 void SkBasicEdgeBuilder::addLine(const SkPoint pts[]) {
-    SkEdge* edge = fAlloc.make<SkEdge>();
+    SkEdge* edge = this->carveEdges<SkEdge>(1);
     if (edge->setLine(pts[0], pts[1], fClipShift)) {
         Combine combine = is_vertical(edge) && !fList.empty()
             ? this->combineVertical(edge, (SkEdge*)fList.top())
@@ -132,7 +135,7 @@ void SkBasicEdgeBuilder::addLine(const SkPoint pts[]) {
     }
 }
 void SkAnalyticEdgeBuilder::addLine(const SkPoint pts[]) {
-    SkAnalyticEdge* edge = fAlloc.make<SkAnalyticEdge>();
+    SkAnalyticEdge* edge = this->carveEdges<SkAnalyticEdge>(1);
     if (edge->setLine(pts[0], pts[1])) {
 
         Combine combine = is_vertical(edge) && !fList.empty()
@@ -146,29 +149,49 @@ void SkAnalyticEdgeBuilder::addLine(const SkPoint pts[]) {
         }
     }
 }
-void SkBasicEdgeBuilder::addQuad(const SkPoint pts[]) {
-    SkQuadraticEdge* edge = fAlloc.make<SkQuadraticEdge>();
-    if (edge->setQuadratic(pts, fClipShift)) {
-        fList.push_back(edge);
+void SkBasicEdgeBuilder::addQuads(const SkPoint pts[], int count) {
+    SkFDot6 xy[kMaxBatchedCurves * 6];
+    SkEdge::ConvertToFDot6(pts, count * 3, fClipShift, xy);
+
+    SkQuadraticEdge* edges = this->carveEdges<SkQuadraticEdge>(count);
+    for (int i = 0; i < count; i++) {
+        if (edges[i].setQuadratic(xy + i * 6, fClipShift)) {
+            fList.push_back(edges + i);
+        }
     }
 }
-void SkAnalyticEdgeBuilder::addQuad(const SkPoint pts[]) {
-    SkAnalyticQuadraticEdge* edge = fAlloc.make<SkAnalyticQuadraticEdge>();
-    if (edge->setQuadratic(pts)) {
-        fList.push_back(edge);
+void SkAnalyticEdgeBuilder::addQuads(const SkPoint pts[], int count) {
+    SkFDot6 xy[kMaxBatchedCurves * 6];
+    SkEdge::ConvertToFDot6(pts, count * 3, SkAnalyticEdge::kDefaultAccuracy, xy);
+
+    SkAnalyticQuadraticEdge* edges = this->carveEdges<SkAnalyticQuadraticEdge>(count);
+    for (int i = 0; i < count; i++) {
+        if (edges[i].setQuadratic(xy + i * 6)) {
+            fList.push_back(edges + i);
+        }
     }
 }
 
-void SkBasicEdgeBuilder::addCubic(const SkPoint pts[]) {
-    SkCubicEdge* edge = fAlloc.make<SkCubicEdge>();
-    if (edge->setCubic(pts, fClipShift)) {
-        fList.push_back(edge);
+void SkBasicEdgeBuilder::addCubics(const SkPoint pts[], int count) {
+    SkFDot6 xy[kMaxBatchedCurves * 8];
+    SkEdge::ConvertToFDot6(pts, count * 4, fClipShift, xy);
+
+    SkCubicEdge* edges = this->carveEdges<SkCubicEdge>(count);
+    for (int i = 0; i < count; i++) {
+        if (edges[i].setCubic(xy + i * 8, fClipShift)) {
+            fList.push_back(edges + i);
+        }
     }
 }
-void SkAnalyticEdgeBuilder::addCubic(const SkPoint pts[]) {
-    SkAnalyticCubicEdge* edge = fAlloc.make<SkAnalyticCubicEdge>();
-    if (edge->setCubic(pts)) {
-        fList.push_back(edge);
+void SkAnalyticEdgeBuilder::addCubics(const SkPoint pts[], int count) {
+    SkFDot6 xy[kMaxBatchedCurves * 8];
+    SkEdge::ConvertToFDot6(pts, count * 4, SkAnalyticEdge::kDefaultAccuracy, xy);
+
+    SkAnalyticCubicEdge* edges = this->carveEdges<SkAnalyticCubicEdge>(count);
+    for (int i = 0; i < count; i++) {
+        if (edges[i].setCubic(xy + i * 8)) {
+            fList.push_back(edges + i);
+        }
     }
 }
 
@@ -209,6 +232,13 @@ SkRect SkAnalyticEdgeBuilder::recoverClip(const SkIRect& src) const {
     return SkRect::Make(src);
 }
 
+size_t SkBasicEdgeBuilder::largestEdgeSize() const {
+    return std::max(sizeof(SkQuadraticEdge), sizeof(SkCubicEdge));
+}
+size_t SkAnalyticEdgeBuilder::largestEdgeSize() const {
+    return std::max(sizeof(SkAnalyticQuadraticEdge), sizeof(SkAnalyticCubicEdge));
+}
+
 char* SkBasicEdgeBuilder::allocEdges(size_t n, size_t* size) {
     *size = sizeof(SkEdge);
     return (char*)fAlloc.makeArrayDefault<SkEdge>(n);
@@ -218,6 +248,26 @@ char* SkAnalyticEdgeBuilder::allocEdges(size_t n, size_t* size) {
     return (char*)fAlloc.makeArrayDefault<SkAnalyticEdge>(n);
 }
 
+void SkEdgeBuilder::queueCurve(const SkPoint pts[], int ptsPerCurve) {
+    if (fBatchPtsPerCurve != ptsPerCurve || fBatchCount == kMaxBatchedCurves) {
+        this->flushCurves();
+        fBatchPtsPerCurve = ptsPerCurve;
+    }
+    memcpy(fBatch + fBatchCount * ptsPerCurve, pts, ptsPerCurve * sizeof(SkPoint));
+    fBatchCount++;
+}
+
+void SkEdgeBuilder::flushCurves() {
+    if (fBatchCount > 0) {
+        if (fBatchPtsPerCurve == 3) {
+            this->addQuads(fBatch, fBatchCount);
+        } else {
+            this->addCubics(fBatch, fBatchCount);
+        }
+        fBatchCount = 0;
+    }
+}
+
 // TODO: maybe get rid of buildPoly() entirely?
 int SkEdgeBuilder::buildPoly(const SkPathView& path, const SkIRect* iclip, bool canCullToTheRight) {
     size_t maxEdgeCount = path.fPoints.size();
@@ -287,7 +337,32 @@ int SkEdgeBuilder::buildPoly(const SkPathView& path, const SkIRect* iclip, bool
     return SkToInt(edgePtr - (char**)fEdgeList);
 }
 
+void SkEdgeBuilder::reserveEdges(const SkPathView& path) {
+    // Guess at how many monotonic pieces each segment makes. Space we never touch costs only
+    // address space, and guessing low just sends the rest of the edges to fAlloc.
+    size_t edgeCount = 0;
+    for (uint8_t verb : path.fVerbs) {
+        switch ((SkPathVerb)verb) {
+            case SkPathVerb::kLine:  edgeCount += 1; break;
+            case SkPathVerb::kQuad:  edgeCount += 2; break;
+            case SkPathVerb::kConic: edgeCount += 4; break;
+            case SkPathVerb::kCubic: edgeCount += 3; break;
+            default:                                 break;
+        }
+    }
+    // Don't reserve more than this up front for enormous paths; the arena can take the rest.
+    constexpr size_t kMaxReservedEdges = 1 << 17;
+    edgeCount = std::min(edgeCount, kMaxReservedEdges);
+
+    const size_t bytes = edgeCount * this->largestEdgeSize();
+    fEdgeStorage = (char*)fAlloc.makeBytesAlignedTo(bytes, alignof(void*));
+    fEdgeStorageEnd = fEdgeStorage + bytes;
+    fList.setReserve(SkToInt(edgeCount));
+}
+
 int SkEdgeBuilder::build(const SkPathView& path, const SkIRect* iclip, bool canCullToTheRight) {
+    this->reserveEdges(path);
+
     SkAutoConicToQuads quadder;
     const SkScalar conicTol = SK_Scalar1 / 4;
     bool is_finite = true;
@@ -313,9 +388,12 @@ int SkEdgeBuilder::build(const SkPathView& path, const SkIRect* iclip, bool canC
                     return;
                 }
                 switch (verb) {
-                    case SkPath::kLine_Verb:  rec->fBuilder->addLine (pts); break;
-                    case SkPath::kQuad_Verb:  rec->fBuilder->addQuad (pts); break;
-                    case SkPath::kCubic_Verb: rec->fBuilder->addCubic(pts); break;
+                    case SkPath::kLine_Verb:
+                        rec->fBuilder->flushCurves();
+                        rec->fBuilder->addLine(pts);
+                        break;
+                    case SkPath::kQuad_Verb:  rec->fBuilder->queueCurve(pts, 3); break;
+                    case SkPath::kCubic_Verb: rec->fBuilder->queueCurve(pts, 4); break;
                     default: break;
                 }
             }
@@ -326,12 +404,13 @@ int SkEdgeBuilder::build(const SkPathView& path, const SkIRect* iclip, bool canC
             SkPoint monoX[5];
             int n = SkChopQuadAtYExtrema(pts, monoX);
             for (int i = 0; i <= n; i++) {
-                this->addQuad(&monoX[i * 2]);
+                this->queueCurve(&monoX[i * 2], 3);
             }
         };
         while (auto e = iter.next()) {
             switch (e.fEdge) {
                 case SkPathEdgeIter::Edge::kLine:
+                    this->flushCurves();
                     this->addLine(e.fPts);
                     break;
                 case SkPathEdgeIter::Edge::kQuad: {
@@ -350,13 +429,14 @@ int SkEdgeBuilder::build(const SkPathView& path, const SkIRect* iclip, bool canC
                     SkPoint monoY[10];
                     int n = SkChopCubicAtYExtrema(e.fPts, monoY);
                     for (int i = 0; i <= n; i++) {
-                        this->addCubic(&monoY[i * 3]);
+                        this->queueCurve(&monoY[i * 3], 4);
                     }
                     break;
                 }
             }
         }
     }
+    this->flushCurves();
     fEdgeList = fList.begin();
     return is_finite ? fList.count() : 0;
 }
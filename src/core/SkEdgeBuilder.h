@@ -35,17 +35,55 @@ protected:
         kTotal_Combine
     };
 
+    // Edges are carved out of one block reserved up front for the whole path (see build()),
+    // rather than out of a chain of ever larger arena blocks. Running out falls back to fAlloc.
+    template <typename Edge>
+    Edge* carveEdges(int count) {
+        static_assert(alignof(Edge) <= alignof(void*), "");
+        static_assert(sizeof(Edge) % alignof(void*) == 0, "");
+        const size_t bytes = count * sizeof(Edge);
+        if (bytes > (size_t)(fEdgeStorageEnd - fEdgeStorage)) {
+            return fAlloc.makeArray<Edge>(count);
+        }
+        // Like makeArray(), zero the edges; not every setter fills in every field.
+        Edge* edges = reinterpret_cast<Edge*>(fEdgeStorage);
+        for (int i = 0; i < count; i++) {
+            new (&edges[i]) Edge();
+        }
+        fEdgeStorage += bytes;
+        return edges;
+    }
+
+    // Monotonic curves are queued up and turned into edges a batch at a time, so that each
+    // batch's points are converted to fixed point together and its edges allocated contiguously.
+    static constexpr int kMaxBatchedCurves = 32;
+
 private:
     int build    (const SkPathView&, const SkIRect* clip, bool clipToTheRight);
     int buildPoly(const SkPathView&, const SkIRect* clip, bool clipToTheRight);
 
+    // Batches only ever hold one kind of curve, and are flushed before any line is added,
+    // so edges are listed in the same order as the path's segments.
+    void queueCurve(const SkPoint pts[], int ptsPerCurve);
+    void flushCurves();
+
+    void reserveEdges(const SkPathView&);
+
     virtual char* allocEdges(size_t n, size_t* sizeof_edge) = 0;
+    virtual size_t largestEdgeSize() const = 0;
     virtual SkRect recoverClip(const SkIRect&) const = 0;
 
-    virtual void addLine (const SkPoint pts[]) = 0;
-    virtual void addQuad (const SkPoint pts[]) = 0;
-    virtual void addCubic(const SkPoint pts[]) = 0;
+    virtual void addLine  (const SkPoint pts[]) = 0;
+    virtual void addQuads (const SkPoint pts[], int count) = 0;  // 3 points per quad
+    virtual void addCubics(const SkPoint pts[], int count) = 0;  // 4 points per cubic
     virtual Combine addPolyLine(const SkPoint pts[], char* edge, char** edgePtr) = 0;
+
+    char*   fEdgeStorage    = nullptr;
+    char*   fEdgeStorageEnd = nullptr;
+
+    SkPoint fBatch[kMaxBatchedCurves * 4];
+    int     fBatchCount = 0;
+    int     fBatchPtsPerCurve = 0;
 };
 
 class SkBasicEdgeBuilder final : public SkEdgeBuilder {
@@ -58,11 +96,12 @@ private:
     Combine combineVertical(const SkEdge* edge, SkEdge* last);
 
     char* allocEdges(size_t, size_t*) override;
+    size_t largestEdgeSize() const override;
     SkRect recoverClip(const SkIRect&) const override;
 
-    void addLine (const SkPoint pts[]) override;
-    void addQuad (const SkPoint pts[]) override;
-    void addCubic(const SkPoint pts[]) override;
+    void addLine  (const SkPoint pts[]) override;
+    void addQuads (const SkPoint pts[], int count) override;
+    void addCubics(const SkPoint pts[], int count) override;
     Combine addPolyLine(const SkPoint pts[], char* edge, char** edgePtr) override;
 
     const int fClipShift;
@@ -78,11 +117,12 @@ private:
     Combine combineVertical(const SkAnalyticEdge* edge, SkAnalyticEdge* last);
 
     char* allocEdges(size_t, size_t*) override;
+    size_t largestEdgeSize() const override;
     SkRect recoverClip(const SkIRect&) const override;
 
-    void addLine (const SkPoint pts[]) override;
-    void addQuad (const SkPoint pts[]) override;
-    void addCubic(const SkPoint pts[]) override;
+    void addLine  (const SkPoint pts[]) override;
+    void addQuads (const SkPoint pts[], int count) override;
+    void addCubics(const SkPoint pts[], int count) override;
     Combine addPolyLine(const SkPoint pts[], char* edge, char** edgePtr) override;
 };
 #endif
@@ -10,6 +10,7 @@
 #include "include/private/SkSemaphore.h"
 #include "include/private/SkSpinlock.h"
 #include "include/private/SkTArray.h"
+#include "src/core/SkTaskGroup.h"
 #include <deque>
 #include <thread>
 
@@ -38,9 +39,16 @@ class SkTrivialExecutor final : public SkExecutor {
 
 static SkExecutor* gDefaultExecutor = nullptr;
 
-void SetDefaultTrivialExecutor() {
+static SkExecutor* trivial_executor() {
     static SkTrivialExecutor *gTrivial = new SkTrivialExecutor();
-    gDefaultExecutor = gTrivial;
+    return gTrivial;
+}
+
+void SetDefaultTrivialExecutor() {
+    gDefaultExecutor = trivial_executor();
+}
+bool SkExecutorIsTrivial(const SkExecutor& executor) {
+    return &executor == trivial_executor();
 }
 SkExecutor& SkExecutor::GetDefault() {
     if (!gDefaultExecutor) {
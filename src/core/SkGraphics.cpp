@@ -19,11 +19,14 @@
 #include "src/core/SkBlitter.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkGeometry.h"
+#include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkRuntimeEffectPriv.h"
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrikeCache.h"
+#include "src/core/SkStrokeCache.h"
 #include "src/core/SkTSearch.h"
 #include "src/core/SkTypefaceCache.h"
 
@@ -40,12 +43,15 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkImageFilterCache::Get()->dumpMemoryStatistics(dump);
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkRuntimeEffect_PurgeCache();
+    SkStrokeCache::PurgeAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -8,9 +8,11 @@
 #include "include/core/SkImageFilter.h"
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkRect.h"
 #include "include/effects/SkComposeImageFilter.h"
 #include "include/private/SkSafe32.h"
+#include "src/core/SkColorFilterBase.h"
 #include "src/core/SkFuzzLogging.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -19,6 +21,7 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkValidationUtils.h"
 #include "src/core/SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -562,6 +565,142 @@ SkImageFilter_Base::Context SkImageFilter_Base::mapContext(const Context& ctx) c
     return ctx.withNewDesiredOutput(childOutput);
 }
 
+sk_sp<SkSpecialImage> SkImageFilter_Base::filterInputForDraw(
+        int index, const Context& ctx, SkIPoint* offset, sk_sp<SkColorFilter>* colorFilter) const {
+    colorFilter->reset();
+    const SkImageFilter* input = this->getInput(index);
+    if (!input || ctx.gpuBacked()) {
+        return this->filterInput(index, ctx, offset);
+    }
+
+    // Walk down the run of color filter and offset nodes, tracking the context each node would
+    // have been given. Offsets are rounded per node, just as the offset filter itself does.
+    Context inputCtx = this->mapContext(ctx);
+    SkIPoint runOffset = SkIPoint::Make(0, 0);
+    bool fused = false;
+    for (; input; input = input->getInput(0)) {
+        SkColorFilter* nodeCF;
+        SkVector nodeOffset;
+        if (input->isColorFilterNode(&nodeCF)) {
+            sk_sp<SkColorFilter> cf(nodeCF);
+            if (as_CFB(cf)->affectsTransparentBlack()) {
+                break;
+            }
+            *colorFilter = *colorFilter ? (*colorFilter)->makeComposed(std::move(cf))
+                                        : std::move(cf);
+        } else if (as_IFB(input)->onIsOffsetNode(&nodeOffset)) {
+            SkVector vec = inputCtx.ctm().mapVector(nodeOffset.fX, nodeOffset.fY);
+            runOffset.fX = Sk32_sat_add(runOffset.fX, SkScalarRoundToInt(vec.fX));
+            runOffset.fY = Sk32_sat_add(runOffset.fY, SkScalarRoundToInt(vec.fY));
+        } else {
+            break;
+        }
+        inputCtx = as_IFB(input)->mapContext(inputCtx);
+        fused = true;
+    }
+    if (!fused) {
+        return this->filterInput(index, ctx, offset);
+    }
+
+    sk_sp<SkSpecialImage> image = input
+            ? as_IFB(input)->filterImage(inputCtx).imageAndOffset(offset)
+            : inputCtx.source().imageAndOffset(offset);
+    if (!image) {
+        return nullptr;
+    }
+    offset->fX = Sk32_sat_add(offset->fX, runOffset.fX);
+    offset->fY = Sk32_sat_add(offset->fY, runOffset.fY);
+    return image;
+}
+
+void SkImageFilter_Base::filterInputs(const Context& ctx, sk_sp<SkSpecialImage> images[],
+                                      SkIPoint offsets[], sk_sp<SkColorFilter> colorFilters[]) const {
+    const int inputCount = this->countInputs();
+
+    // The index of the first input that refers to the same filter as each input, and the inputs
+    // that actually need filtering. Null inputs just return the source, so they are not worth a
+    // task of their own.
+    SkSTArray<4, int, true> firstIndex, toFilter;
+    for (int i = 0; i < inputCount; ++i) {
+        int first = i;
+        for (int j = 0; j < i; ++j) {
+            if (this->getInput(j) == this->getInput(i)) {
+                first = j;
+                break;
+            }
+        }
+        firstIndex.push_back(first);
+        if (first == i && this->getInput(i)) {
+            toFilter.push_back(i);
+        }
+        offsets[i] = SkIPoint::Make(0, 0);
+    }
+
+    auto filter = [&](int i) {
+        images[i] = colorFilters ? this->filterInputForDraw(i, ctx, &offsets[i], &colorFilters[i])
+                                 : this->filterInput(i, ctx, &offsets[i]);
+    };
+    SkExecutor* executor = ctx.executor();
+    if (executor && toFilter.count() > 1) {
+        SkTaskGroup tasks(*executor);
+        tasks.batch(toFilter.count(), [&](int k) { filter(toFilter[k]); });
+        tasks.wait();
+    } else {
+        for (int i : toFilter) {
+            filter(i);
+        }
+    }
+
+    for (int i = 0; i < inputCount; ++i) {
+        if (firstIndex[i] != i) {
+            images[i] = images[firstIndex[i]];
+            offsets[i] = offsets[firstIndex[i]];
+            if (colorFilters) {
+                colorFilters[i] = colorFilters[firstIndex[i]];
+            }
+        } else if (!this->getInput(i)) {
+            filter(i);
+        }
+    }
+}
+
+void SkImageFilter_Base::ForEachRowBand(const Context& ctx, int width, int height,
+                                        const std::function<void(int top, int bottom)>& rows) {
+    SkForEachRowBand(ctx.executor(), width, height, rows);
+}
+
+void SkImageFilter_Base::DrawInRowBands(const Context& ctx, SkSpecialSurface* surface,
+                                        const std::function<void(SkCanvas*)>& draw) {
+    SkCanvas* canvas = surface->getCanvas();
+    SkPixmap pixels;
+    if (!ctx.executor() || !canvas->getTotalMatrix().isIdentity() || !canvas->isClipRect() ||
+        !canvas->peekPixels(&pixels)) {
+        draw(canvas);
+        return;
+    }
+    SkIRect clip = canvas->getDeviceClipBounds();
+    if (!clip.intersect(pixels.bounds())) {
+        return;
+    }
+
+    // Each band gets its own canvas over just its rows of the surface's clip, translated so the
+    // draw can use the same coordinates it would use on the surface's canvas.
+    ForEachRowBand(ctx, clip.width(), clip.height(), [&](int top, int bottom) {
+        if (top == 0 && bottom == clip.height()) {
+            draw(canvas);
+            return;
+        }
+        SkPixmap band;
+        SkAssertResult(pixels.extractSubset(&band, SkIRect::MakeLTRB(clip.fLeft, clip.fTop + top,
+                                                                     clip.fRight,
+                                                                     clip.fTop + bottom)));
+        std::unique_ptr<SkCanvas> bandCanvas = SkCanvas::MakeRasterDirect(
+                band.info(), band.writable_addr(), band.rowBytes(), &surface->props());
+        bandCanvas->translate(-clip.fLeft, -(clip.fTop + top));
+        draw(bandCanvas.get());
+    });
+}
+
 #if SK_SUPPORT_GPU
 sk_sp<SkSpecialImage> SkImageFilter_Base::DrawWithFP(GrRecordingContext* context,
                                                      std::unique_ptr<GrFragmentProcessor> fp,
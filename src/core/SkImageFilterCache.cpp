@@ -7,10 +7,14 @@
 
 #include "src/core/SkImageFilterCache.h"
 
+#include <atomic>
 #include <vector>
 
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkOnce.h"
 #include "include/private/SkTHash.h"
@@ -27,12 +31,20 @@
 
 namespace {
 
+static constexpr char kImageFilterCacheDumpName[] = "skia/sk_image_filter_cache";
+
+// The cache is split into shards, each with its own lock, so that filters evaluated on different
+// threads rarely contend. Keys are spread over the shards by hash. Each shard has an even share of
+// the byte limit, but may use more while the cache as a whole is under its limit; once the total
+// goes over, results are purged in least-recently-used order across all shards.
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fTotalBytes(0), fUseCount(0) { }
     ~CacheImpl() override {
-        fLookup.foreach([&](Value* v) { delete v; });
+        for (Shard& shard : fShards) {
+            shard.fLookup.foreach([&](Value* v) { delete v; });
+        }
     }
     struct Value {
         Value(const Key& key, const skif::FilterResult<For::kOutput>& image,
@@ -42,24 +54,29 @@ public:
         Key fKey;
         skif::FilterResult<For::kOutput> fImage;
         const SkImageFilter* fFilter;
+        // When this was last set or found, from fUseCount. Orders the LRUs of different shards.
+        uint64_t fLastUse;
         static const Key& GetKey(const Value& v) {
             return v.fKey;
         }
         static uint32_t Hash(const Key& key) {
             return SkOpts::hash(reinterpret_cast<const uint32_t*>(&key), sizeof(Key));
         }
+        size_t bytes() const { return fImage.image() ? fImage.image()->getSize() : 0; }
         SK_DECLARE_INTERNAL_LLIST_INTERFACE(Value);
     };
 
     bool get(const Key& key, skif::FilterResult<For::kOutput>* result) const override {
         SkASSERT(result);
 
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            if (v != fLRU.head()) {
-                fLRU.remove(v);
-                fLRU.addToHead(v);
+        Shard& shard = this->shardFor(key);
+        SkAutoMutexExclusive mutex(shard.fMutex);
+        if (Value* v = shard.fLookup.find(key)) {
+            if (v != shard.fLRU.head()) {
+                shard.fLRU.remove(v);
+                shard.fLRU.addToHead(v);
             }
+            v->fLastUse = fUseCount.fetch_add(1, std::memory_order_relaxed);
 
             *result = v->fImage;
             return true;
@@ -69,61 +86,172 @@ public:
 
     void set(const Key& key, const SkImageFilter* filter,
              const skif::FilterResult<For::kOutput>& result) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            this->removeInternal(v);
-        }
+        Shard& shard = this->shardFor(key);
         Value* v = new Value(key, result, filter);
-        fLookup.add(v);
-        fLRU.addToHead(v);
-        fCurrentBytes += result.image() ? result.image()->getSize() : 0;
-        if (auto* values = fImageFilterValues.find(filter)) {
-            values->push_back(v);
-        } else {
-            fImageFilterValues.set(filter, {v});
-        }
+        {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            if (Value* existing = shard.fLookup.find(key)) {
+                this->removeInternal(&shard, existing);
+            }
+            v->fLastUse = fUseCount.fetch_add(1, std::memory_order_relaxed);
+            shard.fLookup.add(v);
+            shard.fLRU.addToHead(v);
+            shard.fBytes += v->bytes();
+            fTotalBytes.fetch_add(v->bytes(), std::memory_order_relaxed);
+            if (auto* values = shard.fImageFilterValues.find(filter)) {
+                values->push_back(v);
+            } else {
+                shard.fImageFilterValues.set(filter, {v});
+            }
 
-        while (fCurrentBytes > fMaxBytes) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            if (tail == v) {
-                break;
+            // Make room in our own shard first, if it is over its share, since we already hold
+            // its lock.
+            const size_t maxBytes = this->getTotalByteLimit();
+            const size_t shardMaxBytes = maxBytes / kShardCount;
+            while (shard.fBytes > shardMaxBytes && this->getTotalBytesUsed() > maxBytes) {
+                Value* tail = shard.fLRU.tail();
+                SkASSERT(tail);
+                if (tail == v) {
+                    break;
+                }
+                this->removeInternal(&shard, tail);
             }
-            this->removeInternal(tail);
         }
+        // Then take from the other shards if that wasn't enough. 'v' is only compared, never
+        // dereferenced, since another thread may have already replaced it.
+        this->purgeToBytes(this->getTotalByteLimit(), v);
     }
 
     void purge() override {
-        SkAutoMutexExclusive mutex(fMutex);
-        while (fCurrentBytes > 0) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            this->removeInternal(tail);
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            while (Value* tail = shard.fLRU.tail()) {
+                this->removeInternal(&shard, tail);
+            }
         }
     }
 
     void purgeByImageFilter(const SkImageFilter* filter) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        auto* values = fImageFilterValues.find(filter);
-        if (!values) {
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            auto* values = shard.fImageFilterValues.find(filter);
+            if (!values) {
+                continue;
+            }
+            for (Value* v : *values) {
+                // We set the filter to be null so that removeInternal() won't delete from values
+                // while we're iterating over it.
+                v->fFilter = nullptr;
+                this->removeInternal(&shard, v);
+            }
+            shard.fImageFilterValues.remove(filter);
+        }
+    }
+
+    void purgeToBytes(size_t bytes) override { this->purgeToBytes(bytes, nullptr); }
+
+    size_t getTotalBytesUsed() const override {
+        return fTotalBytes.load(std::memory_order_relaxed);
+    }
+
+    size_t getTotalByteLimit() const override {
+        return fMaxBytes.load(std::memory_order_relaxed);
+    }
+
+    size_t setTotalByteLimit(size_t newLimit) override {
+        size_t prevLimit = fMaxBytes.exchange(newLimit, std::memory_order_relaxed);
+        if (newLimit < prevLimit) {
+            this->purgeToBytes(newLimit);
+        }
+        return prevLimit;
+    }
+
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump) const override {
+        dump->dumpNumericValue(kImageFilterCacheDumpName, "size", "bytes",
+                               this->getTotalBytesUsed());
+        dump->dumpNumericValue(kImageFilterCacheDumpName, "budget_size", "bytes",
+                               this->getTotalByteLimit());
+        dump->setMemoryBacking(kImageFilterCacheDumpName, "malloc", nullptr);
+        if (dump->getRequestedDetails() == SkTraceMemoryDump::kLight_LevelOfDetail) {
             return;
         }
-        for (Value* v : *values) {
-            // We set the filter to be null so that removeInternal() won't delete from values while
-            // we're iterating over it.
-            v->fFilter = nullptr;
-            this->removeInternal(v);
+
+        for (int i = 0; i < kShardCount; ++i) {
+            const Shard& shard = fShards[i];
+            size_t bytes;
+            int count;
+            {
+                SkAutoMutexExclusive mutex(shard.fMutex);
+                bytes = shard.fBytes;
+                count = shard.fLookup.count();
+            }
+            SkString dumpName = SkStringPrintf("%s/shard_%d", kImageFilterCacheDumpName, i);
+            dump->dumpNumericValue(dumpName.c_str(), "size", "bytes", bytes);
+            dump->dumpNumericValue(dumpName.c_str(), "result_count", "objects", count);
         }
-        fImageFilterValues.remove(filter);
     }
 
-    SkDEBUGCODE(int count() const override { return fLookup.count(); })
+    SkDEBUGCODE(int count() const override {
+        int count = 0;
+        for (const Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            count += shard.fLookup.count();
+        }
+        return count;
+    })
 private:
-    void removeInternal(Value* v) {
+    static constexpr int kShardBits = 3;
+    static constexpr int kShardCount = 1 << kShardBits;
+
+    struct Shard {
+        SkTDynamicHash<Value, Key>                            fLookup;
+        SkTInternalLList<Value>                               fLRU;
+        // Value* always points to an item in fLookup.
+        SkTHashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
+        size_t                                                fBytes = 0;
+        mutable SkMutex                                       fMutex;
+    };
+
+    Shard& shardFor(const Key& key) const {
+        // The top bits, since SkTDynamicHash indexes each shard's table with the bottom ones.
+        return fShards[Value::Hash(key) >> (32 - kShardBits)];
+    }
+
+    // Purges across all shards, oldest first, until at most 'bytes' are in use. Each step only
+    // holds one shard's lock, so this can run alongside get() and set() on other threads.
+    void purgeToBytes(size_t bytes, const Value* keep) {
+        while (this->getTotalBytesUsed() > bytes) {
+            // Find the shard whose least recently used result is the oldest.
+            Shard* oldest = nullptr;
+            uint64_t oldestUse = UINT64_MAX;
+            for (Shard& shard : fShards) {
+                SkAutoMutexExclusive mutex(shard.fMutex);
+                Value* tail = shard.fLRU.tail();
+                if (tail && tail != keep && tail->fLastUse < oldestUse) {
+                    oldest = &shard;
+                    oldestUse = tail->fLastUse;
+                }
+            }
+            if (!oldest) {
+                break;
+            }
+
+            SkAutoMutexExclusive mutex(oldest->fMutex);
+            // The tail may have been found or replaced since we looked, but it is still a
+            // reasonable choice to purge.
+            Value* tail = oldest->fLRU.tail();
+            if (tail && tail != keep) {
+                this->removeInternal(oldest, tail);
+            }
+        }
+    }
+
+    // Must be called with the shard's lock held.
+    void removeInternal(Shard* shard, Value* v) {
         if (v->fFilter) {
-            if (auto* values = fImageFilterValues.find(v->fFilter)) {
+            if (auto* values = shard->fImageFilterValues.find(v->fFilter)) {
                 if (values->size() == 1 && (*values)[0] == v) {
-                    fImageFilterValues.remove(v->fFilter);
+                    shard->fImageFilterValues.remove(v->fFilter);
                 } else {
                     for (auto it = values->begin(); it != values->end(); ++it) {
                         if (*it == v) {
@@ -134,19 +262,17 @@ private:
                 }
             }
         }
-        fCurrentBytes -= v->fImage.image() ? v->fImage.image()->getSize() : 0;
-        fLRU.remove(v);
-        fLookup.remove(v->fKey);
+        shard->fBytes -= v->bytes();
+        fTotalBytes.fetch_sub(v->bytes(), std::memory_order_relaxed);
+        shard->fLRU.remove(v);
+        shard->fLookup.remove(v->fKey);
         delete v;
     }
 private:
-    SkTDynamicHash<Value, Key>                            fLookup;
-    mutable SkTInternalLList<Value>                       fLRU;
-    // Value* always points to an item in fLookup.
-    SkTHashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
-    size_t                                                fMaxBytes;
-    size_t                                                fCurrentBytes;
-    mutable SkMutex                                       fMutex;
+    mutable Shard                 fShards[kShardCount];
+    std::atomic<size_t>           fMaxBytes;
+    std::atomic<size_t>           fTotalBytes;
+    mutable std::atomic<uint64_t> fUseCount;
 };
 
 } // namespace
@@ -162,3 +288,19 @@ SkImageFilterCache* SkImageFilterCache::Get() {
     once([]{ cache = SkImageFilterCache::Create(kDefaultCacheSize); });
     return cache;
 }
+
+size_t SkGraphics::GetImageFilterCacheTotalBytesUsed() {
+    return SkImageFilterCache::Get()->getTotalBytesUsed();
+}
+
+size_t SkGraphics::GetImageFilterCacheTotalByteLimit() {
+    return SkImageFilterCache::Get()->getTotalByteLimit();
+}
+
+size_t SkGraphics::SetImageFilterCacheTotalByteLimit(size_t newLimit) {
+    return SkImageFilterCache::Get()->setTotalByteLimit(newLimit);
+}
+
+void SkGraphics::PurgeImageFilterCacheToBytes(size_t bytes) {
+    SkImageFilterCache::Get()->purgeToBytes(bytes);
+}
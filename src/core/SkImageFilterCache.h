@@ -14,6 +14,7 @@
 
 struct SkIPoint;
 class SkImageFilter;
+class SkTraceMemoryDump;
 
 struct SkImageFilterCacheKey {
     SkImageFilterCacheKey(const uint32_t uniqueID, const SkMatrix& matrix,
@@ -69,6 +70,16 @@ public:
                      const skif::FilterResult<For::kOutput>& result) = 0;
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
+    // Purges the least recently used results until at most 'bytes' are in use. Unlike purge(),
+    // this keeps the results that are still being reused, e.g. when trimming under memory pressure.
+    virtual void purgeToBytes(size_t bytes) = 0;
+
+    virtual size_t getTotalBytesUsed() const = 0;
+    virtual size_t getTotalByteLimit() const = 0;
+    // Returns the previous limit. Lowering the limit purges down to it.
+    virtual size_t setTotalByteLimit(size_t newLimit) = 0;
+
+    virtual void dumpMemoryStatistics(SkTraceMemoryDump*) const = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
 };
 
@@ -8,6 +8,7 @@
 #ifndef SkImageFilterTypes_DEFINED
 #define SkImageFilterTypes_DEFINED
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMatrix.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
@@ -602,7 +603,8 @@ public:
         , fCache(cache)
         , fColorType(colorType)
         , fColorSpace(colorSpace)
-        , fSource(sk_ref_sp(source), LayerSpace<SkIPoint>({0, 0})) {}
+        , fSource(sk_ref_sp(source), LayerSpace<SkIPoint>({0, 0}))
+        , fExecutor(&SkExecutor::GetDefault()) {}
 
     Context(const Mapping& mapping, const LayerSpace<SkIRect>& desiredOutput,
             SkImageFilterCache* cache, SkColorType colorType, SkColorSpace* colorSpace,
@@ -612,7 +614,8 @@ public:
         , fCache(cache)
         , fColorType(colorType)
         , fColorSpace(colorSpace)
-        , fSource(source) {}
+        , fSource(source)
+        , fExecutor(&SkExecutor::GetDefault()) {}
 
     // The mapping that defines the transformation from local parameter space of the filters to the
     // layer space where the image filters are evaluated, as well as the remaining transformation
@@ -659,6 +662,11 @@ public:
 
     // True if image filtering should occur on the GPU if possible.
     bool gpuBacked() const { return fSource.image()->isTextureBacked(); }
+    // Raster filtering may split its work into tasks on this executor, or keep it on the calling
+    // thread when this returns null (always on the GPU). Unless overridden with withExecutor(),
+    // this is SkExecutor::GetDefault(), so clients opt in to multithreaded filtering with
+    // SkExecutor::SetDefault().
+    SkExecutor* executor() const { return this->gpuBacked() ? nullptr : fExecutor; }
     // The recording context to use when computing the filter with the GPU.
     GrRecordingContext* getContext() const { return fSource.image()->getContext(); }
 
@@ -683,11 +691,22 @@ public:
 
     // Create a new context that matches this context, but with an overridden layer space.
     Context withNewMapping(const Mapping& mapping) const {
-        return Context(mapping, fDesiredOutput, fCache, fColorType, fColorSpace, fSource);
+        Context ctx = *this;
+        ctx.fMapping = mapping;
+        return ctx;
     }
     // Create a new context that matches this context, but with an overridden desired output rect.
     Context withNewDesiredOutput(const LayerSpace<SkIRect>& desiredOutput) const {
-        return Context(fMapping, desiredOutput, fCache, fColorType, fColorSpace, fSource);
+        Context ctx = *this;
+        ctx.fDesiredOutput = desiredOutput;
+        return ctx;
+    }
+    // Create a new context that matches this context, but splits raster work across 'executor'
+    // (or keeps it all on the calling thread, if null).
+    Context withExecutor(SkExecutor* executor) const {
+        Context ctx = *this;
+        ctx.fExecutor = executor;
+        return ctx;
     }
 
 private:
@@ -699,6 +718,7 @@ private:
     // is bounded by the device, so this can be a bare pointer.
     SkColorSpace*             fColorSpace;
     FilterResult<For::kInput> fSource;
+    SkExecutor*               fExecutor;
 };
 
 } // end namespace skif
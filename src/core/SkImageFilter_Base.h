@@ -16,6 +16,8 @@
 
 #include "src/core/SkImageFilterTypes.h"
 
+#include <functional>
+
 class GrFragmentProcessor;
 class GrRecordingContext;
 
@@ -280,6 +282,44 @@ protected:
     // other filters to need to call it.
     Context mapContext(const Context& ctx) const;
 
+    /**
+     *  Like filterInput(), but on the raster backend a run of input filters that are just color
+     *  filters or offsets (without crop rects) is not evaluated node by node. The input at the
+     *  bottom of the run is filtered instead, and the run's composed color filter is returned in
+     *  'colorFilter' (or null if the run has none). The caller must apply it to the image when
+     *  drawing it, which fuses the whole run into that one draw. Color filters that affect
+     *  transparent black end the run, since they need to be applied outside of the image too.
+     */
+    sk_sp<SkSpecialImage> filterInputForDraw(int index, const Context& ctx, SkIPoint* offset,
+                                             sk_sp<SkColorFilter>* colorFilter) const;
+
+    /**
+     *  Filters all of this filter's inputs, as filterInput() would one at a time, storing the
+     *  results in images[] and offsets[] (which must have countInputs() entries). On the raster
+     *  backend, distinct input filters are evaluated concurrently on the context's executor; an
+     *  input filter repeated at several indices is only evaluated once. If colorFilters[] is not
+     *  null, the inputs are filtered with filterInputForDraw() instead.
+     */
+    void filterInputs(const Context& ctx, sk_sp<SkSpecialImage> images[], SkIPoint offsets[],
+                      sk_sp<SkColorFilter> colorFilters[] = nullptr) const;
+
+    /**
+     *  Calls rows(top, bottom) for horizontal bands covering [0, height) of a width x height
+     *  output. The bands may run concurrently on the context's executor, so 'rows' must only
+     *  write to the rows it is given.
+     */
+    static void ForEachRowBand(const Context&, int width, int height,
+                               const std::function<void(int top, int bottom)>& rows);
+
+    /**
+     *  Calls draw() with the canvas of 'surface', or, on the raster backend, with canvases
+     *  clipped to horizontal bands of it that are drawn concurrently on the context's executor.
+     *  'draw' must produce the same pixels no matter how the surface is split into bands, i.e.
+     *  it should only issue pixel-local draws.
+     */
+    static void DrawInRowBands(const Context&, SkSpecialSurface* surface,
+                               const std::function<void(SkCanvas*)>& draw);
+
 #if SK_SUPPORT_GPU
     static sk_sp<SkSpecialImage> DrawWithFP(GrRecordingContext* context,
                                             std::unique_ptr<GrFragmentProcessor> fp,
@@ -328,6 +368,12 @@ private:
      */
     virtual bool onIsColorFilterNode(SkColorFilter** /*filterPtr*/) const { return false; }
 
+    /**
+     *  Return true (and the offset, in parameter space) if this node in the DAG just translates
+     *  its input w/o CropRect constraints.
+     */
+    virtual bool onIsOffsetNode(SkVector* /*offset*/) const { return false; }
+
     /**
      *  Return true if this filter can map from its parameter space to a layer space described by an
      *  arbitrary transformation matrix. If this returns false, the filter only needs to worry about
@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkHalf.h"
@@ -15,6 +16,8 @@
 #include "include/private/SkVx.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMipmap.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 #include <new>
 
 //
@@ -381,6 +384,44 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+
+// Fills dst by running proc over each pair (or triple) of src rows, in bands on executor.
+static void downsample_level(FilterProc* proc, const SkPixmap& src, const SkPixmap& dst,
+                             SkExecutor* executor) {
+    const int width = dst.width();
+    SkForEachRowBand(executor, width, dst.height(), [&](int top, int bottom) {
+        const char* srcRow = (const char*)src.addr() + 2 * top * src.rowBytes();
+        char* dstRow = (char*)dst.writable_addr() + top * dst.rowBytes();
+        for (int y = top; y < bottom; y++) {
+            proc(dstRow, srcRow, src.rowBytes(), width);
+            srcRow += src.rowBytes() * 2; // jump two rows
+            dstRow += dst.rowBytes();
+        }
+    });
+}
+
+void SkMipmap::PortableDownsample2x2(SkColorType ct, void* dst, const void* src, size_t srcRB,
+                                     int count) {
+    switch (ct) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+            downsample_2_2<ColorTypeFilter_8888>(dst, src, srcRB, count);
+            break;
+        case kAlpha_8_SkColorType:
+        case kGray_8_SkColorType:
+            downsample_2_2<ColorTypeFilter_8>(dst, src, srcRB, count);
+            break;
+        case kRGBA_F16Norm_SkColorType:
+        case kRGBA_F16_SkColorType:
+            downsample_2_2<ColorTypeFilter_RGBA_F16>(dst, src, srcRB, count);
+            break;
+        default:
+            SkDEBUGFAIL("No SkOpts 2x2 downsampler for this color type.");
+            break;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
@@ -395,9 +436,7 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
 }
 
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
-                          bool computeContents) {
-    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
-
+                          bool computeContents, SkExecutor* executor) {
     FilterProc* proc_1_2 = nullptr;
     FilterProc* proc_1_3 = nullptr;
     FilterProc* proc_2_1 = nullptr;
@@ -416,7 +455,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
+            proc_2_2 = SkOpts::downsample_2_2_8888;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
@@ -447,7 +486,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
+            proc_2_2 = SkOpts::downsample_2_2_a8;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
@@ -458,7 +497,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_1_2 = downsample_1_2<ColorTypeFilter_RGBA_F16>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_RGBA_F16>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_RGBA_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_RGBA_F16>;
+            proc_2_2 = SkOpts::downsample_2_2_f16;
             proc_2_3 = downsample_2_3<ColorTypeFilter_RGBA_F16>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_RGBA_F16>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_RGBA_F16>;
@@ -633,15 +672,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (computeContents) {
-            const void* srcBasePtr = srcPM.addr();
-            void* dstBasePtr = dstPM.writable_addr();
-
-            const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
-            }
+            downsample_level(proc, srcPM, dstPM, executor);
         }
         srcPM = dstPM;
         addr += height * rowBytes;
@@ -787,12 +818,13 @@ bool SkMipmap::validForRootLevel(const SkImageInfo& root) const {
 
 // Helper which extracts a pixmap from the src bitmap
 //
-SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact,
+                          SkExecutor* executor) {
     SkPixmap srcPixmap;
     if (!src.peekPixels(&srcPixmap)) {
         return nullptr;
     }
-    return Build(srcPixmap, fact);
+    return Build(srcPixmap, fact, true, executor);
 }
 
 int SkMipmap::countLevels() const {
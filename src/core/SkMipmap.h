@@ -18,6 +18,7 @@
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -33,10 +34,17 @@ class SkMipmap : public SkCachedData {
 public:
     // Allocate and fill-in a mipmap. If computeContents is false, we just allocated
     // and compute the sizes/rowbytes, but leave the pixel-data uninitialized.
+    // Big levels are computed in bands of rows on executor, if there is one.
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
-                           bool computeContents = true);
+                           bool computeContents = true, SkExecutor* executor = nullptr);
 
-    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
+    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc,
+                           SkExecutor* executor = nullptr);
+
+    // The portable 2x2 box filter for 8888, A8/Gray8 or F16 rows, which the faster
+    // SkOpts::downsample_2_2_* must match exactly. Exposed for tests.
+    static void PortableDownsample2x2(SkColorType, void* dst, const void* src, size_t srcRB,
+                                      int count);
 
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
@@ -56,6 +56,16 @@ namespace SkOpts {
 
     extern float (*cubic_solver)(float, float, float, float);
 
+    // Three pass box blur of srcH lines of 8888 pixels; see SkBlurImageFilter_opts.h.
+    extern void (*box_blur)(int window, int border, int srcLeft, int srcRight, int dstRight,
+                            const uint32_t* src, int srcXStride, int srcYStride, int srcH,
+                                  uint32_t* dst, int dstXStride, int dstYStride);
+
+    // 2x2 box filters for SkMipmap, halving two rows of pixels; see SkMipmap_opts.h.
+    extern void (*downsample_2_2_8888)(void* dst, const void* src, size_t srcRB, int count);
+    extern void (*downsample_2_2_a8  )(void* dst, const void* src, size_t srcRB, int count);
+    extern void (*downsample_2_2_f16 )(void* dst, const void* src, size_t srcRB, int count);
+
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
         return hash_fn(data, bytes, seed);
     }
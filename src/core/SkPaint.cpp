@@ -30,6 +30,7 @@
 #include "src/core/SkSafeRange.h"
 #include "src/core/SkStringUtils.h"
 #include "src/core/SkStroke.h"
+#include "src/core/SkStrokeCache.h"
 #include "src/core/SkSurfacePriv.h"
 #include "src/core/SkTLazy.h"
 #include "src/core/SkWriteBuffer.h"
@@ -347,7 +348,10 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
         srcPtr = &tmpPath;
     }
 
-    if (!rec.applyToPath(dst, *srcPtr)) {
+    // Path effects make new paths every time, so only the original path is worth caching.
+    bool stroked = srcPtr == &src ? SkStrokeCache::ApplyToPath(rec, dst, src)
+                                  : rec.applyToPath(dst, *srcPtr);
+    if (!stroked) {
         if (srcPtr == &tmpPath) {
             // If path's were copy-on-write, this trick would not be needed.
             // As it is, we want to save making a deep-copy from tmpPath -> dst
@@ -7,10 +7,14 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSerialProcs.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkBitmapDevice.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkPictureCommon.h"
@@ -18,6 +22,9 @@
 #include "src/core/SkPicturePlayback.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordSerialize.h"
+#include "src/core/SkTaskGroup.h"
 #include <atomic>
 
 // When we read/write the SkPictInfo via a stream, we have a sentinel byte right after the info.
@@ -30,6 +37,7 @@ enum {
     kFailure_TrailingStreamByteAfterPictInfo     = 0,   // nothing follows
     kPictureData_TrailingStreamByteAfterPictInfo = 1,   // SkPictureData follows
     kCustom_TrailingStreamByteAfterPictInfo      = 2,   // -size32 follows
+    kRecord_TrailingStreamByteAfterPictInfo      = 3,   // SkRecordSerialize() data follows
 };
 
 /* SkPicture impl.  This handles generic responsibilities like unique IDs and serialization. */
@@ -180,6 +188,8 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
             }
             return procs.fPictureProc(data->data(), size, procs.fPictureCtx);
         }
+        case kRecord_TrailingStreamByteAfterPictInfo:
+            return SkRecordDeserialize(stream, info, procs);
         default:    // fall out to error return
             break;
     }
@@ -287,6 +297,125 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
     }
 }
 
+void SkPicturePriv::SerializeRecord(const SkPicture* picture, SkWStream* stream,
+                                    const SkSerialProcs* procsPtr, bool writeIndex) {
+    SkSerialProcs procs;
+    if (procsPtr) {
+        procs = *procsPtr;
+    }
+
+    // The payload aligns itself relative to the start of the stream, so write the header first.
+    SkPictInfo info = picture->createHeader();
+    SkDynamicMemoryWStream record;
+    record.write(&info, sizeof(info));
+    record.write8(kRecord_TrailingStreamByteAfterPictInfo);
+    if (procs.fPictureProc || !SkRecordSerialize(picture, &record, procs, writeIndex)) {
+        picture->serialize(stream, procsPtr);
+        return;
+    }
+    record.writeToAndReset(stream);
+}
+
+sk_sp<SkPicture> SkPicturePriv::MakeLazyFromData(sk_sp<SkData> data,
+                                                 const SkDeserialProcs* procsPtr) {
+    if (!data) {
+        return nullptr;
+    }
+    SkDeserialProcs procs;
+    if (procsPtr) {
+        procs = *procsPtr;
+    }
+
+    SkMemoryStream stream(data);
+    SkPictInfo info;
+    uint8_t trailingStreamByte;
+    if (SkPicture::StreamIsSKP(&stream, &info) && stream.readU8(&trailingStreamByte) &&
+        trailingStreamByte == kRecord_TrailingStreamByteAfterPictInfo) {
+        if (auto picture = SkRecordDeserializeLazy(&stream, info, procs)) {
+            return picture;
+        }
+    }
+    return SkPicture::MakeFromData(data.get(), procsPtr);
+}
+
+// Does drawing this read back pixels it doesn't draw?  Tiles can't draw those independently.
+static bool reads_back_dst(const SkBigPicture* picture);
+
+namespace {
+struct ReadsBackDst {
+    bool operator()(const SkRecords::SaveLayer& op) {
+        return op.backdrop || (op.saveLayerFlags & SkCanvas::kInitWithPrevious_SaveLayerFlag);
+    }
+    bool operator()(const SkRecords::SaveBehind&)    { return true; }
+    bool operator()(const SkRecords::DrawDrawable&)  { return true; }
+    bool operator()(const SkRecords::DrawPicture& op) {
+        // We can't look inside other kinds of pictures.  (Pictures small enough to be something
+        // else are unrolled into their parent when it's recorded.)
+        const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(op.picture);
+        return !big || reads_back_dst(big);
+    }
+    template <typename T> bool operator()(const T&)  { return false; }
+};
+}  // namespace
+
+static bool reads_back_dst(const SkBigPicture* picture) {
+    const SkRecord& record = *picture->record();
+    for (int i = 0; i < record.count(); i++) {
+        if (record.visit(i, ReadsBackDst())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SkPicturePriv::PlaybackTiled(const SkPicture* picture, const SkPixmap& dst,
+                                  const SkMatrix& matrix, SkExecutor* executor,
+                                  int tileWidth, int tileHeight) {
+    SkASSERT(picture && tileWidth > 0 && tileHeight > 0);
+    if (dst.width() <= 0 || dst.height() <= 0) {
+        return;
+    }
+
+    const int xTiles = (dst.width()  + tileWidth  - 1) / tileWidth,
+              yTiles = (dst.height() + tileHeight - 1) / tileHeight;
+
+    const SkBigPicture* big = picture->asSkBigPicture();
+    SkMatrix inverse;
+    if (xTiles * yTiles == 1 || !big || !matrix.invert(&inverse) || reads_back_dst(big)) {
+        SkBitmap bitmap;
+        if (bitmap.installPixels(dst)) {
+            SkCanvas canvas(bitmap);
+            canvas.concat(matrix);
+            picture->playback(&canvas);
+        }
+        return;
+    }
+
+    // Each tile plays the picture back onto a device over all of dst, exactly as a single
+    // playback would, except that its device only writes the tile's pixels and it only draws
+    // the ops its BBH query finds.  Clipping to the tile instead would clip the geometry too,
+    // and scan converters don't round edges clipped at a seam the same as the originals.
+    auto drawTile = [&](int i) {
+        SkIRect tile = SkIRect::MakeXYWH((i % xTiles) * tileWidth,
+                                         (i / xTiles) * tileHeight,
+                                         tileWidth, tileHeight);
+        SkBitmap bitmap;
+        if (!tile.intersect(dst.bounds()) || !bitmap.installPixels(dst)) {
+            return;
+        }
+        auto device = sk_make_sp<SkBitmapDevice>(bitmap);
+        device->setBlitBounds(tile);
+        SkCanvas canvas(device);
+        canvas.concat(matrix);
+        // Like SkCanvas::getLocalClipBounds(), outset by a pixel for anti-aliasing.
+        big->playbackIntersecting(&canvas, inverse.mapRect(SkRect::Make(tile.makeOutset(1, 1))));
+    };
+
+    SkTaskGroup tasks(executor ? *executor : SkExecutor::GetDefault());
+    tasks.batch(xTiles * yTiles, drawTile);
+    tasks.wait();
+}
+
 void SkPicturePriv::Flatten(const sk_sp<const SkPicture> picture, SkWriteBuffer& buffer) {
     SkPictInfo info = picture->createHeader();
     std::unique_ptr<SkPictureData> data(picture->backport());
@@ -10,8 +10,14 @@
 
 #include "include/core/SkPicture.h"
 
+class SkData;
+class SkExecutor;
+class SkPixmap;
 class SkReadBuffer;
+class SkWStream;
 class SkWriteBuffer;
+struct SkDeserialProcs;
+struct SkSerialProcs;
 
 class SkPicturePriv {
 public:
@@ -30,6 +36,38 @@ public:
      */
     static void Flatten(const sk_sp<const SkPicture> , SkWriteBuffer& buffer);
 
+    /**
+     *  Serialize to a stream using the SkRecord format (see SkRecordSerialize.h), which
+     *  SkPicture::MakeFromStream() recognizes and loads without replaying the ops through a
+     *  recorder.  Falls back to SkPicture::serialize() if procs has a picture proc or the
+     *  picture can't be expressed in that format.  With writeIndex, the data can also be
+     *  loaded by MakeLazyFromData().
+     */
+    static void SerializeRecord(const SkPicture*, SkWStream*, const SkSerialProcs* = nullptr,
+                                bool writeIndex = false);
+
+    /**
+     *  Like SkPicture::MakeFromData(), but if data holds an SkRecord format picture written with
+     *  an index, the picture plays back directly from data (e.g. a mapped file), decoding only
+     *  the ops that intersect the clip.  Other data is loaded as usual.
+     */
+    static sk_sp<SkPicture> MakeLazyFromData(sk_sp<SkData>, const SkDeserialProcs* = nullptr);
+
+    /**
+     *  Draws the picture into dst, transformed by matrix, producing exactly the pixels a
+     *  playback into a raster canvas over dst would.  dst is split into tiles of at most
+     *  tileWidth x tileHeight, and each tile plays back on the executor (the default executor if
+     *  null), drawing only the ops its BBH query finds and writing only its own pixels.  Returns
+     *  once every tile has been drawn.
+     *
+     *  Ops are rasterized whole for every tile they touch, so large paths cost more the more
+     *  tiles they cross.  Pictures that aren't SkBigPictures, or that read back what they draw
+     *  over (backdrop filters, kInitWithPrevious layers, saveBehind(), drawables), play back on
+     *  the calling thread.
+     */
+    static void PlaybackTiled(const SkPicture*, const SkPixmap& dst, const SkMatrix& matrix,
+                              SkExecutor* = nullptr, int tileWidth = 256, int tileHeight = 256);
+
     // Returns NULL if this is not an SkBigPicture.
     static const SkBigPicture* AsSkBigPicture(const sk_sp<const SkPicture> picture) {
         return picture->asSkBigPicture();
@@ -28,7 +28,8 @@ SkPictureRecorder::SkPictureRecorder() {
 SkPictureRecorder::~SkPictureRecorder() {}
 
 SkCanvas* SkPictureRecorder::beginRecording(const SkRect& userCullRect,
-                                            sk_sp<SkBBoxHierarchy> bbh) {
+                                            sk_sp<SkBBoxHierarchy> bbh,
+                                            uint32_t recordFlags) {
     const SkRect cullRect = userCullRect.isEmpty() ? SkRect::MakeEmpty() : userCullRect;
 
     fCullRect = cullRect;
@@ -38,12 +39,14 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& userCullRect,
         fRecord.reset(new SkRecord);
     }
     fRecorder->reset(fRecord.get(), cullRect, fMiniRecorder.get());
+    fRecorder->setDedupContent(SkToBool(recordFlags & kDeduplicateContent_RecordFlag));
     fActivelyRecording = true;
     return this->getRecordingCanvas();
 }
 
-SkCanvas* SkPictureRecorder::beginRecording(const SkRect& bounds, SkBBHFactory* factory) {
-    return this->beginRecording(bounds, factory ? (*factory)() : nullptr);
+SkCanvas* SkPictureRecorder::beginRecording(const SkRect& bounds, SkBBHFactory* factory,
+                                            uint32_t recordFlags) {
+    return this->beginRecording(bounds, factory ? (*factory)() : nullptr, recordFlags);
 }
 
 SkCanvas* SkPictureRecorder::getRecordingCanvas() {
@@ -53,6 +56,7 @@ SkCanvas* SkPictureRecorder::getRecordingCanvas() {
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
+    fRecorder->forgetContent();    // The picture holds everything it needs.
 
     if (fRecord->count() == 0) {
         auto pic = fMiniRecorder->detachAsPicture(fBBH ? nullptr : &fCullRect);
@@ -127,6 +131,7 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable() {
     fActivelyRecording = false;
     fRecorder->flushMiniRecorder();
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
+    fRecorder->forgetContent();    // The drawable holds everything it needs.
 
     SkRecordOptimize(fRecord.get());
 
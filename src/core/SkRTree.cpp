@@ -7,158 +7,354 @@
 
 #include "src/core/SkRTree.h"
 
-SkRTree::SkRTree() : fCount(0) {}
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkMathPriv.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkWriteBuffer.h"
 
-void SkRTree::insert(const SkRect boundsArray[], int N) {
-    SkASSERT(0 == fCount);
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
 
-    std::vector<Branch> branches;
-    branches.reserve(N);
+// Spreads the low 16 bits of x out into the even bits.
+template <typename T>
+static T interleave(T x) {
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
 
-    for (int i = 0; i < N; i++) {
-        const SkRect& bounds = boundsArray[i];
-        if (bounds.isEmpty()) {
-            continue;
-        }
+// Returns the distance along a Hilbert curve filling the 65536x65536 grid to (x,y).
+//
+// The textbook version walks down the curve a level at a time, rotating (x,y) into each quadrant,
+// which costs a hard-to-predict branch per level.  This branch-free version instead computes the
+// rotation state for all 16 levels at once with a parallel prefix scan over the bits of x and y.
+// See https://github.com/rawrunprotected/hilbert_curves (public domain).
+// T may be a vector, computing several distances at once.
+template <typename T>
+static T hilbert_distance(T x, T y) {
+    T A, B, C, D;
+    {
+        const T a = x ^ y,
+                       b = 0xFFFF ^ a,
+                       c = 0xFFFF ^ (x | y),
+                       d = x & (y ^ 0xFFFF);
+        A = a | (b >> 1);
+        B = (a >> 1) ^ a;
+        C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+        D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+    }
+    for (int shift : {2, 4}) {
+        const T a = A, b = B, c = C, d = D;
+        A = (a & (a >> shift)) ^ (b & (b >> shift));
+        B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+        C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+        D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+    }
+    {
+        const T a = A, b = B, c = C, d = D;
+        C ^= (a & (c >> 8)) ^ (b & (d >> 8));
+        D ^= (b & (c >> 8)) ^ ((a ^ b) & (d >> 8));
+    }
+
+    const T a  = C ^ (C >> 1),
+                   b  = D ^ (D >> 1),
+                   i0 = x ^ y,
+                   i1 = b | (0xFFFF ^ (i0 | a));
+    return (interleave(i1) << 1) | interleave(i0);
+}
 
-        Branch b;
-        b.fBounds = bounds;
-        b.fOpIndex = i;
-        branches.push_back(b);
+// Sorts the results of a search from start on.  Searches visit children in Hilbert order, but
+// callers like SkRecordDraw() need the ops in order.
+static void sort_results(std::vector<int>* results, size_t start) {
+    const auto begin = results->begin() + start;
+    const size_t count = results->end() - begin;
+    if (count < 64) {
+        std::sort(begin, results->end());
+        return;
     }
 
-    fCount = (int)branches.size();
-    if (fCount) {
-        if (1 == fCount) {
-            fNodes.reserve(1);
-            Node* n = this->allocateNodeAtLevel(0);
-            n->fNumChildren = 1;
-            n->fChildren[0] = branches[0];
-            fRoot.fSubtree = n;
-            fRoot.fBounds  = branches[0].fBounds;
-        } else {
-            fNodes.reserve(CountNodes(fCount));
-            fRoot = this->bulkLoad(&branches);
+    // Big searches tend to find most of what's in range, so it's cheaper to set bits and read
+    // them back than it is to sort.
+    const int maxIndex = *std::max_element(begin, results->end());
+    if ((size_t)maxIndex / 32 > count) {
+        std::sort(begin, results->end());
+        return;
+    }
+    std::vector<uint32_t> bits(maxIndex / 32 + 1);
+    for (auto it = begin; it != results->end(); ++it) {
+        bits[*it >> 5] |= 1u << (*it & 31);
+    }
+    auto out = begin;
+    for (size_t i = 0; i < bits.size(); i++) {
+        for (uint32_t word = bits[i]; word; word &= word - 1) {
+            *out++ = SkToInt(i * 32 + 31 - SkCLZ(word & (0 - word)));
         }
     }
+    // Only a tree from a bad buffer could have found the same op twice.
+    results->erase(out, results->end());
 }
 
-SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
-    SkDEBUGCODE(Node* p = fNodes.data());
-    fNodes.push_back(Node{});
-    Node& out = fNodes.back();
-    SkASSERT(fNodes.data() == p);  // If this fails, we didn't reserve() enough.
-    out.fNumChildren = 0;
-    out.fLevel = level;
-    return &out;
+void SkRTree::Node::reset(int level) {
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    std::fill_n(fLeft,   kMaxChildren, +inf);
+    std::fill_n(fTop,    kMaxChildren, +inf);
+    std::fill_n(fRight,  kMaxChildren, -inf);
+    std::fill_n(fBottom, kMaxChildren, -inf);
+    fNumChildren = 0;
+    fLevel = SkToU16(level);
 }
 
-// This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
-int SkRTree::CountNodes(int branches) {
-    if (branches == 1) {
-        return 1;
+void SkRTree::Node::append(const SkRect& bounds, int child) {
+    SkASSERT(fNumChildren < kMaxChildren);
+    fLeft    [fNumChildren] = bounds.fLeft;
+    fTop     [fNumChildren] = bounds.fTop;
+    fRight   [fNumChildren] = bounds.fRight;
+    fBottom  [fNumChildren] = bounds.fBottom;
+    fChildren[fNumChildren] = child;
+    fNumChildren++;
+}
+
+SkRect SkRTree::Node::bounds() const {
+    using F = skvx::Vec<kMaxChildren, float>;
+    // The unused slots' inverted bounds drop out of the min and max.
+    return {min(F::Load(fLeft)),  min(F::Load(fTop)),
+            max(F::Load(fRight)), max(F::Load(fBottom))};
+}
+
+uint32_t SkRTree::Node::intersects(const SkRect& query) const {
+    using F = skvx::Vec<kMaxChildren, float>;
+    // Children and query are both non-empty, so this matches SkRect::Intersects().
+    const auto hit = (F::Load(fLeft) < query.fRight ) & (query.fLeft < F::Load(fRight) ) &
+                     (F::Load(fTop)  < query.fBottom) & (query.fTop  < F::Load(fBottom));
+    if (!any(hit)) {
+        return 0;
+    }
+    // Unused slots never hit, so each lane can contribute its bit, ORed together in halves.
+    const auto bits = hit & skvx::Vec<kMaxChildren, int32_t>{1 <<  0, 1 <<  1, 1 <<  2, 1 <<  3,
+                                                             1 <<  4, 1 <<  5, 1 <<  6, 1 <<  7,
+                                                             1 <<  8, 1 <<  9, 1 << 10, 1 << 11,
+                                                             1 << 12, 1 << 13, 1 << 14, 1 << 15};
+    const auto b8 = bits.lo | bits.hi;
+    const auto b4 = b8.lo | b8.hi;
+    const auto b2 = b4.lo | b4.hi;
+    return (uint32_t)(b2[0] | b2[1]);
+}
+
+SkRTree::SkRTree() : fCount(0), fInOpOrder(true), fRootBounds(SkRect::MakeEmpty()) {}
+
+void SkRTree::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(0 == fCount);
+
+    SkRect total = SkRect::MakeEmpty();
+    int count = 0;
+    for (int i = 0; i < N; i++) {
+        if (!boundsArray[i].isEmpty()) {
+            total.join(boundsArray[i]);
+            count++;
+        }
     }
-    int numBranches = branches / kMaxChildren;
-    int remainder   = branches % kMaxChildren;
-    if (remainder > 0) {
-        numBranches++;
-        if (remainder >= kMinChildren) {
-            remainder = 0;
-        } else {
-            remainder = kMinChildren - remainder;
+    if (!count) {
+        return;
+    }
+
+    std::vector<Branch> branches(count);
+    if (count < kMinHilbertPackCount) {
+        // Small trees are cheap to search no matter how they are packed, so don't pay for
+        // sorting: pack in op order, which callers like Blink already give a reasonable x,y order.
+        for (int i = 0, n = 0; i < N; i++) {
+            if (!boundsArray[i].isEmpty()) {
+                branches[n++] = {boundsArray[i], i};
+            }
         }
+    } else {
+        HilbertSort(boundsArray, N, total, &branches);
+        fInOpOrder = false;
     }
-    int currentBranch = 0;
-    int nodes = 0;
-    while (currentBranch < branches) {
-        int incrementBy = kMaxChildren;
-        if (remainder != 0) {
-            if (remainder <= kMaxChildren - kMinChildren) {
-                incrementBy -= remainder;
-                remainder = 0;
-            } else {
-                incrementBy = kMinChildren;
-                remainder -= kMaxChildren - kMinChildren;
+
+    fCount = count;
+    fNodes.reserve(CountNodes(count));
+    this->bulkLoad(&branches);
+}
+
+void SkRTree::HilbertSort(const SkRect boundsArray[], int N, const SkRect& total,
+                          std::vector<Branch>* branches) {
+    const int count = (int)branches->size();
+
+    // Bucket the rects by the cell their centers fall in, in a grid over the total bounds with
+    // at least one cell per rect, numbering cells along a Hilbert curve.  A single counting sort
+    // pass then orders the rects by cell, keeping rects that share a cell in op order.
+    int order = 1;
+    while (order < 16 && (1 << (2 * order)) < count) {
+        order++;
+    }
+    using F4 = skvx::Vec<4, float>;
+    using U4 = skvx::Vec<4, uint32_t>;
+    const float cells = (float)((1 << order) - 1),
+                sx = total.width()  > 0 ? 0.5f * cells / total.width()  : 0,
+                sy = total.height() > 0 ? 0.5f * cells / total.height() : 0;
+    auto quantize = [&](const F4& v) {
+        // NaN (from infinite bounds) pins to 0.
+        const F4 q = if_then_else(v > 0, min(v, cells), F4(0));
+        return skvx::bit_pun<U4>(skvx::cast<int32_t>(q)) << (16 - order);
+    };
+
+    // Keys are computed four rects at a time, reading the last few from a zero-padded copy.
+    std::vector<uint32_t> cellOf(N),
+                          offsets((size_t)1 << (2 * order));
+    for (int i = 0; i < N; i += 4) {
+        SkRect tail[4] = {};
+        const SkRect* rects = boundsArray + i;
+        if (N - i < 4) {
+            std::copy(rects, rects + N - i, tail);
+            rects = tail;
+        }
+
+        const auto r  = skvx::Vec<16, float>::Load(rects);
+        const F4   cx = (skvx::shuffle<0,4,8,12>(r) - total.fLeft) +
+                        (skvx::shuffle<2,6,10,14>(r) - total.fLeft),
+                   cy = (skvx::shuffle<1,5,9,13>(r) - total.fTop) +
+                        (skvx::shuffle<3,7,11,15>(r) - total.fTop);
+        const U4 cell = hilbert_distance(quantize(cx * sx), quantize(cy * sy)) >> (32 - 2 * order);
+
+        for (int k = 0; k < std::min(4, N - i); k++) {
+            if (!boundsArray[i + k].isEmpty()) {
+                cellOf[i + k] = cell[k];
+                offsets[cell[k]]++;
             }
         }
-        nodes++;
-        currentBranch++;
-        for (int k = 1; k < incrementBy && currentBranch < branches; ++k) {
-            currentBranch++;
+    }
+    for (uint32_t i = 0, sum = 0; i < offsets.size(); i++) {
+        sum += std::exchange(offsets[i], sum);
+    }
+    for (int i = 0; i < N; i++) {
+        if (!boundsArray[i].isEmpty()) {
+            (*branches)[offsets[cellOf[i]]++] = {boundsArray[i], i};
         }
     }
-    return nodes + CountNodes(nodes);
+    SkASSERT(offsets.back() == (uint32_t)count);
+}
+
+int SkRTree::CountNodes(int branches) {
+    int nodes = 0;
+    do {
+        branches = (branches + kMaxChildren - 1) / kMaxChildren;
+        nodes += branches;
+    } while (branches > 1);
+    return nodes;
 }
 
-SkRTree::Branch SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
-    if (branches->size() == 1) { // Only one branch.  It will be the root.
-        return (*branches)[0];
+void SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
+    const int count = (int)branches->size(),
+              nodes = (count + kMaxChildren - 1) / kMaxChildren;
+
+    int next = 0;
+    for (int i = 0; i < nodes; i++) {
+        SkDEBUGCODE(const Node* p = fNodes.data());
+        fNodes.emplace_back();
+        SkASSERT(fNodes.data() == p);  // If this fails, we didn't reserve() enough.
+
+        // Spread the branches evenly, so each node gets either count/nodes or one more.
+        Node& node = fNodes.back();
+        node.reset(level);
+        for (const int end = (int)((int64_t)count * (i + 1) / nodes); next < end; next++) {
+            node.append((*branches)[next].fBounds, (*branches)[next].fIndex);
+        }
+        // Each node is written after the ones it reads, so this never overtakes next.
+        (*branches)[i] = {node.bounds(), (int)fNodes.size() - 1};
     }
 
-    // We might sort our branches here, but we expect Blink gives us a reasonable x,y order.
-    // Skipping a call to sort (in Y) here resulted in a 17% win for recording with negligible
-    // difference in playback speed.
-    int numBranches = (int)branches->size() / kMaxChildren;
-    int remainder   = (int)branches->size() % kMaxChildren;
-    int newBranches = 0;
+    if (nodes == 1) {
+        fRootBounds = (*branches)[0].fBounds;
+        return;
+    }
+    branches->resize(nodes);
+    this->bulkLoad(branches, level + 1);
+}
 
-    if (remainder > 0) {
-        ++numBranches;
-        // If the remainder isn't enough to fill a node, we'll add fewer nodes to other branches.
-        if (remainder >= kMinChildren) {
-            remainder = 0;
-        } else {
-            remainder = kMinChildren - remainder;
+void SkRTree::search(const SkRect& query, std::vector<int>* results) const {
+    if (fCount > 0 && SkRect::Intersects(fRootBounds, query)) {
+        const size_t start = results->size();
+        this->search((int)fNodes.size() - 1, query, results);
+        if (!fInOpOrder) {
+            sort_results(results, start);
         }
     }
+}
 
-    int currentBranch = 0;
-    while (currentBranch < (int)branches->size()) {
-        int incrementBy = kMaxChildren;
-        if (remainder != 0) {
-            // if need be, omit some nodes to make up for remainder
-            if (remainder <= kMaxChildren - kMinChildren) {
-                incrementBy -= remainder;
-                remainder = 0;
+void SkRTree::search(int index, const SkRect& query, std::vector<int>* results) const {
+    const Node& node = fNodes[index];
+    uint32_t hits = node.intersects(query);
+    for (int i = 0; hits; i++, hits >>= 1) {
+        if (hits & 1) {
+            if (0 == node.fLevel) {
+                results->push_back(node.fChildren[i]);
             } else {
-                incrementBy = kMinChildren;
-                remainder -= kMaxChildren - kMinChildren;
+                this->search(node.fChildren[i], query, results);
             }
         }
-        Node* n = allocateNodeAtLevel(level);
-        n->fNumChildren = 1;
-        n->fChildren[0] = (*branches)[currentBranch];
-        Branch b;
-        b.fBounds = (*branches)[currentBranch].fBounds;
-        b.fSubtree = n;
-        ++currentBranch;
-        for (int k = 1; k < incrementBy && currentBranch < (int)branches->size(); ++k) {
-            b.fBounds.join((*branches)[currentBranch].fBounds);
-            n->fChildren[k] = (*branches)[currentBranch];
-            ++n->fNumChildren;
-            ++currentBranch;
-        }
-        (*branches)[newBranches] = b;
-        ++newBranches;
     }
-    branches->resize(newBranches);
-    return this->bulkLoad(branches, level + 1);
 }
 
-void SkRTree::search(const SkRect& query, std::vector<int>* results) const {
-    if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+void SkRTree::search(const SkRect queries[], int count, std::vector<int> results[]) const {
+    if (fCount == 0) {
+        return;
+    }
+
+    SkAutoSTMalloc<16, int>    active(count);
+    SkAutoSTMalloc<16, size_t> starts(count);
+    int activeCount = 0;
+    for (int i = 0; i < count; i++) {
+        starts[i] = results[i].size();
+        if (SkRect::Intersects(fRootBounds, queries[i])) {
+            active[activeCount++] = i;
+        }
+    }
+    if (activeCount > 0) {
+        this->search((int)fNodes.size() - 1, queries, active, activeCount, results);
+    }
+    for (int i = 0; i < count && !fInOpOrder; i++) {
+        sort_results(&results[i], starts[i]);
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, std::vector<int>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push_back(node->fChildren[i].fOpIndex);
-            } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+void SkRTree::search(int index, const SkRect queries[], const int active[], int activeCount,
+                     std::vector<int> results[]) const {
+    const Node& node = fNodes[index];
+
+    SkAutoSTMalloc<16, uint32_t> hits(activeCount);
+    uint32_t anyHits = 0;
+    for (int q = 0; q < activeCount; q++) {
+        hits[q] = node.intersects(queries[active[q]]);
+        anyHits |= hits[q];
+    }
+
+    if (0 == node.fLevel) {
+        for (int q = 0; q < activeCount; q++) {
+            for (int i = 0; hits[q] >> i; i++) {
+                if (hits[q] >> i & 1) {
+                    results[active[q]].push_back(node.fChildren[i]);
+                }
+            }
+        }
+        return;
+    }
+
+    // Descend into each child with just the queries that hit it.
+    SkAutoSTMalloc<16, int> next(activeCount);
+    for (int i = 0; anyHits; i++, anyHits >>= 1) {
+        if (anyHits & 1) {
+            int nextCount = 0;
+            for (int q = 0; q < activeCount; q++) {
+                if (hits[q] >> i & 1) {
+                    next[nextCount++] = active[q];
+                }
             }
+            this->search(node.fChildren[i], queries, next, nextCount, results);
         }
     }
 }
@@ -170,3 +366,94 @@ size_t SkRTree::bytesUsed() const {
 
     return byteCount;
 }
+
+// Nodes are written in fNodes order, which puts every child before its parent and the root last:
+//
+//   u32 node count
+//   per node: u32 child count | level << 16, then per child its bounds and either its op index
+//             (level 0) or the index of its subtree's node
+void SkRTree::flatten(SkWriteBuffer& buffer) const {
+    if (!fCount) {
+        buffer.writeUInt(0);
+        return;
+    }
+
+    buffer.writeUInt(SkToU32(fNodes.size()));
+    for (const Node& node : fNodes) {
+        buffer.writeUInt(node.fNumChildren | (uint32_t)node.fLevel << 16);
+        for (int i = 0; i < node.fNumChildren; i++) {
+            buffer.writeRect({node.fLeft[i], node.fTop[i], node.fRight[i], node.fBottom[i]});
+            buffer.writeInt(node.fChildren[i]);
+        }
+    }
+}
+
+sk_sp<SkRTree> SkRTree::MakeFromBuffer(SkReadBuffer& buffer, int opCount) {
+    // bulkLoad() never builds trees anywhere near this deep; the limit just bounds recursion in
+    // search() for hostile input.
+    static constexpr int kMaxLevel = 32;
+
+    const uint32_t nodeCount = buffer.readUInt();
+    // Every node takes at least a header word and one child (five words).
+    if (!buffer.validateCanReadN<uint32_t>(6 * (size_t)nodeCount)) {
+        return nullptr;
+    }
+
+    auto tree = sk_make_sp<SkRTree>();
+    // We can't tell how the writer packed the tree.
+    tree->fInOpOrder = false;
+    tree->fNodes.resize(nodeCount);
+    // A node referenced twice would turn the tree into a DAG, which search() would walk (and
+    // report the ops under) once per path to it.
+    std::vector<bool> hasParent(nodeCount);
+    for (uint32_t n = 0; n < nodeCount; n++) {
+        const uint32_t header = buffer.readUInt();
+        const int numChildren = header & 0xffff,
+                  level       = header >> 16;
+        if (!buffer.validate(numChildren >= 1 && numChildren <= kMaxChildren &&
+                             level < kMaxLevel)) {
+            return nullptr;
+        }
+
+        Node& node = tree->fNodes[n];
+        node.reset(level);
+        for (int i = 0; i < numChildren; i++) {
+            SkRect bounds;
+            buffer.readRect(&bounds);
+            const int index = buffer.readInt();
+            // Search relies on children never being empty, as insert() guarantees.
+            if (!buffer.validate(!bounds.isEmpty())) {
+                return nullptr;
+            }
+            if (level == 0) {
+                if (!buffer.validateIndex(index, opCount)) {
+                    return nullptr;
+                }
+                tree->fCount++;
+            } else {
+                // Children come before their parents, one level down, with just one parent.
+                if (!buffer.validateIndex(index, n) ||
+                    !buffer.validate(tree->fNodes[index].fLevel == level - 1 &&
+                                     !hasParent[index])) {
+                    return nullptr;
+                }
+                hasParent[index] = true;
+            }
+            node.append(bounds, index);
+        }
+    }
+    // Every node but the root (last) must be in the tree.
+    for (uint32_t n = 0; n + 1 < nodeCount; n++) {
+        if (!buffer.validate(hasParent[n])) {
+            return nullptr;
+        }
+    }
+    if (!buffer.isValid()) {
+        return nullptr;
+    }
+
+    if (nodeCount > 0) {
+        tree->fRootBounds = tree->fNodes.back().bounds();
+    }
+    return tree;
+}
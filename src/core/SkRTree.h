@@ -11,21 +11,29 @@
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkRect.h"
 
+class SkReadBuffer;
+class SkWriteBuffer;
+
 /**
  * An R-Tree implementation. In short, it is a balanced n-ary tree containing a hierarchy of
  * bounding rectangles.
  *
  * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
- * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * This performs a bottom-up bulk load, packing consecutive runs of rects into nodes, level by
+ * level.  Large trees use the Hilbert pack algorithm: rects are first sorted by the position of
+ * their centers along a Hilbert curve.  Rects that are close together on the curve are close
+ * together in space, so nodes end up small and square no matter what order the rects arrive in.
+ * Small trees skip the sort, and are packed in the order the rects arrive in.
  *
- * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
- * which groups rects by position on the Hilbert curve, is probably worth a look). There also
- * exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
+ * Each node stores its children's bounds as separate left/top/right/bottom arrays, so a query
+ * tests all of a node's children at once with SIMD.
  *
  * For more details see:
  *
  *  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990). "The R*-tree:
  *      an efficient and robust access method for points and rectangles"
+ *
+ *  Kamel, I.; Faloutsos, C. (1993). "On packing R-trees"
  */
 class SkRTree : public SkBBoxHierarchy {
 public:
@@ -35,47 +43,79 @@ public:
     void search(const SkRect& query, std::vector<int>* results) const override;
     size_t bytesUsed() const override;
 
+    // Runs count queries in a single walk of the tree, so nodes that several queries visit
+    // (e.g. near the shared edges of tiles) are loaded and tested together.  Appends to
+    // results[i] exactly what search(queries[i], &results[i]) would.
+    void search(const SkRect queries[], int count, std::vector<int> results[]) const;
+
+    // Writes the tree's nodes so it can be recreated without bulk-loading it again.
+    void flatten(SkWriteBuffer&) const;
+
+    // Returns nullptr if the buffer does not hold a valid tree over op indices in [0, opCount).
+    static sk_sp<SkRTree> MakeFromBuffer(SkReadBuffer&, int opCount);
+
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fNodes.back().fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
-    // These values were empirically determined to produce reasonable performance in most cases.
-    static const int kMinChildren = 6,
-                     kMaxChildren = 11;
+    // Nodes hold up to kMaxChildren children, so their bounds fill a whole number of SIMD
+    // registers.  Bulk loading spreads children evenly, so nodes are never less than half full.
+    static const int kMinChildren = 8,
+                     kMaxChildren = 16;
+
+    // Trees over fewer rects than this are not Hilbert packed.
+    static const int kMinHilbertPackCount = 4096;
 
 private:
-    struct Node;
+    struct Node {
+        // Children's bounds.  Slots past fNumChildren hold inverted bounds that never intersect.
+        float    fLeft  [kMaxChildren],
+                 fTop   [kMaxChildren],
+                 fRight [kMaxChildren],
+                 fBottom[kMaxChildren];
+        // Op indices at level 0, and indices into fNodes above that.
+        int      fChildren[kMaxChildren];
+        uint16_t fNumChildren;
+        uint16_t fLevel;
+
+        void reset(int level);
+        void append(const SkRect& bounds, int child);
+        SkRect bounds() const;
+
+        // Returns a mask with bit i set if child i intersects the (non-empty) query.
+        uint32_t intersects(const SkRect& query) const;
+    };
 
     struct Branch {
-        union {
-            Node* fSubtree;
-            int fOpIndex;
-        };
         SkRect fBounds;
+        int    fIndex;  // An op index at level 0, and an index into fNodes above that.
     };
 
-    struct Node {
-        uint16_t fNumChildren;
-        uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
-    };
+    void search(int node, const SkRect& query, std::vector<int>* results) const;
+    void search(int node, const SkRect queries[], const int active[], int activeCount,
+                std::vector<int> results[]) const;
 
-    void search(Node* root, const SkRect& query, std::vector<int>* results) const;
+    // Fills branches (sized to the count of non-empty rects) with the non-empty rects, sorted
+    // along a Hilbert curve over their total bounds.
+    static void HilbertSort(const SkRect[], int N, const SkRect& total,
+                            std::vector<Branch>* branches);
 
+    // Packs the branches into nodes at the given level, and then recursively packs those.
     // Consumes the input array.
-    Branch bulkLoad(std::vector<Branch>* branches, int level = 0);
+    void bulkLoad(std::vector<Branch>* branches, int level = 0);
 
-    // How many times will bulkLoad() call allocateNodeAtLevel()?
+    // How many nodes will bulkLoad() allocate?
     static int CountNodes(int branches);
 
-    Node* allocateNodeAtLevel(uint16_t level);
-
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
-    Branch fRoot;
+    // Are the leaves in op order?  If not, search results need sorting.
+    bool fInOpOrder;
+    // The root is always the last node, and every node comes after its children.
+    SkRect fRootBounds;
     std::vector<Node> fNodes;
 };
 
@@ -91,6 +91,7 @@ class SkData;
     M(evenly_spaced_gradient)                                      \
     M(gradient)                                                    \
     M(evenly_spaced_2_stop_gradient)                               \
+    M(gradient_lut)                                                \
     M(xy_to_unit_angle)                                            \
     M(xy_to_radius)                                                \
     M(xy_to_2pt_conical_strip)                                     \
@@ -180,6 +181,11 @@ struct SkRasterPipeline_EvenlySpaced2StopGradientCtx {
     bool interpolatedInPremul;
 };
 
+struct SkRasterPipeline_GradientLUTCtx {
+    const uint32_t* colors;     // Premultiplied RGBA 8888, evenly spaced over t in [0,1].
+    float           lastIndex;  // Number of colors - 1.
+};
+
 struct SkRasterPipeline_2PtConicalCtx {
     uint32_t fMask[SkRasterPipeline_kMaxStride];
     float    fP0,
@@ -40,6 +40,7 @@ public:
 
     void blitH     (int x, int y, int w)                            override;
     void blitAntiH (int x, int y, const SkAlpha[], const int16_t[]) override;
+    void blitAntiPixel(int x, int y, U8CPU a)                       override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1)               override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1)               override;
     void blitMask  (const SkMask&, const SkIRect& clip)             override;
@@ -390,6 +391,19 @@ void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const
     }
 }
 
+void SkRasterPipelineBlitter::blitAntiPixel(int x, int y, U8CPU a) {
+    SkIRect clip = {x,y, x+1,y+1};
+    uint8_t coverage[] = { (uint8_t)a };
+
+    SkMask mask;
+    mask.fImage    = coverage;
+    mask.fBounds   = clip;
+    mask.fRowBytes = 1;
+    mask.fFormat   = SkMask::kA8_Format;
+
+    this->blitMask(mask, clip);
+}
+
 void SkRasterPipelineBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
     SkIRect clip = {x,y, x+2,y+1};
     uint8_t coverage[] = { (uint8_t)a0, (uint8_t)a1 };
@@ -7,11 +7,17 @@
 
 #include "src/core/SkRecordOpts.h"
 
+#include "include/core/SkImage.h"
+#include "include/core/SkShader.h"
 #include "include/private/SkTDArray.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordPattern.h"
 #include "src/core/SkRecords.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace SkRecords;
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
@@ -318,3 +324,595 @@ void SkRecordOptimize2(SkRecord* record) {
 
     record->defrag();
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Follows the matrix through a record as SkRecords::Draw sets it, relative to the initial matrix.
+// A Concat44 that doesn't fit in an SkMatrix makes it unknown until the next SetMatrix or Restore.
+class MatrixTracker {
+public:
+    const SkMatrix& matrix() const { return fMatrix; }
+    bool known() const { return fKnown; }
+
+    // Can the matrix map rects to device space exactly?
+    bool rectStaysRect() const { return fKnown && fMatrix.rectStaysRect(); }
+
+    template <typename T> void operator()(const T&) {}
+
+    void operator()(const Save&)       { fStack.push_back({fMatrix, fKnown}); }
+    void operator()(const SaveLayer&)  { fStack.push_back({fMatrix, fKnown}); }
+    void operator()(const SaveBehind&) { fStack.push_back({fMatrix, fKnown}); }
+    void operator()(const Restore&) {
+        if (!fStack.empty()) {
+            fMatrix = fStack.back().fMatrix;
+            fKnown  = fStack.back().fKnown;
+            fStack.pop_back();
+        }
+    }
+
+    void operator()(const SetMatrix& op) { fMatrix = op.matrix; fKnown = true; }
+    void operator()(const Concat&    op) { fMatrix.preConcat(op.matrix); }
+    void operator()(const Translate& op) { fMatrix.preTranslate(op.dx, op.dy); }
+    void operator()(const Scale&     op) { fMatrix.preScale(op.sx, op.sy); }
+    void operator()(const Concat44&  op) {
+        const SkM44& m = op.matrix;
+        if (m.rc(0,2) == 0 && m.rc(1,2) == 0 && m.rc(3,2) == 0 &&
+            m.rc(2,0) == 0 && m.rc(2,1) == 0 && m.rc(2,2) == 1 && m.rc(2,3) == 0) {
+            fMatrix.preConcat(m.asM33());
+        } else {
+            fKnown = false;
+        }
+    }
+
+private:
+    struct Saved {
+        SkMatrix fMatrix;
+        bool     fKnown;
+    };
+
+    SkMatrix           fMatrix = SkMatrix::I();
+    bool               fKnown  = true;
+    std::vector<Saved> fStack;
+};
+
+// What the whole-picture passes need to know about each op.
+enum class OpKind {
+    kNoOp,
+    kMatrix,    // SetMatrix, Concat, Concat44, Translate, Scale
+    kClip,
+    kSave,
+    kLayer,     // SaveLayer, SaveBehind
+    kRestore,
+    kMarkCTM,
+    kDraw,      // Anything tagged kDraw_Tag, plus DrawAnnotation.
+    kOther,
+};
+
+struct Classify {
+    template <typename T> OpKind operator()(const T&) {
+        return (T::kTags & kDraw_Tag) ? OpKind::kDraw : OpKind::kOther;
+    }
+    OpKind operator()(const NoOp&)           { return OpKind::kNoOp;    }
+    OpKind operator()(const SetMatrix&)      { return OpKind::kMatrix;  }
+    OpKind operator()(const Concat&)         { return OpKind::kMatrix;  }
+    OpKind operator()(const Concat44&)       { return OpKind::kMatrix;  }
+    OpKind operator()(const Translate&)      { return OpKind::kMatrix;  }
+    OpKind operator()(const Scale&)          { return OpKind::kMatrix;  }
+    OpKind operator()(const ClipPath&)       { return OpKind::kClip;    }
+    OpKind operator()(const ClipRRect&)      { return OpKind::kClip;    }
+    OpKind operator()(const ClipRect&)       { return OpKind::kClip;    }
+    OpKind operator()(const ClipRegion&)     { return OpKind::kClip;    }
+    OpKind operator()(const ClipShader&)     { return OpKind::kClip;    }
+    OpKind operator()(const Save&)           { return OpKind::kSave;    }
+    OpKind operator()(const SaveLayer&)      { return OpKind::kLayer;   }
+    OpKind operator()(const SaveBehind&)     { return OpKind::kLayer;   }
+    OpKind operator()(const Restore&)        { return OpKind::kRestore; }
+    OpKind operator()(const MarkCTM&)        { return OpKind::kMarkCTM; }
+    OpKind operator()(const DrawAnnotation&) { return OpKind::kDraw;    }
+};
+
+// The local-space bounds of an intersecting clip, if it has any.
+struct ClipBounds {
+    bool fIntersect = false;
+    bool fIsRect    = false;
+    SkRect fBounds  = SkRect::MakeEmpty();
+
+    template <typename T> void operator()(const T&) {}
+    void operator()(const ClipRect& op) {
+        fIntersect = op.opAA.op() == SkClipOp::kIntersect;
+        fIsRect    = true;
+        fBounds    = op.rect.makeSorted();
+    }
+    void operator()(const ClipRRect& op) {
+        fIntersect = op.opAA.op() == SkClipOp::kIntersect;
+        fIsRect    = op.rrect.isRect();
+        fBounds    = op.rrect.getBounds();
+    }
+    void operator()(const ClipPath& op) {
+        fIntersect = op.opAA.op() == SkClipOp::kIntersect && !op.path.isInverseFillType();
+        fBounds    = op.path.getBounds();
+    }
+};
+
+SkIRect round_in(const SkRect& r) {
+    SkIRect ir;
+    r.roundIn(&ir);
+    return ir.isEmpty() ? SkIRect::MakeEmpty() : ir;
+}
+
+// Where might this op draw, in device pixels?  Bounds from SkRecordFillBounds() are clamped to
+// the cull, and conservative up to antialiasing, so we outset them by a pixel.
+SkIRect touched_pixels(const SkRect& bounds, const SkIRect& cull) {
+    SkIRect touched = bounds.makeOutset(1, 1).roundOut();
+    return touched.intersect(cull) ? touched : SkIRect::MakeEmpty();
+}
+
+// Does this paint replace what's under it with opaque color, wherever it draws?
+bool paint_is_opaque(const SkPaint* paint, bool isImage) {
+    if (!paint) {
+        return true;
+    }
+    SkBlendMode blend = paint->getBlendMode();
+    return paint->getAlpha() == 0xFF
+        && (blend == SkBlendMode::kSrcOver || blend == SkBlendMode::kSrc)
+        && paint->getStyle() == SkPaint::kFill_Style
+        && !paint->getPathEffect()
+        && !paint->getMaskFilter()
+        && !paint->getImageFilter()
+        && !paint->getColorFilter()
+        && (isImage ? !paint->getShader()
+                    : !paint->getShader() || paint->getShader()->isOpaque());
+}
+
+// Composes a run of matrix ops.  The result is absolute if the run contains a SetMatrix.
+struct Composer {
+    SkMatrix fMatrix   = SkMatrix::I();
+    bool     fAbsolute = false;
+    bool     fBarrier  = false;  // Concat44s don't always fit in an SkMatrix.
+
+    template <typename T> void operator()(const T&) {}
+    void operator()(const SetMatrix& op) { fMatrix = op.matrix; fAbsolute = true; }
+    void operator()(const Concat&    op) { fMatrix.preConcat(op.matrix); }
+    void operator()(const Translate& op) { fMatrix.preTranslate(op.dx, op.dy); }
+    void operator()(const Scale&     op) { fMatrix.preScale(op.sx, op.sy); }
+    void operator()(const Concat44&)     { fBarrier = true; }
+};
+
+// The local-space area an op covers with opaque pixels, if any.
+struct Occluder {
+    bool   fCovers = false;
+    bool   fAll    = false;  // Covers everything inside the clip.
+    SkRect fRect   = SkRect::MakeEmpty();
+
+    template <typename T> void operator()(const T&) {}
+    void operator()(const DrawPaint& op) {
+        fCovers = fAll = paint_is_opaque(&op.paint, false);
+    }
+    void operator()(const DrawRect& op) {
+        fCovers = paint_is_opaque(&op.paint, false);
+        fRect   = op.rect.makeSorted();
+    }
+    void operator()(const DrawImage& op) {
+        fCovers = op.image->isOpaque() && paint_is_opaque(op.paint, true);
+        fRect   = SkRect::MakeXYWH(op.left, op.top, op.image->width(), op.image->height());
+    }
+    void operator()(const DrawImageRect& op) {
+        fCovers = op.image->isOpaque() && paint_is_opaque(op.paint, true) &&
+                  (!op.src || SkRect::Make(op.image->bounds()).contains(*op.src));
+        fRect   = op.dst.makeSorted();
+    }
+};
+
+}  // namespace
+
+int SkRecordMergeMatrices(SkRecord* record) {
+    int removed = 0;
+    MatrixTracker tracker;
+    for (int i = 0; i < record->count();) {
+        if (record->visit(i, Classify{}) != OpKind::kMatrix ||
+            record->visit(i, [](const auto& op) {
+                return std::is_same<std::decay_t<decltype(op)>, Concat44>::value;
+            })) {
+            record->visit(i++, tracker);
+            continue;
+        }
+
+        // Find the run of matrix ops (and no-ops between them) starting here.
+        Composer composer;
+        int end = i, ops = 0;
+        for (int j = i; j < record->count(); j++) {
+            OpKind kind = record->visit(j, Classify{});
+            if (kind == OpKind::kMatrix) {
+                record->visit(j, composer);
+                if (composer.fBarrier) {
+                    break;
+                }
+                ops++;
+                end = j + 1;
+            } else if (kind != OpKind::kNoOp) {
+                break;
+            }
+        }
+
+        const SkMatrix& m = composer.fMatrix;
+        bool unchanged = composer.fAbsolute ? tracker.known() && m == tracker.matrix()
+                                            : m.isIdentity();
+        if (ops > 1 || unchanged) {
+            for (int j = i; j < end; j++) {
+                if (record->visit(j, Classify{}) == OpKind::kMatrix) {
+                    record->replace<NoOp>(j);
+                    removed++;
+                }
+            }
+            if (!unchanged) {
+                if (composer.fAbsolute) {
+                    new (record->replace<SetMatrix>(i)) SetMatrix{m};
+                } else if (m.isTranslate()) {
+                    new (record->replace<Translate>(i)) Translate{m.getTranslateX(),
+                                                                  m.getTranslateY()};
+                } else if (m.isScaleTranslate() && m.getTranslateX() == 0 &&
+                                                   m.getTranslateY() == 0) {
+                    new (record->replace<Scale>(i)) Scale{m.getScaleX(), m.getScaleY()};
+                } else {
+                    new (record->replace<Concat>(i)) Concat{m};
+                }
+                removed--;
+            }
+        }
+        for (; i < end; i++) {
+            record->visit(i, tracker);
+        }
+    }
+    return removed;
+}
+
+static int noop_dead_state_once(SkRecord* record, const SkRect& cullRect) {
+    SkAutoTMalloc<SkRect>                   bounds(record->count());
+    SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(record->count());
+    SkRecordFillBounds(cullRect, *record, bounds, meta);
+
+    struct Frame {
+        int              fSave;  // Index of the Save, or -1 at the top level.
+        bool             fUsed;  // Has anything drawn since the Save?
+        SkIRect          fClip;  // Device bounds the clip can't extend past.
+        std::vector<int> fMatrices,
+                         fClips;  // State ops nothing has used yet.
+    };
+    std::vector<Frame> frames;
+    frames.push_back({-1, true, cullRect.roundOut(), {}, {}});
+
+    int removed = 0;
+    auto noop = [&](int i) {
+        if (record->visit(i, Classify{}) != OpKind::kNoOp) {
+            record->replace<NoOp>(i);
+            removed++;
+        }
+    };
+    auto use_matrices = [&] {
+        for (Frame& frame : frames) {
+            frame.fMatrices.clear();
+        }
+    };
+    auto use_everything = [&] {
+        for (Frame& frame : frames) {
+            frame.fMatrices.clear();
+            frame.fClips.clear();
+            frame.fUsed = true;
+        }
+    };
+
+    MatrixTracker tracker;
+    for (int i = 0; i < record->count(); i++) {
+        record->visit(i, tracker);
+
+        switch (record->visit(i, Classify{})) {
+            case OpKind::kMatrix:
+                frames.back().fMatrices.push_back(i);
+                break;
+
+            case OpKind::kClip: {
+                use_matrices();
+                ClipBounds clip;
+                record->visit(i, clip);
+                if (clip.fIntersect && tracker.known() && !tracker.matrix().hasPerspective()) {
+                    SkRect device = tracker.matrix().mapRect(clip.fBounds);
+                    if (clip.fIsRect && tracker.rectStaysRect() &&
+                        round_in(device).contains(frames.back().fClip)) {
+                        noop(i);
+                        break;
+                    }
+                    if (!frames.back().fClip.intersect(device.roundOut())) {
+                        frames.back().fClip.setEmpty();
+                    }
+                }
+                frames.back().fClips.push_back(i);
+            } break;
+
+            case OpKind::kSave:
+                frames.push_back({i, false, frames.back().fClip, {}, {}});
+                break;
+
+            case OpKind::kLayer:
+                use_everything();
+                frames.push_back({i, true, frames.back().fClip, {}, {}});
+                break;
+
+            case OpKind::kRestore: {
+                if (frames.size() == 1) {
+                    break;
+                }
+                Frame frame = std::move(frames.back());
+                frames.pop_back();
+                if (!frame.fUsed) {
+                    for (int j = frame.fSave; j <= i; j++) {
+                        noop(j);
+                    }
+                } else {
+                    for (int j : frame.fMatrices) { noop(j); }
+                    for (int j : frame.fClips)    { noop(j); }
+                }
+            } break;
+
+            case OpKind::kMarkCTM:
+                use_matrices();
+                break;
+
+            case OpKind::kDraw:
+                if (record->visit(i, [](const auto& op) {
+                        using T = std::decay_t<decltype(op)>;
+                        return (T::kTags & kDraw_Tag) && !std::is_same<T, DrawBehind>::value;
+                    }) &&
+                    !SkIRect::Intersects(touched_pixels(bounds[i], cullRect.roundOut()),
+                                         frames.back().fClip)) {
+                    noop(i);
+                    break;
+                }
+                use_everything();
+                break;
+
+            case OpKind::kNoOp:
+            case OpKind::kOther:
+                break;
+        }
+    }
+
+    // Anything still pending is restored away at the end of playback.
+    for (const Frame& frame : frames) {
+        for (int j : frame.fMatrices) { noop(j); }
+        for (int j : frame.fClips)    { noop(j); }
+    }
+    return removed;
+}
+
+int SkRecordNoopDeadState(SkRecord* record, const SkRect& cullRect) {
+    // Each pass can expose more: no-oping a dead draw can leave its Save-Restore unused.
+    int removed = 0;
+    while (int n = noop_dead_state_once(record, cullRect)) {
+        removed += n;
+    }
+    return removed;
+}
+
+// Ops that may read the pixels under them: layers with a backdrop or initialized from what's
+// below, and nested pictures and drawables, which may hold such layers.
+struct ReadsBack {
+    template <typename T> bool operator()(const T&) { return false; }
+    bool operator()(const SaveLayer& op) {
+        return op.backdrop || (op.saveLayerFlags & SkCanvas::kInitWithPrevious_SaveLayerFlag);
+    }
+    bool operator()(const SaveBehind&)   { return true; }
+    bool operator()(const DrawPicture&)  { return true; }
+    bool operator()(const DrawDrawable&) { return true; }
+};
+
+int SkRecordNoopOccludedDraws(SkRecord* record, const SkRect& cullRect) {
+    // SaveBehind and DrawBehind draw beneath what's already there.
+    for (int i = 0; i < record->count(); i++) {
+        if (record->visit(i, [](const auto& op) {
+                using T = std::decay_t<decltype(op)>;
+                return std::is_same<T, SaveBehind>::value || std::is_same<T, DrawBehind>::value;
+            })) {
+            return 0;
+        }
+    }
+
+
+    const SkIRect cull = cullRect.roundOut();
+    std::vector<SkIRect> occluders(record->count(), SkIRect::MakeEmpty());
+    std::vector<bool>    topLevel(record->count(), false);
+
+    // Forward, to find what each top-level draw covers.  The clip here is the reverse of
+    // SkRecordNoopDeadState()'s: device bounds the clip is known to include.
+    {
+        const SkIRect kHuge = SkIRect::MakeLTRB(-(1 << 29), -(1 << 29), 1 << 29, 1 << 29);
+        std::vector<SkIRect> clips = {kHuge};
+        std::vector<bool>    layers = {false};
+        int layerDepth = 0;
+
+        MatrixTracker tracker;
+        for (int i = 0; i < record->count(); i++) {
+            switch (record->visit(i, Classify{})) {
+                case OpKind::kClip: {
+                    ClipBounds clip;
+                    record->visit(i, clip);
+                    SkIRect& inner = clips.back();
+                    if (clip.fIntersect && clip.fIsRect && tracker.rectStaysRect()) {
+                        if (!inner.intersect(round_in(tracker.matrix().mapRect(clip.fBounds)))) {
+                            inner.setEmpty();
+                        }
+                    } else {
+                        inner.setEmpty();
+                    }
+                } break;
+
+                case OpKind::kSave:
+                case OpKind::kLayer: {
+                    bool layer = record->visit(i, Classify{}) == OpKind::kLayer;
+                    clips.push_back(clips.back());
+                    layers.push_back(layer);
+                    layerDepth += layer;
+                } break;
+
+                case OpKind::kRestore:
+                    if (clips.size() > 1) {
+                        layerDepth -= layers.back();
+                        clips.pop_back();
+                        layers.pop_back();
+                    }
+                    break;
+
+                case OpKind::kDraw:
+                    if (layerDepth == 0) {
+                        topLevel[i] = true;
+
+                        Occluder occluder;
+                        record->visit(i, occluder);
+                        if (occluder.fCovers && occluder.fAll) {
+                            occluders[i] = clips.back();
+                        } else if (occluder.fCovers && tracker.rectStaysRect()) {
+                            occluders[i] = round_in(tracker.matrix().mapRect(occluder.fRect));
+                            if (!occluders[i].intersect(clips.back())) {
+                                occluders[i].setEmpty();
+                            }
+                        }
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+            record->visit(i, tracker);
+        }
+    }
+
+    SkAutoTMalloc<SkRect>                   bounds(record->count());
+    SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(record->count());
+    SkRecordFillBounds(cullRect, *record, bounds, meta);
+
+    // Backward, keeping the biggest few occluders drawn after the current op.
+    constexpr int kMaxOccluders = 16;
+    std::vector<SkIRect> active;
+    int removed = 0;
+    for (int i = record->count() - 1; i >= 0; i--) {
+        // These can read what's already drawn, so nothing drawn after one of them hides what
+        // was drawn before it.
+        if (record->visit(i, ReadsBack{})) {
+            active.clear();
+            continue;
+        }
+        if (!topLevel[i] || record->visit(i, Classify{}) != OpKind::kDraw ||
+            record->visit(i, [](const auto& op) {
+                return std::is_same<std::decay_t<decltype(op)>, DrawAnnotation>::value;
+            })) {
+            continue;
+        }
+
+        SkIRect touched = touched_pixels(bounds[i], cull);
+        bool occluded = !touched.isEmpty() &&
+                        std::any_of(active.begin(), active.end(),
+                                    [&](const SkIRect& o) { return o.contains(touched); });
+        if (occluded) {
+            record->replace<NoOp>(i);
+            removed++;
+            continue;
+        }
+
+        SkIRect o = occluders[i];
+        if (!o.intersect(cull)) {
+            continue;
+        }
+        auto area = [](const SkIRect& r) { return (int64_t)r.width() * r.height(); };
+        if ((int)active.size() < kMaxOccluders) {
+            active.push_back(o);
+        } else {
+            auto smallest = std::min_element(active.begin(), active.end(),
+                                             [&](const SkIRect& a, const SkIRect& b) {
+                                                 return area(a) < area(b);
+                                             });
+            if (area(*smallest) < area(o)) {
+                *smallest = o;
+            }
+        }
+    }
+    return removed;
+}
+
+int SkRecordBatchImageRects(SkRecord* record) {
+    auto as_image_rect = [](const auto& op) -> const DrawImageRect* {
+        if constexpr (std::is_same<std::decay_t<decltype(op)>, DrawImageRect>::value) {
+            // Image sets don't support filters, and skip (rather than draw) empty rects.
+            const SkPaint* paint = op.paint;
+            SkRect src = op.src ? *op.src : SkRect::Make(op.image->bounds());
+            if ((!paint || (!paint->getImageFilter() && !paint->getMaskFilter())) &&
+                src.isFinite() && !src.isEmpty() && op.dst.isFinite() && !op.dst.isEmpty()) {
+                return &op;
+            }
+        }
+        return nullptr;
+    };
+    auto compatible = [](const DrawImageRect& a, const DrawImageRect& b) {
+        const SkPaint* pa = a.paint;
+        const SkPaint* pb = b.paint;
+        return a.constraint == b.constraint && (pa && pb ? *pa == *pb : pa == pb);
+    };
+
+    int removed = 0;
+    for (int i = 0; i < record->count(); i++) {
+        const DrawImageRect* first = record->visit(i, as_image_rect);
+        if (!first) {
+            continue;
+        }
+
+        std::vector<int> run = {i};
+        int end = i + 1;
+        for (; end < record->count(); end++) {
+            if (const DrawImageRect* op = record->visit(end, as_image_rect)) {
+                if (!compatible(*first, *op)) {
+                    break;
+                }
+                run.push_back(end);
+            } else if (record->visit(end, Classify{}) != OpKind::kNoOp) {
+                break;
+            }
+        }
+        if (run.size() < 2) {
+            continue;
+        }
+
+        const SkPaint* paint = first->paint;
+        unsigned aaFlags = paint && paint->isAntiAlias() ? SkCanvas::kAll_QuadAAFlags
+                                                         : SkCanvas::kNone_QuadAAFlags;
+        SkAutoTArray<SkCanvas::ImageSetEntry> set(run.size());
+        for (size_t j = 0; j < run.size(); j++) {
+            const DrawImageRect* op = record->visit(run[j], as_image_rect);
+            set[j] = SkCanvas::ImageSetEntry(op->image,
+                                             op->src ? *op->src
+                                                     : SkRect::Make(op->image->bounds()),
+                                             op->dst, 1.f, aaFlags);
+        }
+        SkPaint* copy = paint ? new (record->alloc<SkPaint>()) SkPaint(*paint) : nullptr;
+        SkCanvas::SrcRectConstraint constraint = first->constraint;
+
+        for (size_t j = 1; j < run.size(); j++) {
+            record->replace<NoOp>(run[j]);
+        }
+        new (record->replace<DrawEdgeAAImageSet>(i)) DrawEdgeAAImageSet{
+                copy, std::move(set), (int)run.size(), nullptr, nullptr, constraint};
+        removed += (int)run.size() - 1;
+        i = end - 1;
+    }
+    return removed;
+}
+
+void SkRecordOptimizeWholePicture(SkRecord* record, const SkRect& cullRect) {
+    SkRecordMergeMatrices(record);
+    SkRecordNoopOccludedDraws(record, cullRect);
+    SkRecordNoopDeadState(record, cullRect);
+    // Dropping dead state can bring more matrix ops together.
+    SkRecordMergeMatrices(record);
+    SkRecordBatchImageRects(record);
+
+    record->defrag();
+}
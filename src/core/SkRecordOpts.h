@@ -10,6 +10,8 @@
 
 #include "src/core/SkRecord.h"
 
+struct SkRect;
+
 // Run all optimizations in recommended order.
 void SkRecordOptimize(SkRecord*);
 
@@ -29,4 +31,25 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
+// Whole-picture optimizers.  Unlike the peepholes above, these follow the matrix and clip through
+// the entire record, so they assume it is played back at its recorded scale (the initial matrix
+// may at most translate by whole pixels), and that nothing drawn outside cullRect is visible.
+// Each returns the number of ops it turned into no-ops.
+
+// Collapses runs of matrix ops into a single op, and no-ops those that leave the matrix unchanged.
+int SkRecordMergeMatrices(SkRecord*);
+
+// No-ops matrix and clip ops that nothing uses before they're restored, saves with nothing drawn
+// inside them, clips that can't shrink the clip, and draws entirely outside the clip.
+int SkRecordNoopDeadState(SkRecord*, const SkRect& cullRect);
+
+// No-ops draws that are later entirely covered by opaque rects, images or paints.
+int SkRecordNoopOccludedDraws(SkRecord*, const SkRect& cullRect);
+
+// Turns runs of DrawImageRects that share a paint into single DrawEdgeAAImageSets.
+int SkRecordBatchImageRects(SkRecord*);
+
+// Runs all the whole-picture optimizers in recommended order.
+void SkRecordOptimizeWholePicture(SkRecord*, const SkRect& cullRect);
+
 #endif//SkRecordOpts_DEFINED
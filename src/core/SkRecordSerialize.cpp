@@ -0,0 +1,1399 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkRecordSerialize.h"
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
+#include "include/private/SkOnce.h"
+#include "include/private/SkTHash.h"
+#include "include/private/SkTemplates.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkCanvasPriv.h"
+#include "src/core/SkMiniRecorder.h"
+#include "src/core/SkPictureData.h"
+#include "src/core/SkPtrRecorder.h"
+#include "src/core/SkRTree.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkTextBlobPriv.h"
+#include "src/core/SkVerticesPriv.h"
+#include "src/core/SkWriteBuffer.h"
+#include "src/utils/SkPatchUtils.h"
+
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// Stream layout, following the SkPictInfo header and trailing stream byte:
+//
+//   u8  padding count, then that many zero bytes, so that everything below starts 4-byte aligned
+//       relative to the start of the stream
+//   u32 format version
+//   u32 header buffer size, followed by the header (SkWriteBuffer): the flattenable factory
+//       names, the typefaces (procs.fTypefaceProc or SkTypeface::serialize) and the paint, path
+//       and image counts
+//   u32 table buffer size, followed by the paints, paths and images (SkWriteBuffer)
+//   u32 op buffer size, followed by the top-level picture (SkWriteBuffer)
+//   u32 index buffer size, followed by the index (SkWriteBuffer), or 0 if there is none
+//
+// A picture in the op buffer is its cull rect, its op count, and then each op as its
+// SkRecords::Type followed by its fields.  Paints, paths and images are written as indices into
+// the tables; nested pictures are written inline.  Restore's matrix is not written: the reader
+// tracks the matrix through the save stack to recreate it, as SkRecorder would.
+//
+// Flattenables refer to the factory names in the header rather than naming themselves as they go,
+// so every top-level op and every table entry can be decoded on its own.  The optional index is
+//
+//   u32 top-level op count, followed by each op's offset in the op buffer
+//   the offset of each paint, path and image in the table buffer
+//   an SkRTree over the top-level ops' bounds (SkRTree::flatten())
+//
+// which lets SkRecordDeserializeLazy() decode just the ops a playback actually needs.
+
+namespace {
+
+// Bump this whenever the layout above or any op encoding changes.
+constexpr uint32_t kRecordFormatVersion = 2;
+
+// Nested pictures recurse when reading and writing, so bound how deeply they may nest.
+constexpr int kMaxPictureDepth = 128;
+
+struct PaintHash {
+    uint32_t operator()(const SkPaint& paint) const { return paint.getHash(); }
+};
+
+// Paths sharing a generation ID can still differ (e.g. by fill type), so the generation ID
+// only serves as hash: lookups compare the paths themselves, as SkPictureRecord does.
+struct PathHash {
+    uint32_t operator()(const SkPath& path) const { return path.getGenerationID(); }
+};
+
+void write_sized(SkWStream* stream, const SkBinaryWriteBuffer& buffer) {
+    stream->write32(SkToU32(buffer.bytesWritten()));
+    buffer.writeToStream(stream);
+}
+
+class RecordWriter {
+public:
+    RecordWriter(const SkSerialProcs& procs, bool writeIndex)
+        : fFactories(sk_make_sp<SkFactorySet>())
+        , fTypefaces(sk_make_sp<SkRefCntSet>())
+        , fWriteIndex(writeIndex) {
+        // Typefaces are written to the header using the caller's procs (see finish()), so the
+        // buffers themselves only record typeface indices.
+        fBufferProcs = procs;
+        fBufferProcs.fTypefaceProc = nullptr;
+        fBufferProcs.fTypefaceCtx  = nullptr;
+        fOps.setSerialProcs(fBufferProcs);
+        fOps.setFactoryRecorder(fFactories);
+        fOps.setTypefaceRecorder(fTypefaces);
+    }
+
+    bool writePicture(const SkPicture* picture) {
+        if (fDepth >= kMaxPictureDepth) {
+            return false;
+        }
+
+        // Re-record through SkRecorder so every picture type (big, mini, empty, ...) reaches us
+        // as a plain list of SkRecords ops.
+        SkRecord record;
+        SkRecorder recorder(&record, picture->cullRect());
+        picture->playback(&recorder);
+
+        if (fDepth == 0 && fWriteIndex) {
+            SkAutoTMalloc<SkRect> bounds(record.count());
+            SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(record.count());
+            SkRecordFillBounds(picture->cullRect(), record, bounds, meta);
+            fRTree = sk_make_sp<SkRTree>();
+            fRTree->insert(bounds, record.count());
+        }
+
+        fOps.writeRect(picture->cullRect());
+        fOps.writeInt(record.count());
+
+        fDepth++;
+        for (int i = 0; i < record.count() && fOK; i++) {
+            if (fDepth == 1 && fWriteIndex) {
+                fOpOffsets.push_back(SkToU32(fOps.bytesWritten()));
+            }
+            record.visit(i, *this);
+        }
+        fDepth--;
+
+        return fOK;
+    }
+
+    void finish(SkWStream* stream, const SkSerialProcs& procs) {
+        std::vector<uint32_t> tableOffsets;
+        SkBinaryWriteBuffer tables;
+        tables.setSerialProcs(fBufferProcs);
+        tables.setFactoryRecorder(fFactories);
+        tables.setTypefaceRecorder(fTypefaces);
+        for (const SkPaint& paint : fPaints) {
+            tableOffsets.push_back(SkToU32(tables.bytesWritten()));
+            tables.writePaint(paint);
+        }
+        for (const SkPath& path : fPaths) {
+            tableOffsets.push_back(SkToU32(tables.bytesWritten()));
+            tables.writePath(path);
+        }
+        for (const sk_sp<const SkImage>& image : fImages) {
+            tableOffsets.push_back(SkToU32(tables.bytesWritten()));
+            tables.writeImage(image.get());
+        }
+
+        // Both buffers are complete, so the factory and typeface sets are too.
+        SkBinaryWriteBuffer header;
+        const int factoryCount = fFactories->count();
+        SkAutoSTMalloc<16, SkFlattenable::Factory> factories(factoryCount);
+        fFactories->copyToArray(factories.get());
+        header.writeInt(factoryCount);
+        for (int i = 0; i < factoryCount; i++) {
+            const char* name = SkFlattenable::FactoryToName(factories[i]);
+            header.writeString(name ? name : "");
+        }
+
+        const int typefaceCount = fTypefaces->count();
+        SkAutoSTMalloc<16, SkTypeface*> typefaces(typefaceCount);
+        fTypefaces->copyToArray((SkRefCnt**)typefaces.get());
+        header.writeInt(typefaceCount);
+        for (int i = 0; i < typefaceCount; i++) {
+            sk_sp<SkData> data;
+            if (procs.fTypefaceProc) {
+                data = procs.fTypefaceProc(typefaces[i], procs.fTypefaceCtx);
+            }
+            if (!data) {
+                data = typefaces[i]->serialize();
+            }
+            header.writeDataAsByteArray(data.get());
+        }
+
+        header.writeInt(fPaints.count());
+        header.writeInt(fPaths.count());
+        header.writeInt(fImages.count());
+
+        static constexpr uint8_t kZeros[3] = {0, 0, 0};
+        const size_t start = stream->bytesWritten() + 1;
+        const size_t padding = SkAlign4(start) - start;
+        stream->write8(SkToU8(padding));
+        stream->write(kZeros, padding);
+
+        stream->write32(kRecordFormatVersion);
+        write_sized(stream, header);
+        write_sized(stream, tables);
+        write_sized(stream, fOps);
+
+        if (!fWriteIndex) {
+            stream->write32(0);
+            return;
+        }
+        SkBinaryWriteBuffer index;
+        index.writeUInt(SkToU32(fOpOffsets.size()));
+        for (uint32_t offset : fOpOffsets) {
+            index.writeUInt(offset);
+        }
+        for (uint32_t offset : tableOffsets) {
+            index.writeUInt(offset);
+        }
+        fRTree->flatten(index);
+        write_sized(stream, index);
+    }
+
+    template <typename T>
+    void operator()(const T& op) {
+        fOps.writeUInt(T::kType);
+        this->write(op);
+    }
+
+private:
+    void writePaint(const SkPaint& paint) {
+        int* index = fPaintIndices.find(paint);
+        if (!index) {
+            index = fPaintIndices.set(paint, fPaints.count());
+            fPaints.push_back(paint);
+        }
+        fOps.writeInt(*index);
+    }
+
+    void writeOptionalPaint(const SkPaint* paint) {
+        if (paint) {
+            this->writePaint(*paint);
+        } else {
+            fOps.writeInt(-1);
+        }
+    }
+
+    void writePath(const SkPath& path) {
+        int* index = fPathIndices.find(path);
+        if (!index) {
+            index = fPathIndices.set(path, fPaths.count());
+            fPaths.push_back(path);
+        }
+        fOps.writeInt(*index);
+    }
+
+    void writeImage(const SkImage* image) {
+        if (!image) {
+            fOps.writeInt(-1);
+            return;
+        }
+        int* index = fImageIndices.find(image->uniqueID());
+        if (!index) {
+            index = fImageIndices.set(image->uniqueID(), fImages.count());
+            fImages.push_back(sk_ref_sp(image));
+        }
+        fOps.writeInt(*index);
+    }
+
+    void writeOptionalRect(const SkRect* rect) {
+        fOps.writeBool(rect != nullptr);
+        if (rect) {
+            fOps.writeRect(*rect);
+        }
+    }
+
+    void writeRRect(const SkRRect& rrect) {
+        char storage[SkRRect::kSizeInMemory];
+        rrect.writeToMemory(storage);
+        fOps.writePad32(storage, sizeof(storage));
+    }
+
+    template <typename T>
+    void writeArray(const T* array, size_t count) {
+        fOps.writeByteArray(array, count * sizeof(T));
+    }
+
+    template <typename T>
+    void writeOptionalArray(const T* array, size_t count) {
+        fOps.writeBool(array != nullptr);
+        if (array) {
+            this->writeArray(array, count);
+        }
+    }
+
+    void write(const SkRecords::NoOp&) {}
+    void write(const SkRecords::Flush&) {}
+    void write(const SkRecords::Restore&) {}
+    void write(const SkRecords::Save&) {}
+
+    void write(const SkRecords::SaveLayer& op) {
+        this->writeOptionalRect(op.bounds);
+        this->writeOptionalPaint(op.paint);
+        fOps.writeFlattenable(op.backdrop.get());
+        fOps.writeUInt(op.saveLayerFlags);
+    }
+
+    void write(const SkRecords::SaveBehind& op) { this->writeOptionalRect(op.subset); }
+    void write(const SkRecords::MarkCTM& op) { fOps.writeString(op.name.c_str()); }
+    void write(const SkRecords::SetMatrix& op) { fOps.writeMatrix(op.matrix); }
+    void write(const SkRecords::Concat& op) { fOps.writeMatrix(op.matrix); }
+    void write(const SkRecords::Concat44& op) { fOps.write(op.matrix); }
+
+    void write(const SkRecords::Translate& op) {
+        fOps.writeScalar(op.dx);
+        fOps.writeScalar(op.dy);
+    }
+
+    void write(const SkRecords::Scale& op) {
+        fOps.writeScalar(op.sx);
+        fOps.writeScalar(op.sy);
+    }
+
+    void write(const SkRecords::ClipPath& op) {
+        this->writePath(op.path);
+        fOps.writeUInt(static_cast<uint32_t>(op.opAA.op()));
+        fOps.writeBool(op.opAA.aa());
+    }
+
+    void write(const SkRecords::ClipRRect& op) {
+        this->writeRRect(op.rrect);
+        fOps.writeUInt(static_cast<uint32_t>(op.opAA.op()));
+        fOps.writeBool(op.opAA.aa());
+    }
+
+    void write(const SkRecords::ClipRect& op) {
+        fOps.writeRect(op.rect);
+        fOps.writeUInt(static_cast<uint32_t>(op.opAA.op()));
+        fOps.writeBool(op.opAA.aa());
+    }
+
+    void write(const SkRecords::ClipRegion& op) {
+        fOps.writeRegion(op.region);
+        fOps.writeUInt(static_cast<uint32_t>(op.op));
+    }
+
+    void write(const SkRecords::ClipShader& op) {
+        fOps.writeFlattenable(op.shader.get());
+        fOps.writeUInt(static_cast<uint32_t>(op.op));
+    }
+
+    void write(const SkRecords::DrawArc& op) {
+        this->writePaint(op.paint);
+        fOps.writeRect(op.oval);
+        fOps.writeScalar(op.startAngle);
+        fOps.writeScalar(op.sweepAngle);
+        fOps.writeBool(op.useCenter);
+    }
+
+    void write(const SkRecords::DrawDRRect& op) {
+        this->writePaint(op.paint);
+        this->writeRRect(op.outer);
+        this->writeRRect(op.inner);
+    }
+
+    // Drawables are snapshotted into pictures by SkPictureRecorder, so they only show up here
+    // for unusual SkPicture subclasses.  Leave those to the SkPictureData format.
+    void write(const SkRecords::DrawDrawable&) { fOK = false; }
+
+    void write(const SkRecords::DrawImage& op) {
+        this->writeOptionalPaint(op.paint);
+        this->writeImage(op.image.get());
+        fOps.writeScalar(op.left);
+        fOps.writeScalar(op.top);
+    }
+
+    void write(const SkRecords::DrawImageLattice& op) {
+        this->writeOptionalPaint(op.paint);
+        this->writeImage(op.image.get());
+        fOps.writeInt(op.xCount);
+        this->writeArray<int>(op.xDivs, op.xCount);
+        fOps.writeInt(op.yCount);
+        this->writeArray<int>(op.yDivs, op.yCount);
+        fOps.writeInt(op.flagCount);
+        this->writeOptionalArray<SkCanvas::Lattice::RectType>(op.flags, op.flagCount);
+        this->writeOptionalArray<SkColor>(op.colors, op.flagCount);
+        fOps.writeIRect(op.src);
+        fOps.writeRect(op.dst);
+    }
+
+    void write(const SkRecords::DrawImageRect& op) {
+        this->writeOptionalPaint(op.paint);
+        this->writeImage(op.image.get());
+        this->writeOptionalRect(op.src);
+        fOps.writeRect(op.dst);
+        fOps.writeUInt(op.constraint);
+    }
+
+    void write(const SkRecords::DrawImageNine& op) {
+        this->writeOptionalPaint(op.paint);
+        this->writeImage(op.image.get());
+        fOps.writeIRect(op.center);
+        fOps.writeRect(op.dst);
+    }
+
+    void write(const SkRecords::DrawOval& op) {
+        this->writePaint(op.paint);
+        fOps.writeRect(op.oval);
+    }
+
+    void write(const SkRecords::DrawPaint& op) { this->writePaint(op.paint); }
+    void write(const SkRecords::DrawBehind& op) { this->writePaint(op.paint); }
+
+    void write(const SkRecords::DrawPath& op) {
+        this->writePaint(op.paint);
+        this->writePath(op.path);
+    }
+
+    void write(const SkRecords::DrawPicture& op) {
+        this->writeOptionalPaint(op.paint);
+        fOps.writeMatrix(op.matrix);
+        if (!this->writePicture(op.picture.get())) {
+            fOK = false;
+        }
+    }
+
+    void write(const SkRecords::DrawPoints& op) {
+        this->writePaint(op.paint);
+        fOps.writeUInt(op.mode);
+        fOps.writeUInt(op.count);
+        this->writeArray<SkPoint>(op.pts, op.count);
+    }
+
+    void write(const SkRecords::DrawRRect& op) {
+        this->writePaint(op.paint);
+        this->writeRRect(op.rrect);
+    }
+
+    void write(const SkRecords::DrawRect& op) {
+        this->writePaint(op.paint);
+        fOps.writeRect(op.rect);
+    }
+
+    void write(const SkRecords::DrawRegion& op) {
+        this->writePaint(op.paint);
+        fOps.writeRegion(op.region);
+    }
+
+    void write(const SkRecords::DrawTextBlob& op) {
+        this->writePaint(op.paint);
+        SkTextBlobPriv::Flatten(*op.blob, fOps);
+        fOps.writeScalar(op.x);
+        fOps.writeScalar(op.y);
+    }
+
+    void write(const SkRecords::DrawPatch& op) {
+        this->writePaint(op.paint);
+        this->writeOptionalArray<SkPoint>(op.cubics, SkPatchUtils::kNumCtrlPts);
+        this->writeOptionalArray<SkColor>(op.colors, SkPatchUtils::kNumCorners);
+        this->writeOptionalArray<SkPoint>(op.texCoords, SkPatchUtils::kNumCorners);
+        fOps.writeUInt(static_cast<uint32_t>(op.bmode));
+    }
+
+    void write(const SkRecords::DrawAtlas& op) {
+        this->writeOptionalPaint(op.paint);
+        this->writeImage(op.atlas.get());
+        fOps.writeInt(op.count);
+        this->writeArray<SkRSXform>(op.xforms, op.count);
+        this->writeArray<SkRect>(op.texs, op.count);
+        this->writeOptionalArray<SkColor>(op.colors, op.count);
+        fOps.writeUInt(static_cast<uint32_t>(op.mode));
+        this->writeOptionalRect(op.cull);
+    }
+
+    void write(const SkRecords::DrawVertices& op) {
+        this->writePaint(op.paint);
+        op.vertices->priv().encode(fOps);
+        fOps.writeUInt(static_cast<uint32_t>(op.bmode));
+    }
+
+    void write(const SkRecords::DrawShadowRec& op) {
+        this->writePath(op.path);
+        fOps.writePoint3(op.rec.fZPlaneParams);
+        fOps.writePoint3(op.rec.fLightPos);
+        fOps.writeScalar(op.rec.fLightRadius);
+        fOps.writeColor(op.rec.fAmbientColor);
+        fOps.writeColor(op.rec.fSpotColor);
+        fOps.writeUInt(op.rec.fFlags);
+    }
+
+    void write(const SkRecords::DrawAnnotation& op) {
+        fOps.writeRect(op.rect);
+        fOps.writeString(op.key.c_str());
+        fOps.writeBool(op.value != nullptr);
+        fOps.writeDataAsByteArray(op.value.get());
+    }
+
+    void write(const SkRecords::DrawEdgeAAQuad& op) {
+        fOps.writeRect(op.rect);
+        this->writeOptionalArray<SkPoint>(op.clip, 4);
+        fOps.writeUInt(op.aa);
+        fOps.writeColor4f(op.color);
+        fOps.writeUInt(static_cast<uint32_t>(op.mode));
+    }
+
+    void write(const SkRecords::DrawEdgeAAImageSet& op) {
+        int dstClipCount, matrixCount;
+        SkCanvasPriv::GetDstClipAndMatrixCounts(op.set.get(), op.count,
+                                                &dstClipCount, &matrixCount);
+
+        this->writeOptionalPaint(op.paint);
+        fOps.writeInt(op.count);
+        for (int i = 0; i < op.count; i++) {
+            const SkCanvas::ImageSetEntry& entry = op.set[i];
+            this->writeImage(entry.fImage.get());
+            fOps.writeRect(entry.fSrcRect);
+            fOps.writeRect(entry.fDstRect);
+            fOps.writeInt(entry.fMatrixIndex);
+            fOps.writeScalar(entry.fAlpha);
+            fOps.writeUInt(entry.fAAFlags);
+            fOps.writeBool(entry.fHasClip);
+        }
+        this->writeOptionalArray<SkPoint>(op.dstClips, dstClipCount);
+        this->writeOptionalArray<SkMatrix>(op.preViewMatrices, matrixCount);
+        fOps.writeUInt(op.constraint);
+    }
+
+    SkSerialProcs                          fBufferProcs;
+    sk_sp<SkFactorySet>                    fFactories;
+    sk_sp<SkRefCntSet>                     fTypefaces;
+    SkBinaryWriteBuffer                    fOps;
+
+    SkTArray<SkPaint>                      fPaints;
+    SkTArray<SkPath>                       fPaths;
+    SkTArray<sk_sp<const SkImage>>         fImages;
+    SkTHashMap<SkPaint, int, PaintHash>    fPaintIndices;
+    SkTHashMap<SkPath, int, PathHash>      fPathIndices;
+    SkTHashMap<uint32_t, int>              fImageIndices;  // keyed on unique ID
+
+    const bool                             fWriteIndex;
+    std::vector<uint32_t>                  fOpOffsets;     // top-level ops, for the index
+    sk_sp<SkRTree>                         fRTree;
+
+    int                                    fDepth = 0;
+    bool                                   fOK = true;
+};
+
+// The paints, paths and images shared by a picture's ops.
+class RecordTables {
+public:
+    virtual ~RecordTables() = default;
+
+    // These return nullptr if the index is out of range or the entry can't be decoded.
+    virtual const SkPaint* paint(int index) = 0;
+    virtual const SkPath* path(int index) = 0;
+    virtual sk_sp<const SkImage> image(int index) = 0;
+};
+
+// The top-level picture's index (see the layout above), pointing into the index buffer.
+struct RecordIndex {
+    int             fOpCount = 0;
+    const uint32_t* fOpOffsets = nullptr;
+    const uint32_t* fPaintOffsets = nullptr;
+    const uint32_t* fPathOffsets = nullptr;
+    const uint32_t* fImageOffsets = nullptr;
+    sk_sp<SkRTree>  fRTree;
+};
+
+class RecordReader {
+public:
+    RecordReader(SkReadBuffer* buffer, RecordTables* tables)
+        : fBuffer(buffer)
+        , fTables(tables) {}
+
+    // If index is not null, it must describe this picture, which then uses its R-tree.
+    sk_sp<SkPicture> readPicture(const RecordIndex* index = nullptr) {
+        SkRect cull;
+        fBuffer->readRect(&cull);
+        const int count = fBuffer->readInt();
+
+        // Every op takes at least four bytes (its type), which bounds the op count.
+        if (!fBuffer->validate(cull.isFinite() && count >= 0 && fDepth < kMaxPictureDepth) ||
+            !fBuffer->validateCanReadN<uint32_t>(count) ||
+            !fBuffer->validate(!index || index->fOpCount == count)) {
+            return nullptr;
+        }
+
+        auto record = sk_make_sp<SkRecord>();
+        SkRecord* outerRecord = std::exchange(fRecord, record.get());
+        size_t outerSubPictureBytes = std::exchange(fSubPictureBytes, 0);
+        SkM44 outerCTM = std::exchange(fCTM, SkM44());
+        SkTArray<SkM44> outerSavedCTMs = std::exchange(fSavedCTMs, SkTArray<SkM44>());
+
+        fDepth++;
+        for (int i = 0; i < count && fBuffer->isValid(); i++) {
+            this->readOp();
+        }
+        fDepth--;
+
+        const size_t subPictureBytes = std::exchange(fSubPictureBytes, outerSubPictureBytes);
+        fRecord = outerRecord;
+        fCTM = outerCTM;
+        fSavedCTMs = std::move(outerSavedCTMs);
+
+        if (!fBuffer->isValid()) {
+            return nullptr;
+        }
+        if (record->count() == 0) {
+            SkMiniRecorder empty;
+            return empty.detachAsPicture(&cull);
+        }
+        return sk_make_sp<SkBigPicture>(cull, std::move(record), nullptr,
+                                        index ? index->fRTree : nullptr, subPictureBytes);
+    }
+
+    // Reads a single top-level op, out of context, and appends it to record.  The matrix of a
+    // Restore read this way is meaningless (SkRecordDraw() ignores it).
+    void readOp(SkRecord* record) {
+        SkASSERT(fDepth == 0);
+        fRecord = record;
+        this->readOp();
+        fRecord = nullptr;
+    }
+
+private:
+    template <typename T, typename... Args>
+    void append(Args&&... args) {
+        new (fRecord->append<T>()) T{std::forward<Args>(args)...};
+    }
+
+    template <typename T>
+    T* copy(const T& src) {
+        return new (fRecord->alloc<T>()) T(src);
+    }
+
+    const SkPaint& readPaint() {
+        const SkPaint* paint = fTables->paint(fBuffer->readInt());
+        return fBuffer->validate(paint != nullptr) ? *paint : fInvalidPaint;
+    }
+
+    SkPaint* readOptionalPaint() {
+        const int index = fBuffer->readInt();
+        if (index == -1) {
+            return nullptr;
+        }
+        const SkPaint* paint = fTables->paint(index);
+        return fBuffer->validate(paint != nullptr) ? this->copy(*paint) : nullptr;
+    }
+
+    const SkPath& readPath() {
+        const SkPath* path = fTables->path(fBuffer->readInt());
+        return fBuffer->validate(path != nullptr) ? *path : fInvalidPath;
+    }
+
+    sk_sp<const SkImage> readImage() {
+        const int index = fBuffer->readInt();
+        if (index == -1) {
+            return nullptr;
+        }
+        sk_sp<const SkImage> image = fTables->image(index);
+        fBuffer->validate(image != nullptr);
+        return image;
+    }
+
+    SkRect* readOptionalRect() {
+        if (!fBuffer->readBool()) {
+            return nullptr;
+        }
+        SkRect rect;
+        fBuffer->readRect(&rect);
+        return this->copy(rect);
+    }
+
+    SkMatrix readMatrix() {
+        SkMatrix matrix;
+        fBuffer->readMatrix(&matrix);
+        return matrix;
+    }
+
+    SkRRect readRRect() {
+        SkRRect rrect;
+        fBuffer->readRRect(&rrect);
+        return rrect;
+    }
+
+    SkRect readRect() {
+        SkRect rect;
+        fBuffer->readRect(&rect);
+        return rect;
+    }
+
+    SkIRect readIRect() {
+        SkIRect rect;
+        fBuffer->readIRect(&rect);
+        return rect;
+    }
+
+    SkClipOp readClipOp() { return fBuffer->read32LE(SkClipOp::kMax_EnumValue); }
+    SkBlendMode readBlendMode() { return fBuffer->read32LE(SkBlendMode::kLastMode); }
+
+    template <typename T>
+    T* readArray(size_t count) {
+        if (!fBuffer->validateCanReadN<T>(count)) {
+            return nullptr;
+        }
+        T* array = fRecord->alloc<T>(count);
+        return fBuffer->readByteArray(array, count * sizeof(T)) ? array : nullptr;
+    }
+
+    template <typename T>
+    T* readOptionalArray(size_t count) {
+        return fBuffer->readBool() ? this->readArray<T>(count) : nullptr;
+    }
+
+    int readCount() {
+        const int count = fBuffer->readInt();
+        return fBuffer->validate(count >= 0) ? count : 0;
+    }
+
+    void save() { fSavedCTMs.push_back(fCTM); }
+
+    void restore() {
+        if (fDepth == 0) {
+            this->append<SkRecords::Restore>(SkMatrix::I());
+            return;
+        }
+        if (fBuffer->validate(!fSavedCTMs.empty())) {
+            fCTM = fSavedCTMs.back();
+            fSavedCTMs.pop_back();
+        }
+        this->append<SkRecords::Restore>(fCTM.asM33());
+    }
+
+    void readOp() {
+        using namespace SkRecords;
+
+        switch (fBuffer->readUInt()) {
+            case NoOp_Type:  this->append<NoOp>();  break;
+            case Flush_Type: this->append<Flush>(); break;
+            case Save_Type:
+                this->save();
+                this->append<Save>();
+                break;
+            case Restore_Type: this->restore(); break;
+            case SaveLayer_Type: {
+                SkRect* bounds = this->readOptionalRect();
+                SkPaint* paint = this->readOptionalPaint();
+                sk_sp<SkImageFilter> backdrop = fBuffer->readImageFilter();
+                SkCanvas::SaveLayerFlags flags = fBuffer->readUInt();
+                this->save();
+                this->append<SaveLayer>(bounds, paint, std::move(backdrop), flags);
+            } break;
+            case SaveBehind_Type:
+                this->save();
+                this->append<SaveBehind>(this->readOptionalRect());
+                break;
+            case MarkCTM_Type: {
+                SkString name;
+                fBuffer->readString(&name);
+                this->append<MarkCTM>(std::move(name));
+            } break;
+            case SetMatrix_Type: {
+                SkMatrix matrix = this->readMatrix();
+                fCTM = SkM44(matrix);
+                this->append<SetMatrix>(matrix);
+            } break;
+            case Concat_Type: {
+                SkMatrix matrix = this->readMatrix();
+                fCTM.preConcat(matrix);
+                this->append<Concat>(matrix);
+            } break;
+            case Concat44_Type: {
+                SkM44 matrix;
+                fBuffer->read(&matrix);
+                fCTM.preConcat(matrix);
+                this->append<Concat44>(matrix);
+            } break;
+            case Translate_Type: {
+                SkScalar dx = fBuffer->readScalar();
+                SkScalar dy = fBuffer->readScalar();
+                fCTM.preTranslate(dx, dy);
+                this->append<Translate>(dx, dy);
+            } break;
+            case Scale_Type: {
+                SkScalar sx = fBuffer->readScalar();
+                SkScalar sy = fBuffer->readScalar();
+                fCTM.preScale(sx, sy);
+                this->append<Scale>(sx, sy);
+            } break;
+            case ClipPath_Type: {
+                const SkPath& path = this->readPath();
+                SkClipOp op = this->readClipOp();
+                bool aa = fBuffer->readBool();
+                this->append<ClipPath>(path, ClipOpAndAA(op, aa));
+            } break;
+            case ClipRRect_Type: {
+                SkRRect rrect = this->readRRect();
+                SkClipOp op = this->readClipOp();
+                bool aa = fBuffer->readBool();
+                this->append<ClipRRect>(rrect, ClipOpAndAA(op, aa));
+            } break;
+            case ClipRect_Type: {
+                SkRect rect = this->readRect();
+                SkClipOp op = this->readClipOp();
+                bool aa = fBuffer->readBool();
+                this->append<ClipRect>(rect, ClipOpAndAA(op, aa));
+            } break;
+            case ClipRegion_Type: {
+                SkRegion region;
+                fBuffer->readRegion(&region);
+                this->append<ClipRegion>(region, this->readClipOp());
+            } break;
+            case ClipShader_Type: {
+                sk_sp<SkShader> shader = fBuffer->readShader();
+                this->append<ClipShader>(std::move(shader), this->readClipOp());
+            } break;
+            case DrawArc_Type: {
+                const SkPaint& paint = this->readPaint();
+                SkRect oval = this->readRect();
+                SkScalar startAngle = fBuffer->readScalar();
+                SkScalar sweepAngle = fBuffer->readScalar();
+                unsigned useCenter = fBuffer->readBool();
+                this->append<DrawArc>(paint, oval, startAngle, sweepAngle, useCenter);
+            } break;
+            case DrawDRRect_Type: {
+                const SkPaint& paint = this->readPaint();
+                SkRRect outer = this->readRRect();
+                SkRRect inner = this->readRRect();
+                this->append<DrawDRRect>(paint, outer, inner);
+            } break;
+            case DrawImage_Type: {
+                SkPaint* paint = this->readOptionalPaint();
+                sk_sp<const SkImage> image = this->readImage();
+                SkScalar left = fBuffer->readScalar();
+                SkScalar top = fBuffer->readScalar();
+                this->append<DrawImage>(paint, std::move(image), left, top);
+            } break;
+            case DrawImageLattice_Type: {
+                SkPaint* paint = this->readOptionalPaint();
+                sk_sp<const SkImage> image = this->readImage();
+                int xCount = this->readCount();
+                int* xDivs = this->readArray<int>(xCount);
+                int yCount = this->readCount();
+                int* yDivs = this->readArray<int>(yCount);
+                int flagCount = this->readCount();
+                auto* flags = this->readOptionalArray<SkCanvas::Lattice::RectType>(flagCount);
+                SkColor* colors = this->readOptionalArray<SkColor>(flagCount);
+                SkIRect src = this->readIRect();
+                SkRect dst = this->readRect();
+                for (int i = 0; flags && i < flagCount; i++) {
+                    fBuffer->validate(flags[i] <= SkCanvas::Lattice::kFixedColor);
+                }
+                this->append<DrawImageLattice>(paint, std::move(image), xCount, xDivs,
+                                               yCount, yDivs, flagCount, flags, colors,
+                                               src, dst);
+            } break;
+            case DrawImageRect_Type: {
+                SkPaint* paint = this->readOptionalPaint();
+                sk_sp<const SkImage> image = this->readImage();
+                SkRect* src = this->readOptionalRect();
+                SkRect dst = this->readRect();
+                auto constraint = fBuffer->read32LE(SkCanvas::kFast_SrcRectConstraint);
+                this->append<DrawImageRect>(paint, std::move(image), src, dst, constraint);
+            } break;
+            case DrawImageNine_Type: {
+                SkPaint* paint = this->readOptionalPaint();
+                sk_sp<const SkImage> image = this->readImage();
+                SkIRect center = this->readIRect();
+                SkRect dst = this->readRect();
+                this->append<DrawImageNine>(paint, std::move(image), center, dst);
+            } break;
+            case DrawOval_Type: {
+                const SkPaint& paint = this->readPaint();
+                this->append<DrawOval>(paint, this->readRect());
+            } break;
+            case DrawPaint_Type:  this->append<DrawPaint>(this->readPaint());  break;
+            case DrawBehind_Type: this->append<DrawBehind>(this->readPaint()); break;
+            case DrawPath_Type: {
+                const SkPaint& paint = this->readPaint();
+                this->append<DrawPath>(paint, this->readPath());
+            } break;
+            case DrawPicture_Type: {
+                SkPaint* paint = this->readOptionalPaint();
+                SkMatrix matrix = this->readMatrix();
+                sk_sp<SkPicture> picture = this->readPicture();
+                if (!picture) {
+                    fBuffer->validate(false);
+                    picture = SkPicture::MakePlaceholder(SkRect::MakeEmpty());
+                }
+                fSubPictureBytes += picture->approximateBytesUsed();
+                this->append<DrawPicture>(paint, std::move(picture), matrix);
+            } break;
+            case DrawPoints_Type: {
+                const SkPaint& paint = this->readPaint();
+                auto mode = fBuffer->read32LE(SkCanvas::kPolygon_PointMode);
+                unsigned count = fBuffer->readUInt();
+                SkPoint* pts = this->readArray<SkPoint>(count);
+                this->append<DrawPoints>(paint, mode, count, pts);
+            } break;
+            case DrawRRect_Type: {
+                const SkPaint& paint = this->readPaint();
+                this->append<DrawRRect>(paint, this->readRRect());
+            } break;
+            case DrawRect_Type: {
+                const SkPaint& paint = this->readPaint();
+                this->append<DrawRect>(paint, this->readRect());
+            } break;
+            case DrawRegion_Type: {
+                const SkPaint& paint = this->readPaint();
+                SkRegion region;
+                fBuffer->readRegion(&region);
+                this->append<DrawRegion>(paint, region);
+            } break;
+            case DrawTextBlob_Type: {
+                const SkPaint& paint = this->readPaint();
+                sk_sp<SkTextBlob> blob = SkTextBlobPriv::MakeFromBuffer(*fBuffer);
+                SkScalar x = fBuffer->readScalar();
+                SkScalar y = fBuffer->readScalar();
+                if (fBuffer->validate(blob != nullptr)) {
+                    this->append<DrawTextBlob>(paint, std::move(blob), x, y);
+                }
+            } break;
+            case DrawPatch_Type: {
+                const SkPaint& paint = this->readPaint();
+                SkPoint* cubics = this->readOptionalArray<SkPoint>(SkPatchUtils::kNumCtrlPts);
+                SkColor* colors = this->readOptionalArray<SkColor>(SkPatchUtils::kNumCorners);
+                SkPoint* texCoords = this->readOptionalArray<SkPoint>(SkPatchUtils::kNumCorners);
+                this->append<DrawPatch>(paint, cubics, colors, texCoords, this->readBlendMode());
+            } break;
+            case DrawAtlas_Type: {
+                SkPaint* paint = this->readOptionalPaint();
+                sk_sp<const SkImage> atlas = this->readImage();
+                int count = this->readCount();
+                SkRSXform* xforms = this->readArray<SkRSXform>(count);
+                SkRect* texs = this->readArray<SkRect>(count);
+                SkColor* colors = this->readOptionalArray<SkColor>(count);
+                SkBlendMode mode = this->readBlendMode();
+                SkRect* cull = this->readOptionalRect();
+                this->append<DrawAtlas>(paint, std::move(atlas), xforms, texs, colors, count,
+                                        mode, cull);
+            } break;
+            case DrawVertices_Type: {
+                const SkPaint& paint = this->readPaint();
+                sk_sp<SkVertices> vertices = SkVerticesPriv::Decode(*fBuffer);
+                SkBlendMode mode = this->readBlendMode();
+                if (fBuffer->validate(vertices != nullptr)) {
+                    this->append<DrawVertices>(paint, std::move(vertices), mode);
+                }
+            } break;
+            case DrawShadowRec_Type: {
+                const SkPath& path = this->readPath();
+                SkDrawShadowRec rec;
+                fBuffer->readPoint3(&rec.fZPlaneParams);
+                fBuffer->readPoint3(&rec.fLightPos);
+                rec.fLightRadius  = fBuffer->readScalar();
+                rec.fAmbientColor = fBuffer->readColor();
+                rec.fSpotColor    = fBuffer->readColor();
+                rec.fFlags        = fBuffer->readUInt();
+                this->append<DrawShadowRec>(path, rec);
+            } break;
+            case DrawAnnotation_Type: {
+                SkRect rect = this->readRect();
+                SkString key;
+                fBuffer->readString(&key);
+                const bool hasValue = fBuffer->readBool();
+                sk_sp<SkData> value = fBuffer->readByteArrayAsData();
+                this->append<DrawAnnotation>(rect, std::move(key),
+                                             hasValue ? std::move(value) : nullptr);
+            } break;
+            case DrawEdgeAAQuad_Type: {
+                SkRect rect = this->readRect();
+                SkPoint* clip = this->readOptionalArray<SkPoint>(4);
+                auto aa = fBuffer->read32LE(SkCanvas::kAll_QuadAAFlags);
+                SkColor4f color;
+                fBuffer->readColor4f(&color);
+                this->append<DrawEdgeAAQuad>(rect, clip, aa, color, this->readBlendMode());
+            } break;
+            case DrawEdgeAAImageSet_Type: {
+                SkPaint* paint = this->readOptionalPaint();
+                int count = this->readCount();
+                // Each entry takes at least 16 words.
+                if (!fBuffer->validateCanReadN<uint32_t>(16 * (size_t)count)) {
+                    break;
+                }
+                SkAutoTArray<SkCanvas::ImageSetEntry> set(count);
+                for (int i = 0; i < count; i++) {
+                    SkCanvas::ImageSetEntry& entry = set[i];
+                    entry.fImage = this->readImage();
+                    fBuffer->readRect(&entry.fSrcRect);
+                    fBuffer->readRect(&entry.fDstRect);
+                    entry.fMatrixIndex = fBuffer->readInt();
+                    entry.fAlpha = fBuffer->readScalar();
+                    entry.fAAFlags = fBuffer->read32LE(SkCanvas::kAll_QuadAAFlags);
+                    entry.fHasClip = fBuffer->readBool();
+                }
+                int dstClipCount, matrixCount;
+                SkCanvasPriv::GetDstClipAndMatrixCounts(set.get(), count,
+                                                        &dstClipCount, &matrixCount);
+                SkPoint* dstClips = this->readOptionalArray<SkPoint>(dstClipCount);
+                SkMatrix* matrices = this->readOptionalArray<SkMatrix>(matrixCount);
+                auto constraint = fBuffer->read32LE(SkCanvas::kFast_SrcRectConstraint);
+                fBuffer->validate((dstClipCount == 0 || dstClips) &&
+                                  (matrixCount  == 0 || matrices));
+                this->append<DrawEdgeAAImageSet>(paint, std::move(set), count, dstClips,
+                                                 matrices, constraint);
+            } break;
+            default:
+                // Includes DrawDrawable, which is never written.
+                fBuffer->validate(false);
+                break;
+        }
+    }
+
+    SkReadBuffer*                      fBuffer;
+    RecordTables*                      fTables;
+    const SkPaint                      fInvalidPaint;
+    const SkPath                       fInvalidPath;
+
+    SkRecord*                          fRecord = nullptr;
+    size_t                             fSubPictureBytes = 0;
+    SkM44                              fCTM;
+    SkTArray<SkM44>                    fSavedCTMs;
+    int                                fDepth = 0;
+};
+
+// Reads a u32 size followed by that many bytes.  If backing holds the stream's contents, returns
+// a subset of it (when suitably aligned for SkReadBuffer) rather than a copy.
+sk_sp<SkData> read_sized_data(SkStream* stream, const sk_sp<SkData>& backing) {
+    uint32_t size;
+    if (!stream->readU32(&size) || SkAlign4(size) != size) {
+        return nullptr;
+    }
+    if (stream->hasLength() && stream->hasPosition() &&
+        size > stream->getLength() - stream->getPosition()) {
+        return nullptr;
+    }
+    if (backing) {
+        auto data = SkData::MakeSubset(backing.get(), stream->getPosition(), size);
+        if (!data || stream->skip(size) != size) {
+            return nullptr;
+        }
+        return SkIsAlign4((uintptr_t)data->data()) ? data
+                                                   : SkData::MakeWithCopy(data->data(), size);
+    }
+    auto data = SkData::MakeUninitialized(size);
+    if (stream->read(data->writable_data(), size) != size) {
+        return nullptr;
+    }
+    return data;
+}
+
+// What every op and table buffer needs to decode, from the header buffer.
+struct RecordContext {
+    uint32_t                            fVersion = 0;
+    SkDeserialProcs                     fProcs;
+    std::vector<SkFlattenable::Factory> fFactories;
+    SkTArray<sk_sp<SkTypeface>>         fTypefaces;
+    int                                 fPaintCount = 0,
+                                        fPathCount  = 0,
+                                        fImageCount = 0;
+
+    void setupBuffer(SkReadBuffer* buffer) {
+        buffer->setVersion(fVersion);
+        buffer->setDeserialProcs(fProcs);
+        buffer->setTypefaceArray(fTypefaces.begin(), fTypefaces.count());
+        buffer->setFactoryPlayback(fFactories.data(), SkToInt(fFactories.size()));
+    }
+
+    bool read(SkReadBuffer* header) {
+        const int factoryCount = header->readInt();
+        if (!header->validate(factoryCount >= 0) ||
+            !header->validateCanReadN<uint32_t>(factoryCount)) {
+            return false;
+        }
+        fFactories.reserve(factoryCount);
+        for (int i = 0; i < factoryCount && header->isValid(); i++) {
+            SkString name;
+            header->readString(&name);
+            fFactories.push_back(SkFlattenable::NameToFactory(name.c_str()));
+        }
+
+        const int typefaceCount = header->readInt();
+        if (!header->validate(typefaceCount >= 0) ||
+            !header->validateCanReadN<uint32_t>(typefaceCount)) {
+            return false;
+        }
+        for (int i = 0; i < typefaceCount && header->isValid(); i++) {
+            sk_sp<SkData> data = header->readByteArrayAsData();
+            SkMemoryStream stream(std::move(data));
+            sk_sp<SkTypeface> tf;
+            if (fProcs.fTypefaceProc) {
+                // Like SkPictureData, hand the proc the stream rather than the bytes.
+                SkStream* streamPtr = &stream;
+                tf = fProcs.fTypefaceProc(&streamPtr, sizeof(streamPtr), fProcs.fTypefaceCtx);
+            } else {
+                tf = SkTypeface::MakeDeserialize(&stream);
+            }
+            // Like SkPictureData, fall back to the default typeface.
+            fTypefaces.push_back(tf ? std::move(tf) : SkTypeface::MakeDefault());
+        }
+
+        fPaintCount = header->readInt();
+        fPathCount  = header->readInt();
+        fImageCount = header->readInt();
+        return header->validate(fPaintCount >= 0 && fPathCount >= 0 && fImageCount >= 0) &&
+               header->eof();
+    }
+};
+
+// Every section of the payload, undecoded.
+struct RecordSections {
+    RecordContext fContext;
+    sk_sp<SkData> fTables;
+    sk_sp<SkData> fOps;
+    sk_sp<SkData> fIndex;  // empty if the picture was written without one
+};
+
+bool read_sections(SkStream* stream, const sk_sp<SkData>& backing, const SkPictInfo& info,
+                   const SkDeserialProcs& procs, RecordSections* sections) {
+    uint8_t padding;
+    uint32_t version;
+    if (!stream->readU8(&padding) || padding > 3 || stream->skip(padding) != padding ||
+        !stream->readU32(&version) || version != kRecordFormatVersion) {
+        return false;
+    }
+
+    sk_sp<SkData> headerData = read_sized_data(stream, nullptr);
+    if (!headerData) {
+        return false;
+    }
+    SkReadBuffer header(headerData->data(), headerData->size());
+    header.setVersion(info.getVersion());
+    sections->fContext.fVersion = info.getVersion();
+    sections->fContext.fProcs = procs;
+    if (!sections->fContext.read(&header)) {
+        return false;
+    }
+
+    sections->fTables = read_sized_data(stream, backing);
+    sections->fOps    = read_sized_data(stream, backing);
+    sections->fIndex  = read_sized_data(stream, backing);
+    return sections->fTables && sections->fOps && sections->fIndex;
+}
+
+bool read_offsets(SkReadBuffer* buffer, int count, size_t limit, const uint32_t** offsets) {
+    *offsets = buffer->skipT<uint32_t>(count);
+    for (int i = 0; i < count && *offsets; i++) {
+        if (!buffer->validate((*offsets)[i] < limit && SkIsAlign4((*offsets)[i]))) {
+            return false;
+        }
+    }
+    return *offsets != nullptr;
+}
+
+bool read_index(const RecordSections& sections, RecordIndex* index) {
+    const RecordContext& context = sections.fContext;
+    SkReadBuffer buffer(sections.fIndex->data(), sections.fIndex->size());
+    index->fOpCount = buffer.readInt();
+    if (!buffer.validate(index->fOpCount >= 0) ||
+        !read_offsets(&buffer, index->fOpCount,    sections.fOps->size(),    &index->fOpOffsets) ||
+        !read_offsets(&buffer, context.fPaintCount, sections.fTables->size(),
+                      &index->fPaintOffsets) ||
+        !read_offsets(&buffer, context.fPathCount,  sections.fTables->size(),
+                      &index->fPathOffsets) ||
+        !read_offsets(&buffer, context.fImageCount, sections.fTables->size(),
+                      &index->fImageOffsets)) {
+        return false;
+    }
+    index->fRTree = SkRTree::MakeFromBuffer(buffer, index->fOpCount);
+    return index->fRTree && buffer.eof();
+}
+
+// Tables decoded up front, in order.
+class DecodedTables final : public RecordTables {
+public:
+    bool decode(RecordSections* sections) {
+        const RecordContext& context = sections->fContext;
+        SkReadBuffer buffer(sections->fTables->data(), sections->fTables->size());
+        sections->fContext.setupBuffer(&buffer);
+
+        // Every table entry takes at least four bytes.
+        if (!buffer.validateCanReadN<uint32_t>(context.fPaintCount) ||
+            !buffer.validateCanReadN<uint32_t>(context.fPathCount) ||
+            !buffer.validateCanReadN<uint32_t>(context.fImageCount)) {
+            return false;
+        }
+
+        fPaints.reserve(context.fPaintCount);
+        for (int i = 0; i < context.fPaintCount && buffer.isValid(); i++) {
+            buffer.readPaint(&fPaints.push_back(), nullptr);
+        }
+        fPaths.reserve(context.fPathCount);
+        for (int i = 0; i < context.fPathCount && buffer.isValid(); i++) {
+            buffer.readPath(&fPaths.push_back());
+        }
+        fImages.reserve(context.fImageCount);
+        for (int i = 0; i < context.fImageCount && buffer.isValid(); i++) {
+            fImages.push_back(buffer.readImage());
+            buffer.validate(fImages.back() != nullptr);
+        }
+        return buffer.isValid() && buffer.eof();
+    }
+
+    const SkPaint* paint(int index) override {
+        return index >= 0 && index < fPaints.count() ? &fPaints[index] : nullptr;
+    }
+    const SkPath* path(int index) override {
+        return index >= 0 && index < fPaths.count() ? &fPaths[index] : nullptr;
+    }
+    sk_sp<const SkImage> image(int index) override {
+        return index >= 0 && index < fImages.count() ? fImages[index] : nullptr;
+    }
+
+private:
+    SkTArray<SkPaint>           fPaints;
+    SkTArray<SkPath>            fPaths;
+    SkTArray<sk_sp<SkImage>>    fImages;
+};
+
+// Tables decoded an entry at a time, the first time an op refers to it.  Thread safe.
+class LazyTables final : public RecordTables {
+public:
+    LazyTables(RecordContext* context, sk_sp<SkData> data, const RecordIndex& index)
+        : fContext(context)
+        , fData(std::move(data))
+        , fPaintOffsets(index.fPaintOffsets)
+        , fPathOffsets(index.fPathOffsets)
+        , fImageOffsets(index.fImageOffsets)
+        , fPaints(context->fPaintCount)
+        , fPaths(context->fPathCount)
+        , fImages(context->fImageCount) {}
+
+    const SkPaint* paint(int index) override {
+        return this->get(fPaints.get(), fPaintOffsets, fContext->fPaintCount, index,
+                         [](SkReadBuffer* buffer, SkPaint* paint) {
+            buffer->readPaint(paint, nullptr);
+        });
+    }
+
+    const SkPath* path(int index) override {
+        return this->get(fPaths.get(), fPathOffsets, fContext->fPathCount, index,
+                         [](SkReadBuffer* buffer, SkPath* path) { buffer->readPath(path); });
+    }
+
+    sk_sp<const SkImage> image(int index) override {
+        const sk_sp<SkImage>* image =
+                this->get(fImages.get(), fImageOffsets, fContext->fImageCount, index,
+                          [](SkReadBuffer* buffer, sk_sp<SkImage>* image) {
+            *image = buffer->readImage();
+            buffer->validate(*image != nullptr);
+        });
+        return image ? *image : nullptr;
+    }
+
+    size_t bytesUsed() const {
+        return fData->size() + fContext->fPaintCount * sizeof(Entry<SkPaint>)
+                             + fContext->fPathCount  * sizeof(Entry<SkPath>)
+                             + fContext->fImageCount * sizeof(Entry<sk_sp<SkImage>>);
+    }
+
+private:
+    template <typename T>
+    struct Entry {
+        SkOnce fOnce;
+        T      fValue;
+        bool   fValid = false;
+    };
+
+    template <typename T, typename Decode>
+    const T* get(Entry<T>* entries, const uint32_t* offsets, int count, int index,
+                 Decode&& decode) {
+        if (index < 0 || index >= count) {
+            return nullptr;
+        }
+        Entry<T>& entry = entries[index];
+        entry.fOnce([&] {
+            SkReadBuffer buffer(fData->bytes() + offsets[index], fData->size() - offsets[index]);
+            fContext->setupBuffer(&buffer);
+            decode(&buffer, &entry.fValue);
+            entry.fValid = buffer.isValid();
+        });
+        return entry.fValid ? &entry.fValue : nullptr;
+    }
+
+    RecordContext*                          fContext;
+    const sk_sp<SkData>                     fData;
+    const uint32_t*                         fPaintOffsets;
+    const uint32_t*                         fPathOffsets;
+    const uint32_t*                         fImageOffsets;
+    SkAutoTArray<Entry<SkPaint>>            fPaints;
+    SkAutoTArray<Entry<SkPath>>             fPaths;
+    SkAutoTArray<Entry<sk_sp<SkImage>>>     fImages;
+};
+
+}  // namespace
+
+// Plays back a picture straight from its serialized form: each playback looks up the ops that
+// intersect the canvas clip in the index's R-tree, decodes only those, and draws them.  Paints,
+// paths and images are decoded (once) the first time a decoded op needs them.
+class SkLazyRecordPicture final : public SkPicture {
+public:
+    SkLazyRecordPicture(const SkRect& cull, RecordSections&& sections, const RecordIndex& index)
+        : fCull(cull)
+        , fContext(std::make_unique<RecordContext>(std::move(sections.fContext)))
+        , fOps(std::move(sections.fOps))
+        , fIndexData(std::move(sections.fIndex))
+        , fIndex(index)
+        , fTables(std::make_unique<LazyTables>(fContext.get(), std::move(sections.fTables),
+                                               index)) {}
+
+    void playback(SkCanvas* canvas, AbortCallback* callback) const override {
+        // Like SkBigPicture, skip the R-tree when the whole picture is visible anyway.
+        std::vector<int> ops;
+        const SkRect clip = canvas->getLocalClipBounds();
+        if (clip.contains(fCull)) {
+            ops.resize(fIndex.fOpCount);
+            std::iota(ops.begin(), ops.end(), 0);
+        } else {
+            fIndex.fRTree->search(clip, &ops);
+        }
+
+        SkRecord record;
+        for (int op : ops) {
+            const uint32_t offset = fIndex.fOpOffsets[op];
+            SkReadBuffer buffer(fOps->bytes() + offset, fOps->size() - offset);
+            fContext->setupBuffer(&buffer);
+
+            const int count = record.count();
+            RecordReader(&buffer, fTables.get()).readOp(&record);
+            if (!buffer.isValid() && record.count() > count) {
+                // Don't draw whatever was pieced together from a bad op.
+                new (record.replace<SkRecords::NoOp>(count)) SkRecords::NoOp;
+            }
+        }
+        SkRecordDraw(record, canvas, nullptr, nullptr, 0, nullptr, callback);
+    }
+
+    SkRect cullRect() const override { return fCull; }
+    int approximateOpCount(bool) const override { return fIndex.fOpCount; }
+
+    size_t approximateBytesUsed() const override {
+        return sizeof(*this) + fOps->size() + fIndexData->size() + fIndex.fRTree->bytesUsed() +
+               fTables->bytesUsed();
+    }
+
+private:
+    const SkRect                   fCull;
+    std::unique_ptr<RecordContext> fContext;
+    const sk_sp<SkData>            fOps;
+    const sk_sp<SkData>            fIndexData;  // fIndex points into this
+    const RecordIndex              fIndex;
+    std::unique_ptr<LazyTables>    fTables;
+};
+
+bool SkRecordSerialize(const SkPicture* picture, SkWStream* stream, const SkSerialProcs& procs,
+                       bool writeIndex) {
+    RecordWriter writer(procs, writeIndex);
+    if (!writer.writePicture(picture)) {
+        return false;
+    }
+    writer.finish(stream, procs);
+    return true;
+}
+
+sk_sp<SkPicture> SkRecordDeserialize(SkStream* stream, const SkPictInfo& info,
+                                     const SkDeserialProcs& procs) {
+    RecordSections sections;
+    if (!read_sections(stream, nullptr, info, procs, &sections)) {
+        return nullptr;
+    }
+
+    RecordIndex index;
+    if (sections.fIndex->size() > 0 && !read_index(sections, &index)) {
+        return nullptr;
+    }
+
+    DecodedTables tables;
+    if (!tables.decode(&sections)) {
+        return nullptr;
+    }
+
+    SkReadBuffer ops(sections.fOps->data(), sections.fOps->size());
+    sections.fContext.setupBuffer(&ops);
+
+    sk_sp<SkPicture> picture = RecordReader(&ops, &tables)
+            .readPicture(index.fRTree ? &index : nullptr);
+    if (!ops.isValid() || !ops.eof()) {
+        return nullptr;
+    }
+    return picture;
+}
+
+sk_sp<SkPicture> SkRecordDeserializeLazy(SkMemoryStream* stream, const SkPictInfo& info,
+                                         const SkDeserialProcs& procs) {
+    RecordSections sections;
+    RecordIndex index;
+    if (!read_sections(stream, stream->asData(), info, procs, &sections) ||
+        sections.fIndex->size() == 0 || !read_index(sections, &index)) {
+        return nullptr;
+    }
+
+    // Check the top-level picture's cull rect and op count against the index, but leave the ops
+    // themselves for playback.
+    SkReadBuffer ops(sections.fOps->data(), sections.fOps->size());
+    SkRect cull;
+    ops.readRect(&cull);
+    const int count = ops.readInt();
+    if (!ops.validate(cull.isFinite() && count == index.fOpCount)) {
+        return nullptr;
+    }
+    return sk_sp<SkPicture>(new SkLazyRecordPicture(cull, std::move(sections), index));
+}
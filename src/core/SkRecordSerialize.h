@@ -0,0 +1,43 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordSerialize_DEFINED
+#define SkRecordSerialize_DEFINED
+
+#include "include/core/SkRefCnt.h"
+
+class SkMemoryStream;
+class SkPicture;
+class SkStream;
+class SkWStream;
+struct SkDeserialProcs;
+struct SkPictInfo;
+struct SkSerialProcs;
+
+// A serialized form of SkPicture that mirrors SkRecord directly.
+//
+// The SkPictureData format is decoded by replaying its op stream through SkPicturePlayback into
+// an SkRecorder.  Here each SkRecords op is written as-is (sharing paints, paths and images in
+// side tables), so deserialization can placement-new the ops straight into an SkRecord.
+//
+// This is the payload that follows the SkPictInfo header and trailing stream byte.
+
+// Returns false if the picture can't be expressed in this format, in which case nothing has been
+// written to the stream.  With writeIndex, also writes the op offsets and R-tree that
+// SkRecordDeserializeLazy() needs.
+bool SkRecordSerialize(const SkPicture*, SkWStream*, const SkSerialProcs&, bool writeIndex);
+
+// Returns nullptr if the stream does not hold a valid payload.
+sk_sp<SkPicture> SkRecordDeserialize(SkStream*, const SkPictInfo&, const SkDeserialProcs&);
+
+// Like SkRecordDeserialize(), but the picture keeps the stream's data (which may be mapped from a
+// file) and decodes just the ops each playback's clip touches, rather than decoding everything up
+// front.  Returns nullptr if the payload is invalid or was written without an index.
+sk_sp<SkPicture> SkRecordDeserializeLazy(SkMemoryStream*, const SkPictInfo&,
+                                         const SkDeserialProcs&);
+
+#endif//SkRecordSerialize_DEFINED
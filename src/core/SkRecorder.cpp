@@ -7,12 +7,15 @@
 
 #include "src/core/SkRecorder.h"
 
+#include "include/core/SkData.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkSurface.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkPathPriv.h"
 #include "src/utils/SkPatchUtils.h"
 
 #include <memory>
@@ -63,6 +66,103 @@ void SkRecorder::forgetRecord() {
     fDrawableList.reset(nullptr);
     fApproxBytesUsedBySubPictures = 0;
     fRecord = nullptr;
+    this->forgetContent();
+}
+
+void SkRecorder::forgetContent() {
+    fPaths.reset();
+    fPathsByID.reset();
+    fImages.reset();
+    fImagesByID.reset();
+}
+
+uint32_t SkRecorder::PathContentHash::operator()(const SkPath& path) const {
+    uint32_t hash = SkOpts::hash(SkPathPriv::PointData(path),
+                                 path.countPoints() * sizeof(SkPoint),
+                                 (uint32_t)path.getFillType());
+    hash = SkOpts::hash(SkPathPriv::VerbData(path), path.countVerbs(), hash);
+    return SkOpts::hash(SkPathPriv::ConicWeightData(path),
+                        SkPathPriv::ConicWeightCnt(path) * sizeof(SkScalar), hash);
+}
+
+SkPath SkRecorder::dedup(const SkPath& path) {
+    // Volatile paths are drawn once and thrown away, so aren't worth hashing.
+    if (!fDedupContent || path.isVolatile() || path.isEmpty()) {
+        return path;
+    }
+    // Like images, the same path is usually drawn many times, so check its generation ID first.
+    const uint64_t id = (uint64_t)path.getGenerationID() << 8 | (uint64_t)path.getFillType();
+    if (const SkPath* found = fPathsByID.find(id)) {
+        return *found;
+    }
+
+    SkPath canonical = path;
+    if (const SkPath* found = fPaths.find(path)) {
+        canonical = *found;  // Shares found's SkPathRef.
+    } else {
+        fPaths.add(path);
+    }
+    fPathsByID.set(id, canonical);
+    return canonical;
+}
+
+static bool same_pixels(const SkPixmap& a, const SkPixmap& b) {
+    const size_t rowBytes = a.info().minRowBytes();
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.addr(0, y), b.addr(0, y), rowBytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkRecorder::ImageContent::operator==(const ImageContent& that) const {
+    if (fHash != that.fHash || fImage->imageInfo() != that.fImage->imageInfo() ||
+        SkToBool(fEncoded) != SkToBool(that.fEncoded)) {
+        return false;
+    }
+    if (fEncoded) {
+        return fEncoded->equals(that.fEncoded.get());
+    }
+    SkPixmap a, b;
+    return fImage->peekPixels(&a) && that.fImage->peekPixels(&b) && same_pixels(a, b);
+}
+
+sk_sp<const SkImage> SkRecorder::dedup(const SkImage* image) {
+    if (!fDedupContent || !image) {
+        return sk_ref_sp(image);
+    }
+    // The same image is usually drawn many times, so check its uniqueID before hashing anything.
+    if (sk_sp<const SkImage>* found = fImagesByID.find(image->uniqueID())) {
+        return *found;
+    }
+
+    ImageContent content = {sk_ref_sp(image), nullptr, 0};
+    const SkImageInfo& info = image->imageInfo();
+    const SkISize size = info.dimensions();
+    uint32_t hash = SkOpts::hash(&size, sizeof(size), info.colorType() << 8 | info.alphaType());
+    SkPixmap pixmap;
+    if (image->isTextureBacked()) {
+        // Reading the pixels back to hash them would cost more than we'd save.
+    } else if ((content.fEncoded = image->refEncodedData())) {
+        content.fHash = SkOpts::hash(content.fEncoded->data(), content.fEncoded->size(), hash);
+    } else if (image->peekPixels(&pixmap)) {
+        for (int y = 0; y < pixmap.height(); y++) {
+            hash = SkOpts::hash(pixmap.addr(0, y), pixmap.info().minRowBytes(), hash);
+        }
+        content.fHash = hash;
+    }
+
+    sk_sp<const SkImage> canonical = content.fImage;
+    if (content.fEncoded || pixmap.addr()) {
+        if (const ImageContent* found = fImages.find(content)) {
+            canonical = found->fImage;
+        } else {
+            fImages.add(std::move(content));
+        }
+    }
+    fImagesByID.set(image->uniqueID(), canonical);
+    return canonical;
 }
 
 // To make appending to fRecord a little less verbose.
@@ -182,29 +282,29 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
     TRY_MINIRECORDER(drawPath, path, paint);
-    this->append<SkRecords::DrawPath>(paint, path);
+    this->append<SkRecords::DrawPath>(paint, this->dedup(path));
 }
 
 void SkRecorder::onDrawImage(const SkImage* image, SkScalar left, SkScalar top,
                              const SkPaint* paint) {
-    this->append<SkRecords::DrawImage>(this->copy(paint), sk_ref_sp(image), left, top);
+    this->append<SkRecords::DrawImage>(this->copy(paint), this->dedup(image), left, top);
 }
 
 void SkRecorder::onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
                                  const SkPaint* paint, SrcRectConstraint constraint) {
-    this->append<SkRecords::DrawImageRect>(this->copy(paint), sk_ref_sp(image), this->copy(src), dst, constraint);
+    this->append<SkRecords::DrawImageRect>(this->copy(paint), this->dedup(image), this->copy(src), dst, constraint);
 }
 
 void SkRecorder::onDrawImageNine(const SkImage* image, const SkIRect& center,
                                  const SkRect& dst, const SkPaint* paint) {
-    this->append<SkRecords::DrawImageNine>(this->copy(paint), sk_ref_sp(image), center, dst);
+    this->append<SkRecords::DrawImageNine>(this->copy(paint), this->dedup(image), center, dst);
 }
 
 void SkRecorder::onDrawImageLattice(const SkImage* image, const Lattice& lattice, const SkRect& dst,
                                     const SkPaint* paint) {
     int flagCount = lattice.fRectTypes ? (lattice.fXCount + 1) * (lattice.fYCount + 1) : 0;
     SkASSERT(lattice.fBounds);
-    this->append<SkRecords::DrawImageLattice>(this->copy(paint), sk_ref_sp(image),
+    this->append<SkRecords::DrawImageLattice>(this->copy(paint), this->dedup(image),
            lattice.fXCount, this->copy(lattice.fXDivs, lattice.fXCount),
            lattice.fYCount, this->copy(lattice.fYDivs, lattice.fYCount),
            flagCount, this->copy(lattice.fRectTypes, flagCount),
@@ -243,7 +343,7 @@ void SkRecorder::onDrawAtlas(const SkImage* atlas, const SkRSXform xform[], cons
                              const SkColor colors[], int count, SkBlendMode mode,
                              const SkRect* cull, const SkPaint* paint) {
     this->append<SkRecords::DrawAtlas>(this->copy(paint),
-           sk_ref_sp(atlas),
+           this->dedup(atlas),
            this->copy(xform, count),
            this->copy(tex, count),
            this->copy(colors, count),
@@ -253,7 +353,7 @@ void SkRecorder::onDrawAtlas(const SkImage* atlas, const SkRSXform xform[], cons
 }
 
 void SkRecorder::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
-    this->append<SkRecords::DrawShadowRec>(path, rec);
+    this->append<SkRecords::DrawShadowRec>(this->dedup(path), rec);
 }
 
 void SkRecorder::onDrawAnnotation(const SkRect& rect, const char key[], SkData* value) {
@@ -275,6 +375,7 @@ void SkRecorder::onDrawEdgeAAImageSet(const ImageSetEntry set[], int count,
     SkAutoTArray<ImageSetEntry> setCopy(count);
     for (int i = 0; i < count; ++i) {
         setCopy[i] = set[i];
+        setCopy[i].fImage = this->dedup(set[i].fImage.get());
     }
 
     this->append<SkRecords::DrawEdgeAAImageSet>(this->copy(paint), std::move(setCopy), count,
@@ -346,7 +447,7 @@ void SkRecorder::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle ed
 void SkRecorder::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) {
     INHERITED(onClipPath, path, op, edgeStyle);
     SkRecords::ClipOpAndAA opAA(op, kSoft_ClipEdgeStyle == edgeStyle);
-    this->append<SkRecords::ClipPath>(path, opAA);
+    this->append<SkRecords::ClipPath>(this->dedup(path), opAA);
 }
 
 void SkRecorder::onClipShader(sk_sp<SkShader> cs, SkClipOp op) {
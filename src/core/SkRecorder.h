@@ -10,6 +10,7 @@
 
 #include "include/core/SkCanvasVirtualEnforcer.h"
 #include "include/private/SkTDArray.h"
+#include "include/private/SkTHash.h"
 #include "include/utils/SkNoDrawCanvas.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkMiniRecorder.h"
@@ -53,6 +54,13 @@ public:
     // Make SkRecorder forget entirely about its SkRecord*; all calls to SkRecorder will fail.
     void forgetRecord();
 
+    // Off by default.  See SkPictureRecorder::kDeduplicateContent_RecordFlag.
+    void setDedupContent(bool dedup) { fDedupContent = dedup; }
+
+    // Drop the refs held to deduplicate paths and images.  Recording may continue, but won't
+    // share content with what was recorded before.
+    void forgetContent();
+
     void onFlush() override;
 
     void willSave() override;
@@ -128,11 +136,40 @@ private:
     template<typename T, typename... Args>
     void append(Args&&...);
 
+    // Identical paths and images recorded from different objects share one copy, so the record
+    // (and any SKP written from it) holds each just once, and every draw of an image finds the
+    // same decode in SkResourceCache.
+    SkPath dedup(const SkPath&);
+    sk_sp<const SkImage> dedup(const SkImage*);
+
+    struct PathContentHash {
+        uint32_t operator()(const SkPath&) const;
+    };
+
+    struct ImageContent {
+        sk_sp<const SkImage> fImage;
+        sk_sp<SkData>        fEncoded;  // If null, fImage is compared by its pixels.
+        uint32_t             fHash;
+
+        bool operator==(const ImageContent&) const;
+
+        struct Hash {
+            uint32_t operator()(const ImageContent& c) const { return c.fHash; }
+        };
+    };
+
     size_t fApproxBytesUsedBySubPictures;
     SkRecord* fRecord;
     std::unique_ptr<SkDrawableList> fDrawableList;
 
     SkMiniRecorder* fMiniRecorder;
+
+    bool fDedupContent = false;
+    // The ...ByID maps remember what every path and image seen so far deduplicated to.
+    SkTHashSet<SkPath, PathContentHash>          fPaths;
+    SkTHashMap<uint64_t, SkPath>                 fPathsByID;
+    SkTHashSet<ImageContent, ImageContent::Hash> fImages;
+    SkTHashMap<uint32_t, sk_sp<const SkImage>>   fImagesByID;
 };
 
 #endif//SkRecorder_DEFINED
@@ -8,11 +8,13 @@
 #include "include/core/SkRegion.h"
 
 #include "include/private/SkMacros.h"
+#include "include/private/SkTDArray.h"
 #include "include/private/SkTemplates.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkRegionPriv.h"
 #include "src/core/SkSafeMath.h"
 
+#include <algorithm>
 #include <utility>
 
 /* Region Layout
@@ -646,20 +648,6 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
-        }
-    }
-    return !this->isEmpty();
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
 #if defined _WIN32  // disable warning : local variable used without having been initialized
 #pragma warning ( push )
 #pragma warning ( disable : 4701 )
@@ -839,10 +827,17 @@ public:
 
     void addSpan(int bottom, const SkRegionPriv::RunType a_runs[],
                  const SkRegionPriv::RunType b_runs[]) {
-        // skip X values and slots for the next Y+intervalCount
-        int start = fPrevDst + fPrevLen + 2;
-        // start points to beginning of dst interval
+        int start = this->spanStart();
         int stop = operate_on_span(a_runs, b_runs, fArray, start, fMin, fMax);
+        this->finishSpan(bottom, start, stop);
+    }
+
+    // Where the next span's intervals go: skip X values and slots for the next Y+intervalCount.
+    int spanStart() const { return SkToInt(fPrevDst + fPrevLen + 2); }
+
+    // Adds a span whose intervals (and X-sentinel) were already written to [start, stop), with
+    // room for a second sentinel after them.
+    void finishSpan(int bottom, int start, int stop) {
         size_t len = SkToSizeT(stop - start);
         SkASSERT(len >= 1 && (len & 1) == 1);
         SkASSERT(SkRegion_kRunTypeSentinel == (*fArray)[stop - 1]);
@@ -867,6 +862,29 @@ public:
         }
     }
 
+    // Appends whole scanlines from another region, from the Bottom value at runs[0] up to stop.
+    // They must follow on from what's been added so far without coalescing, which is the case
+    // if they start a region, or come after a scanline that isn't the same as their first.
+    void copySpans(const SkRegionPriv::RunType runs[], const SkRegionPriv::RunType* stop) {
+        SkASSERT(runs < stop);
+        const int dst = SkToInt(fPrevDst + fPrevLen);
+        const int count = SkToInt(stop - runs);
+        fArray->resizeToAtLeast(dst + count + 1);  // + 1 for flush()'s sentinel
+        memcpy(&(*fArray)[dst], runs, count * sizeof(SkRegionPriv::RunType));
+
+        // Point at the last scanline's intervals, so we can coalesce with it.
+        const SkRegionPriv::RunType* last = runs;
+        for (;;) {
+            const SkRegionPriv::RunType* next = SkRegionPriv::RunHead::SkipEntireScanline(last);
+            if (next == stop) {
+                break;
+            }
+            last = next;
+        }
+        fPrevDst = dst + SkToInt(last - runs) + 2;
+        fPrevLen = SkToSizeT(stop - last - 2);
+    }
+
     int flush() {
         (*fArray)[fStartDst] = fTop;
         // Previously reserved enough for TWO sentinals.
@@ -1000,6 +1018,115 @@ static int operate(const SkRegionPriv::RunType a_runs[],
     return oper.flush();
 }
 
+/*  Copies a scanline's intervals, from its first Left (or its X-sentinel) through its
+ *  X-sentinel, to dstOffset. Returns the index just past the copied sentinel.
+ */
+static int copy_span(const SkRegionPriv::RunType src[], RunArray* array, int dstOffset) {
+    const int count = distance_to_sentinel(src) + 1;
+    // Plus one for a second terminating sentinel.
+    array->resizeToAtLeast(dstOffset + count + 1);
+    memcpy(&(*array)[dstOffset], src, count * sizeof(SkRegionPriv::RunType));
+    return dstOffset + count;
+}
+
+/*  Like copy_span(), but unions [left, rite) into the intervals on the way. Only the intervals
+ *  that overlap or touch it are merged; the ones before and after it are copied as they are.
+ */
+static int union_span(const SkRegionPriv::RunType src[], int left, int rite,
+                      RunArray* array, int dstOffset) {
+    const SkRegionPriv::RunType* before = src;
+    while (*src != SkRegion_kRunTypeSentinel && src[1] < left) {
+        src += 2;
+    }
+    const int beforeCount = SkToInt(src - before);
+
+    // This is a worst-case for the span, plus one for the new interval and two for TWO
+    // terminating sentinels.
+    array->resizeToAtLeast(dstOffset + beforeCount + distance_to_sentinel(src) + 4);
+    SkRegionPriv::RunType* dst = &(*array)[dstOffset];  // get pointer AFTER resizing.
+    memcpy(dst, before, beforeCount * sizeof(SkRegionPriv::RunType));
+    dst += beforeCount;
+
+    while (*src != SkRegion_kRunTypeSentinel && src[0] <= rite) {
+        left = std::min<int>(left, src[0]);
+        rite = std::max<int>(rite, src[1]);
+        src += 2;
+    }
+    *dst++ = left;
+    *dst++ = rite;
+
+    return copy_span(src, array, SkToInt(dst - &(*array)[0]));
+}
+
+/*  Unions rect into a complex region, given its runs from Top up to stop (just past its
+ *  Y-sentinel). Only the scanlines rect spans are rewritten; those above and below it are copied
+ *  over whole.
+ */
+static int union_rect(const SkRegionPriv::RunType runs[], const SkRegionPriv::RunType* stop,
+                      const SkIRect& rect, RunArray* array) {
+    // Stands in for the intervals of scanlines above or below the region.
+    const SkRegionPriv::RunType kNoIntervals[] = { SkRegion_kRunTypeSentinel };
+
+    const int top = runs[0];
+    const SkRegionPriv::RunType* const ySentinel = stop - 1;
+    const SkRegionPriv::RunType* span = runs + 1;  // Bottom of the scanline starting at y.
+    int y = top;
+
+    RgnOper oper(std::min(top, rect.fTop), array, SkRegion::kUnion_Op);
+    auto addSpan = [&](int bottom, const SkRegionPriv::RunType intervals[], bool inRect) {
+        int start = oper.spanStart();
+        int end = inRect ? union_span(intervals, rect.fLeft, rect.fRight, array, start)
+                         : copy_span(intervals, array, start);
+        oper.finishSpan(bottom, start, end);
+    };
+
+    const SkRegionPriv::RunType* above = span;
+    while (span < ySentinel && span[0] <= rect.fTop) {
+        y = span[0];
+        span = SkRegionPriv::RunHead::SkipEntireScanline(span);
+    }
+    if (span > above) {
+        oper.copySpans(above, span);
+    }
+    if (y < rect.fTop) {
+        // The top of the scanline rect starts in, or the gap between the region and rect.
+        addSpan(rect.fTop, span < ySentinel ? span + 2 : kNoIntervals, false);
+    }
+
+    for (y = rect.fTop; y < rect.fBottom;) {
+        if (y < top) {
+            y = std::min(top, rect.fBottom);
+            addSpan(y, kNoIntervals, true);
+        } else if (span < ySentinel) {
+            const SkRegionPriv::RunType* intervals = span + 2;
+            if (span[0] <= rect.fBottom) {
+                y = span[0];
+                span = SkRegionPriv::RunHead::SkipEntireScanline(span);
+            } else {
+                y = rect.fBottom;
+            }
+            addSpan(y, intervals, true);
+        } else {
+            y = rect.fBottom;
+            addSpan(y, kNoIntervals, true);
+        }
+    }
+
+    if (span < ySentinel) {
+        if (rect.fBottom < top) {
+            addSpan(top, kNoIntervals, false);
+        }
+        // The rest of the scanline rect ends in (or the first one below it) may coalesce with
+        // the last one we wrote, but after that they're all the same as before.
+        addSpan(span[0], span + 2, false);
+        span = SkRegionPriv::RunHead::SkipEntireScanline(span);
+        if (span < ySentinel) {
+            oper.copySpans(span, ySentinel);
+        }
+    }
+    return oper.flush();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /*  Given count RunTypes in a complex region, return the worst case number of
@@ -1112,6 +1239,17 @@ bool SkRegion::Oper(const SkRegion& rgnaOrig, const SkRegion& rgnbOrig, Op op,
         return false;
     }
 
+    // Unioning in a rect only changes the scanlines it spans.
+    if (kUnion_Op == op && result && a_rect != b_rect) {
+        const SkRegion& rgn  = a_rect ? *rgnb : *rgna;
+        const SkIRect   rect = a_rect ? rgna->fBounds : rgnb->fBounds;
+        const RunType* runs = rgn.fRunHead->readonly_runs();
+
+        RunArray array;
+        int count = union_rect(runs, runs + rgn.fRunHead->fRunCount, rect, &array);
+        return result->setRuns(&array[0], count);
+    }
+
     RunType tmpA[kRectRegionRuns];
     RunType tmpB[kRectRegionRuns];
 
@@ -1136,6 +1274,73 @@ bool SkRegion::op(const SkRegion& rgna, const SkRegion& rgnb, Op op) {
     return SkRegion::Oper(rgna, rgnb, op, this);
 }
 
+bool SkRegion::setRects(const SkIRect rects[], int count) {
+    // Like setRect(), ignore empty rects and those that reach the sentinel.
+    SkTDArray<SkIRect> sorted;
+    sorted.setReserve(count);
+    for (int i = 0; i < count; i++) {
+        const SkIRect& r = rects[i];
+        if (!r.isEmpty() &&
+            SkRegion_kRunTypeSentinel != r.right() &&
+            SkRegion_kRunTypeSentinel != r.bottom()) {
+            sorted.push_back(r);
+        }
+    }
+    if (sorted.count() <= 1) {
+        return sorted.isEmpty() ? this->setEmpty() : this->setRect(sorted[0]);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const SkIRect& a, const SkIRect& b) { return a.fTop < b.fTop; });
+
+    // Rather than unioning in one rect at a time, sweep down through them all at once. Each
+    // scanline is made from the rects that span it, which we keep sorted by their left edges.
+    SkTDArray<SkIRect> active;
+    RunArray array;
+    RgnOper oper(sorted[0].fTop, &array, kUnion_Op);
+    int next = 0;
+    int y = sorted[0].fTop;
+    while (next < sorted.count() || !active.isEmpty()) {
+        for (; next < sorted.count() && sorted[next].fTop == y; next++) {
+            const SkIRect& r = sorted[next];
+            const SkIRect* at = std::upper_bound(active.begin(), active.end(), r,
+                    [](const SkIRect& a, const SkIRect& b) { return a.fLeft < b.fLeft; });
+            active.insert(SkToInt(at - active.begin()), 1, &r);
+        }
+
+        int bottom = next < sorted.count() ? sorted[next].fTop : SkRegion_kRunTypeSentinel;
+        for (const SkIRect& r : active) {
+            bottom = std::min(bottom, r.fBottom);
+        }
+
+        // Merge the intervals that overlap or touch.
+        const int start = oper.spanStart();
+        // This is a worst-case for this span plus two for TWO terminating sentinels.
+        array.resizeToAtLeast(start + active.count() * 2 + 2);
+        RunType* const first = &array[start];  // get pointer AFTER resizing.
+        RunType* dst = first;
+        for (const SkIRect& r : active) {
+            if (dst > first && dst[-1] >= r.fLeft) {
+                dst[-1] = std::max(dst[-1], r.fRight);
+            } else {
+                *dst++ = r.fLeft;
+                *dst++ = r.fRight;
+            }
+        }
+        *dst++ = SkRegion_kRunTypeSentinel;
+        oper.finishSpan(bottom, start, start + SkToInt(dst - first));
+
+        int kept = 0;
+        for (const SkIRect& r : active) {
+            if (r.fBottom != bottom) {
+                active[kept++] = r;
+            }
+        }
+        active.setCount(kept);
+        y = bottom;
+    }
+    return this->setRuns(&array[0], oper.flush());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "src/core/SkBuffer.h"
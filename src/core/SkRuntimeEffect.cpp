@@ -14,9 +14,11 @@
 #include "src/core/SkColorFilterBase.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
+#include "src/core/SkLRUCache.h"
 #include "src/core/SkMatrixProvider.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkRuntimeEffectPriv.h"
 #include "src/core/SkUtils.h"
 #include "src/core/SkVM.h"
 #include "src/core/SkWriteBuffer.h"
@@ -66,9 +68,100 @@ SkSL::Compiler* SharedCompiler::gCompiler = nullptr;
 int             SharedCompiler::gInlineThreshold = 0;
 }  // namespace SkSL
 
+// Effects are immutable once made, so Make() shares one effect between all callers that pass the
+// same SkSL, rather than compiling it again each time.
+class SkRuntimeEffectCache {
+public:
+    struct Key {
+        SkString fSkSL;
+        // The only compiler setting that varies between calls to Make().
+        int      fInlineThreshold;
+
+        bool operator==(const Key& that) const {
+            return fInlineThreshold == that.fInlineThreshold && fSkSL == that.fSkSL;
+        }
+    };
+
+    struct KeyHash {
+        uint32_t operator()(const Key& key) const {
+            return SkOpts::hash_fn(key.fSkSL.c_str(), key.fSkSL.size(), key.fInlineThreshold);
+        }
+    };
+
+    static SkRuntimeEffectCache& Get() {
+        static SkRuntimeEffectCache& cache = *(new SkRuntimeEffectCache);
+        return cache;
+    }
+
+    // Returns the cached effect for 'sksl', or nullptr, in which case 'key' is set up to add() the
+    // effect once it has been made.
+    sk_sp<SkRuntimeEffect> find(const SkString& sksl, Key* key) {
+        SkAutoMutexExclusive lock(fMutex);
+        *key = {sksl, fInlineThreshold};
+        if (sk_sp<SkRuntimeEffect>* effect = fEffects.find(*key)) {
+            fHits++;
+            return *effect;
+        }
+        fMisses++;
+        return nullptr;
+    }
+
+    // Returns the effect to use, which is the already cached one if another thread made the same
+    // effect first.
+    sk_sp<SkRuntimeEffect> add(const Key& key, sk_sp<SkRuntimeEffect> effect) {
+        SkAutoMutexExclusive lock(fMutex);
+        if (sk_sp<SkRuntimeEffect>* existing = fEffects.find(key)) {
+            return *existing;
+        }
+        fEffects.insert(key, effect);
+        return effect;
+    }
+
+    // Called with the compiler locked. Effects are keyed by the threshold they were compiled with,
+    // so ones already being compiled with the old threshold can't be found with the new one.
+    void setInlineThreshold(int threshold) {
+        SkAutoMutexExclusive lock(fMutex);
+        fInlineThreshold = threshold;
+    }
+
+    SkRuntimeEffectCacheStats stats() {
+        SkAutoMutexExclusive lock(fMutex);
+        return {fHits, fMisses, fEffects.count()};
+    }
+
+    void purge() {
+        SkAutoMutexExclusive lock(fMutex);
+        fEffects.reset();
+    }
+
+private:
+    static constexpr int kMaxEffects = 64;
+
+    SkRuntimeEffectCache() : fEffects(kMaxEffects) {
+        SkSL::SharedCompiler compiler;
+        fInlineThreshold = compiler.getInlineThreshold();
+    }
+
+    SkMutex                                           fMutex;
+    SkLRUCache<Key, sk_sp<SkRuntimeEffect>, KeyHash> fEffects;
+    int                                               fInlineThreshold;
+    int                                               fHits = 0;
+    int                                               fMisses = 0;
+};
+
 void SkRuntimeEffect_SetInlineThreshold(int threshold) {
+    SkRuntimeEffectCache& cache = SkRuntimeEffectCache::Get();
     SkSL::SharedCompiler compiler;
     compiler.setInlineThreshold(threshold);
+    cache.setInlineThreshold(threshold);
+}
+
+SkRuntimeEffectCacheStats SkRuntimeEffect_GetCacheStats() {
+    return SkRuntimeEffectCache::Get().stats();
+}
+
+void SkRuntimeEffect_PurgeCache() {
+    SkRuntimeEffectCache::Get().purge();
 }
 
 // Accepts a valid marker, or "normals(<marker>)"
@@ -116,9 +209,23 @@ static bool init_uniform_type(const SkSL::Context& ctx,
 }
 
 SkRuntimeEffect::EffectResult SkRuntimeEffect::Make(SkString sksl) {
+    SkRuntimeEffectCache& cache = SkRuntimeEffectCache::Get();
+    SkRuntimeEffectCache::Key key;
+    if (sk_sp<SkRuntimeEffect> effect = cache.find(sksl, &key)) {
+        return std::make_tuple(std::move(effect), SkString());
+    }
+
+    auto result = MakeUncached(std::move(sksl), &key.fInlineThreshold);
+    if (auto& effect = std::get<0>(result)) {
+        effect = cache.add(key, std::move(effect));
+    }
+    return result;
+}
+
+SkRuntimeEffect::EffectResult SkRuntimeEffect::MakeUncached(SkString sksl, int* inlineThreshold) {
     SkSL::SharedCompiler compiler;
     SkSL::Program::Settings settings;
-    settings.fInlineThreshold = compiler.getInlineThreshold();
+    settings.fInlineThreshold = *inlineThreshold = compiler.getInlineThreshold();
     settings.fAllowNarrowingConversions = true;
     auto program = compiler->convertProgram(SkSL::Program::kPipelineStage_Kind,
                                             SkSL::String(sksl.c_str(), sksl.size()),
@@ -237,6 +344,158 @@ SkRuntimeEffect::EffectResult SkRuntimeEffect::Make(SkString sksl) {
     return std::make_tuple(std::move(effect), SkString());
 }
 
+// Bump this whenever the blob layout, or the byte code it holds (SkSL::ByteCodeInstruction),
+// changes.
+static constexpr uint32_t kBlobVersion = 1;
+
+// A tripwire for the most common byte code change: update this along with kBlobVersion.
+static_assert((int)SkSL::ByteCodeInstruction::kLoopContinue == 97,
+              "SkSL::ByteCodeInstruction changed; bump kBlobVersion");
+
+// Each of these takes at least this many 32-bit words in a blob (a string takes at least two).
+static constexpr size_t kMinUniformWords = 8,
+                        kMinChildWords   = 8,
+                        kMinVaryingWords = 3;
+
+// Reads an element count, or returns 0 (and invalidates the buffer) if the rest of the buffer
+// can't hold that many elements, so a corrupt count can't make us allocate much.
+static size_t read_count(SkReadBuffer& buffer, size_t minWordsPerElement) {
+    const uint32_t count = buffer.readUInt();
+    return buffer.validateCanReadN<uint32_t>(minWordsPerElement * count) ? count : 0;
+}
+
+sk_sp<SkData> SkRuntimeEffect::serialize() const {
+    auto [byteCode, errorText] = this->toByteCode();
+    if (!byteCode) {
+        return nullptr;
+    }
+
+    SkBinaryWriteBuffer buffer;
+    buffer.writeUInt(kBlobVersion);
+    buffer.writeString(fSkSL.c_str());
+
+    buffer.writeUInt(fUniforms.size());
+    for (const Uniform& u : fUniforms) {
+        buffer.writeString(u.fName.c_str());
+        buffer.writeUInt(u.fOffset);
+        buffer.writeUInt((uint32_t)u.fType);
+        buffer.writeUInt((uint32_t)u.fGPUType);
+        buffer.writeInt(u.fCount);
+        buffer.writeUInt(u.fFlags);
+        buffer.writeUInt(u.fMarker);
+    }
+
+    buffer.writeUInt(fChildren.size());
+    for (size_t i = 0; i < fChildren.size(); ++i) {
+        const SkSL::SampleUsage& usage = fSampleUsages[i];
+        buffer.writeString(fChildren[i].c_str());
+        buffer.writeUInt((uint32_t)usage.fKind);
+        buffer.writeString(usage.fExpression.c_str());
+        buffer.writeBool(usage.fHasPerspective);
+        buffer.writeBool(usage.fExplicitCoords);
+        buffer.writeBool(usage.fPassThrough);
+    }
+
+    buffer.writeUInt(fVaryings.size());
+    for (const Varying& v : fVaryings) {
+        buffer.writeString(v.fName.c_str());
+        buffer.writeInt(v.fWidth);
+    }
+
+    buffer.writeBool(fUsesSampleCoords);
+    buffer.writeBool(fAllowColorFilter);
+
+    if (!byteCode->flatten(buffer)) {
+        return nullptr;
+    }
+    return buffer.snapshotAsData();
+}
+
+SkRuntimeEffect::EffectResult SkRuntimeEffect::MakeFromBlob(sk_sp<SkData> blob) {
+    #define RETURN_FAILURE(...) return std::make_tuple(nullptr, SkStringPrintf(__VA_ARGS__))
+
+    if (!blob) {
+        RETURN_FAILURE("missing blob");
+    }
+    SkReadBuffer buffer(blob->data(), blob->size());
+    if (buffer.readUInt() != kBlobVersion) {
+        RETURN_FAILURE("blob was written by a different version of Skia");
+    }
+
+    SkString sksl;
+    buffer.readString(&sksl);
+
+    std::vector<Uniform> uniforms(read_count(buffer, kMinUniformWords));
+    size_t offset = 0;
+    for (Uniform& u : uniforms) {
+        buffer.readString(&u.fName);
+        u.fOffset  = buffer.readUInt();
+        u.fType    = buffer.read32LE(Uniform::Type::kFloat4x4);
+        u.fGPUType = buffer.read32LE(kLast_GrSLType);
+        u.fCount   = buffer.readInt();
+        u.fFlags   = buffer.readUInt();
+        u.fMarker  = buffer.readUInt();
+        // Uniforms are packed in order, so uniformSize() and findUniform() stay in bounds.
+        if (!buffer.validate(u.fOffset == offset && u.fCount >= 1 &&
+                             (u.isArray() || u.fCount == 1) && u.fCount <= 0xFFFF)) {
+            break;
+        }
+        offset += u.sizeInBytes();
+    }
+
+    std::vector<SkString> children(read_count(buffer, kMinChildWords));
+    std::vector<SkSL::SampleUsage> sampleUsages(children.size());
+    for (size_t i = 0; i < children.size(); ++i) {
+        SkSL::SampleUsage& usage = sampleUsages[i];
+        SkString expression;
+        buffer.readString(&children[i]);
+        usage.fKind = buffer.read32LE(SkSL::SampleUsage::Kind::kVariable);
+        buffer.readString(&expression);
+        usage.fExpression     = expression.c_str();
+        usage.fHasPerspective = buffer.readBool();
+        usage.fExplicitCoords = buffer.readBool();
+        usage.fPassThrough    = buffer.readBool();
+    }
+
+    std::vector<Varying> varyings(read_count(buffer, kMinVaryingWords));
+    for (Varying& v : varyings) {
+        buffer.readString(&v.fName);
+        v.fWidth = buffer.readInt();
+        buffer.validate(v.fWidth >= 1 && v.fWidth <= 4);
+    }
+
+    bool usesSampleCoords = buffer.readBool();
+    bool allowColorFilter = buffer.readBool();
+
+    // Check the byte code reads back now, so toByteCode() can't fail later.
+    size_t byteCodeOffset = buffer.offset();
+    if (!SkSL::ByteCode::MakeFromBuffer(buffer) || !buffer.isValid()) {
+        RETURN_FAILURE("invalid blob");
+    }
+
+#undef RETURN_FAILURE
+
+    sk_sp<SkRuntimeEffect> effect(new SkRuntimeEffect(std::move(sksl),
+                                                      nullptr,
+                                                      std::move(uniforms),
+                                                      std::move(children),
+                                                      std::move(sampleUsages),
+                                                      std::move(varyings),
+                                                      usesSampleCoords,
+                                                      allowColorFilter));
+    effect->fByteCode = SkData::MakeSubset(blob.get(), byteCodeOffset,
+                                           buffer.offset() - byteCodeOffset);
+    return std::make_tuple(std::move(effect), SkString());
+}
+
+sk_sp<SkData> SkRuntimeEffect_Serialize(const SkRuntimeEffect& effect) {
+    return effect.serialize();
+}
+
+SkRuntimeEffect::EffectResult SkRuntimeEffect_MakeFromBlob(sk_sp<SkData> blob) {
+    return SkRuntimeEffect::MakeFromBlob(std::move(blob));
+}
+
 size_t SkRuntimeEffect::Uniform::sizeInBytes() const {
     auto element_size = [](Type type) -> size_t {
         switch (type) {
@@ -271,7 +530,6 @@ SkRuntimeEffect::SkRuntimeEffect(SkString sksl,
         , fVaryings(std::move(varyings))
         , fUsesSampleCoords(usesSampleCoords)
         , fAllowColorFilter(allowColorFilter) {
-    SkASSERT(fBaseProgram);
     SkASSERT(fChildren.size() == fSampleUsages.size());
 }
 
@@ -325,6 +583,13 @@ bool SkRuntimeEffect::toPipelineStage(const GrShaderCaps* shaderCaps,
 #endif
 
 SkRuntimeEffect::ByteCodeResult SkRuntimeEffect::toByteCode() const {
+    if (!fBaseProgram) {
+        // MakeFromBlob() has already checked that this reads back.
+        SkASSERT(fByteCode);
+        SkReadBuffer buffer(fByteCode->data(), fByteCode->size());
+        return ByteCodeResult(SkSL::ByteCode::MakeFromBuffer(buffer), SkString());
+    }
+
     SkSL::SharedCompiler compiler;
 
     auto byteCode = compiler->toByteCode(*fBaseProgram);
@@ -8,10 +8,40 @@
 #ifndef SkRuntimeEffectPriv_DEFINED
 #define SkRuntimeEffectPriv_DEFINED
 
+#include "include/effects/SkRuntimeEffect.h"
+
 /*
  * Controls how much inlining is performed when compiling SkSL for SkRuntimeEffect instances.
  * See also: SkSL::Program::Settings::fInlineThreshold
  */
 void SkRuntimeEffect_SetInlineThreshold(int threshold);
 
+/*
+ * SkRuntimeEffect::Make() caches recently made effects, keyed by their SkSL source (and the inline
+ * threshold), and returns the cached effect when it is called again with the same source.
+ */
+struct SkRuntimeEffectCacheStats {
+    int fHits;
+    int fMisses;
+    int fCount;     // Number of effects currently in the cache.
+};
+SkRuntimeEffectCacheStats SkRuntimeEffect_GetCacheStats();
+void SkRuntimeEffect_PurgeCache();
+
+/*
+ * Returns a blob holding everything SkRuntimeEffect::Make() computed for the effect, including its
+ * byte code, for SkRuntimeEffect_MakeFromBlob(). Returns nullptr if the effect can't be converted
+ * to byte code.
+ */
+sk_sp<SkData> SkRuntimeEffect_Serialize(const SkRuntimeEffect&);
+
+/*
+ * Recreates an effect from a blob written by SkRuntimeEffect_Serialize(), without running the SkSL
+ * compiler. Only load blobs written by the same build of Skia: the blob's format version rejects
+ * known layout changes, but not every change to what the byte code means. The byte code is run as
+ * is, so blobs must come from a trusted source (e.g. made offline and shipped with the app), never
+ * from untrusted input.
+ */
+SkRuntimeEffect::EffectResult SkRuntimeEffect_MakeFromBlob(sk_sp<SkData> blob);
+
 #endif
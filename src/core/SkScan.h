@@ -26,6 +26,7 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+extern std::atomic<bool> gSkUseSparseTileAA;
 
 class AdditiveBlitter;
 
@@ -52,6 +53,10 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPathView&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPathView&, const SkRasterClip&, SkBlitter*);
+    // Which scan converter AntiFillPath() uses. kDefault leaves it to gSkUseSparseTileAA,
+    // gSkForceAnalyticAA, and how complex the path is.
+    enum class Rasterizer { kDefault, kAnalytic, kSparseTile };
+    static void AntiFillPath(const SkPathView&, const SkRasterClip&, SkBlitter*, Rasterizer);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -80,7 +85,8 @@ private:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void AntiFillPath(const SkPathView&, const SkRegion& clip, SkBlitter*, bool forceRLE);
+    static void AntiFillPath(const SkPathView&, const SkRegion& clip, SkBlitter*, bool forceRLE,
+                             Rasterizer = Rasterizer::kDefault);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -91,6 +97,8 @@ private:
                             const SkIRect& clipBounds, bool forceRLE);
     static void SAAFillPath(const SkPathView& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+    static void SparseAAFillPath(const SkPathView& path, SkBlitter* blitter, const SkIRect& pathIR,
+                                 const SkIRect& clipBounds);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
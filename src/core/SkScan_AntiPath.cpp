@@ -635,11 +635,12 @@ static void compute_complexity(const SkPathView& path, SkScalar& avgLength, SkSc
     }
 }
 
-static bool ShouldUseAAA(const SkPathView& path, SkScalar avgLength, SkScalar complexity) {
+static bool ShouldUseAAA(const SkPathView& path, SkScalar avgLength, SkScalar complexity,
+                         SkScan::Rasterizer rasterizer) {
 #if defined(SK_DISABLE_AAA)
     return false;
 #else
-    if (gSkForceAnalyticAA) {
+    if (rasterizer == SkScan::Rasterizer::kAnalytic || gSkForceAnalyticAA) {
         return true;
     }
     if (!gSkUseAnalyticAA) {
@@ -712,7 +713,7 @@ static int rect_overflows_short_shift(SkIRect rect, int shift) {
 }
 
 void SkScan::AntiFillPath(const SkPathView& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, Rasterizer rasterizer) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -782,10 +783,20 @@ void SkScan::AntiFillPath(const SkPathView& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
+    if (rasterizer == Rasterizer::kSparseTile ||
+        (rasterizer == Rasterizer::kDefault && gSkUseSparseTileAA)) {
+        // Sparse tiles always blit runs, so they're fine for forceRLE too.
+        SkScan::SparseAAFillPath(path, blitter, ir, clipRgn->getBounds());
+        if (isInverse) {
+            sk_blit_below(blitter, ir, *clipRgn);
+        }
+        return;
+    }
+
     SkScalar avgLength, complexity;
     compute_complexity(path, avgLength, complexity);
 
-    if (ShouldUseAAA(path, avgLength, complexity)) {
+    if (ShouldUseAAA(path, avgLength, complexity, rasterizer)) {
         // Do not use AAA if path is too complicated:
         // there won't be any speedup or significant visual improvement.
         SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
@@ -820,18 +831,24 @@ void SkScan::FillPath(const SkPathView& path, const SkRasterClip& clip, SkBlitte
 }
 
 void SkScan::AntiFillPath(const SkPathView& path, const SkRasterClip& clip, SkBlitter* blitter) {
+    AntiFillPath(path, clip, blitter, Rasterizer::kDefault);
+}
+
+void SkScan::AntiFillPath(const SkPathView& path, const SkRasterClip& clip, SkBlitter* blitter,
+                          Rasterizer rasterizer) {
     if (clip.isEmpty() || !path.isFinite()) {
         return;
     }
 
     if (clip.isBW()) {
-        AntiFillPath(path, clip.bwRgn(), blitter, false);
+        AntiFillPath(path, clip.bwRgn(), blitter, false, rasterizer);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        AntiFillPath(path, tmp, &aaBlitter, true); // SkAAClipBlitter can blitMask, why forceRLE?
+        // SkAAClipBlitter can blitMask, why forceRLE?
+        AntiFillPath(path, tmp, &aaBlitter, true, rasterizer);
     }
 }
@@ -0,0 +1,364 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/private/SkTDArray.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkPathView.h"
+#include "src/core/SkScan.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+
+Sparse tile coverage, in the style of font-rs and piet's sparse strips.
+
+Rather than walking its edges down every scanline, each line segment of the (flattened) path
+deposits its signed area into an accumulation buffer with a cell per pixel: the cells where the
+segment crosses a row get the part of the row's height it covers, split by how much of each pixel
+lies to the right of the segment. A running sum along the row then gives every pixel's signed
+coverage, which for pixels no segment touches is just the winding number.
+
+The path is processed in strips kTileSize rows tall, and each strip in tiles kTileSize pixels
+wide. Segments are binned into the strips they cross, and only the tiles they touch are summed
+pixel by pixel. Every pixel between two touched tiles has the same coverage as the one before it,
+so the running sum carries straight across and the whole span is blitted as one run. The buffer
+holds a strip column-major, so the running sums for all of a column's rows are one vector add.
+
+*/
+
+namespace {
+
+constexpr int kTileSize = 16;
+
+// One value for each row of a strip.
+using Column = skvx::Vec<kTileSize, float>;
+
+// A line segment in pixels, relative to the top left of its strip, with fY0 < fY1.
+struct Segment {
+    float fX0, fY0, fX1, fY1;
+    float fDir;  // +1 if the path runs down here, -1 if it runs up.
+};
+
+class SparseTileRasterizer {
+public:
+    SparseTileRasterizer(const SkIRect& bounds)
+            : fBounds(bounds)
+            , fWidth(bounds.width())
+            , fTiles((fWidth + 2 + kTileSize - 1) / kTileSize)
+            , fStripCount((bounds.height() + kTileSize - 1) / kTileSize)
+            , fStrips(fStripCount)
+            , fCells((size_t)fTiles * kTileSize * kTileSize)
+            , fTouched(fTiles)
+            , fAlpha((size_t)kTileSize * fWidth)
+            , fRuns((size_t)kTileSize * (fWidth + 1)) {
+        sk_bzero(fCells.get(), (size_t)fTiles * kTileSize * kTileSize * sizeof(float));
+        sk_bzero(fTouched.get(), fTiles * sizeof(bool));
+    }
+
+    void addPath(const SkPathView& path) {
+        SkPathEdgeIter iter(path);
+        while (auto e = iter.next()) {
+            switch (e.fEdge) {
+                case SkPathEdgeIter::Edge::kLine:
+                    this->addLine(e.fPts[0], e.fPts[1]);
+                    break;
+                case SkPathEdgeIter::Edge::kQuad:
+                    this->addQuad(e.fPts);
+                    break;
+                case SkPathEdgeIter::Edge::kConic: {
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quads =
+                            quadder.computeQuads(e.fPts, iter.conicWeight(), kTolerance);
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        this->addQuad(quads + 2 * i);
+                    }
+                    break;
+                }
+                case SkPathEdgeIter::Edge::kCubic:
+                    this->addCubic(e.fPts);
+                    break;
+            }
+        }
+    }
+
+    void blit(SkPathFillType fillType, SkBlitter* blitter) {
+        const bool evenOdd = SkPathFillType_IsEvenOdd(fillType),
+                   inverse = SkPathFillType_IsInverse(fillType);
+        // Where edges cross inside a pixel, its sum mixes their partial areas, so like any
+        // accumulating rasterizer we only approximate coverage there (most visibly for even-odd).
+        auto coverage = [&](Column winding) {
+            Column c = abs(winding);
+            if (evenOdd) {
+                // A triangle wave: 0 at even windings, 1 at odd ones.
+                c = c - 2 * floor(c * 0.5f);
+                c = min(c, 2 - c);
+            } else {
+                c = min(c, 1);
+            }
+            return inverse ? 1 - c : c;
+        };
+        auto to_alpha = [](Column c) { return skvx::cast<uint8_t>(c * 255 + 0.5f); };
+
+        for (int strip = 0; strip < fStripCount; ++strip) {
+            const int top  = fBounds.fTop + strip * kTileSize,
+                      rows = std::min(kTileSize, fBounds.fBottom - top);
+
+            if (fStrips[strip].isEmpty()) {
+                if (inverse) {
+                    blitter->blitRect(fBounds.fLeft, top, fWidth, rows);
+                }
+                continue;
+            }
+            for (const Segment& segment : fStrips[strip]) {
+                this->accumulate(segment);
+            }
+            fStrips[strip].reset();
+
+            // Each pixel of a touched tile is its own run; each span between them is one run.
+            Column winding = 0;
+            auto span = [&](int x, int width) {
+                auto alpha = to_alpha(coverage(winding));
+                for (int r = 0; r < rows; ++r) {
+                    this->runs(r)[x]  = SkToS16(width);
+                    this->alpha(r)[x] = alpha[r];
+                }
+            };
+            int x = 0;
+            for (int tile = 0; tile < fTiles; ++tile) {
+                if (!fTouched[tile]) {
+                    continue;
+                }
+                fTouched[tile] = false;
+
+                const int tileLeft  = tile * kTileSize,
+                          tileRight = std::min(tileLeft + kTileSize, fWidth);
+                if (std::min(tileLeft, fWidth) > x) {
+                    span(x, std::min(tileLeft, fWidth) - x);
+                }
+                for (int cx = tileLeft; cx < tileRight; ++cx) {
+                    winding += Column::Load(this->cell(cx));
+                    auto alpha = to_alpha(coverage(winding));
+                    for (int r = 0; r < rows; ++r) {
+                        this->runs(r)[cx]  = 1;
+                        this->alpha(r)[cx] = alpha[r];
+                    }
+                }
+                // That includes the two cells past the last pixel, which can't affect anything.
+                sk_bzero(this->cell(tileLeft), kTileSize * kTileSize * sizeof(float));
+                x = std::max(x, tileRight);
+            }
+            if (x < fWidth) {
+                span(x, fWidth - x);
+            }
+
+            for (int r = 0; r < rows; ++r) {
+                this->runs(r)[fWidth] = 0;
+                blitter->blitAntiH(fBounds.fLeft, top + r, this->alpha(r), this->runs(r));
+            }
+        }
+    }
+
+private:
+    // Curves are flattened to within this many pixels of the true curve.
+    static constexpr SkScalar kTolerance = 1.0f / 16;
+    // A sanity limit on how many lines a curve is flattened into.
+    static constexpr int kMaxCurveLines = 256;
+
+    float*   cell(int x)  { return fCells.get() + (size_t)x * kTileSize; }
+    int16_t* runs(int r)  { return fRuns.get() + (size_t)r * (fWidth + 1); }
+    SkAlpha* alpha(int r) { return fAlpha.get() + (size_t)r * fWidth; }
+
+    static int lines_for_curve(SkScalar deviation) {
+        SkScalar lines = SkScalarCeilToScalar(SkScalarSqrt(deviation / kTolerance));
+        return SkTPin((int)lines, 1, kMaxCurveLines);
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        // A chord of 1/n of the quad strays at most |p0 - 2p1 + p2| / (4n^2) from it.
+        SkScalar dd = (pts[0] - pts[1] - pts[1] + pts[2]).length();
+        int n = lines_for_curve(dd / 4);
+
+        SkQuadCoeff quad(pts);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next = to_point(quad.eval((SkScalar)i / n));
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        // Likewise, with the cubic's second derivative bounded by 6x the larger second difference.
+        SkScalar dd = std::max((pts[0] - pts[1] - pts[1] + pts[2]).length(),
+                               (pts[1] - pts[2] - pts[2] + pts[3]).length());
+        int n = lines_for_curve(dd * 3 / 4);
+
+        SkCubicCoeff cubic(pts);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next = to_point(cubic.eval((SkScalar)i / n));
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+    // Clips the line to our rows and bins it into the strips it crosses.
+    void addLine(SkPoint p0, SkPoint p1) {
+        if (p0.fY == p1.fY) {
+            return;  // Horizontal lines don't change anyone's coverage.
+        }
+        float dir = 1;
+        if (p0.fY > p1.fY) {
+            std::swap(p0, p1);
+            dir = -1;
+        }
+        const float top    = (float)fBounds.fTop,
+                    bottom = (float)fBounds.fBottom;
+        if (p1.fY <= top || p0.fY >= bottom) {
+            return;
+        }
+
+        const float dxdy = (p1.fX - p0.fX) / (p1.fY - p0.fY);
+        auto x_at = [&](float y) { return p0.fX + (y - p0.fY) * dxdy; };
+
+        const float y0 = std::max(p0.fY, top),
+                    y1 = std::min(p1.fY, bottom);
+        const int first = (int)((y0 - top) / kTileSize),
+                  last  = std::min(fStripCount - 1,
+                                   (int)std::ceil((y1 - top) / kTileSize) - 1);
+        for (int strip = first; strip <= last; ++strip) {
+            const float stripTop = top + strip * kTileSize,
+                        sy0 = std::max(y0, stripTop),
+                        sy1 = std::min(y1, stripTop + kTileSize);
+            if (sy0 >= sy1) {
+                continue;
+            }
+            float x0 = sy0 == p0.fY ? p0.fX : x_at(sy0),
+                  x1 = sy1 == p1.fY ? p1.fX : x_at(sy1);
+            fStrips[strip].push_back({x0 - fBounds.fLeft, sy0 - stripTop,
+                                      x1 - fBounds.fLeft, sy1 - stripTop, dir});
+        }
+    }
+
+    // Deposits the segment's area into the cells.  Anything left of our first pixel still winds
+    // every pixel in its rows, as if it ran down our left edge, and anything right of our last
+    // pixel winds none of them.  So the segment is split where it crosses those edges, and then
+    // each piece can be pinned inside them without changing what it does to our pixels.
+    void accumulate(const Segment& s) {
+        float t[4] = {0, 0, 0, 1};
+        int cuts = 1;
+        for (float edge : {0.0f, (float)fWidth}) {
+            if ((s.fX0 < edge) != (s.fX1 < edge)) {
+                t[cuts++] = (edge - s.fX0) / (s.fX1 - s.fX0);
+            }
+        }
+        t[cuts] = 1;
+        std::sort(t + 1, t + cuts);
+
+        auto x_at = [&](float u) {
+            return SkTPin(s.fX0 + u * (s.fX1 - s.fX0), 0.0f, (float)fWidth);
+        };
+        auto y_at = [&](float u) { return s.fY0 + u * (s.fY1 - s.fY0); };
+        for (int i = 0; i < cuts; ++i) {
+            float ya = i == 0        ? s.fY0 : y_at(t[i]),
+                  yb = i + 1 == cuts ? s.fY1 : y_at(t[i + 1]);
+            if (ya < yb) {
+                this->accumulateLine(x_at(t[i]), ya, x_at(t[i + 1]), yb, s.fDir);
+            }
+        }
+    }
+
+    void add(int x, int y, float area) {
+        SkASSERT(0 <= x && x < fWidth + 2);
+        SkASSERT(0 <= y && y < kTileSize);
+        this->cell(x)[y] += area;
+        fTouched[x / kTileSize] = true;
+    }
+
+    // The font-rs line accumulator, with x in [0, fWidth] and y in [0, kTileSize].
+    void accumulateLine(float x0, float y0, float x1, float y1, float dir) {
+        const float dxdy = (x1 - x0) / (y1 - y0);
+        float x = x0;
+        for (int y = (int)y0, stop = (int)std::ceil(y1); y < stop; ++y) {
+            const float dy    = std::min((float)(y + 1), y1) - std::max((float)y, y0),
+                        xnext = y + 1 >= y1 ? x1
+                                            : SkTPin(x + dxdy * dy, 0.0f, (float)fWidth),
+                        d     = dy * dir;
+            const float xa = std::min(x, xnext),
+                        xb = std::max(x, xnext),
+                        xaFloor = std::floor(xa),
+                        xbCeil  = std::ceil(xb);
+            const int xai = (int)xaFloor,
+                      xbi = (int)xbCeil;
+            if (xbi <= xai + 1) {
+                // Within one pixel: split the area at the segment's midpoint.
+                float xmf = 0.5f * (x + xnext) - xaFloor;
+                this->add(xai,     y, d - d * xmf);
+                this->add(xai + 1, y, d * xmf);
+            } else {
+                const float s   = 1 / (xb - xa),
+                            xaf = xa - xaFloor,
+                            a0  = 0.5f * s * (1 - xaf) * (1 - xaf),
+                            xbf = xb - xbCeil + 1,
+                            am  = 0.5f * s * xbf * xbf;
+                this->add(xai, y, d * a0);
+                if (xbi == xai + 2) {
+                    this->add(xai + 1, y, d * (1 - a0 - am));
+                } else {
+                    const float a1 = s * (1.5f - xaf);
+                    this->add(xai + 1, y, d * (a1 - a0));
+                    for (int xi = xai + 2; xi < xbi - 1; ++xi) {
+                        this->add(xi, y, d * s);
+                    }
+                    const float a2 = a1 + (xbi - xai - 3) * s;
+                    this->add(xbi - 1, y, d * (1 - a2 - am));
+                }
+                this->add(xbi, y, d * am);
+            }
+            x = xnext;
+        }
+    }
+
+    const SkIRect fBounds;
+    const int     fWidth;
+    const int     fTiles;   // Tiles across a strip, counting two extra cells past the last pixel.
+    const int     fStripCount;
+
+    SkAutoTArray<SkTDArray<Segment>> fStrips;
+    SkAutoTMalloc<float>             fCells;    // One strip's cells, a Column per x.
+    SkAutoTMalloc<bool>              fTouched;  // Which of the strip's tiles have nonzero cells.
+    SkAutoTMalloc<SkAlpha>           fAlpha;    // A strip's worth of rows to blit...
+    SkAutoTMalloc<int16_t>           fRuns;     // ...and their runs, in SkAlphaRuns form.
+};
+
+}  // namespace
+
+void SkScan::SparseAAFillPath(const SkPathView& path, SkBlitter* blitter, const SkIRect& ir,
+                              const SkIRect& clipBounds) {
+    // Inverse fills cover every column of the clip; our caller has handled the rows above and
+    // below the path.
+    SkIRect bounds = ir;
+    if (path.isInverseFillType()) {
+        bounds.fLeft  = clipBounds.fLeft;
+        bounds.fRight = clipBounds.fRight;
+    }
+    if (!bounds.intersect(clipBounds)) {
+        return;
+    }
+
+    SparseTileRasterizer rasterizer(bounds);
+    rasterizer.addPath(path);
+    rasterizer.blit(path.fFillType, blitter);
+}
@@ -10,6 +10,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkImage.h"
+#include "src/core/SkImagePriv.h"
 #include "src/core/SkSpecialSurface.h"
 #include "src/core/SkSurfacePriv.h"
 #include "src/image/SkImage_Base.h"
@@ -195,6 +196,17 @@ public:
         SkRect dst = SkRect::MakeXYWH(x, y,
                                       this->subset().width(), this->subset().height());
 
+        // A raster canvas is done with the pixels when the draw returns, so they can be wrapped
+        // instead of copied (as drawBitmapRect() does for mutable bitmaps). Filters that draw in
+        // row bands draw the same image once per band, so this saves a copy of it per band.
+        SkPixmap pixels;
+        if (canvas->peekPixels(&pixels)) {
+            canvas->drawImageRect(SkMakeImageFromRasterBitmap(fBitmap, kNever_SkCopyPixelsMode),
+                                  SkRect::Make(this->subset()), dst, paint,
+                                  SkCanvas::kStrict_SrcRectConstraint);
+            return;
+        }
+
         canvas->drawBitmapRect(fBitmap, this->subset(),
                                dst, paint, SkCanvas::kStrict_SrcRectConstraint);
     }
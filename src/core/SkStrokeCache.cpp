@@ -0,0 +1,168 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkStrokeCache.h"
+
+#include "include/core/SkPath.h"
+#include "include/core/SkStrokeRec.h"
+#include "include/private/SkIDChangeListener.h"
+#include "include/private/SkMutex.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkResourceCache.h"
+
+#include <atomic>
+
+namespace {
+static unsigned gStrokeKeyNamespaceLabel;
+
+// Small paths are cheap to stroke and are most often drawn once, so not worth the cache space.
+static constexpr int kMinPointsToCache = 16;
+
+// Strokes are kept apart from the global SkResourceCache, so that they neither evict nor are
+// evicted by the bitmaps there, and don't contend for its mutex.
+static constexpr size_t kStrokeCacheBudget = 4 * 1024 * 1024;
+
+static std::atomic<int> gHits{0},
+                        gMisses{0};
+
+static uint64_t make_shared_id(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('p', 'a', 't', 'h');
+    return (sharedID << 32) | pathGenID;
+}
+
+// Purges every stroke of a path once it's edited or destroyed.
+class StrokeInvalidator : public SkIDChangeListener {
+public:
+    StrokeInvalidator(uint32_t pathGenID) : fPathGenID(pathGenID) {}
+
+private:
+    void changed() override {
+        SkResourceCache::PostPurgeSharedID(make_shared_id(fPathGenID));
+    }
+
+    uint32_t fPathGenID;
+};
+
+struct StrokeKey : public SkResourceCache::Key {
+    StrokeKey(const SkPath& path, const SkStrokeRec& rec)
+        : fPathGenID(path.getGenerationID())
+        , fWidth(rec.getWidth())
+        , fMiterLimit(rec.getJoin() == SkPaint::kMiter_Join ? rec.getMiter() : 0)
+        , fResScale(rec.getResScale())
+        , fFlags(rec.getCap()
+               | rec.getJoin() << 2
+               | (rec.getStyle() == SkStrokeRec::kStrokeAndFill_Style) << 4
+               | path.isInverseFillType() << 5)
+    {
+        this->init(&gStrokeKeyNamespaceLabel, make_shared_id(fPathGenID),
+                   sizeof(fPathGenID) + sizeof(fWidth) + sizeof(fMiterLimit) + sizeof(fResScale) +
+                   sizeof(fFlags));
+    }
+
+    uint32_t fPathGenID;
+    SkScalar fWidth;
+    SkScalar fMiterLimit;
+    SkScalar fResScale;
+    uint32_t fFlags;
+};
+
+struct StrokeRec : public SkResourceCache::Rec {
+    StrokeRec(const StrokeKey& key, const SkPath& stroke, sk_sp<SkIDChangeListener> invalidator)
+        : fKey(key)
+        , fStroke(stroke)
+        , fInvalidator(std::move(invalidator)) {}
+
+    ~StrokeRec() override {
+        // Once we're gone there's nothing left for the path to purge.
+        fInvalidator->markShouldDeregister();
+    }
+
+    StrokeKey                 fKey;
+    SkPath                    fStroke;
+    sk_sp<SkIDChangeListener> fInvalidator;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fStroke.approximateBytesUsed(); }
+    const char* getCategory() const override { return "stroked-path"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const StrokeRec& rec = static_cast<const StrokeRec&>(baseRec);
+        // This shares the cached path's points rather than copying them.
+        *static_cast<SkPath*>(contextData) = rec.fStroke;
+        return true;
+    }
+};
+} // namespace
+
+static SkMutex& stroke_cache_mutex() {
+    static SkMutex& mutex = *(new SkMutex);
+    return mutex;
+}
+
+/** Must hold stroke_cache_mutex() when calling. */
+static SkResourceCache* stroke_cache() {
+    stroke_cache_mutex().assertHeld();
+    static SkResourceCache* cache = new SkResourceCache(kStrokeCacheBudget);
+    return cache;
+}
+
+static bool find(const StrokeKey& key, SkPath* dst, SkResourceCache* localCache) {
+    if (localCache) {
+        return localCache->find(key, StrokeRec::Visitor, dst);
+    }
+    SkAutoMutexExclusive lock(stroke_cache_mutex());
+    return stroke_cache()->find(key, StrokeRec::Visitor, dst);
+}
+
+static void add(StrokeRec* rec, SkResourceCache* localCache) {
+    if (localCache) {
+        localCache->add(rec);
+        return;
+    }
+    SkAutoMutexExclusive lock(stroke_cache_mutex());
+    stroke_cache()->add(rec);
+}
+
+bool SkStrokeCache::ApplyToPath(const SkStrokeRec& rec, SkPath* dst, const SkPath& src,
+                                SkResourceCache* localCache) {
+    if (rec.getWidth() <= 0) {  // hairline or fill
+        return false;
+    }
+    if (src.isVolatile() || src.countPoints() < kMinPointsToCache) {
+        return rec.applyToPath(dst, src);
+    }
+
+    StrokeKey key(src, rec);
+    if (find(key, dst, localCache)) {
+        gHits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    gMisses.fetch_add(1, std::memory_order_relaxed);
+
+    SkPath stroke;
+    rec.applyToPath(&stroke, src);
+    auto invalidator = sk_make_sp<StrokeInvalidator>(key.fPathGenID);
+    SkPathPriv::AddGenIDChangeListener(src, invalidator);
+    add(new StrokeRec(key, stroke, std::move(invalidator)), localCache);
+    *dst = std::move(stroke);
+    return true;
+}
+
+void SkStrokeCache::PurgeAll() {
+    SkAutoMutexExclusive lock(stroke_cache_mutex());
+    stroke_cache()->purgeAll();
+}
+
+SkStrokeCache::Stats SkStrokeCache::GetStats() {
+    return {gHits.load(std::memory_order_relaxed), gMisses.load(std::memory_order_relaxed)};
+}
+
+void SkStrokeCache::ResetStats() {
+    gHits.store(0, std::memory_order_relaxed);
+    gMisses.store(0, std::memory_order_relaxed);
+}
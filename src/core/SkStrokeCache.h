@@ -0,0 +1,45 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "include/core/SkTypes.h"
+
+class SkPath;
+class SkResourceCache;
+class SkStrokeRec;
+
+/**
+ *  Remembers the outlines of stroked paths, so a path drawn with the same stroke frame after frame
+ *  is only stroked once. Entries are keyed by the path's generation ID and the exact stroke
+ *  parameters, and are purged when the path is edited or destroyed. They live in an
+ *  SkResourceCache of their own with a small budget, apart from the global one.
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  Strokes src into dst exactly like rec.applyToPath(), but reusing a previous outline if src
+     *  has already been stroked this way. Returns false, leaving dst untouched, if rec is a
+     *  hairline or fill.
+     */
+    static bool ApplyToPath(const SkStrokeRec& rec, SkPath* dst, const SkPath& src,
+                            SkResourceCache* localCache = nullptr);
+
+    /** Drops every cached outline. */
+    static void PurgeAll();
+
+    struct Stats {
+        int fHits;
+        int fMisses;
+    };
+    /** Lookups so far (not counting paths too small or volatile to cache), across all caches. */
+    static Stats GetStats();
+    static void ResetStats();
+};
+
+#endif
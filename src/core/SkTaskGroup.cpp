@@ -8,6 +8,8 @@
 #include "include/core/SkExecutor.h"
 #include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
+
 SkTaskGroup::SkTaskGroup(SkExecutor& executor) : fPending(0), fExecutor(executor) {}
 
 void SkTaskGroup::add(std::function<void(void)> fn) {
@@ -43,6 +45,35 @@ void SkTaskGroup::wait() {
     }
 }
 
+void SkForEachRowBand(SkExecutor* executor, int width, int height,
+                      const std::function<void(int top, int bottom)>& rows,
+                      int minBandPixels, int rowMultiple) {
+    static constexpr int kMaxBands = 32;
+
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    int bands = 1;
+    if (executor && !SkExecutorIsTrivial(*executor)) {
+        int64_t byPixels = (int64_t)width * height / minBandPixels;
+        bands = (int)std::min<int64_t>(std::min(kMaxBands, height / rowMultiple), byPixels);
+    }
+    if (bands <= 1) {
+        rows(0, height);
+        return;
+    }
+
+    int bandHeight = (height + bands - 1) / bands;
+    bandHeight = (bandHeight + rowMultiple - 1) / rowMultiple * rowMultiple;
+    bands = (height + bandHeight - 1) / bandHeight;
+    SkTaskGroup tasks(*executor);
+    tasks.batch(bands, [&](int i) {
+        int top = i * bandHeight;
+        rows(top, std::min(height, top + bandHeight));
+    });
+    tasks.wait();
+}
+
 SkTaskGroup::Enabler::Enabler(int threads) {
     if (threads) {
         fThreadPool = SkExecutor::MakeLIFOThreadPool(threads);
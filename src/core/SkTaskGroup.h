@@ -45,4 +45,17 @@ private:
     SkExecutor&          fExecutor;
 };
 
+// True for the SkExecutor that SkExecutor::GetDefault() returns until a client sets another,
+// which just runs work right away on the calling thread.  (Defined in SkExecutor.cpp.)
+bool SkExecutorIsTrivial(const SkExecutor&);
+
+// Calls rows(top, bottom) for horizontal bands covering [0, height) of a width x height image.
+// Big enough images are split into bands that run concurrently on executor, so 'rows' must only
+// write to the rows it is given.  With a null or trivial executor, this is just rows(0, height).
+// Bands hold at least minBandPixels pixels, and all but the last are a multiple of rowMultiple
+// rows high.
+void SkForEachRowBand(SkExecutor* executor, int width, int height,
+                      const std::function<void(int top, int bottom)>& rows,
+                      int minBandPixels = 32 * 1024, int rowMultiple = 1);
+
 #endif//SkTaskGroup_DEFINED
@@ -188,11 +188,14 @@ static bool intersect(SkPixmap* dst, SkPixmap* src, int srcDx, int srcDy) {
 
 sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(const Context& ctx,
                                                                SkIPoint* offset) const {
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, ctx, &backgroundOffset));
+    sk_sp<SkSpecialImage> inputs[2];
+    SkIPoint inputOffsets[2];
+    this->filterInputs(ctx, inputs, inputOffsets);
 
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, ctx, &foregroundOffset));
+    sk_sp<SkSpecialImage> background = std::move(inputs[0]);
+    const SkIPoint& backgroundOffset = inputOffsets[0];
+    sk_sp<SkSpecialImage> foreground = std::move(inputs[1]);
+    const SkIPoint& foregroundOffset = inputOffsets[1];
 
     SkIRect foregroundBounds = SkIRect::MakeEmpty();
     if (foreground) {
@@ -231,20 +234,19 @@ sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(const Context& ct
         return nullptr;
     }
 
-    SkCanvas* canvas = surf->getCanvas();
-    SkASSERT(canvas);
+    DrawInRowBands(ctx, surf.get(), [&](SkCanvas* canvas) {
+        canvas->clear(0x0);  // can't count on background to fully clear the background
+        canvas->translate(SkIntToScalar(-bounds.left()), SkIntToScalar(-bounds.top()));
 
-    canvas->clear(0x0);  // can't count on background to fully clear the background
-    canvas->translate(SkIntToScalar(-bounds.left()), SkIntToScalar(-bounds.top()));
-
-    if (background) {
-        SkPaint paint;
-        paint.setBlendMode(SkBlendMode::kSrc);
-        background->draw(canvas, SkIntToScalar(backgroundOffset.fX),
-                         SkIntToScalar(backgroundOffset.fY), &paint);
-    }
+        if (background) {
+            SkPaint paint;
+            paint.setBlendMode(SkBlendMode::kSrc);
+            background->draw(canvas, SkIntToScalar(backgroundOffset.fX),
+                             SkIntToScalar(backgroundOffset.fY), &paint);
+        }
 
-    this->drawForeground(canvas, foreground.get(), foregroundBounds);
+        this->drawForeground(canvas, foreground.get(), foregroundBounds);
+    });
 
     return surf->makeImageSnapshot();
 }
@@ -10,17 +10,17 @@
 #include <algorithm>
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkTileMode.h"
 #include "include/private/SkColorData.h"
-#include "include/private/SkNx.h"
 #include "include/private/SkTFitsIn.h"
-#include "src/core/SkArenaAlloc.h"
 #include "src/core/SkAutoPixmapStorage.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
 #if SK_SUPPORT_GPU
@@ -189,177 +189,23 @@ static int calculate_border(int window) {
     return (window & 1) == 1 ? 3 * ((window - 1) / 2) : 3 * (window / 2) - 1;
 }
 
-static int calculate_buffer(int window) {
-    int bufferSize = window - 1;
-    return (window & 1) == 1 ? 3 * bufferSize : 3 * bufferSize + 1;
-}
-
-// blur_one_direction implements the common three pass box filter approximation of Gaussian blur,
-// but combines all three passes into a single pass. This approach is facilitated by three circular
-// buffers the width of the window which track values for trailing edges of each of the three
-// passes. This allows the algorithm to use more precision in the calculation because the values
-// are not rounded each pass. And this implementation also avoids a trap that's easy to fall
-// into resulting in blending in too many zeroes near the edge.
-//
-//  In general, a window sum has the form:
-//     sum_n+1 = sum_n + leading_edge - trailing_edge.
-//  If instead we do the subtraction at the end of the previous iteration, we can just
-// calculate the sums instead of having to do the subtractions too.
-//
-//      In previous iteration:
-//      sum_n+1 = sum_n - trailing_edge.
-//
-//      In this iteration:
-//      sum_n+1 = sum_n + leading_edge.
-//
-//  Now we can stack all three sums and do them at once. Sum0 gets its leading edge from the
-// actual data. Sum1's leading edge is just Sum0, and Sum2's leading edge is Sum1. So, doing the
-// three passes at the same time has the form:
-//
-//    sum0_n+1 = sum0_n + leading edge
-//    sum1_n+1 = sum1_n + sum0_n+1
-//    sum2_n+1 = sum2_n + sum1_n+1
-//
-//    sum2_n+1 / window^3 is the new value of the destination pixel.
-//
-//    Reduce the sums by the trailing edges which were stored in the circular buffers,
-// for the next go around. This is the case for odd sized windows, even windows the the third
-// circular buffer is one larger then the first two circular buffers.
-//
-//    sum2_n+2 = sum2_n+1 - buffer2[i];
-//    buffer2[i] = sum1;
-//    sum1_n+2 = sum1_n+1 - buffer1[i];
-//    buffer1[i] = sum0;
-//    sum0_n+2 = sum0_n+1 - buffer0[i];
-//    buffer0[i] = leading edge
-//
-//   This is all encapsulated in the processValue function below.
-//
-using Pass0And1 = Sk4u[2];
-// The would be dLeft parameter is assumed to be 0.
-static void blur_one_direction(Sk4u* buffer, int window,
+// Blurs srcH lines, each independently of the others. Big blurs are split into bands of lines
+// which run on the executor.
+static void blur_one_direction(SkExecutor* executor, int window,
                                int srcLeft, int srcRight, int dstRight,
                                const uint32_t* src, int srcXStride, int srcYStride, int srcH,
                                      uint32_t* dst, int dstXStride, int dstYStride) {
-
-    // The circular buffers are one less than the window.
-    auto pass0Count = window - 1,
-         pass1Count = window - 1,
-         pass2Count = (window & 1) == 1 ? window - 1 : window;
-
-    Pass0And1* buffer01Start = (Pass0And1*)buffer;
-    Sk4u*      buffer2Start  = buffer + pass0Count + pass1Count;
-    Pass0And1* buffer01End   = (Pass0And1*)buffer2Start;
-    Sk4u*      buffer2End    = buffer2Start + pass2Count;
-
-    // If the window is odd then the divisor is just window ^ 3 otherwise,
-    // it is window * window * (window + 1) = window ^ 3 + window ^ 2;
-    auto window2 = window * window;
-    auto window3 = window2 * window;
-    auto divisor = (window & 1) == 1 ? window3 : window3 + window2;
-
-    // NB the sums in the blur code use the following technique to avoid
-    // adding 1/2 to round the divide.
-    //
-    //   Sum/d + 1/2 == (Sum + h) / d
-    //   Sum + d(1/2) ==  Sum + h
-    //     h == (1/2)d
-    //
-    // But the d/2 it self should be rounded.
-    //    h == d/2 + 1/2 == (d + 1) / 2
-    //
-    // weight = 1 / d * 2 ^ 32
-    auto weight = static_cast<uint32_t>(round(1.0 / divisor * (1ull << 32)));
-    auto half = static_cast<uint32_t>((divisor + 1) / 2);
-
     auto border = calculate_border(window);
 
-    // Calculate the start and end of the source pixels with respect to the destination start.
-    auto srcStart = srcLeft - border,
-         srcEnd   = srcRight - border,
-         dstEnd   = dstRight;
-
-    for (auto y = 0; y < srcH; y++) {
-        auto buffer01Cursor = buffer01Start;
-        auto buffer2Cursor  = buffer2Start;
-
-        Sk4u sum0{0u};
-        Sk4u sum1{0u};
-        Sk4u sum2{half};
-
-        sk_bzero(buffer01Start, (buffer2End - (Sk4u *) (buffer01Start)) * sizeof(*buffer2Start));
-
-        // Given an expanded input pixel, move the window ahead using the leadingEdge value.
-        auto processValue = [&](const Sk4u& leadingEdge) -> Sk4u {
-            sum0 += leadingEdge;
-            sum1 += sum0;
-            sum2 += sum1;
-
-            Sk4u value = sum2.mulHi(weight);
-
-            sum2 -= *buffer2Cursor;
-            *buffer2Cursor = sum1;
-            buffer2Cursor = (buffer2Cursor + 1) < buffer2End ? buffer2Cursor + 1 : buffer2Start;
-
-            sum1 -= (*buffer01Cursor)[1];
-            (*buffer01Cursor)[1] = sum0;
-            sum0 -= (*buffer01Cursor)[0];
-            (*buffer01Cursor)[0] = leadingEdge;
-            buffer01Cursor =
-                    (buffer01Cursor + 1) < buffer01End ? buffer01Cursor + 1 : buffer01Start;
-
-            return value;
-        };
-
-        auto srcIdx = srcStart;
-        auto dstIdx = 0;
-        const uint32_t* srcCursor = src;
-              uint32_t* dstCursor = dst;
-
-        // The destination pixels are not effected by the src pixels,
-        // change to zero as per the spec.
-        // https://drafts.fxtf.org/filter-effects/#FilterPrimitivesOverviewIntro
-        while (dstIdx < srcIdx) {
-            *dstCursor = 0;
-            dstCursor += dstXStride;
-            SK_PREFETCH(dstCursor);
-            dstIdx++;
-        }
-
-        // The edge of the source is before the edge of the destination. Calculate the sums for
-        // the pixels before the start of the destination.
-        while (dstIdx > srcIdx) {
-            Sk4u leadingEdge = srcIdx < srcEnd ? SkNx_cast<uint32_t>(Sk4b::Load(srcCursor)) : 0;
-            (void) processValue(leadingEdge);
-            srcCursor += srcXStride;
-            srcIdx++;
-        }
+    // Bands of fewer pixels than this are not worth the trip through the executor.
+    static constexpr int kMinBandPixels = 128 * 1024;
 
-        // The dstIdx and srcIdx are in sync now; the code just uses the dstIdx for both now.
-        // Consume the source generating pixels to dst.
-        auto loopEnd = std::min(dstEnd, srcEnd);
-        while (dstIdx < loopEnd) {
-            Sk4u leadingEdge = SkNx_cast<uint32_t>(Sk4b::Load(srcCursor));
-            SkNx_cast<uint8_t>(processValue(leadingEdge)).store(dstCursor);
-            srcCursor += srcXStride;
-            dstCursor += dstXStride;
-            SK_PREFETCH(dstCursor);
-            dstIdx++;
-        }
-
-        // The leading edge is beyond the end of the source. Assume that the pixels
-        // are now 0x0000 until the end of the destination.
-        loopEnd = dstEnd;
-        while (dstIdx < loopEnd) {
-            SkNx_cast<uint8_t>(processValue(0u)).store(dstCursor);
-            dstCursor += dstXStride;
-            SK_PREFETCH(dstCursor);
-            dstIdx++;
-        }
-
-        src += srcYStride;
-        dst += dstYStride;
-    }
+    // Keep bands a multiple of 8 lines, so they split evenly into the kernel's groups of lines.
+    SkForEachRowBand(executor, std::max(srcRight, dstRight), srcH, [&](int top, int bottom) {
+        SkOpts::box_blur(window, border, srcLeft, srcRight, dstRight,
+                         src + (int64_t)top * srcYStride, srcXStride, srcYStride, bottom - top,
+                         dst + (int64_t)top * dstYStride, dstXStride, dstYStride);
+    }, kMinBandPixels, 8);
 }
 
 static sk_sp<SkSpecialImage> copy_image_with_bounds(
@@ -468,14 +314,6 @@ static sk_sp<SkSpecialImage> cpu_blur(
         return nullptr;
     }
 
-    auto bufferSizeW = calculate_buffer(windowW),
-         bufferSizeH = calculate_buffer(windowH);
-
-    // The amount 1024 is enough for buffers up to 10 sigma. The tmp bitmap will be
-    // allocated on the heap.
-    SkSTArenaAlloc<1024> alloc;
-    Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(std::max(bufferSizeW, bufferSizeH));
-
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
     //     the destination. Then, do an in-place vertical blur.
@@ -517,7 +355,7 @@ static sk_sp<SkSpecialImage> cpu_blur(
         intermediateDst = static_cast<uint32_t *>(dst.getPixels());
 
         blur_one_direction(
-                buffer, windowW,
+                ctx.executor(), windowW,
                 srcBounds.left(), srcBounds.right(), dstBounds.right(),
                 static_cast<uint32_t *>(src.getPixels()), 1, src.rowBytesAsPixels(), srcH,
                 intermediateSrc, 1, intermediateRowBytesAsPixels);
@@ -525,7 +363,7 @@ static sk_sp<SkSpecialImage> cpu_blur(
 
     if (windowH > 1) {
         blur_one_direction(
-                buffer, windowH,
+                ctx.executor(), windowH,
                 srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
                 intermediateSrc, intermediateRowBytesAsPixels, 1, intermediateWidth,
                 intermediateDst, dst.rowBytesAsPixels(), 1);
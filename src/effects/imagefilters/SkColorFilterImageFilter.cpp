@@ -86,8 +86,12 @@ void SkColorFilterImageFilterImpl::flatten(SkWriteBuffer& buffer) const {
 
 sk_sp<SkSpecialImage> SkColorFilterImageFilterImpl::onFilterImage(const Context& ctx,
                                                                   SkIPoint* offset) const {
+    // A run of color filters and offsets below this one is fused into the draw below, rather than
+    // each producing an image of its own.
     SkIPoint inputOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> input(this->filterInput(0, ctx, &inputOffset));
+    sk_sp<SkColorFilter> inputColorFilter;
+    sk_sp<SkSpecialImage> input(this->filterInputForDraw(0, ctx, &inputOffset,
+                                                         &inputColorFilter));
 
     SkIRect inputBounds;
     if (as_CFB(fColorFilter)->affectsTransparentBlack()) {
@@ -110,32 +114,34 @@ sk_sp<SkSpecialImage> SkColorFilterImageFilterImpl::onFilterImage(const Context&
         return nullptr;
     }
 
-    SkCanvas* canvas = surf->getCanvas();
-    SkASSERT(canvas);
-
     SkPaint paint;
 
     paint.setBlendMode(SkBlendMode::kSrc);
-    paint.setColorFilter(fColorFilter);
-
-    // TODO: it may not be necessary to clear or drawPaint inside the input bounds
-    // (see skbug.com/5075)
-    if (as_CFB(fColorFilter)->affectsTransparentBlack()) {
-        // The subsequent input->draw() call may not fill the entire canvas. For filters which
-        // affect transparent black, ensure that the filter is applied everywhere.
-        paint.setColor(SK_ColorTRANSPARENT);
-        canvas->drawPaint(paint);
-        paint.setColor(SK_ColorBLACK);
-    } else {
-        canvas->clear(0x0);
-    }
+    paint.setColorFilter(inputColorFilter ? fColorFilter->makeComposed(inputColorFilter)
+                                          : fColorFilter);
+
+    DrawInRowBands(ctx, surf.get(), [&](SkCanvas* canvas) {
+        SkPaint bandPaint(paint);
+
+        // TODO: it may not be necessary to clear or drawPaint inside the input bounds
+        // (see skbug.com/5075)
+        if (as_CFB(fColorFilter)->affectsTransparentBlack()) {
+            // The subsequent input->draw() call may not fill the entire canvas. For filters which
+            // affect transparent black, ensure that the filter is applied everywhere.
+            bandPaint.setColor(SK_ColorTRANSPARENT);
+            canvas->drawPaint(bandPaint);
+            bandPaint.setColor(SK_ColorBLACK);
+        } else {
+            canvas->clear(0x0);
+        }
 
-    if (input) {
-        input->draw(canvas,
-                    SkIntToScalar(inputOffset.fX - bounds.fLeft),
-                    SkIntToScalar(inputOffset.fY - bounds.fTop),
-                    &paint);
-    }
+        if (input) {
+            input->draw(canvas,
+                        SkIntToScalar(inputOffset.fX - bounds.fLeft),
+                        SkIntToScalar(inputOffset.fY - bounds.fTop),
+                        &bandPaint);
+        }
+    });
 
     offset->fX = bounds.fLeft;
     offset->fY = bounds.fTop;
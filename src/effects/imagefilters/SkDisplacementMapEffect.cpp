@@ -230,18 +230,20 @@ private:
 }  // anonymous namespace
 #endif
 
+// Computes rows [top, bottom) of 'bounds' into the corresponding rows of 'dst'.
 static void compute_displacement(Extractor ex, const SkVector& scale, SkBitmap* dst,
                                  const SkBitmap& displ, const SkIPoint& offset,
                                  const SkBitmap& src,
-                                 const SkIRect& bounds) {
+                                 const SkIRect& bounds,
+                                 int top, int bottom) {
     static const SkScalar Inv8bit = SkScalarInvert(255);
     const int srcW = src.width();
     const int srcH = src.height();
     const SkVector scaleForColor = SkVector::Make(scale.fX * Inv8bit, scale.fY * Inv8bit);
     const SkVector scaleAdj = SkVector::Make(SK_ScalarHalf - scale.fX * SK_ScalarHalf,
                                              SK_ScalarHalf - scale.fY * SK_ScalarHalf);
-    SkPMColor* dstPtr = dst->getAddr32(0, 0);
-    for (int y = bounds.top(); y < bounds.bottom(); ++y) {
+    SkPMColor* dstPtr = dst->getAddr32(0, top - bounds.top());
+    for (int y = top; y < bottom; ++y) {
         const SkPMColor* displPtr = displ.getAddr32(bounds.left() + offset.fX, y + offset.fY);
         for (int x = bounds.left(); x < bounds.right(); ++x, ++displPtr) {
             SkColor c = SkUnPreMultiply::PMColorToColor(*displPtr);
@@ -276,8 +278,9 @@ sk_sp<SkSpecialImage> SkDisplacementMapEffectImpl::onFilterImage(const Context&
     // With a more complex DAG attached to this input, it's not clear that working in ANY specific
     // color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
     // ideal, but it's at least consistent and predictable.
-    Context displContext(ctx.mapping(), ctx.desiredOutput(), ctx.cache(),
-                         kN32_SkColorType, nullptr, ctx.source());
+    Context displContext = Context(ctx.mapping(), ctx.desiredOutput(), ctx.cache(),
+                                   kN32_SkColorType, nullptr, ctx.source())
+                                   .withExecutor(ctx.executor());
     sk_sp<SkSpecialImage> displ(this->filterInput(0, displContext, &displOffset));
     if (!displ) {
         return nullptr;
@@ -392,8 +395,11 @@ sk_sp<SkSpecialImage> SkDisplacementMapEffectImpl::onFilterImage(const Context&
         return nullptr;
     }
 
-    compute_displacement(Extractor(fXChannelSelector, fYChannelSelector), scale, &dst,
-                         displBM, colorOffset - displOffset, colorBM, colorBounds);
+    ForEachRowBand(ctx, colorBounds.width(), colorBounds.height(), [&](int top, int bottom) {
+        compute_displacement(Extractor(fXChannelSelector, fYChannelSelector), scale, &dst,
+                             displBM, colorOffset - displOffset, colorBM, colorBounds,
+                             colorBounds.top() + top, colorBounds.top() + bottom);
+    });
 
     offset->fX = bounds.left();
     offset->fY = bounds.top();
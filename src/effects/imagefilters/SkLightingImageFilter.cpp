@@ -284,94 +284,94 @@ public:
     }
 };
 
+// Lights rows [top, bottom) of 'bounds' (which is at least 2x2). Rows are independent, so the
+// rows of one image can be lit by several threads at once.
 template <class PixelFetcher>
 static void lightBitmap(const BaseLightingType& lightingType,
                  const SkImageFilterLight* l,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
-                 const SkIRect& bounds) {
+                 const SkIRect& bounds,
+                 int top, int bottom) {
     SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
+    SkASSERT(bounds.top() <= top && top < bottom && bottom <= bounds.bottom());
     int left = bounds.left(), right = bounds.right();
-    int bottom = bounds.bottom();
-    int y = bounds.top();
     SkIRect srcBounds = src.bounds();
-    SkPMColor* dptr = dst->getAddr32(0, 0);
-    {
-        int x = left;
-        int m[9];
-        m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-        m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
-        m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topLeftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
+    for (int y = top; y < bottom; ++y) {
+        SkPMColor* dptr = dst->getAddr32(0, y - bounds.top());
+        if (y == bounds.top()) {
+            int x = left;
+            int m[9];
+            m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
             m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+            m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
             m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
+            SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+            *dptr++ = lightingType.light(topLeftNormal(m, surfaceScale), surfaceToLight,
+                                         l->lightColor(surfaceToLight));
+            for (++x; x < right - 1; ++x)
+            {
+                shiftMatrixLeft(m);
+                m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+                m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
+                surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+                *dptr++ = lightingType.light(topNormal(m, surfaceScale), surfaceToLight,
+                                             l->lightColor(surfaceToLight));
+            }
+            shiftMatrixLeft(m);
             surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(topNormal(m, surfaceScale), surfaceToLight,
+            *dptr++ = lightingType.light(topRightNormal(m, surfaceScale), surfaceToLight,
                                          l->lightColor(surfaceToLight));
-        }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topRightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
-
-    for (++y; y < bottom - 1; ++y) {
-        int x = left;
-        int m[9];
-        m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
-        m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-        m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-        m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
-        m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
+        } else if (y == bounds.bottom() - 1) {
+            int x = left;
+            int m[9];
+            m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
+            m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
+            m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
+            m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+            SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+            *dptr++ = lightingType.light(bottomLeftNormal(m, surfaceScale), surfaceToLight,
+                                         l->lightColor(surfaceToLight));
+            for (++x; x < right - 1; ++x)
+            {
+                shiftMatrixLeft(m);
+                m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
+                m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+                surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+                *dptr++ = lightingType.light(bottomNormal(m, surfaceScale), surfaceToLight,
+                                             l->lightColor(surfaceToLight));
+            }
             shiftMatrixLeft(m);
+            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+            *dptr++ = lightingType.light(bottomRightNormal(m, surfaceScale), surfaceToLight,
+                                         l->lightColor(surfaceToLight));
+        } else {
+            int x = left;
+            int m[9];
+            m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
             m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
+            m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
             m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+            m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
             m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
+            SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+            *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
                                          l->lightColor(surfaceToLight));
-        }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
-
-    {
-        int x = left;
-        int m[9];
-        m[1] = PixelFetcher::Fetch(src, x,     bottom - 2, srcBounds);
-        m[2] = PixelFetcher::Fetch(src, x + 1, bottom - 2, srcBounds);
-        m[4] = PixelFetcher::Fetch(src, x,     bottom - 1, srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, bottom - 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomLeftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
+            for (++x; x < right - 1; ++x) {
+                shiftMatrixLeft(m);
+                m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
+                m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+                m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
+                surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+                *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
+                                             l->lightColor(surfaceToLight));
+            }
             shiftMatrixLeft(m);
-            m[2] = PixelFetcher::Fetch(src, x + 1, bottom - 2, srcBounds);
-            m[5] = PixelFetcher::Fetch(src, x + 1, bottom - 1, srcBounds);
             surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(bottomNormal(m, surfaceScale), surfaceToLight,
+            *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
                                          l->lightColor(surfaceToLight));
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomRightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
     }
 }
 
@@ -380,13 +380,14 @@ static void lightBitmap(const BaseLightingType& lightingType,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
-                 const SkIRect& bounds) {
+                 const SkIRect& bounds,
+                 int top, int bottom) {
     if (src.bounds().contains(bounds)) {
         lightBitmap<UncheckedPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
+            lightingType, light, src, dst, surfaceScale, bounds, top, bottom);
     } else {
         lightBitmap<DecalPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
+            lightingType, light, src, dst, surfaceScale, bounds, top, bottom);
     }
 }
 
@@ -1304,12 +1305,10 @@ sk_sp<SkSpecialImage> SkDiffuseLightingImageFilter::onFilterImage(const Context&
     sk_sp<SkImageFilterLight> transformedLight(light()->transform(matrix));
 
     DiffuseLightingType lightingType(fKD);
-    lightBitmap(lightingType,
-                                                             transformedLight.get(),
-                                                             inputBM,
-                                                             &dst,
-                                                             surfaceScale(),
-                                                             bounds);
+    ForEachRowBand(ctx, bounds.width(), bounds.height(), [&](int top, int bottom) {
+        lightBitmap(lightingType, transformedLight.get(), inputBM, &dst, surfaceScale(), bounds,
+                    bounds.top() + top, bounds.top() + bottom);
+    });
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()),
                                           dst);
@@ -1440,12 +1439,10 @@ sk_sp<SkSpecialImage> SkSpecularLightingImageFilter::onFilterImage(const Context
 
     sk_sp<SkImageFilterLight> transformedLight(light()->transform(matrix));
 
-    lightBitmap(lightingType,
-                                                              transformedLight.get(),
-                                                              inputBM,
-                                                              &dst,
-                                                              surfaceScale(),
-                                                              bounds);
+    ForEachRowBand(ctx, bounds.width(), bounds.height(), [&](int top, int bottom) {
+        lightBitmap(lightingType, transformedLight.get(), inputBM, &dst, surfaceScale(), bounds,
+                    bounds.top() + top, bounds.top() + bottom);
+    });
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()), dst);
 }
@@ -8,6 +8,7 @@
 #include "include/effects/SkMergeImageFilter.h"
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
@@ -71,11 +72,12 @@ sk_sp<SkSpecialImage> SkMergeImageFilterImpl::onFilterImage(const Context& ctx,
 
     std::unique_ptr<sk_sp<SkSpecialImage>[]> inputs(new sk_sp<SkSpecialImage>[inputCount]);
     std::unique_ptr<SkIPoint[]> offsets(new SkIPoint[inputCount]);
+    std::unique_ptr<sk_sp<SkColorFilter>[]> colorFilters(new sk_sp<SkColorFilter>[inputCount]);
 
-    // Filter all of the inputs.
+    // Filter all of the inputs. Runs of color filters feeding the merge are applied as the inputs
+    // are drawn below.
+    this->filterInputs(ctx, inputs.get(), offsets.get(), colorFilters.get());
     for (int i = 0; i < inputCount; ++i) {
-        offsets[i] = { 0, 0 };
-        inputs[i] = this->filterInput(i, ctx, &offsets[i]);
         if (!inputs[i]) {
             continue;
         }
@@ -104,21 +106,22 @@ sk_sp<SkSpecialImage> SkMergeImageFilterImpl::onFilterImage(const Context& ctx,
         return nullptr;
     }
 
-    SkCanvas* canvas = surf->getCanvas();
-    SkASSERT(canvas);
-
-    canvas->clear(0x0);
-
     // Composite all of the filter inputs.
-    for (int i = 0; i < inputCount; ++i) {
-        if (!inputs[i]) {
-            continue;
+    DrawInRowBands(ctx, surf.get(), [&](SkCanvas* canvas) {
+        canvas->clear(0x0);
+        for (int i = 0; i < inputCount; ++i) {
+            if (!inputs[i]) {
+                continue;
+            }
+
+            SkPaint paint;
+            paint.setColorFilter(colorFilters[i]);
+            inputs[i]->draw(canvas,
+                            SkIntToScalar(offsets[i].x() - x0),
+                            SkIntToScalar(offsets[i].y() - y0),
+                            &paint);
         }
-
-        inputs[i]->draw(canvas,
-                        SkIntToScalar(offsets[i].x() - x0), SkIntToScalar(offsets[i].y() - y0),
-                        nullptr);
-    }
+    });
 
     offset->fX = bounds.left();
     offset->fY = bounds.top();
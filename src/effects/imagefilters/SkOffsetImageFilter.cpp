@@ -34,6 +34,7 @@ protected:
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
     SkIRect onFilterNodeBounds(const SkIRect&, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
+    bool onIsOffsetNode(SkVector*) const override;
 
 private:
     friend void SkOffsetImageFilter::RegisterFlattenables();
@@ -109,18 +110,17 @@ sk_sp<SkSpecialImage> SkOffsetImageFilterImpl::onFilterImage(const Context& ctx,
             return nullptr;
         }
 
-        SkCanvas* canvas = surf->getCanvas();
-        SkASSERT(canvas);
+        DrawInRowBands(ctx, surf.get(), [&](SkCanvas* canvas) {
+            // TODO: it seems like this clear shouldn't be necessary (see skbug.com/5075)
+            canvas->clear(0x0);
 
-        // TODO: it seems like this clear shouldn't be necessary (see skbug.com/5075)
-        canvas->clear(0x0);
+            SkPaint paint;
+            paint.setBlendMode(SkBlendMode::kSrc);
+            canvas->translate(SkIntToScalar(srcOffset.fX - bounds.fLeft),
+                              SkIntToScalar(srcOffset.fY - bounds.fTop));
 
-        SkPaint paint;
-        paint.setBlendMode(SkBlendMode::kSrc);
-        canvas->translate(SkIntToScalar(srcOffset.fX - bounds.fLeft),
-                          SkIntToScalar(srcOffset.fY - bounds.fTop));
-
-        input->draw(canvas, vec.fX, vec.fY, &paint);
+            input->draw(canvas, vec.fX, vec.fY, &paint);
+        });
 
         offset->fX = bounds.fLeft;
         offset->fY = bounds.fTop;
@@ -128,6 +128,16 @@ sk_sp<SkSpecialImage> SkOffsetImageFilterImpl::onFilterImage(const Context& ctx,
     }
 }
 
+bool SkOffsetImageFilterImpl::onIsOffsetNode(SkVector* offset) const {
+    if (!this->cropRectIsSet()) {
+        if (offset) {
+            *offset = fOffset;
+        }
+        return true;
+    }
+    return false;
+}
+
 SkRect SkOffsetImageFilterImpl::computeFastBounds(const SkRect& src) const {
     SkRect bounds = this->getInput(0) ? this->getInput(0)->computeFastBounds(src) : src;
     bounds.offset(fOffset.fX, fOffset.fY);
@@ -8,6 +8,7 @@
 #include "include/effects/SkXfermodeImageFilter.h"
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
 #include "include/private/SkColorData.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
@@ -53,7 +54,8 @@ protected:
 
     void flatten(SkWriteBuffer&) const override;
 
-    void drawForeground(SkCanvas* canvas, SkSpecialImage*, const SkIRect&) const;
+    void drawForeground(SkCanvas* canvas, SkSpecialImage*, sk_sp<SkColorFilter>,
+                        const SkIRect&) const;
 
 private:
     friend void SkXfermodeImageFilter::RegisterFlattenables();
@@ -105,11 +107,15 @@ void SkXfermodeImageFilterImpl::flatten(SkWriteBuffer& buffer) const {
 
 sk_sp<SkSpecialImage> SkXfermodeImageFilterImpl::onFilterImage(const Context& ctx,
                                                                SkIPoint* offset) const {
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, ctx, &backgroundOffset));
+    sk_sp<SkSpecialImage> inputs[2];
+    SkIPoint inputOffsets[2];
+    sk_sp<SkColorFilter> inputColorFilters[2];
+    this->filterInputs(ctx, inputs, inputOffsets, inputColorFilters);
 
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, ctx, &foregroundOffset));
+    sk_sp<SkSpecialImage> background = std::move(inputs[0]);
+    const SkIPoint& backgroundOffset = inputOffsets[0];
+    sk_sp<SkSpecialImage> foreground = std::move(inputs[1]);
+    const SkIPoint& foregroundOffset = inputOffsets[1];
 
     SkIRect foregroundBounds = SkIRect::MakeEmpty();
     if (foreground) {
@@ -148,21 +154,22 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilterImpl::onFilterImage(const Context& ct
         return nullptr;
     }
 
-    SkCanvas* canvas = surf->getCanvas();
-    SkASSERT(canvas);
-
-    canvas->clear(0x0); // can't count on background to fully clear the background
-    canvas->translate(SkIntToScalar(-bounds.left()), SkIntToScalar(-bounds.top()));
-
-    if (background) {
-        SkPaint paint;
-        paint.setBlendMode(SkBlendMode::kSrc);
-        background->draw(canvas,
-                         SkIntToScalar(backgroundOffset.fX), SkIntToScalar(backgroundOffset.fY),
-                         &paint);
-    }
+    DrawInRowBands(ctx, surf.get(), [&](SkCanvas* canvas) {
+        canvas->clear(0x0); // can't count on background to fully clear the background
+        canvas->translate(SkIntToScalar(-bounds.left()), SkIntToScalar(-bounds.top()));
+
+        if (background) {
+            SkPaint paint;
+            paint.setBlendMode(SkBlendMode::kSrc);
+            paint.setColorFilter(inputColorFilters[0]);
+            background->draw(canvas,
+                             SkIntToScalar(backgroundOffset.fX),
+                             SkIntToScalar(backgroundOffset.fY),
+                             &paint);
+        }
 
-    this->drawForeground(canvas, foreground.get(), foregroundBounds);
+        this->drawForeground(canvas, foreground.get(), inputColorFilters[1], foregroundBounds);
+    });
 
     return surf->makeImageSnapshot();
 }
@@ -213,11 +220,14 @@ SkIRect SkXfermodeImageFilterImpl::onFilterBounds(const SkIRect& src,
 }
 
 void SkXfermodeImageFilterImpl::drawForeground(SkCanvas* canvas, SkSpecialImage* img,
+                                               sk_sp<SkColorFilter> colorFilter,
                                                const SkIRect& fgBounds) const {
     SkPaint paint;
     paint.setBlendMode(fMode);
     if (img) {
+        paint.setColorFilter(std::move(colorFilter));
         img->draw(canvas, SkIntToScalar(fgBounds.fLeft), SkIntToScalar(fgBounds.fTop), &paint);
+        paint.setColorFilter(nullptr);
     }
 
     SkAutoCanvasRestore acr(canvas, true);
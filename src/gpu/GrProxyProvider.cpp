@@ -8,6 +8,7 @@
 #include "src/gpu/GrProxyProvider.h"
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/private/GrImageContext.h"
@@ -349,7 +350,7 @@ sk_sp<GrTextureProxy> GrProxyProvider::createMippedProxyFromBitmap(const SkBitma
         return nullptr;
     }
 
-    sk_sp<SkMipmap> mipmaps(SkMipmap::Build(bitmap.pixmap(), nullptr));
+    sk_sp<SkMipmap> mipmaps(SkMipmap::Build(bitmap, nullptr, &SkExecutor::GetDefault()));
     if (!mipmaps) {
         return nullptr;
     }
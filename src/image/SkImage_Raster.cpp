@@ -8,6 +8,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPixelRef.h"
 #include "include/core/SkSurface.h"
 #include "include/private/SkImageInfoPriv.h"
@@ -129,7 +130,7 @@ public:
         if (mips) {
             img->fBitmap.fMips = std::move(mips);
         } else {
-            img->fBitmap.fMips.reset(SkMipmap::Build(fBitmap.pixmap(), nullptr));
+            img->fBitmap.fMips.reset(SkMipmap::Build(fBitmap, nullptr, &SkExecutor::GetDefault()));
         }
         return sk_sp<SkImage>(img);
     }
@@ -0,0 +1,397 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurImageFilter_opts_DEFINED
+#define SkBlurImageFilter_opts_DEFINED
+
+#include "include/private/SkNx.h"
+#include "src/core/SkArenaAlloc.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#endif
+
+namespace SK_OPTS_NS {
+
+// box_blur() implements the common three pass box filter approximation of Gaussian blur,
+// but combines all three passes into a single pass. This approach is facilitated by three circular
+// buffers the width of the window which track values for trailing edges of each of the three
+// passes. This allows the algorithm to use more precision in the calculation because the values
+// are not rounded each pass. And this implementation also avoids a trap that's easy to fall
+// into resulting in blending in too many zeroes near the edge.
+//
+//  In general, a window sum has the form:
+//     sum_n+1 = sum_n + leading_edge - trailing_edge.
+//  If instead we do the subtraction at the end of the previous iteration, we can just
+// calculate the sums instead of having to do the subtractions too.
+//
+//      In previous iteration:
+//      sum_n+1 = sum_n - trailing_edge.
+//
+//      In this iteration:
+//      sum_n+1 = sum_n + leading_edge.
+//
+//  Now we can stack all three sums and do them at once. Sum0 gets its leading edge from the
+// actual data. Sum1's leading edge is just Sum0, and Sum2's leading edge is Sum1. So, doing the
+// three passes at the same time has the form:
+//
+//    sum0_n+1 = sum0_n + leading edge
+//    sum1_n+1 = sum1_n + sum0_n+1
+//    sum2_n+1 = sum2_n + sum1_n+1
+//
+//    sum2_n+1 / window^3 is the new value of the destination pixel.
+//
+//    Reduce the sums by the trailing edges which were stored in the circular buffers,
+// for the next go around. This is the case for odd sized windows, even windows the the third
+// circular buffer is one larger then the first two circular buffers.
+//
+//    sum2_n+2 = sum2_n+1 - buffer2[i];
+//    buffer2[i] = sum1;
+//    sum1_n+2 = sum1_n+1 - buffer1[i];
+//    buffer1[i] = sum0;
+//    sum0_n+2 = sum0_n+1 - buffer0[i];
+//    buffer0[i] = leading edge
+//
+//   This is all encapsulated in the processValue function below.
+//
+// Lines are blurred kBoxBlurLines at a time, with the sums holding the four channels of one pixel
+// from each line.  When the lines are columns their pixels sit side by side in memory, so each
+// step loads and stores them all at once rather than walking down one column at a time.
+static constexpr int kBoxBlurLines = 4;
+
+// The sums for one step of kBoxBlurLines lines, four channels per line, in as few registers as
+// this ISA allows.  skvx::Vec would be the natural fit, but only Clang keeps it out of memory.
+// Like the SkNx it may hold, it has internal linkage.
+namespace {  // NOLINT(google-build-namespaces)
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    struct BoxBlurSums {
+        __m512i fV;
+
+        static BoxBlurSums Splat(uint32_t x) { return {_mm512_set1_epi32(x)}; }
+
+        static BoxBlurSums Expand(const uint32_t pixels[kBoxBlurLines]) {
+            return {_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)pixels))};
+        }
+        void narrow(uint32_t pixels[kBoxBlurLines]) const {
+            _mm_storeu_si128((__m128i*)pixels, _mm512_cvtepi32_epi8(fV));
+        }
+
+        // Like Expand() and narrow(), for lines that are not adjacent.
+        static BoxBlurSums Gather(const uint32_t* p, const int offsets[kBoxBlurLines]) {
+            const uint32_t pixels[kBoxBlurLines] = {
+                p[offsets[0]], p[offsets[1]], p[offsets[2]], p[offsets[3]],
+            };
+            return Expand(pixels);
+        }
+        void scatter(uint32_t* p, const int offsets[kBoxBlurLines], int lines) const {
+            uint32_t pixels[kBoxBlurLines];
+            this->narrow(pixels);
+            for (int i = 0; i < lines; i++) {
+                p[offsets[i]] = pixels[i];
+            }
+        }
+
+        // The top 32 bits of each lane * weight.
+        BoxBlurSums mulHi(uint32_t weight) const {
+            __m512i w    = _mm512_set1_epi32(weight),
+                    even = _mm512_srli_epi64(_mm512_mul_epu32(fV, w), 32),
+                    odd  = _mm512_mul_epu32(_mm512_srli_epi64(fV, 32), w);
+            return {_mm512_mask_blend_epi32(0xaaaa, even, odd)};
+        }
+
+        BoxBlurSums& operator+=(const BoxBlurSums& o) {
+            fV = _mm512_add_epi32(fV, o.fV);
+            return *this;
+        }
+        BoxBlurSums& operator-=(const BoxBlurSums& o) {
+            fV = _mm512_sub_epi32(fV, o.fV);
+            return *this;
+        }
+    };
+
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    struct BoxBlurSums {
+        __m256i fV[2];  // Lines 0 and 1, then lines 2 and 3.
+
+        static BoxBlurSums Splat(uint32_t x) {
+            return {{_mm256_set1_epi32(x), _mm256_set1_epi32(x)}};
+        }
+
+        static BoxBlurSums Expand(const uint32_t pixels[kBoxBlurLines]) {
+            return {{_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(pixels + 0))),
+                     _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(pixels + 2)))}};
+        }
+        void narrow(uint32_t pixels[kBoxBlurLines]) const {
+            // Every lane is <= 255, so the saturating packs just narrow.  They work within
+            // 128-bit halves, leaving lines 0 and 2 in the low half, 1 and 3 in the high half.
+            __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(fV[0], fV[1]),
+                                                _mm256_setzero_si256());
+            bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0,4,1,5, 2,6,3,7));
+            _mm_storeu_si128((__m128i*)pixels, _mm256_castsi256_si128(bytes));
+        }
+
+        // Like Expand() and narrow(), for lines that are not adjacent.
+        static BoxBlurSums Gather(const uint32_t* p, const int offsets[kBoxBlurLines]) {
+            const uint32_t pixels[kBoxBlurLines] = {
+                p[offsets[0]], p[offsets[1]], p[offsets[2]], p[offsets[3]],
+            };
+            return Expand(pixels);
+        }
+        void scatter(uint32_t* p, const int offsets[kBoxBlurLines], int lines) const {
+            uint32_t pixels[kBoxBlurLines];
+            this->narrow(pixels);
+            for (int i = 0; i < lines; i++) {
+                p[offsets[i]] = pixels[i];
+            }
+        }
+
+        // The top 32 bits of each lane * weight.
+        BoxBlurSums mulHi(uint32_t weight) const {
+            __m256i w = _mm256_set1_epi32(weight);
+            BoxBlurSums r;
+            for (int i = 0; i < 2; i++) {
+                __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(fV[i], w), 32),
+                        odd  = _mm256_mul_epu32(_mm256_srli_epi64(fV[i], 32), w);
+                r.fV[i] = _mm256_blend_epi32(even, odd, 0xaa);
+            }
+            return r;
+        }
+
+        BoxBlurSums& operator+=(const BoxBlurSums& o) {
+            fV[0] = _mm256_add_epi32(fV[0], o.fV[0]);
+            fV[1] = _mm256_add_epi32(fV[1], o.fV[1]);
+            return *this;
+        }
+        BoxBlurSums& operator-=(const BoxBlurSums& o) {
+            fV[0] = _mm256_sub_epi32(fV[0], o.fV[0]);
+            fV[1] = _mm256_sub_epi32(fV[1], o.fV[1]);
+            return *this;
+        }
+    };
+
+#else
+    struct BoxBlurSums {
+        Sk4u fV[kBoxBlurLines];
+
+        static BoxBlurSums Splat(uint32_t x) { return {{x, x, x, x}}; }
+
+        static BoxBlurSums Expand(const uint32_t pixels[kBoxBlurLines]) {
+            BoxBlurSums r;
+            for (int i = 0; i < kBoxBlurLines; i++) {
+                r.fV[i] = SkNx_cast<uint32_t>(Sk4b::Load(pixels + i));
+            }
+            return r;
+        }
+        void narrow(uint32_t pixels[kBoxBlurLines]) const {
+            for (int i = 0; i < kBoxBlurLines; i++) {
+                SkNx_cast<uint8_t>(fV[i]).store(pixels + i);
+            }
+        }
+
+        // Like Expand() and narrow(), for lines that are not adjacent.
+        static BoxBlurSums Gather(const uint32_t* p, const int offsets[kBoxBlurLines]) {
+            BoxBlurSums r;
+            for (int i = 0; i < kBoxBlurLines; i++) {
+                r.fV[i] = SkNx_cast<uint32_t>(Sk4b::Load(p + offsets[i]));
+            }
+            return r;
+        }
+        void scatter(uint32_t* p, const int offsets[kBoxBlurLines], int lines) const {
+            for (int i = 0; i < lines; i++) {
+                SkNx_cast<uint8_t>(fV[i]).store(p + offsets[i]);
+            }
+        }
+
+        // The top 32 bits of each lane * weight.
+        BoxBlurSums mulHi(uint32_t weight) const {
+            BoxBlurSums r;
+            for (int i = 0; i < kBoxBlurLines; i++) {
+                r.fV[i] = fV[i].mulHi(weight);
+            }
+            return r;
+        }
+
+        BoxBlurSums& operator+=(const BoxBlurSums& o) {
+            for (int i = 0; i < kBoxBlurLines; i++) {
+                fV[i] += o.fV[i];
+            }
+            return *this;
+        }
+        BoxBlurSums& operator-=(const BoxBlurSums& o) {
+            for (int i = 0; i < kBoxBlurLines; i++) {
+                fV[i] -= o.fV[i];
+            }
+            return *this;
+        }
+    };
+#endif
+}  // namespace
+
+// Blurs the lines (at most kBoxBlurLines) starting at src, writing them starting at dst.
+// The would be dLeft parameter is assumed to be 0.
+static void box_blur_lines(BoxBlurSums* buffer, int window, int border,
+                           int srcLeft, int srcRight, int dstRight,
+                           const uint32_t* src, int srcXStride, int srcYStride,
+                                 uint32_t* dst, int dstXStride, int dstYStride, int lines) {
+    using Pass0And1 = BoxBlurSums[2];
+
+    // The circular buffers are one less than the window.
+    auto pass0Count = window - 1,
+         pass1Count = window - 1,
+         pass2Count = (window & 1) == 1 ? window - 1 : window;
+
+    Pass0And1*   buffer01Start = (Pass0And1*)buffer;
+    BoxBlurSums* buffer2Start  = buffer + pass0Count + pass1Count;
+    Pass0And1*   buffer01End   = (Pass0And1*)buffer2Start;
+    BoxBlurSums* buffer2End    = buffer2Start + pass2Count;
+
+    // If the window is odd then the divisor is just window ^ 3 otherwise,
+    // it is window * window * (window + 1) = window ^ 3 + window ^ 2;
+    auto window2 = window * window;
+    auto window3 = window2 * window;
+    auto divisor = (window & 1) == 1 ? window3 : window3 + window2;
+
+    // NB the sums in the blur code use the following technique to avoid
+    // adding 1/2 to round the divide.
+    //
+    //   Sum/d + 1/2 == (Sum + h) / d
+    //   Sum + d(1/2) ==  Sum + h
+    //     h == (1/2)d
+    //
+    // But the d/2 it self should be rounded.
+    //    h == d/2 + 1/2 == (d + 1) / 2
+    //
+    // weight = 1 / d * 2 ^ 32
+    auto weight = static_cast<uint32_t>(round(1.0 / divisor * (1ull << 32)));
+    auto half = static_cast<uint32_t>((divisor + 1) / 2);
+
+    // Calculate the start and end of the source pixels with respect to the destination start.
+    auto srcStart = srcLeft - border,
+         srcEnd   = srcRight - border,
+         dstEnd   = dstRight;
+
+    // Adjacent lines load and store as a single vector.  Otherwise, gather and scatter a pixel
+    // per line, repeating the last line to fill out a short group.
+    const bool contiguousSrc = srcYStride == 1 && lines == kBoxBlurLines,
+               contiguousDst = dstYStride == 1 && lines == kBoxBlurLines;
+    int srcOffsets[kBoxBlurLines],
+        dstOffsets[kBoxBlurLines];
+    for (int i = 0; i < kBoxBlurLines; i++) {
+        srcOffsets[i] = std::min(i, lines - 1) * srcYStride;
+        dstOffsets[i] = std::min(i, lines - 1) * dstYStride;
+    }
+    auto load = [&](const uint32_t* p) {
+        if (contiguousSrc) {
+            return BoxBlurSums::Expand(p);
+        }
+        return BoxBlurSums::Gather(p, srcOffsets);
+    };
+    auto store = [&](uint32_t* p, const BoxBlurSums& v) {
+        if (contiguousDst) {
+            v.narrow(p);
+        } else {
+            v.scatter(p, dstOffsets, lines);
+        }
+    };
+
+    auto buffer01Cursor = buffer01Start;
+    auto buffer2Cursor  = buffer2Start;
+
+    BoxBlurSums sum0 = BoxBlurSums::Splat(0);
+    BoxBlurSums sum1 = BoxBlurSums::Splat(0);
+    BoxBlurSums sum2 = BoxBlurSums::Splat(half);
+
+    std::fill(buffer, buffer2End, BoxBlurSums::Splat(0));
+
+    // Given an expanded input pixel, move the window ahead using the leadingEdge value.
+    auto processValue = [&](const BoxBlurSums& leadingEdge) -> BoxBlurSums {
+        sum0 += leadingEdge;
+        sum1 += sum0;
+        sum2 += sum1;
+
+        BoxBlurSums value = sum2.mulHi(weight);
+
+        sum2 -= *buffer2Cursor;
+        *buffer2Cursor = sum1;
+        buffer2Cursor = (buffer2Cursor + 1) < buffer2End ? buffer2Cursor + 1 : buffer2Start;
+
+        sum1 -= (*buffer01Cursor)[1];
+        (*buffer01Cursor)[1] = sum0;
+        sum0 -= (*buffer01Cursor)[0];
+        (*buffer01Cursor)[0] = leadingEdge;
+        buffer01Cursor =
+                (buffer01Cursor + 1) < buffer01End ? buffer01Cursor + 1 : buffer01Start;
+
+        return value;
+    };
+
+    auto srcIdx = srcStart;
+    auto dstIdx = 0;
+    const uint32_t* srcCursor = src;
+          uint32_t* dstCursor = dst;
+
+    // The destination pixels are not effected by the src pixels,
+    // change to zero as per the spec.
+    // https://drafts.fxtf.org/filter-effects/#FilterPrimitivesOverviewIntro
+    while (dstIdx < srcIdx) {
+        store(dstCursor, BoxBlurSums::Splat(0));
+        dstCursor += dstXStride;
+        dstIdx++;
+    }
+
+    // The edge of the source is before the edge of the destination. Calculate the sums for
+    // the pixels before the start of the destination.
+    while (dstIdx > srcIdx) {
+        (void) processValue(srcIdx < srcEnd ? load(srcCursor) : BoxBlurSums::Splat(0));
+        srcCursor += srcXStride;
+        srcIdx++;
+    }
+
+    // The dstIdx and srcIdx are in sync now; the code just uses the dstIdx for both now.
+    // Consume the source generating pixels to dst.
+    auto loopEnd = std::min(dstEnd, srcEnd);
+    while (dstIdx < loopEnd) {
+        store(dstCursor, processValue(load(srcCursor)));
+        srcCursor += srcXStride;
+        dstCursor += dstXStride;
+        dstIdx++;
+    }
+
+    // The leading edge is beyond the end of the source. Assume that the pixels
+    // are now 0x0000 until the end of the destination.
+    loopEnd = dstEnd;
+    while (dstIdx < loopEnd) {
+        store(dstCursor, processValue(BoxBlurSums::Splat(0)));
+        dstCursor += dstXStride;
+        dstIdx++;
+    }
+}
+
+/*not static*/ inline void box_blur(int window, int border,
+                                    int srcLeft, int srcRight, int dstRight,
+                                    const uint32_t* src, int srcXStride, int srcYStride, int srcH,
+                                          uint32_t* dst, int dstXStride, int dstYStride) {
+    // There are window - 1 entries in each of the first two circular buffers, and one more than
+    // that in the third for even windows.
+    SkSTArenaAlloc<4096> alloc;
+    BoxBlurSums* buffer = alloc.makeArrayDefault<BoxBlurSums>(3 * window);
+
+    for (int y = 0; y < srcH; y += kBoxBlurLines) {
+        box_blur_lines(buffer, window, border, srcLeft, srcRight, dstRight,
+                       src, srcXStride, srcYStride,
+                       dst, dstXStride, dstYStride, std::min(kBoxBlurLines, srcH - y));
+        src += kBoxBlurLines * srcYStride;
+        dst += kBoxBlurLines * dstYStride;
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkBlurImageFilter_opts_DEFINED
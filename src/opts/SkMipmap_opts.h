@@ -0,0 +1,217 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipmap_opts_DEFINED
+#define SkMipmap_opts_DEFINED
+
+#include "include/private/SkHalf.h"
+#include "include/private/SkNx.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <immintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+// These 2x2 box filters each average count pairs of pixels from the two rows starting at src
+// (srcRB bytes apart) into count dst pixels.  They handle SkMipmap's most common case, an even
+// sized level of 8888, A8 or F16 pixels, and produce exactly what its portable
+// downsample_2_2<ColorTypeFilter_8888/_8/_RGBA_F16> would.  Each vector loop leaves its last few
+// pixels to the portable loop below it.
+
+namespace SK_OPTS_NS {
+
+static inline void downsample_2_2_8888(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint32_t*>(src);
+    auto p1 = (const uint32_t*)((const char*)p0 + srcRB);
+    auto d  = static_cast<uint32_t*>(dst);
+
+    int i = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // Channels 0 and 2, and channels 1 and 3, are summed separately in 16-bit fields, which have
+    // room for the sum of four.  hadd sums horizontal pairs of pixels within each 128-bit half,
+    // so the permute puts the dst pixels back in order.
+    const __m256i mask = _mm256_set1_epi32(0x00ff00ff);
+    for (; i + 8 <= count; i += 8) {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(p0 + 2*i + 0)),
+                b0 = _mm256_loadu_si256((const __m256i*)(p0 + 2*i + 8)),
+                a1 = _mm256_loadu_si256((const __m256i*)(p1 + 2*i + 0)),
+                b1 = _mm256_loadu_si256((const __m256i*)(p1 + 2*i + 8));
+
+        __m256i even = _mm256_hadd_epi32(
+                _mm256_add_epi16(_mm256_and_si256(a0, mask), _mm256_and_si256(a1, mask)),
+                _mm256_add_epi16(_mm256_and_si256(b0, mask), _mm256_and_si256(b1, mask)));
+        __m256i odd  = _mm256_hadd_epi32(
+                _mm256_add_epi16(_mm256_srli_epi16(a0, 8), _mm256_srli_epi16(a1, 8)),
+                _mm256_add_epi16(_mm256_srli_epi16(b0, 8), _mm256_srli_epi16(b1, 8)));
+
+        __m256i px = _mm256_or_si256(_mm256_srli_epi16(even, 2),
+                                     _mm256_slli_epi16(_mm256_srli_epi16(odd, 2), 8));
+        px = _mm256_permute4x64_epi64(px, _MM_SHUFFLE(3,1,2,0));
+        _mm256_storeu_si256((__m256i*)(d + i), px);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // As above, with an SSE2 stand-in for hadd.
+    auto hadd = [](__m128i a, __m128i b) {
+        __m128 x = _mm_castsi128_ps(a),
+               y = _mm_castsi128_ps(b);
+        return _mm_add_epi16(_mm_castps_si128(_mm_shuffle_ps(x, y, _MM_SHUFFLE(2,0,2,0))),
+                             _mm_castps_si128(_mm_shuffle_ps(x, y, _MM_SHUFFLE(3,1,3,1))));
+    };
+    const __m128i mask = _mm_set1_epi32(0x00ff00ff);
+    for (; i + 4 <= count; i += 4) {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(p0 + 2*i + 0)),
+                b0 = _mm_loadu_si128((const __m128i*)(p0 + 2*i + 4)),
+                a1 = _mm_loadu_si128((const __m128i*)(p1 + 2*i + 0)),
+                b1 = _mm_loadu_si128((const __m128i*)(p1 + 2*i + 4));
+
+        __m128i even = hadd(_mm_add_epi16(_mm_and_si128(a0, mask), _mm_and_si128(a1, mask)),
+                            _mm_add_epi16(_mm_and_si128(b0, mask), _mm_and_si128(b1, mask)));
+        __m128i odd  = hadd(_mm_add_epi16(_mm_srli_epi16(a0, 8), _mm_srli_epi16(a1, 8)),
+                            _mm_add_epi16(_mm_srli_epi16(b0, 8), _mm_srli_epi16(b1, 8)));
+
+        __m128i px = _mm_or_si128(_mm_srli_epi16(even, 2),
+                                  _mm_slli_epi16(_mm_srli_epi16(odd, 2), 8));
+        _mm_storeu_si128((__m128i*)(d + i), px);
+    }
+#elif defined(SK_ARM_HAS_NEON)
+    // vld4 splits 16 pixels into their channels, and vpaddl/vpadal sum horizontal pairs.
+    for (; i + 8 <= count; i += 8) {
+        uint8x16x4_t r0 = vld4q_u8((const uint8_t*)(p0 + 2*i)),
+                     r1 = vld4q_u8((const uint8_t*)(p1 + 2*i));
+        uint8x8x4_t px;
+        for (int c = 0; c < 4; ++c) {
+            px.val[c] = vshrn_n_u16(vpadalq_u8(vpaddlq_u8(r0.val[c]), r1.val[c]), 2);
+        }
+        vst4_u8((uint8_t*)(d + i), px);
+    }
+#endif
+
+    // Spreads a pixel's channels out into 16-bit fields: 0 and 2 in the bottom half, 1 and 3 above.
+    auto spread = [](uint32_t px) {
+        return (px & 0x00ff00ff) | ((uint64_t)(px & 0xff00ff00) << 24);
+    };
+    for (; i < count; ++i) {
+        uint64_t sum = spread(p0[2*i]) + spread(p0[2*i+1]) + spread(p1[2*i]) + spread(p1[2*i+1]);
+        sum = (sum >> 2) & 0x00ff00ff00ff00ff;
+        d[i] = (uint32_t)(sum | (sum >> 24));
+    }
+}
+
+static inline void downsample_2_2_a8(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint8_t*>(src);
+    auto p1 = p0 + srcRB;
+    auto d  = static_cast<uint8_t*>(dst);
+
+    int i = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // Each 16-bit lane holds a horizontal pair of source pixels.  packus works within each 128-bit
+    // half, so the permute puts the dst pixels back in order.
+    auto sum = [](__m256i r0, __m256i r1) {
+        const __m256i lo = _mm256_set1_epi16(0x00ff);
+        __m256i s = _mm256_add_epi16(_mm256_add_epi16(_mm256_and_si256(r0, lo),
+                                                      _mm256_srli_epi16(r0, 8)),
+                                     _mm256_add_epi16(_mm256_and_si256(r1, lo),
+                                                      _mm256_srli_epi16(r1, 8)));
+        return _mm256_srli_epi16(s, 2);
+    };
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = sum(_mm256_loadu_si256((const __m256i*)(p0 + 2*i +  0)),
+                        _mm256_loadu_si256((const __m256i*)(p1 + 2*i +  0))),
+                b = sum(_mm256_loadu_si256((const __m256i*)(p0 + 2*i + 32)),
+                        _mm256_loadu_si256((const __m256i*)(p1 + 2*i + 32)));
+        __m256i px = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(3,1,2,0));
+        _mm256_storeu_si256((__m256i*)(d + i), px);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    auto sum = [](__m128i r0, __m128i r1) {
+        const __m128i lo = _mm_set1_epi16(0x00ff);
+        __m128i s = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(r0, lo), _mm_srli_epi16(r0, 8)),
+                                  _mm_add_epi16(_mm_and_si128(r1, lo), _mm_srli_epi16(r1, 8)));
+        return _mm_srli_epi16(s, 2);
+    };
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = sum(_mm_loadu_si128((const __m128i*)(p0 + 2*i +  0)),
+                        _mm_loadu_si128((const __m128i*)(p1 + 2*i +  0))),
+                b = sum(_mm_loadu_si128((const __m128i*)(p0 + 2*i + 16)),
+                        _mm_loadu_si128((const __m128i*)(p1 + 2*i + 16)));
+        _mm_storeu_si128((__m128i*)(d + i), _mm_packus_epi16(a, b));
+    }
+#elif defined(SK_ARM_HAS_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint16x8_t lo = vpadalq_u8(vpaddlq_u8(vld1q_u8(p0 + 2*i +  0)), vld1q_u8(p1 + 2*i +  0)),
+                   hi = vpadalq_u8(vpaddlq_u8(vld1q_u8(p0 + 2*i + 16)), vld1q_u8(p1 + 2*i + 16));
+        vst1q_u8(d + i, vcombine_u8(vshrn_n_u16(lo, 2), vshrn_n_u16(hi, 2)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        unsigned sum = p0[2*i] + p1[2*i] + p0[2*i+1] + p1[2*i+1];
+        d[i] = (uint8_t)(sum >> 2);
+    }
+}
+
+static inline void downsample_2_2_f16(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint64_t*>(src);
+    auto p1 = (const uint64_t*)((const char*)p0 + srcRB);
+    auto d  = static_cast<uint64_t*>(dst);
+
+    int i = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // Two dst pixels at a time, eight channels to a register.  The conversions are integer
+    // versions of SkHalfToFloat_finite_ftz() and SkFloatToHalf_finite_ftz() (not F16C, which rounds
+    // differently and keeps denormals), and the sums go in the same order as the portable code's.
+    auto to_float = [](__m128i h) {
+        __m256i bits     = _mm256_cvtepu16_epi32(h),
+                sign     = _mm256_and_si256(bits, _mm256_set1_epi32(0x8000)),
+                positive = _mm256_xor_si256(bits, sign),
+                is_norm  = _mm256_cmpgt_epi32(positive, _mm256_set1_epi32(0x03ff)),
+                norm     = _mm256_add_epi32(_mm256_slli_epi32(positive, 13),
+                                            _mm256_set1_epi32((127 - 15) << 23));
+        return _mm256_castsi256_ps(_mm256_or_si256(_mm256_slli_epi32(sign, 16),
+                                                   _mm256_and_si256(norm, is_norm)));
+    };
+    auto to_half = [](__m256 f) {
+        __m256i bits         = _mm256_castps_si256(f),
+                sign         = _mm256_and_si256(bits, _mm256_set1_epi32(0x80000000)),
+                positive     = _mm256_xor_si256(bits, sign),
+                will_be_norm = _mm256_cmpgt_epi32(positive, _mm256_set1_epi32(0x387fdfff)),
+                norm         = _mm256_srai_epi32(_mm256_sub_epi32(positive,
+                                                                  _mm256_set1_epi32((127-15) << 23)),
+                                                 13),
+                h            = _mm256_or_si256(_mm256_srai_epi32(sign, 16),
+                                               _mm256_and_si256(will_be_norm, norm));
+        return _mm_packs_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+    };
+    // Loads src pixels 4i..4i+3 of a row, split into the even and odd ones.
+    auto load = [](const uint64_t* p, __m128i* even, __m128i* odd) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(p + 0)),
+                b = _mm_loadu_si128((const __m128i*)(p + 2));
+        *even = _mm_unpacklo_epi64(a, b);
+        *odd  = _mm_unpackhi_epi64(a, b);
+    };
+    for (; i + 2 <= count; i += 2) {
+        __m128i e0, o0, e1, o1;
+        load(p0 + 2*i, &e0, &o0);
+        load(p1 + 2*i, &e1, &o1);
+        __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(to_float(e0), to_float(e1)),
+                                                 to_float(o0)),
+                                   to_float(o1));
+        _mm_storeu_si128((__m128i*)(d + i), to_half(_mm256_mul_ps(sum, _mm256_set1_ps(0.25f))));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        Sk4f sum = SkHalfToFloat_finite_ftz(p0[2*i]) + SkHalfToFloat_finite_ftz(p1[2*i])
+                 + SkHalfToFloat_finite_ftz(p0[2*i+1]) + SkHalfToFloat_finite_ftz(p1[2*i+1]);
+        SkFloatToHalf_finite_ftz(sum * 0.25f).store(d + i);
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMipmap_opts_DEFINED
@@ -11,6 +11,8 @@
 #include "src/core/SkCubicSolver.h"
 #include "src/opts/SkBitmapProcState_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
+#include "src/opts/SkBlurImageFilter_opts.h"
+#include "src/opts/SkMipmap_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -25,6 +27,12 @@ namespace SkOpts {
 
         cubic_solver = SK_OPTS_NS::cubic_solver;
 
+        box_blur = SK_OPTS_NS::box_blur;
+
+        downsample_2_2_8888 = SK_OPTS_NS::downsample_2_2_8888;
+        downsample_2_2_a8   = SK_OPTS_NS::downsample_2_2_a8;
+        downsample_2_2_f16  = SK_OPTS_NS::downsample_2_2_f16;
+
         RGBA_to_BGRA          = SK_OPTS_NS::RGBA_to_BGRA;
         RGBA_to_rgbA          = SK_OPTS_NS::RGBA_to_rgbA;
         RGBA_to_bgrA          = SK_OPTS_NS::RGBA_to_bgrA;
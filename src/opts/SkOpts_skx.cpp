@@ -8,10 +8,18 @@
 #include "src/core/SkOpts.h"
 
 #define SK_OPTS_NS skx
+#include "src/opts/SkBlurImageFilter_opts.h"
+#include "src/opts/SkMipmap_opts.h"
 #include "src/opts/SkVM_opts.h"
 
 namespace SkOpts {
     void Init_skx() {
+        box_blur = SK_OPTS_NS::box_blur;
+
+        downsample_2_2_8888 = SK_OPTS_NS::downsample_2_2_8888;
+        downsample_2_2_a8   = SK_OPTS_NS::downsample_2_2_a8;
+        downsample_2_2_f16  = SK_OPTS_NS::downsample_2_2_f16;
+
         interpret_skvm = SK_OPTS_NS::interpret_skvm;
     }
 }  // namespace SkOpts
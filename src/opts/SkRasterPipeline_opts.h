@@ -2455,6 +2455,12 @@ STAGE(evenly_spaced_2_stop_gradient, const void* ctx) {
     a = mad(t, c->f[3], c->b[3]);
 }
 
+STAGE(gradient_lut, const SkRasterPipeline_GradientLUTCtx* c) {
+    // Clamping also takes care of NaN t, which max() turns into 0 (or trunc_() does on ARM).
+    F t = min(max(r, 0), 1);
+    from_8888(gather(c->colors, trunc_(mad(t, c->lastIndex, 0.5f))), &r, &g, &b, &a);
+}
+
 STAGE(xy_to_unit_angle, Ctx::None) {
     F X = r,
       Y = g;
@@ -3957,6 +3963,11 @@ STAGE_GP(evenly_spaced_2_stop_gradient, const SkRasterPipeline_EvenlySpaced2Stop
                    &r,&g,&b,&a);
 }
 
+STAGE_GP(gradient_lut, const SkRasterPipeline_GradientLUTCtx* c) {
+    F t = clamp_01(x);  // NaN t becomes 0.
+    from_8888(gather<U32>(c->colors, trunc_(mad(t, c->lastIndex, 0.5f))), &r, &g, &b, &a);
+}
+
 STAGE_GG(xy_to_unit_angle, Ctx::None) {
     F xabs = abs_(x),
       yabs = abs_(y);
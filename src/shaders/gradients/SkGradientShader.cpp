@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include "include/core/SkMallocPixelRef.h"
+#include "include/private/SkColorData.h"
 #include "include/private/SkFloatBits.h"
 #include "include/private/SkHalf.h"
 #include "include/private/SkVx.h"
@@ -23,6 +24,8 @@
 #include "src/shaders/gradients/SkSweepGradient.h"
 #include "src/shaders/gradients/SkTwoPointConicalGradient.h"
 
+std::atomic<bool> gSkUseGradientLUT{false};
+
 enum GradientSerializationFlags {
     // Bits 29:31 used for various boolean flags
     kHasPosition_GSF    = 0x80000000,
@@ -35,7 +38,7 @@ enum GradientSerializationFlags {
     kTileModeShift_GSF  = 8,
     kTileModeMask_GSF   = 0xF,
 
-    // Bits 0:7 for fGradFlags (note that kForce4fContext_PrivateFlag is 0x80)
+    // Bits 0:7 for fGradFlags (note that kUseColorLUT_PrivateFlag is 0x80)
     kGradFlagsShift_GSF = 0,
     kGradFlagsMask_GSF  = 0xFF,
 };
@@ -274,6 +277,74 @@ static void init_stop_pos(
     add_stop_color(ctx, stop, Fs, Bs);
 }
 
+sk_sp<SkGradientShaderBase::ColorLUT> SkGradientShaderBase::refColorLUT(
+        SkColorSpace* dstCS) const {
+    SkAutoMutexExclusive lock(fColorLUTMutex);
+    if (fColorLUT && SkColorSpace::Equals(fColorLUT->fDstCS.get(), dstCS)) {
+        return fColorLUT;
+    }
+
+    const bool premulGrad = fGradFlags & SkGradientShader::kInterpolateColorsInPremul_Flag;
+    SkColor4fXformer xformedColors(fOrigColors4f, fColorCount, fColorSpace.get(), dstCS);
+    auto premul = [](const Sk4f& c) { return c * Sk4f(c[3], c[3], c[3], 1); };
+    auto color = [&](int i) {
+        Sk4f c = Sk4f::Load(xformedColors.fColors[i].vec());
+        return premulGrad ? premul(c) : c;
+    };
+
+    // 256 entries already step through every 8-bit value, but hard stops want finer steps.
+    bool hasHardStops = false;
+    for (int i = 1; fOrigPos && i < fColorCount; i++) {
+        hasHardStops |= fOrigPos[i] == fOrigPos[i - 1];
+    }
+
+    auto lut = sk_make_sp<ColorLUT>();
+    lut->fDstCS = sk_ref_sp(dstCS);
+    lut->fCount = hasHardStops ? 1024 : 256;
+    lut->fColors.reset(lut->fCount);
+
+    // Like the gradient stage, use the last stop at or before t, so hard stops take the color
+    // on their right. The first entry is the exception: it's also used for clamped t < 0, so it
+    // takes the first color even if there's a hard stop at 0.
+    int stop = 0;
+    for (int i = 0; i < lut->fCount; i++) {
+        const float t = i / (lut->fCount - 1.0f);
+        while (i > 0 && stop < fColorCount - 2 && this->getPos(stop + 1) <= t) {
+            stop++;
+        }
+        const float t_l = this->getPos(stop),
+                    t_r = this->getPos(stop + 1);
+        Sk4f c = color(t_l < t_r || i == 0 ? stop : stop + 1);
+        if (t_l < t_r) {
+            const float f = SkTPin((t - t_l) / (t_r - t_l), 0.0f, 1.0f);
+            c = c + (color(stop + 1) - c) * f;
+        }
+        if (!premulGrad) {
+            c = premul(c);
+        }
+        lut->fColors[i] = Sk4f_toL32(Sk4f::Min(Sk4f::Max(c, 0), 1));
+    }
+
+    fColorLUT = lut;
+    return lut;
+}
+
+// The color table only has 8 bits per channel.
+static bool can_use_color_lut(SkColorType ct) {
+    switch (ct) {
+        case kAlpha_8_SkColorType:
+        case kRGB_565_SkColorType:
+        case kARGB_4444_SkColorType:
+        case kRGBA_8888_SkColorType:
+        case kRGB_888x_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kGray_8_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
     SkRasterPipeline* p = rec.fPipeline;
     SkArenaAlloc* alloc = rec.fAlloc;
@@ -323,8 +394,20 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
                           : SkPMColor4f{ c.fR, c.fG, c.fB, c.fA };
     };
 
-    // The two-stop case with stops at 0 and 1.
-    if (fColorCount == 2 && fOrigPos == nullptr) {
+    // Evenly spaced two-stop gradients are as cheap to compute as to look up.
+    const bool useLUT = this->useColorLUT() && can_use_color_lut(rec.fDstColorType) &&
+                        !(fColorCount == 2 && fOrigPos == nullptr);
+
+    if (useLUT) {
+        sk_sp<ColorLUT> lut = this->refColorLUT(rec.fDstCS);
+        auto ctx = alloc->make<SkRasterPipeline_GradientLUTCtx>();
+        ctx->colors    = lut->fColors.get();
+        ctx->lastIndex = lut->fCount - 1;
+        alloc->make<sk_sp<ColorLUT>>(std::move(lut));  // Keep the table alive for the draw.
+
+        p->append(SkRasterPipeline::gradient_lut, ctx);
+    } else if (fColorCount == 2 && fOrigPos == nullptr) {
+        // The two-stop case with stops at 0 and 1.
         const SkPMColor4f c_l = prepareColor(0),
                           c_r = prepareColor(1);
 
@@ -410,7 +493,7 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
         p->append(SkRasterPipeline::check_decal_mask, decal_ctx);
     }
 
-    if (!premulGrad && !this->colorsAreOpaque()) {
+    if (!useLUT && !premulGrad && !this->colorsAreOpaque()) {
         p->append(SkRasterPipeline::premul);
     }
 
@@ -659,7 +742,7 @@ void SkGradientShaderBase::commonAsAGradient(GradientInfo* info) const {
         }
         info->fColorCount = fColorCount;
         info->fTileMode = fTileMode;
-        info->fGradientFlags = fGradFlags;
+        info->fGradientFlags = fGradFlags & ~kUseColorLUT_PrivateFlag;
     }
 }
 
@@ -11,19 +11,32 @@
 #include "include/effects/SkGradientShader.h"
 
 #include "include/core/SkMatrix.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkTArray.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkVM.h"
 #include "src/shaders/SkShaderBase.h"
 
+#include <atomic>
+
 class SkColorSpace;
 class SkRasterPipeline;
 class SkReadBuffer;
 class SkWriteBuffer;
 
+// When set, every gradient behaves as if made with kUseColorLUT_PrivateFlag (see below). Tools
+// set this once at startup; draws on other threads only ever read it.
+extern std::atomic<bool> gSkUseGradientLUT;
+
 class SkGradientShaderBase : public SkShaderBase {
 public:
+    // Passed along with the public SkGradientShader::Flags, this makes raster pipeline draws into
+    // 8-bit destinations look the colors up in a table precomputed per shader, instead of
+    // searching the stops for every pixel. This trades some precision (e.g. hard stops blur over
+    // 1/1024 of the gradient) for speed.
+    static constexpr uint32_t kUseColorLUT_PrivateFlag = 0x80;
+
     struct Descriptor {
         Descriptor() {
             sk_bzero(this, sizeof(*this));
@@ -65,6 +78,11 @@ public:
 
     uint32_t getGradFlags() const { return fGradFlags; }
 
+    bool useColorLUT() const {
+        return (fGradFlags & kUseColorLUT_PrivateFlag) ||
+               gSkUseGradientLUT.load(std::memory_order_relaxed);
+    }
+
     const SkMatrix& getGradientMatrix() const { return fPtsToUnit; }
 
 protected:
@@ -133,6 +151,18 @@ public:
     SkTileMode getTileMode() const { return fTileMode; }
 
 private:
+    // Premultiplied 8888 colors at evenly spaced t, for one destination color space.
+    struct ColorLUT : public SkNVRefCnt<ColorLUT> {
+        sk_sp<SkColorSpace>     fDstCS;
+        SkAutoTMalloc<uint32_t> fColors;
+        int                     fCount;
+    };
+    // Returns the table for dstCS, reusing the last one made if it was for the same space.
+    sk_sp<ColorLUT> refColorLUT(SkColorSpace* dstCS) const;
+
+    mutable SkMutex         fColorLUTMutex;
+    mutable sk_sp<ColorLUT> fColorLUT;
+
     // Reserve inline space for up to 4 stops.
     static constexpr size_t kInlineStopCount   = 4;
     static constexpr size_t kInlineStorageSize = (sizeof(SkColor4f) + sizeof(SkScalar))
@@ -63,6 +63,10 @@ SkShaderBase::Context* SkLinearGradient::onMakeContext(
     if (!this->colorsCanConvertToSkColor()) {
         return nullptr;
     }
+    // The color table is only looked up by the raster pipeline.
+    if (this->useColorLUT()) {
+        return nullptr;
+    }
 
     return fTileMode != SkTileMode::kDecal
         ? CheckedMakeContext<LinearGradient4fContext>(alloc, *this, rec)
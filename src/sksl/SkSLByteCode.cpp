@@ -9,7 +9,9 @@
 
 #include "include/core/SkPoint3.h"
 #include "include/private/SkVx.h"
+#include "src/core/SkReadBuffer.h"
 #include "src/core/SkUtils.h"   // sk_unaligned_load
+#include "src/core/SkWriteBuffer.h"
 #include "src/sksl/SkSLByteCode.h"
 #include "src/sksl/SkSLByteCodeGenerator.h"
 #include "src/sksl/SkSLExternalValue.h"
@@ -1047,6 +1049,103 @@ bool ByteCode::runStriped(const ByteCodeFunction* f, int N,
 #endif
 }
 
+bool ByteCode::flatten(SkWriteBuffer& buffer) const {
+    if (!fExternalValues.empty()) {
+        return false;
+    }
+
+    buffer.writeInt(fGlobalSlotCount);
+    buffer.writeInt(fUniformSlotCount);
+    buffer.writeInt(fChildFPCount);
+    buffer.writeBool(fUsesFragCoord);
+
+    buffer.writeUInt(fUniforms.size());
+    for (const Uniform& u : fUniforms) {
+        buffer.writeString(u.fName.c_str());
+        buffer.writeUInt((uint32_t)u.fType);
+        buffer.writeInt(u.fColumns);
+        buffer.writeInt(u.fRows);
+        buffer.writeInt(u.fSlot);
+    }
+
+    buffer.writeUInt(fFunctions.size());
+    for (const auto& f : fFunctions) {
+        buffer.writeString(f->fName.c_str());
+        buffer.writeUInt(f->fParameters.size());
+        for (const ByteCodeFunction::Parameter& p : f->fParameters) {
+            buffer.writeInt(p.fSlotCount);
+            buffer.writeBool(p.fIsOutParameter);
+        }
+        buffer.writeInt(f->fParameterCount);
+        buffer.writeInt(f->fReturnCount);
+        buffer.writeInt(f->fLocalCount);
+        buffer.writeInt(f->fStackCount);
+        buffer.writeInt(f->fConditionCount);
+        buffer.writeInt(f->fLoopCount);
+        buffer.writeByteArray(f->fCode.data(), f->fCode.size());
+    }
+    return true;
+}
+
+std::unique_ptr<ByteCode> ByteCode::MakeFromBuffer(SkReadBuffer& buffer) {
+    // Counts and slots are never negative, and every element we read takes at least four bytes,
+    // which bounds the array sizes by what is left in the buffer.
+    auto readCount = [&buffer]() {
+        int count = buffer.readInt();
+        return buffer.validate(count >= 0) ? count : 0;
+    };
+    auto readArraySize = [&buffer]() -> size_t {
+        uint32_t size = buffer.readUInt();
+        return buffer.validateCanReadN<uint32_t>(size) ? size : 0;
+    };
+
+    std::unique_ptr<ByteCode> byteCode(new ByteCode);
+    byteCode->fGlobalSlotCount  = readCount();
+    byteCode->fUniformSlotCount = readCount();
+    byteCode->fChildFPCount     = readCount();
+    byteCode->fUsesFragCoord    = buffer.readBool();
+
+    byteCode->fUniforms.resize(readArraySize());
+    for (Uniform& u : byteCode->fUniforms) {
+        SkString name;
+        buffer.readString(&name);
+        u.fName    = String(name.c_str(), name.size());
+        u.fType    = buffer.read32LE(TypeCategory::kFloat);
+        u.fColumns = readCount();
+        u.fRows    = readCount();
+        u.fSlot    = readCount();
+    }
+
+    size_t functionCount = readArraySize();
+    for (size_t i = 0; i < functionCount && buffer.isValid(); ++i) {
+        std::unique_ptr<ByteCodeFunction> f(new ByteCodeFunction);
+        SkString name;
+        buffer.readString(&name);
+        f->fName = String(name.c_str(), name.size());
+        f->fParameters.resize(readArraySize());
+        for (ByteCodeFunction::Parameter& p : f->fParameters) {
+            p.fSlotCount      = readCount();
+            p.fIsOutParameter = buffer.readBool();
+        }
+        f->fParameterCount = readCount();
+        f->fReturnCount    = readCount();
+        f->fLocalCount     = readCount();
+        f->fStackCount     = readCount();
+        f->fConditionCount = readCount();
+        f->fLoopCount      = readCount();
+
+        size_t codeSize = buffer.getArrayCount();
+        if (!buffer.validateCanReadN<uint8_t>(codeSize)) {
+            break;
+        }
+        f->fCode.resize(codeSize);
+        buffer.readByteArray(f->fCode.data(), codeSize);
+        byteCode->fFunctions.push_back(std::move(f));
+    }
+
+    return buffer.isValid() ? std::move(byteCode) : nullptr;
+}
+
 } // namespace SkSL
 
 #endif
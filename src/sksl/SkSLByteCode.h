@@ -14,6 +14,9 @@
 #include <memory>
 #include <vector>
 
+class SkReadBuffer;
+class SkWriteBuffer;
+
 namespace SkSL {
 
 class  ExternalValue;
@@ -172,6 +175,7 @@ public:
 
 private:
     ByteCodeFunction(const FunctionDeclaration* declaration);
+    ByteCodeFunction() = default;
 
     friend class ByteCode;
     friend class ByteCodeGenerator;
@@ -273,6 +277,19 @@ public:
      */
     bool canRun() const { return fChildFPCount == 0 && !fUsesFragCoord; }
 
+    /**
+     * Writes the byte code so that MakeFromBuffer() can recreate it without compiling any SkSL.
+     * Returns false, having written nothing, if it refers to external values, since those only
+     * exist in the process that compiled it.
+     */
+    bool flatten(SkWriteBuffer&) const;
+
+    /**
+     * Returns nullptr if the buffer doesn't hold flattened byte code. The instructions themselves
+     * are not validated, so the buffer must come from a trusted source.
+     */
+    static std::unique_ptr<ByteCode> MakeFromBuffer(SkReadBuffer&);
+
 private:
     ByteCode(const ByteCode&) = delete;
     ByteCode& operator=(const ByteCode&) = delete;
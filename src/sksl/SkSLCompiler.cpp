@@ -19,6 +19,7 @@
 #include "src/sksl/SkSLIRGenerator.h"
 #include "src/sksl/SkSLMetalCodeGenerator.h"
 #include "src/sksl/SkSLPipelineStageCodeGenerator.h"
+#include "src/sksl/SkSLPool.h"
 #include "src/sksl/SkSLRehydrator.h"
 #include "src/sksl/SkSLSPIRVCodeGenerator.h"
 #include "src/sksl/SkSLSPIRVtoHLSL.h"
@@ -117,9 +118,11 @@ static void reset_call_counts(std::vector<std::unique_ptr<ProgramElement>>* src)
 }
 
 Compiler::Compiler(Flags flags)
-: fFlags(flags)
+: fModulePool(Pool::Create())
+, fFlags(flags)
 , fContext(std::make_shared<Context>())
 , fErrorCount(0) {
+    AutoAttachPoolToThread attach(fModulePool.get());
     fRootSymbolTable = std::make_shared<SymbolTable>(this);
     fIRGenerator =
             std::make_unique<IRGenerator>(fContext.get(), &fInliner, fRootSymbolTable, *this);
@@ -318,6 +321,7 @@ void Compiler::loadGeometryIntrinsics() {
     if (fGeometrySymbolTable) {
         return;
     }
+    AutoAttachPoolToThread attach(fModulePool.get());
     fGeometryIntrinsics = std::make_unique<IRIntrinsicMap>(fGPUIntrinsics.get());
     std::vector<std::unique_ptr<ProgramElement>> geomElements;
     #if !SKSL_STANDALONE
@@ -340,6 +344,7 @@ void Compiler::loadFPIntrinsics() {
     if (fFPSymbolTable) {
         return;
     }
+    AutoAttachPoolToThread attach(fModulePool.get());
     fFPIntrinsics = std::make_unique<IRIntrinsicMap>(fGPUIntrinsics.get());
     std::vector<std::unique_ptr<ProgramElement>> fpElements;
     #if !SKSL_STANDALONE
@@ -361,6 +366,7 @@ void Compiler::loadPipelineIntrinsics() {
     if (fPipelineSymbolTable) {
         return;
     }
+    AutoAttachPoolToThread attach(fModulePool.get());
     fPipelineIntrinsics = std::make_unique<IRIntrinsicMap>(fGPUIntrinsics.get());
     std::vector<std::unique_ptr<ProgramElement>> pipelineIntrinics;
     #if !SKSL_STANDALONE
@@ -383,6 +389,7 @@ void Compiler::loadInterpreterIntrinsics() {
     if (fInterpreterSymbolTable) {
         return;
     }
+    AutoAttachPoolToThread attach(fModulePool.get());
     fInterpreterIntrinsics = std::make_unique<IRIntrinsicMap>(/*parent=*/nullptr);
     std::vector<std::unique_ptr<ProgramElement>> interpElements;
     #if !SKSL_STANDALONE
@@ -1590,6 +1597,9 @@ std::unique_ptr<Program> Compiler::convertProgram(
 
     fErrorText = "";
     fErrorCount = 0;
+    // The program's nodes are carved out of one pool, which its nodes keep alive.
+    std::unique_ptr<Pool> pool = Pool::Create();
+    AutoAttachPoolToThread attach(pool.get());
     fInliner.reset(&fIRGenerator->fContext, fIRGenerator->fModifiers.get(), &settings);
     std::vector<std::unique_ptr<ProgramElement>> elements;
     switch (kind) {
@@ -17,6 +17,7 @@
 #include "src/sksl/SkSLErrorReporter.h"
 #include "src/sksl/SkSLInliner.h"
 #include "src/sksl/SkSLLexer.h"
+#include "src/sksl/SkSLPool.h"
 #include "src/sksl/ir/SkSLProgram.h"
 #include "src/sksl/ir/SkSLSymbolTable.h"
 
@@ -256,6 +257,9 @@ private:
     // holds ModifiersPools belonging to the core includes for lifetime purposes
     std::vector<std::unique_ptr<ModifiersPool>> fModifiers;
 
+    // allocates the IR nodes of the core includes
+    std::unique_ptr<Pool> fModulePool;
+
     Inliner fInliner;
     std::unique_ptr<IRGenerator> fIRGenerator;
     int fFlags;
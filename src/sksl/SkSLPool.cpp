@@ -0,0 +1,139 @@
+/*
+ * Copyright 2020 Google LLC.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/sksl/SkSLPool.h"
+
+#include "include/core/SkTypes.h"
+#include "include/private/SkMalloc.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+namespace SkSL {
+
+// Every node, pooled or not, is preceded by a header naming the pool it came from (or null for the
+// heap), so FreeIRNode() doesn't depend on which pool is attached when the node dies.
+static constexpr size_t kAlignment = alignof(std::max_align_t);
+static constexpr size_t kHeaderSize = kAlignment;
+
+static size_t align(size_t size) {
+    return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+class PoolData {
+public:
+    void* alloc(size_t size) {
+        if ((size_t)(fEnd - fCursor) < size) {
+            this->addBlock(size);
+        }
+        void* result = fCursor;
+        fCursor += size;
+        fRefCnt.fetch_add(1, std::memory_order_relaxed);
+        return result;
+    }
+
+    void unref() {
+        if (1 == fRefCnt.fetch_sub(1, std::memory_order_acq_rel)) {
+            delete this;
+        }
+    }
+
+private:
+    // Blocks start small, so a short program doesn't pin much memory, and grow for big modules.
+    static constexpr size_t kMinBlockSize = 4 * 1024;
+    static constexpr size_t kMaxBlockSize = 64 * 1024;
+
+    struct Block {
+        Block* fNext;
+    };
+    static constexpr size_t kBlockHeaderSize = (sizeof(Block) + kAlignment - 1) & ~(kAlignment - 1);
+
+    ~PoolData() {
+        while (fBlocks) {
+            Block* next = fBlocks->fNext;
+            sk_free(fBlocks);
+            fBlocks = next;
+        }
+    }
+
+    void addBlock(size_t minSize) {
+        size_t size = std::max(fNextBlockSize, kBlockHeaderSize + minSize);
+        fNextBlockSize = std::min(fNextBlockSize * 2, kMaxBlockSize);
+        Block* block = (Block*)sk_malloc_throw(size);
+        block->fNext = fBlocks;
+        fBlocks = block;
+        fCursor = (char*)block + kBlockHeaderSize;
+        fEnd = (char*)block + size;
+    }
+
+    Block* fBlocks = nullptr;
+    char* fCursor = nullptr;
+    char* fEnd = nullptr;
+    size_t fNextBlockSize = kMinBlockSize;
+    // One reference for the owning Pool, plus one for each live node.
+    std::atomic<int> fRefCnt{1};
+
+    friend class Pool;
+};
+
+#if defined(SK_BUILD_FOR_IOS)
+
+// iOS did not support thread_local until iOS 9.0, so nodes always come from the heap there.
+static PoolData* get_thread_local_pool() { return nullptr; }
+static void set_thread_local_pool(PoolData*) {}
+
+#else
+
+static thread_local PoolData* sThreadLocalPool = nullptr;
+
+static PoolData* get_thread_local_pool() { return sThreadLocalPool; }
+static void set_thread_local_pool(PoolData* pool) { sThreadLocalPool = pool; }
+
+#endif
+
+Pool::Pool() : fData(new PoolData) {}
+
+Pool::~Pool() {
+    SkASSERT(get_thread_local_pool() != fData);
+    fData->unref();
+}
+
+std::unique_ptr<Pool> Pool::Create() {
+    return std::unique_ptr<Pool>(new Pool);
+}
+
+void* Pool::AllocIRNode(size_t size) {
+    PoolData* pool = get_thread_local_pool();
+    size_t total = kHeaderSize + align(size);
+    void* header = pool ? pool->alloc(total) : sk_malloc_throw(total);
+    *(PoolData**)header = pool;
+    return (char*)header + kHeaderSize;
+}
+
+void Pool::FreeIRNode(void* node) {
+    if (!node) {
+        return;
+    }
+    void* header = (char*)node - kHeaderSize;
+    if (PoolData* pool = *(PoolData**)header) {
+        pool->unref();
+    } else {
+        sk_free(header);
+    }
+}
+
+AutoAttachPoolToThread::AutoAttachPoolToThread(Pool* pool)
+        : fPrevious(get_thread_local_pool()) {
+    set_thread_local_pool(pool ? pool->fData : nullptr);
+}
+
+AutoAttachPoolToThread::~AutoAttachPoolToThread() {
+    set_thread_local_pool(fPrevious);
+}
+
+}  // namespace SkSL
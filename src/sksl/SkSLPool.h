@@ -0,0 +1,60 @@
+/*
+ * Copyright 2020 Google LLC.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_POOL
+#define SKSL_POOL
+
+#include <memory>
+
+namespace SkSL {
+
+class PoolData;
+
+/**
+ * Hands out memory for IR nodes in large blocks rather than one malloc per node. While a Pool is
+ * attached to the current thread (see AutoAttachPoolToThread), IRNode's operator new carves nodes
+ * out of the pool; otherwise nodes come from the heap as usual.
+ *
+ * Freeing a pooled node only drops a reference on its pool. The blocks are released once the Pool
+ * and every node it handed out are gone, so nodes may safely outlive the Pool that made them (and
+ * be freed on any thread).
+ */
+class Pool {
+public:
+    ~Pool();
+
+    static std::unique_ptr<Pool> Create();
+
+    static void* AllocIRNode(size_t size);
+
+    static void FreeIRNode(void* node);
+
+private:
+    Pool();
+
+    PoolData* fData;
+
+    friend class AutoAttachPoolToThread;
+};
+
+/**
+ * Attaches a Pool to the current thread for the lifetime of this object, and then reattaches
+ * whichever pool (if any) was attached before. A null pool detaches the current one.
+ */
+class AutoAttachPoolToThread {
+public:
+    AutoAttachPoolToThread(Pool* pool);
+
+    ~AutoAttachPoolToThread();
+
+private:
+    PoolData* fPrevious;
+};
+
+}  // namespace SkSL
+
+#endif
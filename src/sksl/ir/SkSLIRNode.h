@@ -11,6 +11,7 @@
 #include "src/sksl/SkSLASTNode.h"
 #include "src/sksl/SkSLLexer.h"
 #include "src/sksl/SkSLModifiersPool.h"
+#include "src/sksl/SkSLPool.h"
 #include "src/sksl/SkSLString.h"
 
 #include <algorithm>
@@ -38,6 +39,15 @@ class IRNode {
 public:
     virtual ~IRNode();
 
+    // Nodes come from the Pool attached to the current thread, if there is one.
+    static void* operator new(const size_t size) {
+        return Pool::AllocIRNode(size);
+    }
+
+    static void operator delete(void* ptr) {
+        Pool::FreeIRNode(ptr);
+    }
+
     IRNode& operator=(const IRNode& other) {
         // Need to have a copy assignment operator because Type requires it, but can't use the
         // default version until we finish migrating away from std::unique_ptr children. For now,
@@ -24,18 +24,22 @@ std::vector<const FunctionDeclaration*> SymbolTable::GetFunctions(const Symbol&
 }
 
 Symbol* SymbolTable::operator[](StringFragment name) {
-    auto entry = fSymbols.find(name);
-    if (entry == fSymbols.end()) {
+    return this->lookup(MakeSymbolKey(name));
+}
+
+Symbol* SymbolTable::lookup(const SymbolKey& key) {
+    Symbol** symbolPPtr = fSymbols.find(key);
+    if (!symbolPPtr) {
         if (fParent) {
-            return (*fParent)[name];
+            return fParent->lookup(key);
         }
         return nullptr;
     }
     if (fParent) {
-        auto functions = GetFunctions(*entry->second);
+        auto functions = GetFunctions(**symbolPPtr);
         if (functions.size() > 0) {
             bool modified = false;
-            const Symbol* previous = (*fParent)[name];
+            const Symbol* previous = fParent->lookup(key);
             if (previous) {
                 auto previousFunctions = GetFunctions(*previous);
                 for (const FunctionDeclaration* prev : previousFunctions) {
@@ -59,7 +63,7 @@ Symbol* SymbolTable::operator[](StringFragment name) {
             }
         }
     }
-    Symbol* symbol = entry->second;
+    Symbol* symbol = *symbolPPtr;
     while (symbol && symbol->is<SymbolAlias>()) {
         symbol = symbol->as<SymbolAlias>().origSymbol();
     }
@@ -79,11 +83,13 @@ void SymbolTable::addAlias(StringFragment name, Symbol* symbol) {
 void SymbolTable::addWithoutOwnership(Symbol* symbol) {
     const StringFragment& name = symbol->name();
 
-    Symbol*& refInSymbolTable = fSymbols[name];
-    if (refInSymbolTable == nullptr) {
-        refInSymbolTable = symbol;
+    SymbolKey key = MakeSymbolKey(name);
+    Symbol** symbolPPtr = fSymbols.find(key);
+    if (!symbolPPtr) {
+        fSymbols.set(key, symbol);
         return;
     }
+    Symbol*& refInSymbolTable = *symbolPPtr;
 
     if (!symbol->is<FunctionDeclaration>()) {
         fErrorReporter.error(symbol->fOffset, "symbol '" + name + "' was already defined");
@@ -106,12 +112,4 @@ void SymbolTable::addWithoutOwnership(Symbol* symbol) {
     }
 }
 
-std::unordered_map<StringFragment, Symbol*>::iterator SymbolTable::begin() {
-    return fSymbols.begin();
-}
-
-std::unordered_map<StringFragment, Symbol*>::iterator SymbolTable::end() {
-    return fSymbols.end();
-}
-
 }  // namespace SkSL
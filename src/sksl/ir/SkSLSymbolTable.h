@@ -8,12 +8,14 @@
 #ifndef SKSL_SYMBOLTABLE
 #define SKSL_SYMBOLTABLE
 
-#include <unordered_map>
-#include <memory>
-#include <vector>
+#include "include/private/SkChecksum.h"
+#include "include/private/SkTHash.h"
 #include "src/sksl/SkSLErrorReporter.h"
 #include "src/sksl/ir/SkSLSymbol.h"
 
+#include <memory>
+#include <vector>
+
 namespace SkSL {
 
 class FunctionDeclaration;
@@ -60,22 +62,48 @@ public:
 
     const String* takeOwnershipOfString(std::unique_ptr<String> n);
 
-    std::unordered_map<StringFragment, Symbol*>::iterator begin();
-
-    std::unordered_map<StringFragment, Symbol*>::iterator end();
+    // Calls fn(StringFragment name, const Symbol*) for each symbol in this table (but not its
+    // parents), in no particular order.
+    template <typename Fn>
+    void foreach(Fn&& fn) const {
+        fSymbols.foreach([&fn](const SymbolKey& key, const Symbol* symbol) {
+            fn(key.fName, symbol);
+        });
+    }
 
     std::shared_ptr<SymbolTable> fParent;
 
     std::vector<std::unique_ptr<const Symbol>> fOwnedSymbols;
 
 private:
+    // A name along with its hash. Lookups hash the name once and reuse the key all the way up the
+    // chain of parent tables.
+    struct SymbolKey {
+        StringFragment fName;
+        uint32_t       fHash;
+
+        bool operator==(const SymbolKey& that) const {
+            return fHash == that.fHash && fName == that.fName;
+        }
+
+        struct Hash {
+            uint32_t operator()(const SymbolKey& key) const { return key.fHash; }
+        };
+    };
+
+    static SymbolKey MakeSymbolKey(StringFragment name) {
+        return SymbolKey{name, SkOpts::hash_fn(name.fChars, name.fLength, 0)};
+    }
+
+    Symbol* lookup(const SymbolKey& key);
+
     static std::vector<const FunctionDeclaration*> GetFunctions(const Symbol& s);
 
     std::vector<std::unique_ptr<IRNode>> fOwnedNodes;
 
     std::vector<std::unique_ptr<String>> fOwnedStrings;
 
-    std::unordered_map<StringFragment, Symbol*> fSymbols;
+    SkTHashMap<SymbolKey, Symbol*, SymbolKey::Hash> fSymbols;
 
     ErrorReporter& fErrorReporter;
 
@@ -10,10 +10,12 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/private/SkMalloc.h"
+#include "include/private/SkVx.h"
 #include "include/utils/SkParse.h"
 #include "src/utils/SkUTF.h"
 
 #include <cmath>
+#include <limits>
 #include <tuple>
 #include <vector>
 
@@ -269,6 +271,22 @@ static inline const char* skip_ws(const char* p) {
     return p;
 }
 
+// Skips over runs of plain string chars, 16 at a time, stopping at (or before) the first
+// potential string terminator (see is_eostring).  Never reads past |p_stop|.
+static inline const char* skip_string_chars(const char* p, const char* p_stop) {
+    using U8x16 = skvx::Vec<16, uint8_t>;
+
+    while (p_stop - p >= 16) {
+        const auto c = U8x16::Load(p);
+        if (any((c < 0x20) | (c == '"') | (c == '\\') | (c == '}') | (c == ']'))) {
+            break;
+        }
+        p += 16;
+    }
+
+    return p;
+}
+
 static inline float pow10(int32_t exp) {
     static constexpr float g_pow10_table[63] =
     {
@@ -696,7 +714,7 @@ private:
         do {
             // Consume string chars.
             // This is the fast path, and hopefully we only hit it once then quick-exit below.
-            for (p = p + 1; !is_eostring(*p); ++p);
+            for (p = skip_string_chars(p + 1, p_stop); !is_eostring(*p); ++p);
 
             if (*p == '"') {
                 // Valid string found.
@@ -854,6 +872,278 @@ private:
     }
 };
 
+// Binary DOM encoding (little-endian):
+//
+//   [magic: "\x89SKJ"] [version: u32] [value]
+//
+//   value := [type: u8] [payload]
+//
+//     kNull, kFalse, kTrue : (no payload)
+//     kInt                 : [i32]
+//     kFloat               : [f32]
+//     kString              : [size: packed] [chars]
+//     kArray               : [count: packed] [value] * count
+//     kObject              : [count: packed] ([key size: packed] [key chars] [value]) * count
+//
+// Packed sizes use the SkWStream::writePackedUInt() encoding.
+//
+static constexpr char kBinaryMagic[] = { '\x89', 'S', 'K', 'J' };
+
+enum class BinaryType : uint8_t {
+    kNull,
+    kFalse,
+    kTrue,
+    kInt,
+    kFloat,
+    kString,
+    kArray,
+    kObject,
+};
+
+// Vector records with uninitialized storage, populated in place by the binary parser.
+class InPlaceVector final : public Value {
+public:
+    static InPlaceVector MakeArray(size_t count, SkArenaAlloc& alloc) {
+        return InPlaceVector(Tag::kArray, count, count * sizeof(Value), alloc);
+    }
+
+    static InPlaceVector MakeObject(size_t count, SkArenaAlloc& alloc) {
+        return InPlaceVector(Tag::kObject, count, count * sizeof(Member), alloc);
+    }
+
+    Value* storage() const {
+        return const_cast<Value*>(reinterpret_cast<const Value*>(this->ptr<size_t>() + 1));
+    }
+
+private:
+    InPlaceVector(Tag tag, size_t count, size_t storage_size, SkArenaAlloc& alloc) {
+        auto* size_ptr = reinterpret_cast<size_t*>(
+                alloc.makeBytesAlignedTo(sizeof(size_t) + storage_size, kRecAlign));
+        *size_ptr = count;
+        this->init_tagged_pointer(tag, size_ptr);
+    }
+};
+
+class BinaryDOMParser {
+public:
+    explicit BinaryDOMParser(SkArenaAlloc& alloc) : fAlloc(alloc) {}
+
+    Value parse(const char* p, size_t size) {
+        SkASSERT(DOM::IsBinary(p, size));
+
+        fP    = p + sizeof(kBinaryMagic);
+        fStop = p + size;
+
+        uint32_t version;
+        if (!this->read(&version) || version != DOM::kBinaryVersion) {
+            return NullValue();
+        }
+
+        // Values are decoded in place, into preallocated vector storage.  Pending (partially
+        // populated) vectors are tracked on a scope stack.
+        struct Scope {
+            Value* fCurrent;
+            Value* fEnd;
+            bool   fIsObject;
+        };
+        std::vector<Scope> scopes;
+
+        Value root  = NullValue();
+        Scope scope = { &root, &root + 1, false };
+
+        for (;;) {
+            if (scope.fCurrent == scope.fEnd) {
+                if (scopes.empty()) {
+                    break;
+                }
+                scope = scopes.back();
+                scopes.pop_back();
+                continue;
+            }
+
+            // Object members are stored as sequential key/value records.
+            if (scope.fIsObject && !this->readString(scope.fCurrent++)) {
+                return NullValue();
+            }
+
+            Value* dst = scope.fCurrent++;
+
+            uint8_t type;
+            if (!this->read(&type)) {
+                return NullValue();
+            }
+
+            switch (static_cast<BinaryType>(type)) {
+            case BinaryType::kNull:
+                *dst = NullValue();
+                break;
+            case BinaryType::kFalse:
+                *dst = BoolValue(false);
+                break;
+            case BinaryType::kTrue:
+                *dst = BoolValue(true);
+                break;
+            case BinaryType::kInt: {
+                int32_t i;
+                if (!this->read(&i)) {
+                    return NullValue();
+                }
+                *dst = NumberValue(i);
+            } break;
+            case BinaryType::kFloat: {
+                float f;
+                if (!this->read(&f)) {
+                    return NullValue();
+                }
+                *dst = NumberValue(f);
+            } break;
+            case BinaryType::kString:
+                if (!this->readString(dst)) {
+                    return NullValue();
+                }
+                break;
+            case BinaryType::kArray:
+            case BinaryType::kObject: {
+                const auto is_object = static_cast<BinaryType>(type) == BinaryType::kObject;
+
+                // Each array value takes at least one byte, each object member at least two:
+                // this guards against bogus counts (and runaway allocations).
+                size_t count;
+                if (!this->readSize(&count) ||
+                    count > SkToSizeT(fStop - fP) / (is_object ? 2 : 1)) {
+                    return NullValue();
+                }
+
+                const auto vec = is_object ? InPlaceVector::MakeObject(count, fAlloc)
+                                           : InPlaceVector::MakeArray (count, fAlloc);
+                *dst = vec;
+
+                scopes.push_back(scope);
+                scope.fCurrent  = vec.storage();
+                scope.fEnd      = scope.fCurrent + count * (is_object ? 2 : 1);
+                scope.fIsObject = is_object;
+            } break;
+            default:
+                return NullValue();
+            }
+        }
+
+        // Trailing garbage is an error.
+        return fP == fStop ? root : NullValue();
+    }
+
+private:
+    template <typename T>
+    bool read(T* v) {
+        if (SkToSizeT(fStop - fP) < sizeof(T)) {
+            return false;
+        }
+        memcpy(v, fP, sizeof(T));
+        fP += sizeof(T);
+        return true;
+    }
+
+    bool readSize(size_t* size) {
+        uint8_t u8;
+        if (!this->read(&u8)) {
+            return false;
+        }
+
+        switch (u8) {
+        case 0xfe: {
+            uint16_t u16;
+            if (!this->read(&u16)) {
+                return false;
+            }
+            *size = u16;
+        } break;
+        case 0xff: {
+            uint32_t u32;
+            if (!this->read(&u32)) {
+                return false;
+            }
+            *size = u32;
+        } break;
+        default:
+            *size = u8;
+            break;
+        }
+
+        return true;
+    }
+
+    bool readString(Value* dst) {
+        size_t size;
+        if (!this->readSize(&size) || size > SkToSizeT(fStop - fP)) {
+            return false;
+        }
+
+        // FastString may read one byte before the string (always safe, as the size precedes
+        // it), and up to |eos|.
+        *dst = FastString(fP, size, fStop - 1, fAlloc);
+        fP += size;
+        return true;
+    }
+
+    SkArenaAlloc& fAlloc;
+    const char*   fP    = nullptr;
+    const char*   fStop = nullptr;
+};
+
+void WriteBinary(const Value& v, SkWStream* stream) {
+    const auto write_type = [stream](BinaryType type) {
+        stream->write8(SkToU8(type));
+    };
+    const auto write_string = [stream](const StringValue& str) {
+        stream->writePackedUInt(str.size());
+        stream->write(str.begin(), str.size());
+    };
+
+    switch (v.getType()) {
+    case Value::Type::kNull:
+        write_type(BinaryType::kNull);
+        break;
+    case Value::Type::kBool:
+        write_type(*v.as<BoolValue>() ? BinaryType::kTrue : BinaryType::kFalse);
+        break;
+    case Value::Type::kNumber: {
+        // Numbers are stored as either int32 or float (see NumberValue),
+        // so the conversions below are lossless.
+        const auto n = *v.as<NumberValue>();
+        if (n >= std::numeric_limits<int32_t>::min() &&
+            n <= std::numeric_limits<int32_t>::max() &&
+            n == static_cast<int32_t>(n) && !(n == 0 && std::signbit(n))) {
+            write_type(BinaryType::kInt);
+            stream->write32(static_cast<uint32_t>(static_cast<int32_t>(n)));
+        } else {
+            write_type(BinaryType::kFloat);
+            stream->writeScalar(static_cast<float>(n));
+        }
+    } break;
+    case Value::Type::kString:
+        write_type(BinaryType::kString);
+        write_string(v.as<StringValue>());
+        break;
+    case Value::Type::kArray: {
+        const auto& array = v.as<ArrayValue>();
+        write_type(BinaryType::kArray);
+        stream->writePackedUInt(array.size());
+        for (const auto& element : array) {
+            WriteBinary(element, stream);
+        }
+    } break;
+    case Value::Type::kObject: {
+        const auto& object = v.as<ObjectValue>();
+        write_type(BinaryType::kObject);
+        stream->writePackedUInt(object.size());
+        for (const auto& member : object) {
+            write_string(member.fKey.as<StringValue>());
+            WriteBinary(member.fValue, stream);
+        }
+    } break;
+    }
+}
+
 void Write(const Value& v, SkWStream* stream) {
     switch (v.getType()) {
     case Value::Type::kNull:
@@ -913,6 +1203,13 @@ static constexpr size_t kMinChunkSize = 4096;
 
 DOM::DOM(const char* data, size_t size)
     : fAlloc(kMinChunkSize) {
+    if (IsBinary(data, size)) {
+        BinaryDOMParser parser(fAlloc);
+
+        fRoot = parser.parse(data, size);
+        return;
+    }
+
     DOMParser parser(fAlloc);
 
     fRoot = parser.parse(data, size);
@@ -922,4 +1219,14 @@ void DOM::write(SkWStream* stream) const {
     Write(fRoot, stream);
 }
 
+void DOM::writeBinary(SkWStream* stream) const {
+    stream->write(kBinaryMagic, sizeof(kBinaryMagic));
+    stream->write32(kBinaryVersion);
+    WriteBinary(fRoot, stream);
+}
+
+bool DOM::IsBinary(const void* data, size_t size) {
+    return size >= sizeof(kBinaryMagic) && !memcmp(data, kBinaryMagic, sizeof(kBinaryMagic));
+}
+
 } // namespace skjson
@@ -334,12 +334,31 @@ public:
 
 class DOM final : public SkNoncopyable {
 public:
+    /**
+     *  Instantiates a DOM from either JSON text, or from a binary encoding as produced by
+     *  writeBinary().
+     */
     DOM(const char*, size_t);
 
     const Value& root() const { return fRoot; }
 
     void write(SkWStream*) const;
 
+    /**
+     *  Writes a compact binary encoding of the DOM.  This can be used to instantiate an
+     *  equivalent DOM without parsing JSON text (no tokenizing, number parsing or unescaping).
+     *
+     *  The encoding is little-endian, and versioned - see kBinaryVersion.
+     */
+    void writeBinary(SkWStream*) const;
+
+    /**
+     *  @return    True if the data looks like a binary DOM encoding.
+     */
+    static bool IsBinary(const void*, size_t);
+
+    static constexpr uint32_t kBinaryVersion = 1;
+
 private:
     SkArenaAlloc fAlloc;
     Value        fRoot;
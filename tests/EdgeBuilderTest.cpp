@@ -0,0 +1,176 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkAnalyticEdge.h"
+#include "src/core/SkEdge.h"
+#include "src/core/SkEdgeBuilder.h"
+#include "src/core/SkFDot6.h"
+#include "src/core/SkPathView.h"
+#include "tests/Test.h"
+
+#include <cstring>
+
+static bool same_edge(const SkEdge& a, const SkEdge& b) {
+    return a.fX           == b.fX
+        && a.fDX          == b.fDX
+        && a.fFirstY      == b.fFirstY
+        && a.fLastY       == b.fLastY
+        && a.fCurveCount  == b.fCurveCount
+        && a.fCurveShift  == b.fCurveShift
+        && a.fCubicDShift == b.fCubicDShift
+        && a.fWinding     == b.fWinding;
+}
+
+static bool same_edge(const SkAnalyticEdge& a, const SkAnalyticEdge& b) {
+    return a.fX           == b.fX
+        && a.fDX          == b.fDX
+        && a.fUpperX      == b.fUpperX
+        && a.fY           == b.fY
+        && a.fUpperY      == b.fUpperY
+        && a.fLowerY      == b.fLowerY
+        && a.fDY          == b.fDY
+        && a.fCurveCount  == b.fCurveCount
+        && a.fCurveShift  == b.fCurveShift
+        && a.fCubicDShift == b.fCubicDShift
+        && a.fWinding     == b.fWinding;
+}
+
+// How the edge setters converted each curve's points to FDot6 before they were batched; the
+// batched conversion must give exactly the same values.
+static void scalar_convert_to_fdot6(const SkPoint pts[], int count, int shift, SkFDot6 xy[]) {
+    for (int i = 0; i < count; i++) {
+#ifdef SK_RASTERIZE_EVEN_ROUNDING
+        xy[2*i + 0] = SkScalarRoundToFDot6(pts[i].fX, shift);
+        xy[2*i + 1] = SkScalarRoundToFDot6(pts[i].fY, shift);
+#else
+        float scale = float(1 << (shift + 6));
+        xy[2*i + 0] = int(pts[i].fX * scale);
+        xy[2*i + 1] = int(pts[i].fY * scale);
+#endif
+    }
+}
+
+// Runs of y-monotonic curves (more than fit in a batch), broken up by lines. Each segment's points
+// are appended to segments, and its point count (2 for lines, 3 for quads, 4 for cubics) to kinds.
+static SkPath make_curves(SkRandom* rand, SkTDArray<SkPoint>* segments, SkTDArray<int>* kinds) {
+    auto coord = [&](float lo, float hi) { return rand->nextRangeF(lo, hi); };
+
+    SkPath path;
+    SkPoint last = {0, 0};
+    path.moveTo(last);
+    for (int run = 0; run < 6; run++) {
+        int kind = run % 3 + 2;
+        int count = kind == 2 ? 3 : 50;
+        for (int i = 0; i < count; i++) {
+            SkPoint pts[4] = {last};
+            for (int j = 1; j < kind; j++) {
+                pts[j] = {coord(0, 200), pts[j-1].fY + coord(1, 4)};
+            }
+            switch (kind) {
+                case 2: path.lineTo (pts[1]);                 break;
+                case 3: path.quadTo (pts[1], pts[2]);         break;
+                case 4: path.cubicTo(pts[1], pts[2], pts[3]); break;
+            }
+            memcpy(segments->append(kind), pts, kind * sizeof(SkPoint));
+            kinds->push_back(kind);
+            last = pts[kind - 1];
+        }
+    }
+    path.close();
+    SkPoint closing[2] = {last, {0, 0}};
+    memcpy(segments->append(2), closing, sizeof(closing));
+    kinds->push_back(2);
+    return path;
+}
+
+// Curves are turned into edges in batches; make sure that gives the same edges, in the same
+// order, as setting them up one at a time from scalar converted points.
+DEF_TEST(EdgeBuilder_BatchedCurves, reporter) {
+    SkRandom rand;
+    for (int shift = 0; shift <= 2; shift += 2) {
+        SkTDArray<SkPoint> segments;
+        SkTDArray<int>     kinds;
+        SkPath path = make_curves(&rand, &segments, &kinds);
+
+        SkBasicEdgeBuilder builder(shift);
+        int count = builder.buildEdges(path.view(), nullptr);
+        REPORTER_ASSERT(reporter, count == kinds.count());
+        if (count != kinds.count()) {
+            continue;
+        }
+
+        const SkPoint* pts = segments.begin();
+        for (int i = 0; i < count; i++) {
+            const SkEdge* edge = builder.edgeList()[i];
+            SkFDot6 xy[8];
+            scalar_convert_to_fdot6(pts, kinds[i], shift, xy);
+            switch (kinds[i]) {
+                case 2: {
+                    SkEdge expected = {};
+                    expected.setLine(pts[0], pts[1], shift);
+                    REPORTER_ASSERT(reporter, same_edge(*edge, expected), "line %d", i);
+                } break;
+                case 3: {
+                    SkQuadraticEdge expected = {};
+                    expected.setQuadratic(xy, shift);
+                    REPORTER_ASSERT(reporter, same_edge(*edge, expected), "quad %d", i);
+                } break;
+                case 4: {
+                    SkCubicEdge expected = {};
+                    expected.setCubic(xy, shift);
+                    REPORTER_ASSERT(reporter, same_edge(*edge, expected), "cubic %d", i);
+                } break;
+            }
+            pts += kinds[i];
+        }
+    }
+}
+
+DEF_TEST(EdgeBuilder_BatchedAnalyticCurves, reporter) {
+    SkRandom rand;
+    SkTDArray<SkPoint> segments;
+    SkTDArray<int>     kinds;
+    SkPath path = make_curves(&rand, &segments, &kinds);
+
+    SkAnalyticEdgeBuilder builder;
+    int count = builder.buildEdges(path.view(), nullptr);
+    REPORTER_ASSERT(reporter, count == kinds.count());
+    if (count != kinds.count()) {
+        return;
+    }
+
+    const SkPoint* pts = segments.begin();
+    for (int i = 0; i < count; i++) {
+        const SkAnalyticEdge* edge = builder.analyticEdgeList()[i];
+        SkFDot6 xy[8];
+        scalar_convert_to_fdot6(pts, kinds[i], SkAnalyticEdge::kDefaultAccuracy, xy);
+        switch (kinds[i]) {
+            case 2: {
+                SkAnalyticEdge expected = {};
+                expected.setLine(pts[0], pts[1]);
+                REPORTER_ASSERT(reporter, same_edge(*edge, expected), "line %d", i);
+            } break;
+            case 3: {
+                SkAnalyticQuadraticEdge expected = {};
+                expected.setQuadratic(xy);
+                auto quad = static_cast<const SkAnalyticQuadraticEdge*>(edge);
+                REPORTER_ASSERT(reporter, same_edge(*quad, expected) &&
+                                          same_edge(quad->fQEdge, expected.fQEdge), "quad %d", i);
+            } break;
+            case 4: {
+                SkAnalyticCubicEdge expected = {};
+                expected.setCubic(xy);
+                auto cubic = static_cast<const SkAnalyticCubicEdge*>(edge);
+                REPORTER_ASSERT(reporter, same_edge(*cubic, expected) &&
+                                          same_edge(cubic->fCEdge, expected.fCEdge), "cubic %d", i);
+            } break;
+        }
+        pts += kinds[i];
+    }
+}
@@ -46,3 +46,134 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+#include "include/private/SkTo.h"
+#include "src/core/SkAutoMalloc.h"
+#include "src/core/SkRasterClip.h"
+
+// Accumulates everything blitted into an A8 coverage buffer.
+struct CoverageBlitter : public SkBlitter {
+    CoverageBlitter(int width, int height)
+        : fWidth(width), fCoverage((size_t)width * height) {
+        memset(fCoverage.get(), 0, (size_t)width * height);
+    }
+
+    void blitH(int x, int y, int width) override {
+        for (int i = 0; i < width; ++i) {
+            this->add(x + i, y, 0xFF);
+        }
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        for (int n = runs[0]; n > 0; n = runs[0]) {
+            for (int i = 0; i < n; ++i) {
+                this->add(x + i, y, antialias[0]);
+            }
+            x += n;
+            antialias += n;
+            runs += n;
+        }
+    }
+
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        SkASSERT(mask.fFormat == SkMask::kA8_Format);
+        for (int y = clip.fTop; y < clip.fBottom; ++y) {
+            for (int x = clip.fLeft; x < clip.fRight; ++x) {
+                this->add(x, y, *mask.getAddr8(x, y));
+            }
+        }
+    }
+
+    // A pixel blitted more than once (with src-over, say) ends up with about the sum.
+    void add(int x, int y, SkAlpha alpha) {
+        uint8_t* c = &fCoverage[(size_t)y * fWidth + x];
+        *c = SkTo<uint8_t>(std::min(0xFF, *c + alpha));
+    }
+
+    int fWidth;
+    SkAutoTMalloc<uint8_t> fCoverage;
+};
+
+DEF_TEST(SparseTileAAFillPath, reporter) {
+    const int size = 300;
+    const SkRasterClip clip(SkIRect::MakeWH(size, size));
+
+    auto fill = [&](const SkPath& path, SkScan::Rasterizer rasterizer, CoverageBlitter* blitter) {
+        SkScan::AntiFillPath(path.view(), clip, blitter, rasterizer);
+    };
+
+    // Sparse tiles compute each pixel's area exactly, so a rect's coverage is easy to predict.
+    const SkRect rect = {20.25f, 30.75f, 281.5f, 70.5f};
+    auto overlap = [](int pixel, SkScalar lo, SkScalar hi) {
+        return std::max(0.f, std::min(pixel + 1.f, hi) - std::max(pixel + 0.f, lo));
+    };
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kInverseWinding}) {
+        SkPath path = SkPath::Rect(rect);
+        path.setFillType(fillType);
+        CoverageBlitter sparse(size, size);
+        fill(path, SkScan::Rasterizer::kSparseTile, &sparse);
+
+        int maxDiff = 0;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                SkScalar w = overlap(x, rect.fLeft, rect.fRight),
+                         h = overlap(y, rect.fTop, rect.fBottom),
+                         c = path.isInverseFillType() ? 1 - w * h : w * h;
+                maxDiff = std::max(maxDiff, std::abs(sparse.fCoverage[y * size + x] -
+                                                     (int)(c * 255 + 0.5f)));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 1, "max diff %d", maxDiff);
+    }
+
+    // Elsewhere, analytic AA is the approximate one, but the two should never disagree by much, and
+    // should cover the same area overall.
+    auto check = [&](const SkPath& path) {
+        CoverageBlitter analytic(size, size),
+                        sparse(size, size);
+        fill(path, SkScan::Rasterizer::kAnalytic, &analytic);
+        fill(path, SkScan::Rasterizer::kSparseTile, &sparse);
+
+        int maxDiff = 0;
+        int64_t analyticSum = 0,
+                sparseSum   = 0;
+        for (size_t i = 0; i < (size_t)size * size; ++i) {
+            maxDiff = std::max(maxDiff, std::abs(analytic.fCoverage[i] - sparse.fCoverage[i]));
+            analyticSum += analytic.fCoverage[i];
+            sparseSum   += sparse.fCoverage[i];
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 96, "max diff %d", maxDiff);
+        REPORTER_ASSERT(reporter, std::abs(analyticSum - sparseSum) <= analyticSum / 500,
+                        "sums %lld vs. %lld", (long long)analyticSum, (long long)sparseSum);
+    };
+
+    SkPath path;
+    path.addCircle(150, 150, 100);
+    path.addRect(20, 30, 280.5f, 60.25f);
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kEvenOdd,
+                                    SkPathFillType::kInverseWinding,
+                                    SkPathFillType::kInverseEvenOdd}) {
+        path.setFillType(fillType);
+        check(path);
+    }
+
+    // Off the sides of the clip, with curves of every kind.
+    path.reset();
+    path.moveTo(-50, 10);
+    path.quadTo(150, -40, 350, 100);
+    path.conicTo(250, 290, 150, 200, 0.5f);
+    path.cubicTo(100, 400, -100, 50, 40.3f, 120.7f);
+    path.close();
+    check(path);
+
+    // A five-pointed star, whose middle winds twice.
+    path.reset();
+    for (int i = 0; i < 5; ++i) {
+        SkScalar a = i * 4 * SK_ScalarPI / 5;
+        SkPoint p = {150.3f + 140 * SkScalarSin(a), 150.6f - 140 * SkScalarCos(a)};
+        i ? path.lineTo(p) : path.moveTo(p);
+    }
+    check(path);
+    path.setFillType(SkPathFillType::kEvenOdd);
+    check(path);
+}
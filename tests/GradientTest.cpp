@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkShader.h"
@@ -13,8 +14,11 @@
 #include "include/private/SkTemplates.h"
 #include "src/core/SkTLazy.h"
 #include "src/shaders/SkColorShader.h"
+#include "src/shaders/gradients/SkGradientShaderPriv.h"
 #include "tests/Test.h"
 
+#include <functional>
+
 // https://code.google.com/p/chromium/issues/detail?id=448299
 // Giant (inverse) matrix causes overflow when converting/computing using 32.32
 // Before the fix, we would assert (and then crash).
@@ -551,3 +555,64 @@ DEF_TEST(Gradient, reporter) {
     test_linear_fuzzer(reporter);
     test_sweep_fuzzer(reporter);
 }
+
+// With kUseColorLUT_PrivateFlag, gradients are looked up in a table of colors, which should only
+// be off from computing them per pixel by half a table entry (up to 2 for these stops), plus
+// rounding and dithering differences.
+DEF_TEST(Gradient_ColorLUT, reporter) {
+    const SkPoint pts[] = {{ 10, 20 }, { 190, 140 }};
+    const SkColor colors[] = { SK_ColorRED, 0x8000FF00, SK_ColorBLUE, SK_ColorWHITE, 0 };
+    const SkScalar pos[] = { 0, 0.3f, 0.5f, 0.75f, 1 };
+
+    std::function<sk_sp<SkShader>(uint32_t flags)> makers[] = {
+        [&](uint32_t flags) {
+            return SkGradientShader::MakeLinear(pts, colors, pos, 5, SkTileMode::kClamp,
+                                                flags, nullptr);
+        },
+        [&](uint32_t flags) {
+            return SkGradientShader::MakeLinear(pts, colors, nullptr, 3, SkTileMode::kRepeat,
+                                                flags, nullptr);
+        },
+        [&](uint32_t flags) {
+            return SkGradientShader::MakeLinear(pts, colors, nullptr, 4, SkTileMode::kMirror,
+                                                flags, nullptr);
+        },
+        [&](uint32_t flags) {
+            return SkGradientShader::MakeRadial({ 100, 100 }, 70, colors, pos, 5,
+                                                SkTileMode::kClamp, flags, nullptr);
+        },
+        [&](uint32_t flags) {
+            return SkGradientShader::MakeSweep(100, 100, colors, nullptr, 4, flags, nullptr);
+        },
+    };
+
+    auto draw = [](sk_sp<SkShader> shader, bool dither) {
+        SkBitmap bm;
+        bm.allocN32Pixels(200, 200);
+        SkCanvas canvas(bm);
+        SkPaint paint;
+        paint.setShader(std::move(shader));
+        paint.setDither(dither);
+        canvas.drawPaint(paint);
+        return bm;
+    };
+
+    for (const auto& make : makers) {
+        for (bool dither : { false, true }) {
+            SkBitmap expected = draw(make(0), dither),
+                     actual   = draw(make(SkGradientShaderBase::kUseColorLUT_PrivateFlag), dither);
+            int maxDiff = 0;
+            for (int y = 0; y < expected.height(); y++) {
+                for (int x = 0; x < expected.width(); x++) {
+                    SkPMColor e = *expected.getAddr32(x, y),
+                              a = *actual.getAddr32(x, y);
+                    for (int shift = 0; shift < 32; shift += 8) {
+                        maxDiff = std::max(maxDiff, abs(int((e >> shift) & 0xFF) -
+                                                        int((a >> shift) & 0xFF)));
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, maxDiff <= 5, "max diff %d", maxDiff);
+        }
+    }
+}
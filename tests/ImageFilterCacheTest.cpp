@@ -154,6 +154,42 @@ static void test_explicit_purging(skiatest::Reporter* reporter,
     REPORTER_ASSERT(reporter, !cache->get(key2, &foundImage));
 }
 
+// Exercise purgeToBytes and setTotalByteLimit, which purge the least recently used results first
+static void test_purge_to_bytes(skiatest::Reporter* reporter, const sk_sp<SkSpecialImage>& image) {
+    static const size_t kCacheSize = 1000000;
+    const size_t imageSize = image->getSize();
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip = SkIRect::MakeWH(100, 100);
+    SkImageFilterCacheKey key1(0, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey key2(1, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey key3(2, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+
+    SkIPoint offset = SkIPoint::Make(3, 4);
+    auto filter = make_filter();
+    for (const auto& key : {key1, key2, key3}) {
+        cache->set(key, filter.get(),
+                   skif::FilterResult<For::kOutput>(image, skif::LayerSpace<SkIPoint>(offset)));
+    }
+    REPORTER_ASSERT(reporter, 3 * imageSize == cache->getTotalBytesUsed());
+
+    // Touch key1 so key2 is now the least recently used.
+    skif::FilterResult<For::kOutput> foundImage;
+    REPORTER_ASSERT(reporter, cache->get(key1, &foundImage));
+
+    cache->purgeToBytes(2 * imageSize);
+    REPORTER_ASSERT(reporter, 2 * imageSize == cache->getTotalBytesUsed());
+    REPORTER_ASSERT(reporter, !cache->get(key2, &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(key3, &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(key1, &foundImage));
+
+    REPORTER_ASSERT(reporter, kCacheSize == cache->setTotalByteLimit(imageSize));
+    REPORTER_ASSERT(reporter, imageSize == cache->getTotalByteLimit());
+    REPORTER_ASSERT(reporter, imageSize == cache->getTotalBytesUsed());
+    REPORTER_ASSERT(reporter, !cache->get(key3, &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(key1, &foundImage));
+}
+
 DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     SkBitmap srcBM = create_bm();
 
@@ -169,6 +205,7 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_purge_to_bytes(reporter, fullImg);
 }
 
 
@@ -188,6 +225,7 @@ static void test_image_backed(skiatest::Reporter* reporter,
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_purge_to_bytes(reporter, fullImg);
 }
 
 DEF_TEST(ImageFilterCache_ImageBackedRaster, reporter) {
@@ -282,4 +320,5 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterCache_GPUBacked, reporter, ctxInfo
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_purge_to_bytes(reporter, fullImg);
 }
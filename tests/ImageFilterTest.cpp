@@ -7,6 +7,7 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -19,6 +20,7 @@
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/effects/SkTableColorFilter.h"
 #include "include/gpu/GrDirectContext.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkColorFilterBase.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
@@ -263,6 +265,23 @@ private:
 
     using INHERITED = SkImageFilter_Base;
 };
+
+// Passes its input through untouched. As neither a color filter nor an offset node, it keeps the
+// filters on either side of it from being fused into one draw.
+class PassThroughImageFilter : public SkImageFilter_Base {
+public:
+    PassThroughImageFilter(sk_sp<SkImageFilter> input) : INHERITED(&input, 1, nullptr) {}
+
+private:
+    Factory getFactory() const override { return nullptr; }
+    const char* getTypeName() const override { return nullptr; }
+
+    sk_sp<SkSpecialImage> onFilterImage(const Context& ctx, SkIPoint* offset) const override {
+        return this->filterInput(0, ctx, offset);
+    }
+
+    using INHERITED = SkImageFilter_Base;
+};
 }  // namespace
 
 sk_sp<SkFlattenable> MatrixTestImageFilter::CreateProc(SkReadBuffer& buffer) {
@@ -2048,3 +2067,193 @@ DEF_TEST(PictureImageSourceBounds, reporter) {
                                                              SkImageFilter::kReverse_MapDirection,
                                                              &input));
 }
+
+static sk_sp<SkSpecialImage> make_random_special_image(int width, int height) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    SkRandom rand;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(width, height), bitmap);
+}
+
+// An executor that runs each task as soon as it is added, so work is still split into tasks (e.g.
+// row bands) but never runs concurrently.
+class InlineExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { work(); }
+};
+
+// Filters 'src' with 'filter' on 'executor', copying the result into 'dst' so that it can't alias
+// the source's pixels (raster special images wrap them rather than copying).
+static bool filter_on_executor(SkImageFilter* filter, SkSpecialImage* src, SkExecutor* executor,
+                               SkBitmap* dst, SkIPoint* offset) {
+    SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(src->width(), src->height()),
+                                    nullptr, kN32_SkColorType, nullptr, src);
+    sk_sp<SkSpecialImage> result(
+            as_IFB(filter)->filterImage(ctx.withExecutor(executor)).imageAndOffset(offset));
+    return result && special_image_to_bitmap(nullptr, result.get(), dst);
+}
+
+// Filters that evaluate their inputs concurrently (filterInputs()) or draw in row bands
+// (DrawInRowBands(), ForEachRowBand()) must produce exactly the same pixels with or without
+// threads to spread the work across.
+DEF_TEST(ImageFilterThreadedMatchesSerial, reporter) {
+    static constexpr int kWidth = 640, kHeight = 400;
+    sk_sp<SkSpecialImage> src = make_random_special_image(kWidth, kHeight);
+
+    // Inputs that each need filtering of their own, some of them shared between several inputs.
+    sk_sp<SkImageFilter> blur(SkImageFilters::Blur(3, 3, nullptr));
+    sk_sp<SkImageFilter> offset(SkImageFilters::Offset(5, -7, nullptr));
+    sk_sp<SkImageFilter> tint(SkImageFilters::ColorFilter(
+            SkColorFilters::Blend(0x8033AA55, SkBlendMode::kSrcATop), nullptr));
+    sk_sp<SkImageFilter> merged(SkImageFilters::Merge(blur, offset));
+    sk_sp<SkImageFilter> mergeInputs[] = { blur, offset, tint, blur, nullptr, merged };
+
+    struct {
+        const char*          fName;
+        sk_sp<SkImageFilter> fFilter;
+    } filters[] = {
+        { "lighting", SkImageFilters::PointLitSpecular({ kWidth / 2, kHeight / 2, 40 },
+                                                       SK_ColorWHITE, 2, 1.5f, 8, merged) },
+        { "displacement", SkImageFilters::DisplacementMap(SkColorChannel::kR, SkColorChannel::kB,
+                                                          16, blur, tint) },
+        { "arithmetic", SkImageFilters::Arithmetic(0.25f, 0.5f, 0.5f, 0, true, offset, tint) },
+        { "xfermode", SkImageFilters::Xfermode(SkBlendMode::kMultiply, blur, merged) },
+        { "merge", SkImageFilters::Merge(mergeInputs, SK_ARRAY_COUNT(mergeInputs)) },
+        { "color filter", SkImageFilters::ColorFilter(
+                SkColorFilters::Blend(0x40FF0000, SkBlendMode::kMultiply), merged) },
+        { "offset", SkImageFilters::Offset(3, 4, merged) },
+        { "blur", SkImageFilters::Blur(12, 7, nullptr) },
+    };
+
+    InlineExecutor inlineExecutor;
+    std::unique_ptr<SkExecutor> threadPool = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (const auto& test : filters) {
+        SkBitmap expected;
+        SkIPoint expectedOffset;
+        if (!filter_on_executor(test.fFilter.get(), src.get(), nullptr, &expected,
+                                &expectedOffset)) {
+            ERRORF(reporter, "%s: could not filter", test.fName);
+            continue;
+        }
+
+        for (SkExecutor* executor : { (SkExecutor*)&inlineExecutor, threadPool.get() }) {
+            SkBitmap actual;
+            SkIPoint actualOffset;
+            if (!filter_on_executor(test.fFilter.get(), src.get(), executor, &actual,
+                                    &actualOffset)) {
+                ERRORF(reporter, "%s: could not filter on an executor", test.fName);
+                continue;
+            }
+            REPORTER_ASSERT(reporter, actualOffset == expectedOffset, test.fName);
+            REPORTER_ASSERT(reporter, actual.dimensions() == expected.dimensions(), test.fName);
+            if (actual.dimensions() == expected.dimensions()) {
+                REPORTER_ASSERT(reporter, !memcmp(actual.getPixels(), expected.getPixels(),
+                                                  expected.computeByteSize()), test.fName);
+            }
+        }
+    }
+}
+
+// Runs of color filter and offset nodes are fused into the draw of the filter consuming them
+// (filterInputForDraw()). Fused, the colors are only rounded to 8 bits once instead of after every
+// node, so they may differ by a little from filtering each node on its own.
+DEF_TEST(ImageFilterFusedMatchesUnfused, reporter) {
+    sk_sp<SkSpecialImage> src = make_random_special_image(96, 64);
+
+    const float saturate[20] = { 0.8f, 0.3f, 0.1f, 0, 0,
+                                 0.1f, 0.7f, 0.2f, 0, 0,
+                                 0.2f, 0.1f, 0.9f, 0, 0,
+                                 0,    0,    0,    1, 0 };
+    sk_sp<SkColorFilter> matrix = SkColorFilters::Matrix(saturate),
+                         tint   = SkColorFilters::Blend(0xC0FF8040, SkBlendMode::kModulate),
+                         tint2  = SkColorFilters::Blend(0x6040A0FF, SkBlendMode::kSrcATop);
+    const SkIRect crop = SkIRect::MakeXYWH(10, 5, 60, 40);
+
+    // Each DAG is built with 'link' between every pair of nodes: as is, the runs fuse; wrapped in
+    // a PassThroughImageFilter, every node is filtered on its own.
+    using Link = std::function<sk_sp<SkImageFilter>(sk_sp<SkImageFilter>)>;
+    struct {
+        const char*                                  fName;
+        std::function<sk_sp<SkImageFilter>(Link)>    fMake;
+        bool                                         fFuses;
+    } tests[] = {
+        { "chained color filters", [&](Link link) {
+            return SkImageFilters::ColorFilter(tint2, link(
+                   SkImageFilters::ColorFilter(tint, link(
+                   SkImageFilters::ColorFilter(matrix, link(nullptr))))));
+        }, true },
+        { "offsets", [&](Link link) {
+            return SkImageFilters::ColorFilter(matrix, link(
+                   SkImageFilters::Offset(6, -4, link(
+                   SkImageFilters::ColorFilter(tint, link(
+                   SkImageFilters::Offset(-3, 9, link(nullptr))))))));
+        }, true },
+        { "cropped offset", [&](Link link) {
+            return SkImageFilters::ColorFilter(matrix, link(
+                   SkImageFilters::Offset(6, -4, link(
+                   SkImageFilters::ColorFilter(tint, link(nullptr))), &crop)));
+        }, false },
+        { "merge", [&](Link link) {
+            sk_sp<SkImageFilter> inputs[] = {
+                link(SkImageFilters::ColorFilter(matrix, link(
+                     SkImageFilters::Offset(5, 3, link(nullptr))))),
+                link(SkImageFilters::ColorFilter(tint, link(
+                     SkImageFilters::ColorFilter(tint2, link(nullptr))))),
+                link(SkImageFilters::Offset(-2, -7, link(
+                     SkImageFilters::Blur(2, 2, nullptr)))),
+            };
+            return SkImageFilters::Merge(inputs, SK_ARRAY_COUNT(inputs));
+        }, true },
+        { "xfermode", [&](Link link) {
+            return SkImageFilters::Xfermode(SkBlendMode::kScreen,
+                   link(SkImageFilters::ColorFilter(matrix, link(
+                        SkImageFilters::Offset(4, -6, link(nullptr))))),
+                   link(SkImageFilters::ColorFilter(tint, link(
+                        SkImageFilters::ColorFilter(tint2, link(nullptr))))));
+        }, true },
+    };
+
+    Link fuse = [](sk_sp<SkImageFilter> filter) { return filter; },
+         dontFuse = [](sk_sp<SkImageFilter> filter) -> sk_sp<SkImageFilter> {
+             return sk_make_sp<PassThroughImageFilter>(std::move(filter));
+         };
+
+    for (const auto& test : tests) {
+        SkBitmap fused, unfused;
+        SkIPoint fusedOffset, unfusedOffset;
+        if (!filter_on_executor(test.fMake(fuse).get(), src.get(), nullptr, &fused,
+                                &fusedOffset) ||
+            !filter_on_executor(test.fMake(dontFuse).get(), src.get(), nullptr, &unfused,
+                                &unfusedOffset)) {
+            ERRORF(reporter, "%s: could not filter", test.fName);
+            continue;
+        }
+        REPORTER_ASSERT(reporter, fusedOffset == unfusedOffset, test.fName);
+        if (fused.dimensions() != unfused.dimensions()) {
+            ERRORF(reporter, "%s: %dx%d fused, %dx%d unfused", test.fName,
+                   fused.width(), fused.height(), unfused.width(), unfused.height());
+            continue;
+        }
+
+        int maxDiff = 0;
+        for (int y = 0; y < fused.height(); ++y) {
+            for (int x = 0; x < fused.width(); ++x) {
+                SkPMColor a = *fused.getAddr32(x, y),
+                          b = *unfused.getAddr32(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    maxDiff = std::max(maxDiff, abs(int((a >> shift) & 0xFF) -
+                                                    int((b >> shift) & 0xFF)));
+                }
+            }
+        }
+        // A cropped offset isn't fused, so nothing changes at all.
+        REPORTER_ASSERT(reporter, maxDiff <= (test.fFuses ? 2 : 0), "%s: max diff %d",
+                        test.fName, maxDiff);
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "tests/Test.h"
 
+#include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "src/core/SkArenaAlloc.h"
@@ -454,3 +455,103 @@ DEF_TEST(JSON_ParseNumber, reporter) {
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(**jnumber, test.value, test.tolerance));
     }
 }
+
+DEF_TEST(JSON_ParseLongString, reporter) {
+    // Exercise the (chunked) string scanning with special chars at all offsets.
+    static constexpr size_t kMaxLen = 70;
+
+    for (size_t len = 0; len <= kMaxLen; ++len) {
+        SkString plain(len);
+        memset(plain.writable_str(), 'x', len);
+        for (size_t pos = 0; pos <= len; ++pos) {
+            SkString str(plain);
+            if (pos < len) {
+                str.writable_str()[pos] = '}';
+            }
+
+            // Plain strings, and strings with special chars.
+            for (const auto& s : { str, SkStringPrintf("%s\\n%s", str.c_str(), str.c_str()) }) {
+                const auto json = SkStringPrintf("[\"%s\"]", s.c_str());
+                const DOM dom(json.c_str(), json.size());
+                const ArrayValue* array = dom.root();
+                REPORTER_ASSERT(reporter, array && array->size() == 1);
+                REPORTER_ASSERT(reporter, (*array)[0].is<StringValue>());
+            }
+
+            // Control chars are rejected.
+            if (pos < len) {
+                str.writable_str()[pos] = '\t';
+                const auto json = SkStringPrintf("[\"%s\"]", str.c_str());
+                const DOM dom(json.c_str(), json.size());
+                REPORTER_ASSERT(reporter, dom.root().is<NullValue>());
+            }
+        }
+
+        // Unterminated strings are rejected.
+        const auto json = SkStringPrintf("[\"%s]", plain.c_str());
+        const DOM dom(json.c_str(), json.size());
+        REPORTER_ASSERT(reporter, dom.root().is<NullValue>());
+    }
+}
+
+DEF_TEST(JSON_Binary, reporter) {
+    static constexpr const char* g_tests[] = {
+        "[]",
+        "{}",
+        "[[],{},[{}]]",
+        "[null,true,false,0,-1,12.8,-0.5,2147483647,-2147483648,1e+20]",
+        "[\"\",\"123456\",\"1234567\",\"foo\\nbar\",\"\\u1234\"]",
+        "{\"k1\":null,\"k2\":0,\"k3\":[true,"
+            "{\"kk1\":\"foo\",\"kk2\":\"bar\",\"kk3\":1.28,\"kk4\":[42]},\"boo\",null]}",
+    };
+
+    const auto to_text = [](const DOM& dom) {
+        SkDynamicMemoryWStream str;
+        dom.write(&str);
+        auto data = str.detachAsData();
+        return SkString(static_cast<const char*>(data->data()), data->size());
+    };
+
+    for (const auto* tst : g_tests) {
+        const DOM dom(tst, strlen(tst));
+        REPORTER_ASSERT(reporter, !dom.root().is<NullValue>());
+
+        SkDynamicMemoryWStream bstr;
+        dom.writeBinary(&bstr);
+        const auto bin = bstr.detachAsData();
+        REPORTER_ASSERT(reporter,  DOM::IsBinary(bin->data(), bin->size()));
+        REPORTER_ASSERT(reporter, !DOM::IsBinary(tst, strlen(tst)));
+
+        // Round trip.
+        const DOM bdom(static_cast<const char*>(bin->data()), bin->size());
+        REPORTER_ASSERT(reporter, to_text(bdom).equals(to_text(dom)));
+
+        // Truncated or padded inputs are rejected.
+        for (size_t i = 0; i < bin->size(); ++i) {
+            const DOM truncated(static_cast<const char*>(bin->data()), i);
+            REPORTER_ASSERT(reporter, truncated.root().is<NullValue>());
+        }
+
+        auto padded = SkData::MakeUninitialized(bin->size() + 1);
+        memcpy(padded->writable_data(), bin->data(), bin->size());
+        static_cast<char*>(padded->writable_data())[bin->size()] = '\0';
+        const DOM padded_dom(static_cast<const char*>(padded->data()), padded->size());
+        REPORTER_ASSERT(reporter, padded_dom.root().is<NullValue>());
+    }
+
+    // Numbers preserve their int/float representation.
+    {
+        static constexpr char json[] = "[1,1.5,-2.25]";
+        const DOM dom(json, strlen(json));
+        SkDynamicMemoryWStream bstr;
+        dom.writeBinary(&bstr);
+        const auto bin = bstr.detachAsData();
+        const DOM bdom(static_cast<const char*>(bin->data()), bin->size());
+
+        const ArrayValue* array = bdom.root();
+        REPORTER_ASSERT(reporter, array && array->size() == 3);
+        REPORTER_ASSERT(reporter, *(*array)[0].as<NumberValue>() == 1);
+        REPORTER_ASSERT(reporter, *(*array)[1].as<NumberValue>() == 1.5);
+        REPORTER_ASSERT(reporter, *(*array)[2].as<NumberValue>() == -2.25);
+    }
+}
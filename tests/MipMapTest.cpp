@@ -6,8 +6,11 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
+#include "include/private/SkTemplates.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkMipmap.h"
+#include "src/core/SkOpts.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
@@ -211,6 +214,80 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+// Big levels are built in bands on an SkExecutor; that should not change any pixels.
+DEF_TEST(MipMap_Threaded, reporter) {
+    std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(4);
+
+    SkRandom rand;
+    for (SkColorType ct : {kN32_SkColorType, kAlpha_8_SkColorType, kRGBA_F16_SkColorType}) {
+        for (int size : {600, 601}) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, size, ct, kPremul_SkAlphaType));
+            // Random bits are fine for 8888 and A8; keep F16 finite by clearing the top exponent
+            // bit of each half.
+            auto bits = (uint32_t*)bm.getPixels();
+            uint32_t keep = ct == kRGBA_F16_SkColorType ? 0xbfffbfff : 0xffffffff;
+            for (size_t i = 0; i < bm.computeByteSize() / 4; ++i) {
+                bits[i] = rand.nextU() & keep;
+            }
+
+            sk_sp<SkMipmap> serial(SkMipmap::Build(bm, nullptr));
+            sk_sp<SkMipmap> threaded(SkMipmap::Build(bm, nullptr, pool.get()));
+
+            REPORTER_ASSERT(reporter, serial->countLevels() == threaded->countLevels());
+            for (int i = 0; i < serial->countLevels(); ++i) {
+                SkMipmap::Level a, b;
+                serial->getLevel(i, &a);
+                threaded->getLevel(i, &b);
+                const SkPixmap& pa = a.fPixmap;
+                const SkPixmap& pb = b.fPixmap;
+                for (int y = 0; y < pa.height(); ++y) {
+                    REPORTER_ASSERT(reporter, !memcmp(pa.addr(0, y), pb.addr(0, y),
+                                                      pa.info().minRowBytes()));
+                }
+            }
+        }
+    }
+}
+
+// The vectorized 2x2 box filters must match the portable ones exactly, including the scalar loops
+// that finish off counts their vectors don't divide.
+DEF_TEST(MipMap_Downsample2x2Opts, reporter) {
+    const struct {
+        SkColorType fColorType;
+        void (*fProc)(void*, const void*, size_t, int);
+        const char* fName;
+    } kernels[] = {
+        { kN32_SkColorType,      SkOpts::downsample_2_2_8888, "8888" },
+        { kAlpha_8_SkColorType,  SkOpts::downsample_2_2_a8,   "a8"   },
+        { kRGBA_F16_SkColorType, SkOpts::downsample_2_2_f16,  "f16"  },
+    };
+
+    SkRandom rand;
+    for (const auto& kernel : kernels) {
+        const size_t bpp = SkColorTypeBytesPerPixel(kernel.fColorType);
+        for (int count : {1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 257}) {
+            // Two rows of 2*count pixels, with some slack past the end of each.
+            const size_t srcRB = (2 * count + 3) * bpp;
+            SkAutoTMalloc<uint32_t> src((2 * srcRB + 3) / 4);
+            // Random bits are fine for 8888 and A8; keep F16 finite by clearing the top exponent
+            // bit of each half.
+            uint32_t keep = kernel.fColorType == kRGBA_F16_SkColorType ? 0xbfffbfff : 0xffffffff;
+            for (size_t i = 0; i < (2 * srcRB + 3) / 4; ++i) {
+                src[i] = rand.nextU() & keep;
+            }
+
+            SkAutoTMalloc<char> expected(count * bpp),
+                                actual(count * bpp);
+            SkMipmap::PortableDownsample2x2(kernel.fColorType, expected.get(), src.get(), srcRB,
+                                            count);
+            kernel.fProc(actual.get(), src.get(), srcRB, count);
+            REPORTER_ASSERT(reporter, !memcmp(actual.get(), expected.get(), count * bpp),
+                            "%s, count %d", kernel.fName, count);
+        }
+    }
+}
+
 #include "include/core/SkCanvas.h"
 #include "include/core/SkSurface.h"
 
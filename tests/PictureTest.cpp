@@ -11,29 +11,39 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixelRef.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkShader.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/core/SkVertices.h"
+#include "include/effects/SkImageFilters.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkClipOpPriv.h"
 #include "src/core/SkMiniRecorder.h"
 #include "src/core/SkPicturePriv.h"
+#include "src/core/SkRecord.h"
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
 
 #include <memory>
+#include <vector>
 
 class SkRRect;
 class SkRegion;
@@ -999,3 +1009,331 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+namespace {
+struct RestoreMatrices {
+    std::vector<SkMatrix> matrices;
+    void operator()(const SkRecords::Restore& op) { matrices.push_back(op.matrix); }
+    template <typename T> void operator()(const T&) {}
+};
+}  // namespace
+
+DEF_TEST(Picture_RecordSerialization, r) {
+    SkPictureRecorder recorder;
+
+    SkCanvas* canvas = recorder.beginRecording({0,0, 50,50});
+    for (int i = 0; i < 10; i++) {
+        SkPaint paint;
+        paint.setColor(0xff000000 | (i * 0x151515));
+        canvas->drawRect(SkRect::MakeXYWH(5*i, 0, 5, 50), paint);
+    }
+    sk_sp<SkPicture> nested = recorder.finishRecordingAsPicture();
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorBLUE);
+    bitmap.erase(SK_ColorYELLOW, SkIRect::MakeWH(8, 8));
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(40, 0, 0, 40, 60, 60);
+    path.close();
+
+    const SkPoint pts[] = {{5, 100}, {60, 90}, {30, 120}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+
+    SkPaint fill, stroke;
+    fill.setAntiAlias(true);
+    fill.setColor(SK_ColorRED);
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(3);
+    stroke.setColor(SK_ColorGREEN);
+
+    canvas = recorder.beginRecording({0,0, 128,128});
+    canvas->drawColor(SK_ColorWHITE);
+    canvas->save();
+        canvas->translate(5, 5);
+        canvas->clipRect({0,0, 110,110}, true);
+        canvas->drawPath(path, fill);
+        canvas->drawPath(path, stroke);
+        canvas->drawRRect(SkRRect::MakeRectXY({70,5, 120,40}, 8, 8), fill);
+        canvas->drawDRRect(SkRRect::MakeOval({70,45, 120,95}),
+                           SkRRect::MakeOval({80,55, 110,85}), stroke);
+        canvas->save();
+            canvas->rotate(15);
+            canvas->scale(0.5f, 0.75f);
+            canvas->drawOval({10,10, 60,30}, stroke);
+        canvas->restore();
+    canvas->restore();
+    canvas->saveLayer(SkRect{0,64, 64,128}, nullptr);
+        canvas->clipPath(path, SkClipOp::kDifference, true);
+        canvas->drawImage(image, 2, 66);
+        canvas->drawImageRect(image, SkRect::MakeXYWH(20, 66, 40, 20), nullptr);
+        canvas->drawPoints(SkCanvas::kPolygon_PointMode, SK_ARRAY_COUNT(pts), pts, stroke);
+        canvas->drawVertices(SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, 3, pts,
+                                                  nullptr, colors), SkBlendMode::kModulate,
+                             fill);
+    canvas->restore();
+    SkMatrix matrix = SkMatrix::Translate(64, 64);
+    SkPaint alpha;
+    alpha.setAlpha(0x80);
+    canvas->drawPicture(nested, &matrix, &alpha);
+    canvas->drawArc({70,100, 120,128}, 0, 200, true, fill);
+    canvas->drawRegion(SkRegion({100,0, 128,20}), stroke);
+    canvas->drawTextBlob(SkTextBlob::MakeFromString("Skia", SkFont(nullptr, 12)), 5, 60, fill);
+    canvas->drawAnnotation({0,0, 10,10}, "key", SkData::MakeWithCString("value").get());
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkDynamicMemoryWStream stream;
+    SkPicturePriv::SerializeRecord(picture.get(), &stream);
+    sk_sp<SkData> data = stream.detachAsData();
+
+    sk_sp<SkPicture> copy = SkPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, copy);
+    REPORTER_ASSERT(r, SkPicturePriv::AsSkBigPicture(copy));
+    REPORTER_ASSERT(r, copy->cullRect() == picture->cullRect());
+    REPORTER_ASSERT(r, copy->approximateOpCount(true) == picture->approximateOpCount(true));
+
+    auto draw = [](const sk_sp<SkPicture>& pic) {
+        SkBitmap bm;
+        bm.allocN32Pixels(128, 128);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(bm).drawPicture(pic);
+        return bm;
+    };
+    // Restore ops don't store their matrix, but should recreate the same one.
+    auto restore_matrices = [](const sk_sp<SkPicture>& pic) {
+        RestoreMatrices visitor;
+        if (const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(pic)) {
+            for (int i = 0; i < big->record()->count(); i++) {
+                big->record()->visit(i, visitor);
+            }
+        }
+        return visitor;
+    };
+    RestoreMatrices before = restore_matrices(picture),
+                    after  = restore_matrices(copy);
+    REPORTER_ASSERT(r, before.matrices.size() == 3);
+    REPORTER_ASSERT(r, before.matrices == after.matrices);
+
+    // Should draw just like a round trip through the SkPictureData format.
+    SkBitmap expected = draw(SkPicture::MakeFromData(picture->serialize().get())),
+             actual   = draw(copy);
+    REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                               expected.computeByteSize()));
+
+    // Truncated data must be rejected.
+    for (size_t size = 0; size < data->size(); size += 7) {
+        REPORTER_ASSERT(r, !SkPicture::MakeFromData(data->data(), size), "size %zu", size);
+    }
+}
+
+DEF_TEST(Picture_LazyRecordSerialization, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorMAGENTA);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording({0,0, 20,20});
+    canvas->drawCircle(10, 10, 8, SkPaint());
+    sk_sp<SkPicture> nested = recorder.finishRecordingAsPicture();
+
+    canvas = recorder.beginRecording({0,0, 256,256});
+    for (int y = 0; y < 256; y += 32) {
+        for (int x = 0; x < 256; x += 32) {
+            SkPaint paint;
+            paint.setColor(0xff000000 | (x << 16) | (y << 8));
+            canvas->save();
+                canvas->translate(x, y);
+                canvas->clipRect({0,0, 30,30});
+                canvas->drawRect({2,2, 28,28}, paint);
+                if ((x + y) % 64 == 0) {
+                    canvas->drawPicture(nested);
+                } else {
+                    canvas->drawImage(image, 20, 20);
+                }
+            canvas->restore();
+        }
+    }
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkDynamicMemoryWStream stream;
+    SkPicturePriv::SerializeRecord(picture.get(), &stream, nullptr, /*writeIndex=*/true);
+    sk_sp<SkData> data = stream.detachAsData();
+
+    // Loading eagerly should reuse the serialized R-tree.
+    sk_sp<SkPicture> eager = SkPicture::MakeFromData(data.get());
+    const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(eager);
+    REPORTER_ASSERT(r, big && big->bbh());
+
+    sk_sp<SkPicture> lazy = SkPicturePriv::MakeLazyFromData(data);
+    REPORTER_ASSERT(r, lazy && !SkPicturePriv::AsSkBigPicture(lazy));
+    REPORTER_ASSERT(r, lazy->cullRect() == picture->cullRect());
+    REPORTER_ASSERT(r, lazy->approximateOpCount() == eager->approximateOpCount());
+
+    // Draw the whole picture, and then tile by tile so that only some ops are decoded.
+    auto draw = [](const sk_sp<SkPicture>& pic, const SkIRect& tile) {
+        SkBitmap bm;
+        bm.allocN32Pixels(tile.width(), tile.height());
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bm);
+        canvas.translate(-tile.x(), -tile.y());
+        canvas.drawPicture(pic);
+        return bm;
+    };
+    for (SkIRect tile : {SkIRect::MakeWH(256, 256), SkIRect::MakeXYWH(0, 0, 50, 50),
+                         SkIRect::MakeXYWH(100, 60, 64, 64), SkIRect::MakeXYWH(230, 200, 26, 56)}) {
+        SkBitmap expected = draw(eager, tile),
+                 actual   = draw(lazy, tile);
+        REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()),
+                        "tile %d %d", tile.x(), tile.y());
+    }
+
+    // Without an index, fall back to loading the picture as usual.
+    SkDynamicMemoryWStream noIndex;
+    SkPicturePriv::SerializeRecord(picture.get(), &noIndex);
+    REPORTER_ASSERT(r, SkPicturePriv::AsSkBigPicture(
+                               SkPicturePriv::MakeLazyFromData(noIndex.detachAsData())));
+
+    // Truncated data must be rejected.
+    for (size_t size = 0; size < data->size(); size += 7) {
+        sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, size);
+        REPORTER_ASSERT(r, !SkPicturePriv::MakeLazyFromData(truncated), "size %zu", size);
+    }
+}
+
+DEF_TEST(Picture_RecordSerializationPathFillType, r) {
+    // Changing the fill type keeps the path's generation ID, but the paths must not be merged.
+    SkPath path;
+    path.addCircle(20, 20, 10);
+    SkPath inverse = path;
+    inverse.setFillType(SkPathFillType::kInverseWinding);
+    REPORTER_ASSERT(r, path.getGenerationID() == inverse.getGenerationID());
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording({0,0, 80,40});
+    canvas->drawPath(path, SkPaint());
+    canvas->translate(40, 0);
+    canvas->clipRect({0,0, 40,40});
+    canvas->drawPath(inverse, SkPaint());
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkDynamicMemoryWStream stream;
+    SkPicturePriv::SerializeRecord(picture.get(), &stream);
+    sk_sp<SkPicture> copy = SkPicture::MakeFromData(stream.detachAsData().get());
+    REPORTER_ASSERT(r, copy);
+
+    auto draw = [](const sk_sp<SkPicture>& pic) {
+        SkBitmap bm;
+        bm.allocN32Pixels(80, 40);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(bm).drawPicture(pic);
+        return bm;
+    };
+    SkBitmap expected = draw(picture),
+             actual   = draw(copy);
+    REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                               expected.computeByteSize()));
+}
+
+static sk_sp<SkPicture> make_tiled_playback_picture(bool readsBack) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(10, 10);
+    bitmap.eraseColor(SK_ColorCYAN);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkRandom rand;
+    auto point = [&] { return SkPoint{rand.nextRangeF(-20, 320), rand.nextRangeF(-20, 220)}; };
+    auto rect  = [&] {
+        return SkRect::MakeXYWH(rand.nextRangeF(-10, 230), rand.nextRangeF(-10, 130),
+                                rand.nextRangeF(1, 60), rand.nextRangeF(1, 60));
+    };
+
+    SkCanvas* canvas = recorder.beginRecording({-40,-40, 360,280}, &factory);
+    for (int i = 0; i < 300; i++) {
+        SkPaint paint;
+        paint.setColor(rand.nextU() | 0x80000000);
+        paint.setAntiAlias(i % 3 != 0);
+        if (i % 5 == 1) {
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(rand.nextRangeF(0, 4));
+        }
+        switch (i % 8) {
+            case 0: canvas->drawRect(rect(), paint); break;
+            case 1: canvas->drawImageRect(image, rect(), &paint); break;
+            case 2: canvas->drawOval(rect(), paint); break;
+            case 3: {
+                SkPath path;
+                path.moveTo(point());
+                path.quadTo(point(), point());
+                path.cubicTo(point(), point(), point());
+                path.lineTo(point());
+                canvas->drawPath(path, paint);
+            } break;
+            case 4: {
+                SkPoint p0 = point(), p1 = point();
+                canvas->drawLine(p0, p1, paint);
+            } break;
+            case 5:
+                canvas->save();
+                    canvas->clipRRect(SkRRect::MakeOval(rect().makeOutset(20, 20)), i % 2);
+                    canvas->drawPaint(paint);
+                canvas->restore();
+                break;
+            case 6: {
+                SkRect bounds = rect();
+                canvas->saveLayerAlpha(&bounds, 0x80);
+                    canvas->drawRect(bounds.makeOffset(10, 10), paint);
+                canvas->restore();
+            } break;
+            case 7: {
+                SkPaint layerPaint;
+                layerPaint.setImageFilter(SkImageFilters::Blur(3, 2, nullptr));
+                SkRect bounds = rect();
+                canvas->saveLayer(&bounds, &layerPaint);
+                    canvas->drawOval(bounds.makeInset(5, 5), paint);
+                canvas->restore();
+            } break;
+        }
+    }
+    if (readsBack) {
+        sk_sp<SkImageFilter> blur = SkImageFilters::Blur(4, 4, nullptr);
+        canvas->saveLayer(SkCanvas::SaveLayerRec(nullptr, nullptr, blur.get(), 0));
+        canvas->restore();
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+DEF_TEST(Picture_TiledPlayback, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (bool readsBack : {false, true}) {
+        sk_sp<SkPicture> picture = make_tiled_playback_picture(readsBack);
+        for (const SkMatrix& matrix : {SkMatrix::I(),
+                                       SkMatrix::Translate(-7.5f, 3),
+                                       SkMatrix::Scale(1.7f, 1.3f),
+                                       SkMatrix::RotateDeg(7)}) {
+            SkBitmap expected;
+            expected.allocN32Pixels(320, 240);
+            expected.eraseColor(SK_ColorWHITE);
+            SkCanvas canvas(expected);
+            canvas.concat(matrix);
+            picture->playback(&canvas);
+
+            for (SkISize tile : {SkISize{320, 240}, SkISize{64, 64}, SkISize{37, 29}}) {
+                SkBitmap actual;
+                actual.allocN32Pixels(320, 240);
+                actual.eraseColor(SK_ColorWHITE);
+                SkPicturePriv::PlaybackTiled(picture.get(), actual.pixmap(), matrix,
+                                             executor.get(), tile.width(), tile.height());
+                REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                                           expected.computeByteSize()),
+                                "tile %dx%d", tile.width(), tile.height());
+            }
+        }
+    }
+}
@@ -25,10 +25,11 @@ static SkRect random_rect(SkRandom& rand) {
     return rect;
 }
 
-static bool verify_query(SkRect query, SkRect rects[], const std::vector<int>& found) {
+static bool verify_query(SkRect query, SkRect rects[], const std::vector<int>& found,
+                         int numRects = NUM_RECTS) {
     std::vector<int> expected;
     // manually intersect with every rectangle
-    for (int i = 0; i < NUM_RECTS; ++i) {
+    for (int i = 0; i < numRects; ++i) {
         if (SkRect::Intersects(query, rects[i])) {
             expected.push_back(i);
         }
@@ -89,3 +90,120 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(RTree_BatchedSearch, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (int i = 0; i < NUM_RECTS; i++) {
+        rects[i] = random_rect(rand);
+    }
+    SkRTree rtree;
+    rtree.insert(rects.get(), NUM_RECTS);
+
+    // A grid of tiles, plus an empty query and one that misses everything.
+    std::vector<SkRect> queries;
+    for (int y = 0; y < 1000; y += 125) {
+        for (int x = 0; x < 1000; x += 250) {
+            queries.push_back(SkRect::MakeXYWH(x, y, 250, 125));
+        }
+    }
+    queries.push_back(SkRect::MakeEmpty());
+    queries.push_back(SkRect::MakeXYWH(2000, 2000, 10, 10));
+
+    std::vector<std::vector<int>> results(queries.size());
+    results[0].push_back(-1);  // Results are appended.
+    rtree.search(queries.data(), (int)queries.size(), results.data());
+    REPORTER_ASSERT(reporter, results[0].front() == -1);
+    results[0].erase(results[0].begin());
+
+    for (size_t i = 0; i < queries.size(); i++) {
+        std::vector<int> expected;
+        rtree.search(queries[i], &expected);
+        REPORTER_ASSERT(reporter, results[i] == expected);
+        REPORTER_ASSERT(reporter, verify_query(queries[i], rects, results[i]));
+    }
+}
+
+DEF_TEST(RTree_HilbertPack, reporter) {
+    // Enough rects to sort them along a Hilbert curve, some of them empty.
+    const int numRects = SkRTree::kMinHilbertPackCount + 100;
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(numRects);
+    int count = 0;
+    for (int i = 0; i < numRects; i++) {
+        rects[i] = i % 17 ? random_rect(rand) : SkRect::MakeEmpty();
+        count += !rects[i].isEmpty();
+    }
+    SkRTree rtree;
+    rtree.insert(rects.get(), numRects);
+    REPORTER_ASSERT(reporter, count == rtree.getCount());
+
+    std::vector<SkRect> queries;
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        queries.push_back(random_rect(rand));
+    }
+    std::vector<std::vector<int>> results(queries.size());
+    rtree.search(queries.data(), (int)queries.size(), results.data());
+
+    for (size_t i = 0; i < queries.size(); i++) {
+        std::vector<int> hits;
+        rtree.search(queries[i], &hits);
+        REPORTER_ASSERT(reporter, verify_query(queries[i], rects, hits, numRects));
+        REPORTER_ASSERT(reporter, results[i] == hits);
+    }
+}
+
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkWriteBuffer.h"
+
+// MakeFromBuffer() must only accept trees: every node but the root referenced exactly once.
+DEF_TEST(RTree_MakeFromBuffer, reporter) {
+    const SkRect bounds = {0, 0, 10, 10};
+    struct Node {
+        int              level;
+        std::vector<int> children;
+    };
+    auto load = [&](const std::vector<Node>& nodes) {
+        SkBinaryWriteBuffer writer;
+        writer.writeUInt(SkToU32(nodes.size()));
+        for (const Node& node : nodes) {
+            writer.writeUInt(SkToU32(node.children.size()) | (uint32_t)node.level << 16);
+            for (int child : node.children) {
+                writer.writeRect(bounds);
+                writer.writeInt(child);
+            }
+        }
+        sk_sp<SkData> data = writer.snapshotAsData();
+        SkReadBuffer reader(data->data(), data->size());
+        return SkRTree::MakeFromBuffer(reader, 4);
+    };
+
+    // Two leaves under one root is fine.
+    sk_sp<SkRTree> tree = load({{0, {0, 1}}, {0, {2, 3}}, {1, {0, 1}}});
+    REPORTER_ASSERT(reporter, tree && tree->getCount() == 4);
+
+    // One leaf shared by two parents.
+    REPORTER_ASSERT(reporter, !load({{0, {0, 1}}, {1, {0}}, {1, {0}}, {2, {1, 2}}}));
+    // ... or twice by the same parent.
+    REPORTER_ASSERT(reporter, !load({{0, {0, 1}}, {1, {0, 0}}}));
+    // A leaf that isn't under the root.
+    REPORTER_ASSERT(reporter, !load({{0, {0, 1}}, {0, {2, 3}}, {1, {1}}}));
+
+    // A round trip through flatten() still loads, and finds the same ops.
+    SkRandom rand;
+    SkRect rects[NUM_RECTS];
+    for (SkRect& r : rects) {
+        r = random_rect(rand);
+    }
+    SkRTree rtree;
+    rtree.insert(rects, NUM_RECTS);
+    SkBinaryWriteBuffer writer;
+    rtree.flatten(writer);
+    sk_sp<SkData> data = writer.snapshotAsData();
+    SkReadBuffer reader(data->data(), data->size());
+    tree = SkRTree::MakeFromBuffer(reader, NUM_RECTS);
+    REPORTER_ASSERT(reporter, tree && tree->getCount() == rtree.getCount());
+    if (tree) {
+        run_queries(reporter, rand, rects, *tree);
+    }
+}
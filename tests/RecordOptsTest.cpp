@@ -8,11 +8,13 @@
 #include "tests/RecordTestUtils.h"
 #include "tests/Test.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordOpts.h"
 #include "src/core/SkRecorder.h"
 #include "src/core/SkRecords.h"
@@ -414,3 +416,187 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_MergeMatrices, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.save();
+        recorder.translate(10, 0);
+        recorder.translate(0, 20);
+        recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+        recorder.scale(2, 2);
+        recorder.scale(0.5f, 0.5f);
+        recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.restore();
+
+    REPORTER_ASSERT(r, 3 == SkRecordMergeMatrices(&record));
+    assert_type<SkRecords::Save>(r, record, 0);
+    auto translate = assert_type<SkRecords::Translate>(r, record, 1);
+    REPORTER_ASSERT(r, translate->dx == 10 && translate->dy == 20);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+    assert_type<SkRecords::NoOp>(r, record, 4);
+    assert_type<SkRecords::NoOp>(r, record, 5);
+    assert_type<SkRecords::DrawRect>(r, record, 6);
+}
+
+DEF_TEST(RecordOpts_NoopDeadState, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    // Nothing draws inside this save.
+    recorder.save();
+        recorder.translate(10, 10);
+        recorder.clipRect(SkRect::MakeWH(50, 50));
+    recorder.restore();
+
+    // This clip can't shrink the clip, and the translate is only used by the dead draw.
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(W, H));
+        recorder.clipRect(SkRect::MakeWH(100, 100));
+        recorder.drawRect(SkRect::MakeWH(50, 50), SkPaint());
+        recorder.translate(500, 500);
+        recorder.drawRect(SkRect::MakeWH(50, 50), SkPaint());
+    recorder.restore();
+
+    REPORTER_ASSERT(r, 7 == SkRecordNoopDeadState(&record, SkRect::MakeWH(W, H)));
+    for (int i = 0; i < 4; i++) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    assert_type<SkRecords::Save>(r, record, 4);
+    assert_type<SkRecords::NoOp>(r, record, 5);
+    assert_type<SkRecords::ClipRect>(r, record, 6);
+    assert_type<SkRecords::DrawRect>(r, record, 7);
+    assert_type<SkRecords::NoOp>(r, record, 8);
+    assert_type<SkRecords::NoOp>(r, record, 9);
+    assert_type<SkRecords::Restore>(r, record, 10);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint translucent;
+    translucent.setAlpha(0x80);
+
+    recorder.drawRect(SkRect::MakeXYWH(20, 20, 50, 50), SkPaint());     // Occluded.
+    recorder.saveLayer(nullptr, nullptr);
+        recorder.drawRect(SkRect::MakeWH(W, H), SkPaint());            // In a layer.
+    recorder.restore();
+    recorder.drawRect(SkRect::MakeXYWH(150, 20, 50, 50), SkPaint());    // Partly covered.
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 100, 100), translucent); // Occluded.
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(180, 200));
+        recorder.drawRect(SkRect::MakeWH(W, H), SkPaint());
+    recorder.restore();
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 100, 100), translucent); // Not an occluder.
+
+    REPORTER_ASSERT(r, 2 == SkRecordNoopOccludedDraws(&record, SkRect::MakeWH(W, H)));
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::DrawRect>(r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 4);
+    assert_type<SkRecords::NoOp>(r, record, 5);
+    assert_type<SkRecords::DrawRect>(r, record, 10);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws_ReadBack, r) {
+    sk_sp<SkImageFilter> blur = SkImageFilters::Blur(3, 3, nullptr);
+    SkCanvas::SaveLayerRec backdrop(nullptr, nullptr, blur.get(), 0),
+                           initWithPrevious(nullptr, nullptr,
+                                            SkCanvas::kInitWithPrevious_SaveLayerFlag);
+
+    for (const SkCanvas::SaveLayerRec& rec : {backdrop, initWithPrevious}) {
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+
+        // The layer reads this rect before the draw after it covers it.
+        recorder.drawRect(SkRect::MakeXYWH(20, 20, 50, 50), SkPaint());
+        recorder.saveLayer(rec);
+            recorder.drawRect(SkRect::MakeXYWH(100, 100, 10, 10), SkPaint());
+        recorder.restore();
+        recorder.drawRect(SkRect::MakeWH(W, H), SkPaint());
+
+        REPORTER_ASSERT(r, 0 == SkRecordNoopOccludedDraws(&record, SkRect::MakeWH(W, H)));
+        assert_type<SkRecords::DrawRect>(r, record, 0);
+    }
+}
+
+DEF_TEST(RecordOpts_BatchImageRects, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint paint;
+    paint.setAlpha(0x80);
+    recorder.drawImageRect(image, SkRect::MakeWH(10, 10), &paint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(2, 2, 4, 4), SkRect::MakeXYWH(10, 0, 10, 10),
+                           &paint, SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(20, 0, 10, 10), &paint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(30, 0, 10, 10), nullptr);
+
+    REPORTER_ASSERT(r, 2 == SkRecordBatchImageRects(&record));
+    auto set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 0);
+    REPORTER_ASSERT(r, set->count == 3);
+    REPORTER_ASSERT(r, *set->paint == paint);
+    REPORTER_ASSERT(r, set->set[1].fSrcRect == SkRect::MakeXYWH(2, 2, 4, 4));
+    REPORTER_ASSERT(r, set->set[2].fSrcRect == SkRect::MakeWH(8, 8));
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::DrawImageRect>(r, record, 3);
+}
+
+// Draws the same thing into each record, optimizing one of them, and checks they render alike.
+DEF_TEST(RecordOpts_WholePicture, r) {
+    const SkRect cull = SkRect::MakeWH(256, 256);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorGREEN);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkRecord records[2];
+    for (SkRecord& record : records) {
+        SkRecorder recorder(&record, cull);
+
+        SkPaint paint;
+        recorder.drawColor(SK_ColorWHITE);
+        for (int i = 0; i < 40; i++) {
+            paint.setColor(0xFF000000 | (i * 0x1F3D5B));
+            paint.setAlpha(i % 3 ? 0xFF : 0x80);
+            recorder.save();
+                recorder.translate(i * 7 % 200, i * 13 % 200);
+                recorder.scale(i % 2 + 1, i % 2 + 1);
+                if (i % 5 == 0) {
+                    recorder.clipRect(SkRect::MakeWH(40, 40));
+                }
+                if (i % 4 == 0) {
+                    recorder.drawImageRect(image, SkRect::MakeWH(30, 30), &paint);
+                    recorder.drawImageRect(image, SkRect::MakeXYWH(30, 0, 20, 20), &paint);
+                } else {
+                    recorder.drawRect(SkRect::MakeWH(30 + i, 20), paint);
+                }
+            recorder.restore();
+            if (i % 7 == 0) {
+                recorder.save();
+                    recorder.translate(300, 0);
+                    recorder.drawRect(SkRect::MakeWH(20, 20), paint);
+                recorder.restore();
+            }
+        }
+    }
+    SkRecordOptimizeWholePicture(&records[1], cull);
+    REPORTER_ASSERT(r, records[1].count() < records[0].count());
+
+    SkBitmap bitmaps[2];
+    for (int i = 0; i < 2; i++) {
+        bitmaps[i].allocN32Pixels(256, 256);
+        SkCanvas canvas(bitmaps[i]);
+        SkRecordDraw(records[i], &canvas, nullptr, nullptr, 0, nullptr, nullptr);
+    }
+    REPORTER_ASSERT(r, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                                   bitmaps[0].computeByteSize()));
+}
@@ -5,8 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "tests/RecordTestUtils.h"
 #include "tests/Test.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImageGenerator.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
@@ -108,3 +113,75 @@ DEF_TEST(Recorder_drawImage_takeReference, reporter) {
     }
     REPORTER_ASSERT(reporter, image->unique());
 }
+
+DEF_TEST(Recorder_DedupContent, r) {
+    auto make_raster = [](SkColor color) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(16, 16);
+        bitmap.eraseColor(color);
+        bitmap.setImmutable();
+        return SkImage::MakeFromBitmap(bitmap);
+    };
+    sk_sp<SkImage> green0 = make_raster(SK_ColorGREEN),
+                   green1 = make_raster(SK_ColorGREEN),
+                   blue   = make_raster(SK_ColorBLUE);
+
+    // Two lazy images made from separate copies of the same "encoded" bytes.
+    struct Generator : public SkImageGenerator {
+        Generator() : SkImageGenerator(SkImageInfo::MakeN32Premul(16, 16)) {}
+        sk_sp<SkData> onRefEncodedData() override { return SkData::MakeWithCString("green"); }
+    };
+    sk_sp<SkImage> lazy0 = SkImage::MakeFromGenerator(std::make_unique<Generator>()),
+                   lazy1 = SkImage::MakeFromGenerator(std::make_unique<Generator>());
+
+    auto make_path = [](bool isVolatile) {
+        SkPath path;
+        path.moveTo(0, 0).lineTo(10, 5).quadTo(20, 20, 0, 10).close();
+        path.setIsVolatile(isVolatile);
+        return path;
+    };
+
+    {
+        // Nothing is shared unless asked for.
+        SkRecord record;
+        SkRecorder recorder(&record, 100, 100);
+        recorder.drawImage(green0, 0, 0);
+        recorder.drawImage(green1, 0, 0);
+        REPORTER_ASSERT(r, assert_type<SkRecords::DrawImage>(r, record, 1)->image == green1);
+    }
+
+    SkRecord record;
+    SkRecorder recorder(&record, 100, 100);
+    recorder.setDedupContent(true);
+    recorder.drawImage(green0, 0, 0);
+    recorder.drawImage(green1, 0, 0);
+    recorder.drawImage(blue, 0, 0);
+    recorder.drawImage(lazy0, 0, 0);
+    recorder.drawImage(lazy1, 0, 0);
+    recorder.drawPath(make_path(false), SkPaint());
+    recorder.drawPath(make_path(false), SkPaint());
+    recorder.drawPath(make_path(true), SkPaint());
+
+    auto image = [&](int i) { return assert_type<SkRecords::DrawImage>(r, record, i)->image; };
+    REPORTER_ASSERT(r, image(0) == green0 && image(1) == green0);
+    REPORTER_ASSERT(r, image(2) == blue);
+    REPORTER_ASSERT(r, image(3) == lazy0 && image(4) == lazy0);
+
+    auto path = [&](int i) { return assert_type<SkRecords::DrawPath>(r, record, i)->path; };
+    REPORTER_ASSERT(r, path(5).getGenerationID() == path(6).getGenerationID());
+    REPORTER_ASSERT(r, path(5).getGenerationID() != path(7).getGenerationID());
+
+    // Pictures drawing identical images serialize them just once.
+    auto serialized_size = [](const SkImage* a, const SkImage* b) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(
+                100, 100, nullptr, SkPictureRecorder::kDeduplicateContent_RecordFlag);
+        canvas->drawImage(a, 0, 0);
+        canvas->drawImage(b, 50, 50);
+        return recorder.finishRecordingAsPicture()->serialize()->size();
+    };
+    REPORTER_ASSERT(r, serialized_size(green0.get(), green1.get()) ==
+                       serialized_size(green0.get(), green0.get()));
+    REPORTER_ASSERT(r, serialized_size(green0.get(), blue.get()) >
+                       serialized_size(green0.get(), green0.get()));
+}
@@ -397,6 +397,52 @@ DEF_TEST(Region_readFromMemory_bad, r) {
     }
 }
 
+// Unioning in a rect has its own path when the other side is complex, and so does setRects().
+// Check them against the general path, making the rect complex by adding a far away pixel that
+// we take back out afterwards.
+static SkRegion union_rect_slowly(const SkRegion& rgn, const SkIRect& rect) {
+    const SkIRect far = SkIRect::MakeXYWH(10000, 10000, 1, 1);
+    SkRegion complexRect(rect);
+    complexRect.op(far, SkRegion::kUnion_Op);
+
+    SkRegion result;
+    result.op(rgn, complexRect, SkRegion::kUnion_Op);
+    result.op(far, SkRegion::kDifference_Op);
+    return result;
+}
+
+DEF_TEST(Region_unionRect, reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 1000; i++) {
+        SkRegion rgn;
+        SkIRect rect;
+        for (int j = 0; j < 8; j++) {
+            rand_rect(&rect, rand);
+            rgn.op(rect, SkRegion::kXOR_Op);
+        }
+        rand_rect(&rect, rand);
+
+        SkRegion actual;
+        actual.op(rgn, rect, SkRegion::kUnion_Op);
+        REPORTER_ASSERT(reporter, actual == union_rect_slowly(rgn, rect));
+        actual.op(rect, rgn, SkRegion::kUnion_Op);
+        REPORTER_ASSERT(reporter, actual == union_rect_slowly(rgn, rect));
+    }
+
+    for (int i = 0; i < 100; i++) {
+        const int N = 64;
+        SkIRect rects[N];
+        SkRegion expected;
+        for (int j = 0; j < N; j++) {
+            rand_rect(&rects[j], rand);
+            expected = union_rect_slowly(expected, rects[j]);
+        }
+        SkRegion actual;
+        REPORTER_ASSERT(reporter, actual.setRects(rects, N) == !expected.isEmpty());
+        REPORTER_ASSERT(reporter, actual == expected);
+    }
+}
+
 DEF_TEST(region_toobig, reporter) {
     const int big = 1 << 30;
     const SkIRect neg = SkIRect::MakeXYWH(-big, -big, 10, 10);
@@ -13,6 +13,7 @@
 #include "include/core/SkSurface.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/gpu/GrDirectContext.h"
+#include "src/core/SkRuntimeEffectPriv.h"
 #include "src/core/SkTLazy.h"
 #include "src/gpu/GrColor.h"
 #include "tests/Test.h"
@@ -103,8 +104,8 @@ DEF_TEST(SkRuntimeEffectInvalidColorFilters, r) {
 
 class TestEffect {
 public:
-    TestEffect(skiatest::Reporter* r, sk_sp<SkSurface> surface)
-            : fReporter(r), fSurface(std::move(surface)) {}
+    TestEffect(skiatest::Reporter* r, sk_sp<SkSurface> surface, bool fromBlob = false)
+            : fReporter(r), fSurface(std::move(surface)), fFromBlob(fromBlob) {}
 
     void build(const char* header, const char* body) {
         SkString src = SkStringPrintf("%s half4 main(float2 p) { %s }",
@@ -115,6 +116,20 @@ public:
                            SkStringPrintf("Effect didn't compile: %s", errorText.c_str()));
             return;
         }
+        if (fFromBlob) {
+            // Replace the effect with one recreated from its blob, which must behave the same.
+            sk_sp<SkData> blob = SkRuntimeEffect_Serialize(*effect);
+            if (!blob) {
+                REPORT_FAILURE(fReporter, "blob", SkString("Effect couldn't be serialized"));
+                return;
+            }
+            std::tie(effect, errorText) = SkRuntimeEffect_MakeFromBlob(std::move(blob));
+            if (!effect) {
+                REPORT_FAILURE(fReporter, "effect",
+                               SkStringPrintf("Blob didn't load: %s", errorText.c_str()));
+                return;
+            }
+        }
         fBuilder.init(std::move(effect));
     }
 
@@ -173,6 +188,7 @@ public:
 private:
     skiatest::Reporter*             fReporter;
     sk_sp<SkSurface>                fSurface;
+    bool                            fFromBlob;
     SkTLazy<SkRuntimeShaderBuilder> fBuilder;
 };
 
@@ -190,13 +206,14 @@ static sk_sp<SkShader> make_RGBW_shader() {
     return bmp.makeShader();
 }
 
-static void test_RuntimeEffect_Shaders(skiatest::Reporter* r, GrRecordingContext* rContext) {
+static void test_RuntimeEffect_Shaders(skiatest::Reporter* r, GrRecordingContext* rContext,
+                                       bool fromBlob = false) {
     SkImageInfo info = SkImageInfo::Make(2, 2, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
     sk_sp<SkSurface> surface = rContext
                                     ? SkSurface::MakeRenderTarget(rContext, SkBudgeted::kNo, info)
                                     : SkSurface::MakeRaster(info);
     REPORTER_ASSERT(r, surface);
-    TestEffect effect(r, surface);
+    TestEffect effect(r, surface, fromBlob);
 
     using float4 = std::array<float, 4>;
 
@@ -273,6 +290,53 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkRuntimeEffectSimple_GPU, r, ctxInfo) {
     test_RuntimeEffect_Shaders(r, ctxInfo.directContext());
 }
 
+DEF_TEST(SkRuntimeEffectSimple_Blob, r) {
+    test_RuntimeEffect_Shaders(r, nullptr, /*fromBlob=*/true);
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkRuntimeEffectSimple_Blob_GPU, r, ctxInfo) {
+    test_RuntimeEffect_Shaders(r, ctxInfo.directContext(), /*fromBlob=*/true);
+}
+
+DEF_TEST(SkRuntimeEffectBlobInvalid, r) {
+    static constexpr char kSource[] = R"(
+        uniform float4 gColor;
+        in shader child;
+        half4 main(float2 p) { return half4(gColor) * sample(child, p.yx); }
+    )";
+    sk_sp<SkRuntimeEffect> effect = std::get<0>(SkRuntimeEffect::Make(SkString(kSource)));
+    REPORTER_ASSERT(r, effect);
+    sk_sp<SkData> blob = SkRuntimeEffect_Serialize(*effect);
+    REPORTER_ASSERT(r, blob);
+
+    auto [blobEffect, error] = SkRuntimeEffect_MakeFromBlob(blob);
+    REPORTER_ASSERT(r, blobEffect);
+    REPORTER_ASSERT(r, blobEffect->source().equals(effect->source()));
+    REPORTER_ASSERT(r, blobEffect->uniformSize() == effect->uniformSize());
+    REPORTER_ASSERT(r, blobEffect->findUniform("gColor"));
+    REPORTER_ASSERT(r, blobEffect->findChild("child") == 0);
+
+    // Every truncation of the blob must be rejected.
+    for (size_t size = 0; size < blob->size(); size += 4) {
+        auto [truncated, truncatedError] =
+                SkRuntimeEffect_MakeFromBlob(SkData::MakeSubset(blob.get(), 0, size));
+        REPORTER_ASSERT(r, !truncated);
+    }
+
+    // As must blobs from another version.
+    sk_sp<SkData> otherVersion = SkData::MakeWithCopy(blob->data(), blob->size());
+    static_cast<uint32_t*>(otherVersion->writable_data())[0] ^= 0xFFFF;
+    REPORTER_ASSERT(r, !std::get<0>(SkRuntimeEffect_MakeFromBlob(otherVersion)));
+
+    // A huge value in any word (e.g. the uniform, child or varying count) must fail cleanly, not
+    // try to allocate that many of anything.
+    for (size_t i = 1; i < blob->size() / 4; ++i) {
+        sk_sp<SkData> corrupt = SkData::MakeWithCopy(blob->data(), blob->size());
+        static_cast<uint32_t*>(corrupt->writable_data())[i] = 0xFFFFFFF0;
+        SkRuntimeEffect_MakeFromBlob(corrupt);
+    }
+}
+
 DEF_TEST(SkRuntimeShaderBuilderReuse, r) {
     const char* kSource = R"(
         uniform half x;
@@ -310,3 +374,30 @@ DEF_TEST(SkRuntimeEffectThreaded, r) {
         thread.join();
     }
 }
+
+DEF_TEST(SkRuntimeEffectCache, r) {
+    // Other tests may be making effects concurrently, so only check this test's own effects.
+    static constexpr char kSource[] =
+            "uniform half4 cacheTestColor; half4 main() { return cacheTestColor; }";
+
+    SkRuntimeEffectCacheStats before = SkRuntimeEffect_GetCacheStats();
+    auto [effect1, error1] = SkRuntimeEffect::Make(SkString(kSource));
+    auto [effect2, error2] = SkRuntimeEffect::Make(SkString(kSource));
+    REPORTER_ASSERT(r, effect1);
+    REPORTER_ASSERT(r, effect1 == effect2);
+
+    SkRuntimeEffectCacheStats after = SkRuntimeEffect_GetCacheStats();
+    REPORTER_ASSERT(r, after.fHits > before.fHits);
+    REPORTER_ASSERT(r, after.fMisses > before.fMisses);
+
+    // Different source must not share an effect, even if it only differs in whitespace.
+    auto [effect3, error3] = SkRuntimeEffect::Make(SkStringPrintf("%s ", kSource));
+    REPORTER_ASSERT(r, effect3 && effect3 != effect1);
+
+    // Failures aren't cached, and keep reporting their errors.
+    for (int i = 0; i < 2; ++i) {
+        auto [effect, error] = SkRuntimeEffect::Make(SkString("half4 main() { return x; }"));
+        REPORTER_ASSERT(r, !effect);
+        REPORTER_ASSERT(r, error.contains("x"));
+    }
+}
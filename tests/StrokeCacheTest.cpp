@@ -0,0 +1,88 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkStrokeRec.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkStrokeCache.h"
+#include "tests/Test.h"
+
+static SkPath make_polyline(int points) {
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 1; i < points; ++i) {
+        path.lineTo(i * 10.0f, (i & 1) ? 15.0f : 0.0f);
+    }
+    return path;
+}
+
+static int count_entries(SkResourceCache* cache) {
+    int count = 0;
+    cache->visitAll([](const SkResourceCache::Rec&, void* context) { ++*(int*)context; }, &count);
+    return count;
+}
+
+DEF_TEST(StrokeCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(4);
+    const SkStrokeRec rec(paint, 1);
+    const SkPath path = make_polyline(32);
+
+    SkPath first, second, expected;
+    REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, &first, path, &cache));
+    rec.applyToPath(&expected, path);
+    REPORTER_ASSERT(reporter, first == expected);
+
+    // A hit hands back the very same outline.
+    REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, &second, path, &cache));
+    REPORTER_ASSERT(reporter, second.getGenerationID() == first.getGenerationID());
+
+    // Every scale gets an outline of its own, stroked just as it would be without the cache...
+    SkPath scaled, moreScaled, expectedScaled;
+    SkStrokeCache::ApplyToPath(SkStrokeRec(paint, 1.5f), &scaled, path, &cache);
+    SkStrokeCache::ApplyToPath(SkStrokeRec(paint, 2.0f), &moreScaled, path, &cache);
+    SkStrokeRec(paint, 1.5f).applyToPath(&expectedScaled, path);
+    REPORTER_ASSERT(reporter, scaled == expectedScaled);
+    REPORTER_ASSERT(reporter, scaled.getGenerationID() != first.getGenerationID());
+    REPORTER_ASSERT(reporter, moreScaled.getGenerationID() != scaled.getGenerationID());
+
+    // ...as do other stroke parameters.
+    SkPaint wider(paint);
+    wider.setStrokeWidth(5);
+    SkStrokeCache::ApplyToPath(SkStrokeRec(wider, 1), &second, path, &cache);
+    REPORTER_ASSERT(reporter, second.getGenerationID() != first.getGenerationID());
+    REPORTER_ASSERT(reporter, count_entries(&cache) == 4);
+
+    // Fills and hairlines aren't strokes at all, and volatile paths are never cached.
+    REPORTER_ASSERT(reporter, !SkStrokeCache::ApplyToPath(SkStrokeRec(SkStrokeRec::kFill_InitStyle),
+                                                          &second, path, &cache));
+    SkPath scratch = make_polyline(32);
+    scratch.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, &second, scratch, &cache));
+    REPORTER_ASSERT(reporter, second == expected);
+    REPORTER_ASSERT(reporter, count_entries(&cache) == 4);
+
+    // Editing or deleting a path purges its strokes.
+    {
+        SkPath doomed = make_polyline(32);
+        SkStrokeCache::ApplyToPath(rec, &second, doomed, &cache);
+        REPORTER_ASSERT(reporter, count_entries(&cache) == 5);
+
+        doomed.lineTo(0, 100);
+        SkStrokeCache::ApplyToPath(rec, &second, path, &cache);  // Any lookup handles purges.
+        REPORTER_ASSERT(reporter, count_entries(&cache) == 4);
+
+        SkStrokeCache::ApplyToPath(rec, &second, doomed, &cache);
+        REPORTER_ASSERT(reporter, count_entries(&cache) == 5);
+    }
+    SkStrokeCache::ApplyToPath(rec, &second, path, &cache);
+    REPORTER_ASSERT(reporter, count_entries(&cache) == 4);
+}
@@ -41,6 +41,7 @@ bool CollectImages(CommandLineFlags::StringArray dir, SkTArray<SkString>* output
 void SetCtxOptionsFromCommonFlags(struct GrContextOptions*);
 
 /**
- *  Enable, disable, or force analytic anti-aliasing using --analyticAA and --forceAnalyticAA.
+ *  Enable, disable, or force analytic anti-aliasing using --analyticAA and --forceAnalyticAA,
+ *  or switch to the sparse tile rasterizer using --sparseTileAA.
  */
 void SetAnalyticAAFromCommonFlags();
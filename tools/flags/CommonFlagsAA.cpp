@@ -9,8 +9,12 @@ static DEFINE_bool(forceAnalyticAA, false,
             "Force analytic anti-aliasing even if the path is complicated: "
             "whether it's concave or convex, we consider a path complicated"
             "if its number of points is comparable to its resolution.");
+static DEFINE_bool(sparseTileAA, false,
+            "Fill anti-aliased paths with the sparse tile rasterizer instead of "
+            "analytic or supersampled anti-aliasing.");
 
 void SetAnalyticAAFromCommonFlags() {
     gSkUseAnalyticAA   = FLAGS_analyticAA;
     gSkForceAnalyticAA = FLAGS_forceAnalyticAA;
+    gSkUseSparseTileAA = FLAGS_sparseTileAA;
 }
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTime.h"
+#include "src/core/SkOSFile.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordOpts.h"
+#include "src/core/SkRecorder.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/flags/CommandLineFlags.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+// Runs the whole-picture optimizers over .skps, reporting how many ops each pass removes, how
+// much faster the result plays back, and whether it still draws the same pixels.
+
+static DEFINE_string2(skps, r, "", ".SKPs to optimize.");
+static DEFINE_string(match, "", "The usual filters on file names to optimize.");
+static DEFINE_int(loops, 10, "Playbacks to time, reporting the fastest.");
+static DEFINE_string2(write, w, "", "If set, write the optimized pictures to this directory.");
+
+static int count_ops(const SkRecord& record) {
+    int count = 0;
+    for (int i = 0; i < record.count(); i++) {
+        count += record.visit(i, [](const auto& op) {
+            return !std::is_same<std::decay_t<decltype(op)>, SkRecords::NoOp>::value;
+        });
+    }
+    return count;
+}
+
+static int merge_matrices(SkRecord* record, const SkRect&) {
+    return SkRecordMergeMatrices(record);
+}
+
+static int batch_image_rects(SkRecord* record, const SkRect&) {
+    return SkRecordBatchImageRects(record);
+}
+
+// Returns the fastest of FLAGS_loops playbacks in ms, leaving the last one in bitmap.
+static double time_playback(const SkRecord& record, const SkRect& cull, SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(SkScalarCeilToInt(cull.width()), SkScalarCeilToInt(cull.height()));
+
+    double fastest = 0;
+    for (int i = 0; i < std::max(1, FLAGS_loops); i++) {
+        bitmap->eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(*bitmap);
+        canvas.translate(-cull.left(), -cull.top());
+
+        double start = SkTime::GetMSecs();
+        SkRecordDraw(record, &canvas, nullptr, nullptr, 0, nullptr, nullptr);
+        double elapsed = SkTime::GetMSecs() - start;
+        fastest = i == 0 ? elapsed : std::min(fastest, elapsed);
+    }
+    return fastest;
+}
+
+// Counts pixels that differ, and the largest difference in any channel.
+static int diff_pixels(const SkBitmap& a, const SkBitmap& b, int* maxDiff) {
+    int count = 0;
+    *maxDiff = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            uint32_t pa = *a.getAddr32(x, y),
+                     pb = *b.getAddr32(x, y);
+            if (pa != pb) {
+                count++;
+                for (int shift = 0; shift < 32; shift += 8) {
+                    int d = abs((int)((pa >> shift) & 0xFF) - (int)((pb >> shift) & 0xFF));
+                    *maxDiff = std::max(*maxDiff, d);
+                }
+            }
+        }
+    }
+    return count;
+}
+
+int main(int argc, char** argv) {
+    CommandLineFlags::Parse(argc, argv);
+
+    for (int i = 0; i < FLAGS_skps.count(); i++) {
+        if (CommandLineFlags::ShouldSkip(FLAGS_match, FLAGS_skps[i])) {
+            continue;
+        }
+
+        std::unique_ptr<SkStream> stream = SkStream::MakeFromFile(FLAGS_skps[i]);
+        if (!stream) {
+            SkDebugf("Could not read %s.\n", FLAGS_skps[i]);
+            return 1;
+        }
+        sk_sp<SkPicture> src(SkPicture::MakeFromStream(stream.get()));
+        if (!src) {
+            SkDebugf("Could not read %s as an SkPicture.\n", FLAGS_skps[i]);
+            return 1;
+        }
+        const SkRect cull = src->cullRect();
+
+        SkRecord original, optimized;
+        {
+            SkRecorder rec(&original, cull);
+            src->playback(&rec);
+        }
+        {
+            SkRecorder rec(&optimized, cull);
+            src->playback(&rec);
+        }
+
+        printf("%s\n", FLAGS_skps[i]);
+        printf("  %-22s %8d ops\n", "recorded", count_ops(optimized));
+
+        // The same order as SkRecordOptimizeWholePicture().
+        const struct {
+            const char* name;
+            int (*pass)(SkRecord*, const SkRect&);
+        } passes[] = {
+            {"merge matrices",    merge_matrices},
+            {"occluded draws",    SkRecordNoopOccludedDraws},
+            {"dead state",        SkRecordNoopDeadState},
+            {"merge matrices",    merge_matrices},
+            {"batch image rects", batch_image_rects},
+        };
+        for (const auto& pass : passes) {
+            int removed = pass.pass(&optimized, cull);
+            printf("  %-22s %8d ops (-%d)\n", pass.name, count_ops(optimized), removed);
+        }
+        optimized.defrag();
+
+        SkBitmap before, after;
+        double beforeMs = time_playback(original,  cull, &before),
+               afterMs  = time_playback(optimized, cull, &after);
+        int maxDiff;
+        int diffs = diff_pixels(before, after, &maxDiff);
+        printf("  playback %.3gms -> %.3gms (%.2fx), %d pixels differ (max %d)\n",
+               beforeMs, afterMs, afterMs > 0 ? beforeMs / afterMs : 0.0, diffs, maxDiff);
+
+        if (FLAGS_write.count() > 0) {
+            SkPictureRecorder recorder;
+            SkRecordDraw(optimized, recorder.beginRecording(cull),
+                         nullptr, nullptr, 0, nullptr, nullptr);
+            sk_sp<SkPicture> dst(recorder.finishRecordingAsPicture());
+
+            SkString path = SkOSPath::Join(FLAGS_write[0],
+                                           SkOSPath::Basename(FLAGS_skps[i]).c_str());
+            SkFILEWStream ostream(path.c_str());
+            dst->serialize(&ostream);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkStream.h"
+#include "include/effects/SkRuntimeEffect.h"
+#include "src/core/SkRuntimeEffectPriv.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/flags/CommandLineFlags.h"
+
+// Compiles runtime effects offline, so Skia's own clients can ship the blobs and load them with
+// SkRuntimeEffect_MakeFromBlob() instead of running the SkSL compiler at startup.
+// Each input foo.sksl is written to <outDir>/foo.skrt.
+
+static DEFINE_string2(input, i, "", "Runtime effect .sksl files to compile.");
+static DEFINE_string2(outDir, o, "", "Directory to write the compiled .skrt blobs to.");
+
+int main(int argc, char** argv) {
+    CommandLineFlags::SetUsage("Compiles runtime effects into blobs for "
+                               "SkRuntimeEffect_MakeFromBlob()");
+    CommandLineFlags::Parse(argc, argv);
+    SkGraphics::Init();
+
+    if (FLAGS_input.isEmpty() || FLAGS_outDir.count() != 1) {
+        SkDebugf("Usage: %s -i <file.sksl>... -o <outDir>\n", argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 0; i < FLAGS_input.count(); i++) {
+        const char* path = FLAGS_input[i];
+        sk_sp<SkData> sksl = SkData::MakeFromFileName(path);
+        if (!sksl) {
+            SkDebugf("Could not read %s\n", path);
+            failures++;
+            continue;
+        }
+
+        auto [effect, errorText] = SkRuntimeEffect::Make(
+                SkString(static_cast<const char*>(sksl->data()), sksl->size()));
+        if (!effect) {
+            SkDebugf("%s: %s\n", path, errorText.c_str());
+            failures++;
+            continue;
+        }
+        sk_sp<SkData> blob = SkRuntimeEffect_Serialize(*effect);
+        if (!blob) {
+            SkDebugf("%s: effect can't be converted to byte code\n", path);
+            failures++;
+            continue;
+        }
+
+        SkString name = SkOSPath::Basename(path);
+        if (name.endsWith(".sksl")) {
+            name.resize(name.size() - strlen(".sksl"));
+        }
+        name.append(".skrt");
+        SkString outPath = SkOSPath::Join(FLAGS_outDir[0], name.c_str());
+        SkFILEWStream out(outPath.c_str());
+        if (!out.isValid() || !out.write(blob->data(), blob->size())) {
+            SkDebugf("Could not write %s\n", outPath.c_str());
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}